@@ -6,7 +6,21 @@
 #include "serialdevice.h"
 #include "16x50.h"
 
-/* UART: very mimimal for the moment */
+/*
+ *	UART: very mimimal for the moment
+ *
+ *	With the FIFOs enabled the receive side is filled from the serial
+ *	device as fast as it will supply bytes, and the interrupt is only
+ *	raised at the trigger level or when data has sat below it for a
+ *	few polls (the character timeout). The transmit FIFO is emptied to
+ *	the device on each poll and THRE is raised once it is empty. With
+ *	them disabled the UART behaves as an 8250 passing bytes through.
+ */
+
+#define FIFO_SIZE	16
+#define RX_TIMEOUT	4	/* Polls without activity before a timeout */
+
+static const uint8_t rx_trigger[4] = { 1, 4, 8, 14 };
 
 struct uart16x50 {
     uint8_t ier;
@@ -24,7 +38,15 @@ struct uart16x50 {
 #define RXDA	1
 #define TEMT	2
 #define MODEM	8
+#define RXTO	0x10	/* Enabled by the IER RXDA bit */
     uint8_t irqline;
+    uint8_t rxfifo[FIFO_SIZE];
+    uint8_t txfifo[FIFO_SIZE];
+    unsigned rxhead;
+    unsigned rxcount;
+    unsigned txhead;
+    unsigned txcount;
+    unsigned rxidle;
     unsigned clock;
     int trace;
     struct serial_device *dev;
@@ -34,6 +56,10 @@ void uart16x50_reset(struct uart16x50 *uptr)
 {
     uptr->dlab = 0;
     uptr->iir = 1;
+    uptr->fcr = 0;
+    uptr->rxcount = 0;
+    uptr->txcount = 0;
+    uptr->rxidle = 0;
 }
 
 /* Compute the interrupt indicator register from what is pending */
@@ -41,6 +67,8 @@ static void uart16x50_recalc_iir(struct uart16x50 *uptr)
 {
     if (uptr->irq & RXDA)
         uptr->iir = 0x04;
+    else if (uptr->irq & RXTO)
+        uptr->iir = 0x0C;
     else if (uptr->irq & TEMT)
         uptr->iir = 0x02;
     else if (uptr->irq & MODEM)
@@ -61,7 +89,7 @@ static void uart16x50_interrupt(struct uart16x50 *uptr, uint8_t n)
 {
     if (uptr->irq & n)
         return;
-    if (!(uptr->ier & n))
+    if (!(uptr->ier & ((n == RXTO) ? RXDA : n)))
         return;
     uptr->irq |= n;
     uart16x50_recalc_iir(uptr);
@@ -75,12 +103,64 @@ static void uart16x50_clear_interrupt(struct uart16x50 *uptr, uint8_t n)
     uart16x50_recalc_iir(uptr);
 }
 
+/* Recompute the receive interrupts after the FIFO level changes */
+static void uart16x50_rx_level(struct uart16x50 *uptr)
+{
+    if (uptr->rxcount)
+        uptr->lsr |= 0x01;
+    else
+        uptr->lsr &= ~0x01;
+    if (uptr->rxcount >= rx_trigger[uptr->fcr >> 6])
+        uart16x50_interrupt(uptr, RXDA);
+    else
+        uart16x50_clear_interrupt(uptr, RXDA);
+}
+
+static void uart16x50_fifo_event(struct uart16x50 *uptr)
+{
+    unsigned r = uptr->dev->ready(uptr->dev);
+    unsigned n = 0;
+
+    /* Fill the receive FIFO with whatever the device has waiting */
+    while ((r & 1) && uptr->rxcount < FIFO_SIZE) {
+        uptr->rxfifo[(uptr->rxhead + uptr->rxcount++) % FIFO_SIZE] =
+            uptr->dev->get(uptr->dev);
+        r = uptr->dev->ready(uptr->dev);
+        n++;
+    }
+    if (n) {
+        uptr->rxidle = 0;
+        uart16x50_rx_level(uptr);
+    } else if (uptr->rxcount && uptr->rxidle < RX_TIMEOUT) {
+        if (++uptr->rxidle == RX_TIMEOUT)
+            uart16x50_interrupt(uptr, RXTO);
+    }
+
+    /* Drain the transmit FIFO */
+    if (!(r & 2))
+        return;
+    while (uptr->txcount) {
+        uptr->dev->put(uptr->dev, uptr->txfifo[uptr->txhead]);
+        uptr->txhead = (uptr->txhead + 1) % FIFO_SIZE;
+        uptr->txcount--;
+    }
+    if (!(uptr->lsr & 0x20)) {
+        uptr->lsr |= 0x60;
+        uart16x50_interrupt(uptr, TEMT);
+    }
+}
+
 void uart16x50_event(struct uart16x50 *uptr)
 {
-    uint8_t r = uptr->dev->ready(uptr->dev);
+    uint8_t r;
     uint8_t old = uptr->lsr;
     uint8_t dhigh;
 
+    if (uptr->fcr & 1) {
+        uart16x50_fifo_event(uptr);
+        return;
+    }
+    r = uptr->dev->ready(uptr->dev);
     uptr->lsr &= ~0x61;		/* Clear RX and TX bits */
     if (r & 1)
         uptr->lsr |= 0x01;	/* RX not empty */
@@ -153,7 +233,13 @@ void uart16x50_write(struct uart16x50 *uptr, uint8_t addr, uint8_t val)
 {
     switch(addr) {
     case 0:	/* If dlab = 0, then write else LS*/
-        if (uptr->dlab == 0) {
+        if (uptr->dlab == 0 && (uptr->fcr & 1)) {
+            /* Bytes written to a full FIFO are lost */
+            if (uptr->txcount < FIFO_SIZE)
+                uptr->txfifo[(uptr->txhead + uptr->txcount++) % FIFO_SIZE] = val;
+            uptr->lsr &= ~0x60;
+            uart16x50_clear_interrupt(uptr, TEMT);
+        } else if (uptr->dlab == 0) {
             uptr->dev->put(uptr->dev, val);
             uart16x50_clear_interrupt(uptr, TEMT);
             uart16x50_interrupt(uptr, TEMT);
@@ -171,7 +257,20 @@ void uart16x50_write(struct uart16x50 *uptr, uint8_t addr, uint8_t val)
             uptr->ier = val;
         break;
     case 2:	/* FCR */
-        uptr->fcr = val & 0x9F;
+        /* Turning the FIFOs on or off empties them */
+        if ((val ^ uptr->fcr) & 1)
+            val |= 0x06;
+        if (val & 0x02) {
+            uptr->rxcount = 0;
+            uptr->rxidle = 0;
+            uptr->lsr &= ~0x01;
+            uart16x50_clear_interrupt(uptr, RXDA | RXTO);
+        }
+        if (val & 0x04)
+            uptr->txcount = 0;
+        uptr->fcr = val & 0xC9;
+        if (uptr->fcr & 1)
+            uart16x50_rx_level(uptr);
         break;
     case 3:	/* LCR */
         uptr->lcr = val;
@@ -200,7 +299,17 @@ uint8_t uart16x50_read(struct uart16x50 *uptr, uint8_t addr)
     switch(addr) {
     case 0:
         /* receive buffer */
-        if (uptr->dlab == 0) {
+        if (uptr->dlab == 0 && (uptr->fcr & 1)) {
+            r = uptr->rxfifo[uptr->rxhead];
+            if (uptr->rxcount) {
+                uptr->rxhead = (uptr->rxhead + 1) % FIFO_SIZE;
+                uptr->rxcount--;
+            }
+            uptr->rxidle = 0;
+            uart16x50_clear_interrupt(uptr, RXTO);
+            uart16x50_rx_level(uptr);
+            return r;
+        } else if (uptr->dlab == 0) {
             uart16x50_clear_interrupt(uptr, RXDA);
             return uptr->dev->get(uptr->dev);
         } else
@@ -213,8 +322,13 @@ uint8_t uart16x50_read(struct uart16x50 *uptr, uint8_t addr)
         else
             return uptr->ms;
     case 2:
-        /* IIR */
-        return uptr->iir;
+        /* IIR. Reading it acknowledges a THRE interrupt */
+        r = uptr->iir;
+        if ((r & 0x0F) == 0x02)
+            uart16x50_clear_interrupt(uptr, TEMT);
+        if (uptr->fcr & 1)
+            r |= 0xC0;
+        return r;
     case 3:
         /* LCR */
         return uptr->lcr;
@@ -225,6 +339,8 @@ uint8_t uart16x50_read(struct uart16x50 *uptr, uint8_t addr)
         /* Reading the LSR causes these bits to clear */
         r = uptr->lsr;
         uptr->lsr &= 0xF0;
+        if (uptr->rxcount)
+            uptr->lsr |= 0x01;
         return r;
     case 6:
         /* msr */
@@ -42,6 +42,7 @@
 
 static uint8_t fast = 0;
 static uint8_t int_recalc = 0;
+static uint8_t spi_hle = 0;
 static uint8_t gpio_out;
 static uint8_t gpio_in = 0xFF;		/* SD not present, printer floating */
 static uint8_t flash_in = 1;
@@ -755,9 +756,12 @@ static uint8_t ctc_read(uint8_t channel)
 
 static uint8_t bitcnt;
 static uint8_t txbits, rxbits;
+static uint8_t in_hle;
 
 static void spi_clock_high(void)
 {
+	static uint16_t lastpc = 0xFFFF;
+
 	txbits <<= 1;
 	txbits |= gpio_out & 1;
 	bitcnt++;
@@ -765,6 +769,11 @@ static void spi_clock_high(void)
 		rxbits = sd_spi_in(sdcard, txbits);
 		if (trace & TRACE_SPI)
 			fprintf(stderr, "spi %02X | %02X\n", rxbits, txbits);
+		/* Help whoever is adding signatures find the routine */
+		if (spi_hle && !in_hle && (trace & TRACE_SPI) && cpu_z80.M1PC != lastpc) {
+			lastpc = cpu_z80.M1PC;
+			fprintf(stderr, "spi: byte clocked by unknown code at %04X\n", lastpc);
+		}
 		bitcnt = 0;
 	}
 }
@@ -890,6 +899,326 @@ void io_write(int unused, uint16_t addr, uint8_t val)
 		fprintf(stderr, "Unknown write to port %04X of %02X\n", addr, val);
 }
 
+/*
+ *	High level emulation of the SD card byte routines
+ *
+ *	Bit banging SPI costs the guest a few dozen instructions a byte.
+ *	With -H we recognise the ROM/BIOS spi_write8 and spi_read8 routines,
+ *	and the 256 byte loops that call them, and run them here. The port
+ *	accesses still go through io_write and io_read in the same order so
+ *	the card sees the same thing. The registers, R and t-states end up
+ *	as the guest code would have left them. Anything that doesn't match
+ *	byte for byte is left to run normally.
+ *
+ *	Only the SD card routines are matched. The DS1302 and I2C bit bang
+ *	drivers in the guest are not, and still run a bit at a time.
+ */
+
+static uint16_t hle_pc;
+static unsigned hle_t;			/* T-states used */
+static unsigned hle_m1;			/* M1 cycles, for R */
+
+static uint8_t hle_byte(void)
+{
+	return do_mem_read(hle_pc++, 1);
+}
+
+static int hle_match(const uint8_t *p, unsigned len)
+{
+	while (len--)
+		if (hle_byte() != *p++)
+			return 0;
+	return 1;
+}
+
+static uint16_t hle_word(void)
+{
+	uint16_t r = hle_byte();
+	return r | (hle_byte() << 8);
+}
+
+/* Flags as left by AND/OR/XOR */
+static uint8_t hle_logic_flags(uint8_t v)
+{
+	uint8_t f = v & 0xA8;
+	uint8_t p = v ^ (v >> 4);
+
+	p ^= p >> 2;
+	p ^= p >> 1;
+	if (v == 0)
+		f |= 0x40;
+	if (!(p & 1))
+		f |= 0x04;
+	return f;
+}
+
+/*
+ *	spi_write8:	ld a,(gpio_out_cache); and ~(MOSI|CLK); ld d,a
+ *	then for bit 7 to 0 (ld a,d for all but bit 7)
+ *			bit n,c; jr z,.+4; or MOSI
+ *			out (gpio_out),a; or CLK; out (gpio_out),a
+ *	and ret. Sends C, clobbers A and D.
+ */
+static int spi_match_write8(uint16_t pc, uint16_t *cache)
+{
+	static const uint8_t head[] = { 0xE6, 0xFC, 0x57 };
+	static const uint8_t bit[] = {
+		0x28, 0x02, 0xF6, 0x01, 0xD3, 0x10, 0xF6, 0x02, 0xD3, 0x10
+	};
+	int n;
+
+	hle_pc = pc;
+	if (hle_byte() != 0x3A)
+		return 0;
+	*cache = hle_word();
+	if (!hle_match(head, sizeof(head)))
+		return 0;
+	for (n = 7; n >= 0; n--) {
+		if (n != 7 && hle_byte() != 0x7A)
+			return 0;
+		if (hle_byte() != 0xCB || hle_byte() != 0x41 + 8 * n)
+			return 0;
+		if (!hle_match(bit, sizeof(bit)))
+			return 0;
+	}
+	return hle_byte() == 0xC9;
+}
+
+static void spi_write8(uint16_t cache)
+{
+	uint8_t c = cpu_z80.R1.br.C;
+	uint8_t d = do_mem_read(cache, 1) & 0xFC;
+	uint8_t a = d;
+	int n;
+
+	hle_t += 13 + 7 + 4;
+	hle_m1 += 3;
+	for (n = 7; n >= 0; n--) {
+		if (n != 7) {
+			a = d;
+			hle_t += 4;
+			hle_m1++;
+		}
+		hle_t += 8;
+		hle_m1 += 2;
+		if (c & (1 << n)) {
+			a |= 1;
+			hle_t += 7 + 7;
+			hle_m1 += 2;
+		} else {
+			hle_t += 12;
+			hle_m1++;
+		}
+		io_write(0, (a << 8) | 0x10, a);
+		a |= 2;
+		io_write(0, (a << 8) | 0x10, a);
+		hle_t += 11 + 7 + 11;
+		hle_m1 += 3;
+	}
+	cpu_z80.R1.br.A = a;
+	cpu_z80.R1.br.F = hle_logic_flags(a);
+	cpu_z80.R1.br.D = d;
+}
+
+/*
+ *	spi_read8:	ld e,0; ld a,(gpio_out_cache); and ~CLK; or MOSI; ld d,a
+ *	then eight times
+ *			ld a,d; out (gpio_out),a; or CLK; out (gpio_out),a
+ *			in a,(gpio_in); and MISO; or e; rlca; ld e,a
+ *	and ret. Returns the byte in A and E, clobbers D.
+ */
+static int spi_match_read8(uint16_t pc, uint16_t *cache)
+{
+	static const uint8_t head[] = { 0x1E, 0x00, 0x3A };
+	static const uint8_t head2[] = { 0xE6, 0xFD, 0xF6, 0x01, 0x57 };
+	static const uint8_t bit[] = {
+		0x7A, 0xD3, 0x10, 0xF6, 0x02, 0xD3, 0x10,
+		0xDB, 0x00, 0xE6, 0x80, 0xB3, 0x07, 0x5F
+	};
+	int n;
+
+	hle_pc = pc;
+	if (!hle_match(head, sizeof(head)))
+		return 0;
+	*cache = hle_word();
+	if (!hle_match(head2, sizeof(head2)))
+		return 0;
+	for (n = 0; n < 8; n++)
+		if (!hle_match(bit, sizeof(bit)))
+			return 0;
+	return hle_byte() == 0xC9;
+}
+
+static void spi_read8(uint16_t cache)
+{
+	uint8_t d = (do_mem_read(cache, 1) & 0xFD) | 0x01;
+	uint8_t e = 0;
+	uint8_t a = d;
+	uint8_t f = 0;
+	int n;
+
+	hle_t += 7 + 13 + 7 + 7 + 4;
+	hle_m1 += 5;
+	for (n = 0; n < 8; n++) {
+		a = d;
+		io_write(0, (a << 8) | 0x10, a);
+		a |= 2;
+		io_write(0, (a << 8) | 0x10, a);
+		a = io_read(0, a << 8);
+		a = (a & 0x80) | e;
+		f = hle_logic_flags(a) & 0xC4;
+		a = (a << 1) | (a >> 7);
+		f |= (a & 0x29);
+		e = a;
+		hle_t += 4 + 11 + 7 + 11 + 11 + 7 + 4 + 4 + 4;
+		hle_m1 += 9;
+	}
+	cpu_z80.R1.br.A = a;
+	cpu_z80.R1.br.F = f;
+	cpu_z80.R1.br.D = d;
+	cpu_z80.R1.br.E = e;
+}
+
+/* Find out which routine if any lives at pc. Returns 1 for read8, 2
+   for write8 and 0 for neither */
+static int spi_routine(uint16_t pc, uint16_t *cache)
+{
+	if (spi_match_read8(pc, cache))
+		return 1;
+	if (spi_match_write8(pc, cache))
+		return 2;
+	return 0;
+}
+
+/* The routine works from gpio_out_cache. If that doesn't agree with
+   the port about the bank then the code would page itself out */
+static int spi_safe(uint16_t cache)
+{
+	return ((do_mem_read(cache, 1) ^ gpio_out) & 0xF0) == 0;
+}
+
+static void hle_ret(void)
+{
+	uint16_t sp = cpu_z80.R1.wr.SP;
+	cpu_z80.PC = do_mem_read(sp, 1) | (do_mem_read(sp + 1, 1) << 8);
+	cpu_z80.R1.wr.SP = sp + 2;
+	hle_t += 10;
+	hle_m1++;
+}
+
+static void hle_call(uint16_t ret)
+{
+	uint16_t sp = cpu_z80.R1.wr.SP - 2;
+	mem_write(0, sp + 1, ret >> 8);
+	mem_write(0, sp, ret);
+	cpu_z80.R1.wr.SP = sp;
+	hle_t += 17;
+	hle_m1++;
+}
+
+/*
+ *	The block loops
+ *		1:	call spi_read8; ld (hl),a; inc hl; djnz 1b
+ *		1:	ld c,(hl); call spi_write8; inc hl; djnz 1b
+ *
+ *	With interrupts enabled we do one pass and leave B and HL for the
+ *	next so the CTC and SIO interrupts are still taken between bytes as
+ *	they would be on the real loop.
+ */
+static int spi_block(uint16_t pc)
+{
+	static const uint8_t rtail[] = { 0x77, 0x23, 0x10, 0xF9 };
+	static const uint8_t wtail[] = { 0x23, 0x10, 0xF9 };
+	uint16_t cache;
+	uint16_t fn;
+	uint8_t op = do_mem_read(pc, 1);
+	uint8_t *b = &cpu_z80.R1.br.B;
+	uint16_t *hl = &cpu_z80.R1.wr.HL;
+
+	if (op == 0xCD) {
+		hle_pc = pc + 1;
+		fn = hle_word();
+		if (!hle_match(rtail, sizeof(rtail)))
+			return 0;
+		if (spi_routine(fn, &cache) != 1 || !spi_safe(cache))
+			return 0;
+		do {
+			hle_call(pc + 3);
+			spi_read8(cache);
+			hle_ret();
+			mem_write(0, *hl, cpu_z80.R1.br.A);
+			(*hl)++;
+			hle_t += 7 + 6 + 8;
+			hle_m1 += 3;
+			if (--*b)
+				hle_t += 5;
+		} while (*b && !cpu_z80.IFF1);
+		cpu_z80.PC = *b ? pc : pc + 7;
+		return 1;
+	}
+	if (op == 0x4E && do_mem_read(pc + 1, 1) == 0xCD) {
+		hle_pc = pc + 2;
+		fn = hle_word();
+		if (!hle_match(wtail, sizeof(wtail)))
+			return 0;
+		if (spi_routine(fn, &cache) != 2 || !spi_safe(cache))
+			return 0;
+		do {
+			cpu_z80.R1.br.C = do_mem_read(*hl, 1);
+			hle_call(pc + 4);
+			spi_write8(cache);
+			hle_ret();
+			(*hl)++;
+			hle_t += 7 + 6 + 8;
+			hle_m1 += 3;
+			if (--*b)
+				hle_t += 5;
+		} while (*b && !cpu_z80.IFF1);
+		cpu_z80.PC = *b ? pc : pc + 7;
+		return 1;
+	}
+	return 0;
+}
+
+static int z80_hle(int unused, uint16_t pc)
+{
+	uint16_t cache;
+	int r = 0;
+
+	/* Only worth a look while the card is selected */
+	if (gpio_out & 4)
+		return 0;
+	hle_t = 0;
+	hle_m1 = 0;
+	in_hle = 1;
+	if (spi_block(pc))
+		r = 1;
+	else switch (spi_routine(pc, &cache)) {
+	case 1:
+		if (spi_safe(cache)) {
+			spi_read8(cache);
+			hle_ret();
+			r = 1;
+		}
+		break;
+	case 2:
+		if (spi_safe(cache)) {
+			spi_write8(cache);
+			hle_ret();
+			r = 1;
+		}
+		break;
+	}
+	in_hle = 0;
+	if (r) {
+		cpu_z80.tstates += hle_t;
+		cpu_z80.R = (cpu_z80.R & 0x80) | ((cpu_z80.R + hle_m1) & 0x7F);
+		if (trace & TRACE_SPI)
+			fprintf(stderr, "spi: hle at %04X\n", pc);
+	}
+	return r;
+}
+
 static void poll_irq_event(void)
 {
 	if (!live_irq)
@@ -939,7 +1268,7 @@ static void exit_cleanup(void)
 
 static void usage(void)
 {
-	fprintf(stderr, "2063: [-1] [-r rompath] [-S sdcard] [-T] [-f] [-d debug]\n");
+	fprintf(stderr, "2063: [-1] [-r rompath] [-S sdcard] [-T] [-f] [-H] [-d debug]\n");
 	exit(EXIT_FAILURE);
 }
 
@@ -954,7 +1283,7 @@ int main(int argc, char *argv[])
 	unsigned have_16x50 = 0;
 	unsigned rsize;
 
-	while ((opt = getopt(argc, argv, "d:fr:S:T")) != -1) {
+	while ((opt = getopt(argc, argv, "d:fHr:S:T")) != -1) {
 		switch (opt) {
 		case 1:
 			have_16x50 = 1;
@@ -971,6 +1300,9 @@ int main(int argc, char *argv[])
 		case 'f':
 			fast = 1;
 			break;
+		case 'H':
+			spi_hle = 1;
+			break;
 		case 'T':
 			have_tms = 1;
 			break;
@@ -1054,6 +1386,8 @@ int main(int argc, char *argv[])
 	cpu_z80.memRead = mem_read;
 	cpu_z80.memWrite = mem_write;
 	cpu_z80.trace = z80_trace;
+	if (spi_hle)
+		cpu_z80.hle = z80_hle;
 
 	/* This is the wrong way to do it but it's easier for the moment. We
 	   should track how much real time has occurred and try to keep cycle
@@ -1075,8 +1409,8 @@ int main(int argc, char *argv[])
 		for (i = 0; i < 333; i++) {
 			int j;
 			for (j = 0; j < 10; j++) {
-				Z80ExecuteTStates(&cpu_z80, tstate_steps);
-				ctc_tick(tstate_steps);
+				/* An SPI block done in one go runs well over */
+				ctc_tick(Z80ExecuteTStates(&cpu_z80, tstate_steps));
 				sio2_timer();
 			}
 			/* We want to run UI events regularly it seems */
@@ -5,6 +5,7 @@
 #include <time.h>
 #include "system.h"
 #include "58174.h"
+#include "wallclock.h"
 
 /*
  *	MM58174 RTC. Nybble wide interface
@@ -37,12 +38,10 @@ static void rtc_reload(struct mm58174 *rtc)
 
 uint8_t mm58174_read(struct mm58174 *rtc, uint8_t reg)
 {
-	time_t t;
 	struct tm *tm;
 	static unsigned fake_tenths;
 
-	t = time(NULL);
-	tm = gmtime(&t);
+	tm = wallclock_gmtime();
 	if (tm == NULL)
 		return 0xFF;
 		
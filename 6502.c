@@ -908,6 +908,8 @@ void irq6502(void)
 }
 
 static void (*loopexternal) (void);
+static void (*traceexternal) (uint16_t pc, uint8_t a, uint8_t x, uint8_t y,
+			      uint8_t sp, uint8_t status);
 
 int log_6502 = 0;
 
@@ -930,6 +932,8 @@ uint64_t exec6502(uint64_t tickcount)
 			fprintf(stderr, "%02X %02X %02X %02X %02X | %04X %s\n",
 				a, x, y, sp, status, pc - 1, dis);
 		}
+		if (traceexternal)
+			(*traceexternal) (pc - 1, a, x, y, sp, status);
 		penaltyop = 0;
 		penaltyaddr = 0;
 
@@ -973,6 +977,12 @@ void hookexternal(void (*funcptr) (void))
 	loopexternal = funcptr;
 }
 
+void hooktrace(void (*funcptr) (uint16_t, uint8_t, uint8_t, uint8_t, uint8_t,
+				uint8_t))
+{
+	traceexternal = funcptr;
+}
+
 uint16_t getPC(void)
 {
 	return (pc);
@@ -8,6 +8,8 @@ extern void irq6502(void);
 extern uint64_t exec6502(uint64_t tickcount);
 extern void step6502(void);
 extern void hookexternal(void (*loopexternal)(void));
+extern void hooktrace(void (*traceexternal)(uint16_t pc, uint8_t a, uint8_t x,
+				uint8_t y, uint8_t sp, uint8_t status));
 extern uint16_t getPC(void);
 extern uint64_t getclockticks(void);
 extern void waitstates(uint32_t n);
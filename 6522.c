@@ -7,6 +7,11 @@
 
 /*
  *	Minimal beginnings of 6522 VIA emulation
+ *
+ *	The timers are not stepped on each tick. We count the clocks we
+ *	have been given (clock) and bring the counters up to date (synced)
+ *	when they are looked at, or when we reach the point at which an
+ *	enabled timer interrupt would fire (deadline).
  */
 
 struct via6522 {
@@ -22,10 +27,13 @@ struct via6522 {
 	uint8_t irb;
 	uint8_t ddra;
 	uint8_t ddrb;
-	uint16_t t1;
+	uint32_t t1;		/* Can hold latch + 1 */
 	uint16_t t1l;
 	uint16_t t2;
 	uint8_t t2l;
+	uint64_t clock;
+	uint64_t synced;
+	uint64_t deadline;
 	/* Pin states rather than registers */
 	uint8_t ca;
 	uint8_t cb;
@@ -53,9 +61,32 @@ static void via_recalc_all(struct via6522 *via)
 	via_recalc_irq(via);
 }
 
-/* Perform time related processing for the VIA */
-void via_tick(struct via6522 *via, unsigned int clocks)
+/* Work out when the next timer interrupt that matters will occur. A
+   flag that is already set or masked can wait until someone looks */
+static void via_schedule(struct via6522 *via)
+{
+	uint8_t want = via->ier & ~via->ifr;
+	uint64_t d = UINT64_MAX;
+
+	if (via->t1 && (want & 0x40))
+		d = via->t1;
+	if (via->t2 && !(via->acr & 0x20) && (want & 0x20) && via->t2 < d)
+		d = via->t2;
+	if (d == UINT64_MAX)
+		via->deadline = UINT64_MAX;
+	else
+		via->deadline = via->synced + d;
+}
+
+/* Bring the timers up to date with the clocks we have been given */
+static void via_sync(struct via6522 *via)
 {
+	uint64_t clocks = via->clock - via->synced;
+
+	if (clocks == 0)
+		return;
+	via->synced = via->clock;
+
 	/* This isn't quite right but it's near enough for the moment */
 	if (via->t1) {
 		if (clocks >= via->t1) {
@@ -64,15 +95,17 @@ void via_tick(struct via6522 *via, unsigned int clocks)
 			via->ifr |= 0x40;
 			via_recalc_irq(via);
 			/* +1 or + 2 ?? */
-			if (via->acr & 0x40)
-				via->t1 = via->t1l + 1;
-			else
+			if (via->acr & 0x40) {
+				uint32_t period = via->t1l + 1;
+				via->t1 = period - (clocks - via->t1) % period;
+			} else
 				via->t1 = 0;
 		}
 		else
 			via->t1 -= clocks;
 	}
 
+	/* T2 interrupts once per write then stops */
 	if (via->t2 && !(via->acr & 0x20)) {
 		if (clocks >= via->t2) {
 			via->ifr |= 0x20;
@@ -80,14 +113,37 @@ void via_tick(struct via6522 *via, unsigned int clocks)
 			via->t2 = 0;
 			if (via->trace)
 				fprintf(stderr,"[VIA T2 expire.].\n");
-		}
-		via->t2 -= clocks;
+		} else
+			via->t2 -= clocks;
 	}
+	via_schedule(via);
+}
+
+/* Perform time related processing for the VIA */
+void via_tick(struct via6522 *via, unsigned int clocks)
+{
+	via->clock += clocks;
+	if (via->clock >= via->deadline)
+		via_sync(via);
+}
+
+/* Clocks until the next timer interrupt, or 0 if none is due */
+unsigned int via_next_event(struct via6522 *via)
+{
+	uint64_t n;
+
+	if (via->deadline == UINT64_MAX)
+		return 0;
+	n = via->deadline - via->clock;
+	if (n > UINT32_MAX)
+		return UINT32_MAX;
+	return n;
 }
 
 uint8_t via_read(struct via6522 *via, uint8_t addr)
 {
 	uint8_t r;
+	via_sync(via);
 	if (via->trace)
 		fprintf(stderr, "[VIA read %d: ", addr);
 	switch(addr) {
@@ -149,6 +205,7 @@ uint8_t via_read(struct via6522 *via, uint8_t addr)
 			r =  via->ira;
 			break;
 	}
+	via_schedule(via);
 	if (via->trace)
 		fprintf(stderr, "%02X.]\n", r);
 	return r;
@@ -156,6 +213,7 @@ uint8_t via_read(struct via6522 *via, uint8_t addr)
 
 void via_write(struct via6522 *via, uint8_t addr, uint8_t val)
 {
+	via_sync(via);
 	if (via->trace)
 		fprintf(stderr, "[VIA write %d: %02X.]\n", addr, val);
 	switch(addr) {
@@ -230,6 +288,7 @@ void via_write(struct via6522 *via, uint8_t addr, uint8_t val)
 			via->ora = val;
 			break;
 	}
+	via_schedule(via);
 }
 
 int via_irq_pending(struct via6522 *via)
@@ -255,6 +314,7 @@ struct via6522 *via_create(void)
         exit(1);
     }
     memset(v, 0, sizeof(struct via6522));
+    v->deadline = UINT64_MAX;
     return v;
 }
 
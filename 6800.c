@@ -725,6 +725,72 @@ static uint8_t clock_hc11[256][4] = {
     { 6, 6, 0, 0 }			/* STX / STY */
 };
 
+/*
+ *	Addressing mode by opcode (ignoring any 68HC11 prefix). This is what
+ *	has to be fetched after the opcode before we can execute it. The
+ *	16bit immediates follow the register size except that 8D is BSR
+ *	and 8F/CF are the meaningless store immediates (XGDX/XGDY on the
+ *	68HC11).
+ *
+ *	FIXME: 8D is weird, CD undefined - how does CD really work ?
+ */
+#define AM_INH		0	/* Nothing (or the instruction does it) */
+#define AM_BYTE		1	/* Immediate 8bit, direct or branch */
+#define AM_IMM16	2	/* Immediate 16bit */
+#define AM_IDX		3	/* Offset from X (or Y) */
+#define AM_EXT		4	/* Extended */
+
+static const uint8_t addr_mode[256] = {
+    /* 0x00 */
+    AM_INH, AM_INH, AM_INH, AM_INH, AM_INH, AM_INH, AM_INH, AM_INH,
+    AM_INH, AM_INH, AM_INH, AM_INH, AM_INH, AM_INH, AM_INH, AM_INH,
+    /* 0x10 */
+    AM_INH, AM_INH, AM_INH, AM_INH, AM_INH, AM_INH, AM_INH, AM_INH,
+    AM_INH, AM_INH, AM_INH, AM_INH, AM_INH, AM_INH, AM_INH, AM_INH,
+    /* 0x20 */
+    AM_BYTE, AM_BYTE, AM_BYTE, AM_BYTE, AM_BYTE, AM_BYTE, AM_BYTE, AM_BYTE,
+    AM_BYTE, AM_BYTE, AM_BYTE, AM_BYTE, AM_BYTE, AM_BYTE, AM_BYTE, AM_BYTE,
+    /* 0x30 */
+    AM_INH, AM_INH, AM_INH, AM_INH, AM_INH, AM_INH, AM_INH, AM_INH,
+    AM_INH, AM_INH, AM_INH, AM_INH, AM_INH, AM_INH, AM_INH, AM_INH,
+    /* 0x40 */
+    AM_INH, AM_INH, AM_INH, AM_INH, AM_INH, AM_INH, AM_INH, AM_INH,
+    AM_INH, AM_INH, AM_INH, AM_INH, AM_INH, AM_INH, AM_INH, AM_INH,
+    /* 0x50 */
+    AM_INH, AM_INH, AM_INH, AM_INH, AM_INH, AM_INH, AM_INH, AM_INH,
+    AM_INH, AM_INH, AM_INH, AM_INH, AM_INH, AM_INH, AM_INH, AM_INH,
+    /* 0x60 */
+    AM_IDX, AM_IDX, AM_IDX, AM_IDX, AM_IDX, AM_IDX, AM_IDX, AM_IDX,
+    AM_IDX, AM_IDX, AM_IDX, AM_IDX, AM_IDX, AM_IDX, AM_IDX, AM_IDX,
+    /* 0x70 */
+    AM_EXT, AM_EXT, AM_EXT, AM_EXT, AM_EXT, AM_EXT, AM_EXT, AM_EXT,
+    AM_EXT, AM_EXT, AM_EXT, AM_EXT, AM_EXT, AM_EXT, AM_EXT, AM_EXT,
+    /* 0x80 */
+    AM_BYTE, AM_BYTE, AM_BYTE, AM_IMM16, AM_BYTE, AM_BYTE, AM_BYTE, AM_BYTE,
+    AM_BYTE, AM_BYTE, AM_BYTE, AM_BYTE, AM_IMM16, AM_BYTE, AM_IMM16, AM_INH,
+    /* 0x90 */
+    AM_BYTE, AM_BYTE, AM_BYTE, AM_BYTE, AM_BYTE, AM_BYTE, AM_BYTE, AM_BYTE,
+    AM_BYTE, AM_BYTE, AM_BYTE, AM_BYTE, AM_BYTE, AM_BYTE, AM_BYTE, AM_BYTE,
+    /* 0xA0 */
+    AM_IDX, AM_IDX, AM_IDX, AM_IDX, AM_IDX, AM_IDX, AM_IDX, AM_IDX,
+    AM_IDX, AM_IDX, AM_IDX, AM_IDX, AM_IDX, AM_IDX, AM_IDX, AM_IDX,
+    /* 0xB0 */
+    AM_EXT, AM_EXT, AM_EXT, AM_EXT, AM_EXT, AM_EXT, AM_EXT, AM_EXT,
+    AM_EXT, AM_EXT, AM_EXT, AM_EXT, AM_EXT, AM_EXT, AM_EXT, AM_EXT,
+    /* 0xC0 */
+    AM_BYTE, AM_BYTE, AM_BYTE, AM_IMM16, AM_BYTE, AM_BYTE, AM_BYTE, AM_BYTE,
+    AM_BYTE, AM_BYTE, AM_BYTE, AM_BYTE, AM_IMM16, AM_IMM16, AM_IMM16, AM_INH,
+    /* 0xD0 */
+    AM_BYTE, AM_BYTE, AM_BYTE, AM_BYTE, AM_BYTE, AM_BYTE, AM_BYTE, AM_BYTE,
+    AM_BYTE, AM_BYTE, AM_BYTE, AM_BYTE, AM_BYTE, AM_BYTE, AM_BYTE, AM_BYTE,
+    /* 0xE0 */
+    AM_IDX, AM_IDX, AM_IDX, AM_IDX, AM_IDX, AM_IDX, AM_IDX, AM_IDX,
+    AM_IDX, AM_IDX, AM_IDX, AM_IDX, AM_IDX, AM_IDX, AM_IDX, AM_IDX,
+    /* 0xF0 */
+    AM_EXT, AM_EXT, AM_EXT, AM_EXT, AM_EXT, AM_EXT, AM_EXT, AM_EXT,
+    AM_EXT, AM_EXT, AM_EXT, AM_EXT, AM_EXT, AM_EXT, AM_EXT, AM_EXT
+};
+
 /*
  *	Debug and trace support
  */
@@ -1564,13 +1630,36 @@ static void m6800_disassemble(struct m6800 *cpu, uint16_t pc)
     fprintf(stderr, "\n");
 }
 
+/*
+ *	Memory access from the instruction stream. Pages the board or the
+ *	internal RAM/ROM windows map directly are accessed directly, the
+ *	rest go via m6800_do_read/write.
+ */
+
+static inline uint8_t m6800_rd(struct m6800 *cpu, uint16_t addr)
+{
+    const uint8_t *p = cpu->rd[addr >> 8];
+    if (p)
+        return p[addr & 0xFF];
+    return m6800_do_read(cpu, addr);
+}
+
+static inline void m6800_wr(struct m6800 *cpu, uint16_t addr, uint8_t val)
+{
+    uint8_t *p = cpu->wr[addr >> 8];
+    if (p)
+        p[addr & 0xFF] = val;
+    else
+        m6800_do_write(cpu, addr, val);
+}
+
 /*
  *	The 6803 stack operations
  */
 
 static void m6800_push(struct m6800 *cpu, uint8_t val)
 {
-    m6800_do_write(cpu, cpu->s--, val);
+    m6800_wr(cpu, cpu->s--, val);
 }
 
 static void m6800_push16(struct m6800 *cpu, uint16_t val)
@@ -1581,7 +1670,7 @@ static void m6800_push16(struct m6800 *cpu, uint16_t val)
 
 static uint8_t m6800_pull(struct m6800 *cpu)
 {
-    return m6800_do_read(cpu, ++cpu->s);
+    return m6800_rd(cpu, ++cpu->s);
 }
 
 static uint16_t m6800_pull16(struct m6800 *cpu)
@@ -1616,8 +1705,8 @@ static int m6800_vector(struct m6800 *cpu, uint16_t vector)
     }
     cpu->p |= P_I;
     /* What's the vector Victor ? */
-    cpu->pc = m6800_do_read(cpu, vector) << 8;
-    cpu->pc |= m6800_do_read(cpu, vector + 1);
+    cpu->pc = m6800_rd(cpu, vector) << 8;
+    cpu->pc |= m6800_rd(cpu, vector + 1);
     cpu->wait = 0;
     if (cpu->debug)
         fprintf(stderr, "*** Vector %04X\n", vector);
@@ -1833,7 +1922,7 @@ static void m6800_hcf(struct m6800 *cpu)
 static int m6800_execute_one(struct m6800 *cpu)
 {
     uint16_t fetch_pc = cpu->pc;
-    uint16_t opcode = m6800_do_read(cpu, cpu->pc);
+    uint16_t opcode = m6800_rd(cpu, cpu->pc);
     uint8_t data8, tmp8;
     uint16_t data16, tmp16;
     uint8_t tmpc, tmp2;
@@ -1865,35 +1954,23 @@ static int m6800_execute_one(struct m6800 *cpu)
                 break;
             }
             opcode <<= 8;
-            opcode |= m6800_do_read(cpu, cpu->pc);
+            opcode |= m6800_rd(cpu, cpu->pc);
             cpu->pc++;
             clocks++;
         }
     }
     /* Fetch address/data for non immediate opcodes */
-    switch(opcode & 0xF0) {
-        case 0x80:	/* Immediate 8/16bit */
-        case 0xC0:	/* Immediate 8/16bit */
-            /* FIXME: 8D is weird, CD undefined - how does CD really work ? */
-            if (opcode != 0x8D && ((opcode & 0x0F) >= 0x0C || (opcode & 0x0F) == 3)) {
-                /* The apparent store immediates (and 68HC11 XGDX) break the
-                   decode rule */
-                if ((opcode & 0xFF) != 0x8F && (opcode & 0xFF) != 0xCF) {
-                    data16 = m6800_do_read(cpu, cpu->pc++) << 8; 
-                    data16 |= m6800_do_read(cpu, cpu->pc++);
-                }
-                break;
-            }
-        case 0x20:	/* Branches */
-        case 0x90:	/* Direct */
-        case 0xD0:	/* Direct */
-            data8 = m6800_do_read(cpu, cpu->pc++);
+    switch(addr_mode[opcode & 0xFF]) {
+        case AM_IMM16:
+            data16 = m6800_rd(cpu, cpu->pc++) << 8;
+            data16 |= m6800_rd(cpu, cpu->pc++);
+            break;
+        case AM_BYTE:
+            data8 = m6800_rd(cpu, cpu->pc++);
             break;
-        case 0x60:	/* Indexed */
-        case 0xA0:	/* Indexed */
-        case 0xE0:	/* Indexed */
+        case AM_IDX:
             /* Save the first byte for the strange 6303 logic immediate ops */
-            data8 = m6800_do_read(cpu, cpu->pc++);
+            data8 = m6800_rd(cpu, cpu->pc++);
             data16 = data8 + cpu->x;
             /* 0x18: Use Y, index via Y
                0x1A: Use Y, index via X
@@ -1901,12 +1978,10 @@ static int m6800_execute_one(struct m6800 *cpu)
             if ((opcode & 0xFF00) == 0x1800 || (opcode & 0xFF00) == 0xCD00)
                 data16 = data8 + cpu->y;
             break;
-        case 0x70:	/* Extended */
-        case 0xB0:	/* Extended */
-        case 0xF0:	/* Extended */
+        case AM_EXT:
             /* Ordering ? */
-            data16 = m6800_do_read(cpu, cpu->pc++) << 8; 
-            data16 |= m6800_do_read(cpu, cpu->pc++);
+            data16 = m6800_rd(cpu, cpu->pc++) << 8;
+            data16 |= m6800_rd(cpu, cpu->pc++);
             break;
     }
     /* 68HC11 prefixed opcodes match the non prefix form plus the clock.
@@ -1923,7 +1998,7 @@ static int m6800_execute_one(struct m6800 *cpu)
         if (cpu->type == CPU_6303 || cpu->type == CPU_68HC11) {
             /* TRAP pushes the faulting address */
             fprintf(stderr, "illegal instruction %02X:%02X at %04X\n",
-                opcode, m6800_do_read(cpu, fetch_pc + 1), fetch_pc);
+                opcode, m6800_rd(cpu, fetch_pc + 1), fetch_pc);
             cpu->pc = fetch_pc;
             if (cpu->type == CPU_6303)
                 m6800_vector(cpu, 0xFFEE);
@@ -2078,12 +2153,12 @@ static int m6800_execute_one(struct m6800 *cpu)
             return clocks;
         }
         if (cpu->type == CPU_6XA1) {
-            cpu->x += m6800_do_read(cpu, cpu->s + 1);
+            cpu->x += m6800_rd(cpu, cpu->s + 1);
             return clocks;
         }
-        data8 = m6800_do_read(cpu, m6800_do_read(cpu, cpu->pc++));
-        if((data8 & m6800_do_read(cpu, cpu->pc++)) == data8)
-            m6800_bra(cpu, m6800_do_read(cpu, cpu->pc++), 1);
+        data8 = m6800_rd(cpu, m6800_rd(cpu, cpu->pc++));
+        if((data8 & m6800_rd(cpu, cpu->pc++)) == data8)
+            m6800_bra(cpu, m6800_rd(cpu, cpu->pc++), 1);
         else
             cpu->pc++;
         return clocks;
@@ -2094,12 +2169,12 @@ static int m6800_execute_one(struct m6800 *cpu)
             return clocks;
         }
         if (cpu->type == CPU_6XA1) {
-            cpu->x += m6800_do_read(cpu, cpu->s + 1);
+            cpu->x += m6800_rd(cpu, cpu->s + 1);
             return clocks;
         }
-        data8 = m6800_do_read(cpu, m6800_do_read(cpu, cpu->pc++));
-        if(!(data8 & m6800_do_read(cpu, cpu->pc++)))
-            m6800_bra(cpu, m6800_do_read(cpu, cpu->pc++), 1);
+        data8 = m6800_rd(cpu, m6800_rd(cpu, cpu->pc++));
+        if(!(data8 & m6800_rd(cpu, cpu->pc++)))
+            m6800_bra(cpu, m6800_rd(cpu, cpu->pc++), 1);
         else
             cpu->pc++;
         return clocks;
@@ -2117,16 +2192,16 @@ static int m6800_execute_one(struct m6800 *cpu)
                 cpu->b = m6800_maths8_noh(cpu, cpu->a, 0, cpu->a - 1);
             return clocks;
         }
-        data8 = m6800_do_read(cpu, cpu->pc++);
-        tmp8 = m6800_do_read(cpu, data8) | m6800_do_read(cpu, cpu->pc++);
+        data8 = m6800_rd(cpu, cpu->pc++);
+        tmp8 = m6800_rd(cpu, data8) | m6800_rd(cpu, cpu->pc++);
         m6800_logic8(cpu, tmp8);
-        m6800_do_write(cpu, data8, tmp8);
+        m6800_wr(cpu, data8, tmp8);
         return clocks;
     case 0x15:  /* BCLR direct */
-        data8 = m6800_do_read(cpu, cpu->pc++);
-        tmp8 = m6800_do_read(cpu, data8) & ~m6800_do_read(cpu, cpu->pc++);
+        data8 = m6800_rd(cpu, cpu->pc++);
+        tmp8 = m6800_rd(cpu, data8) & ~m6800_rd(cpu, cpu->pc++);
         m6800_logic8(cpu, tmp8);
-        m6800_do_write(cpu, data8, tmp8);
+        m6800_wr(cpu, data8, tmp8);
         return clocks;
     case 0x16:	/* TAB */
         cpu->b = cpu->a;
@@ -2206,37 +2281,37 @@ static int m6800_execute_one(struct m6800 *cpu)
         cpu->a = m6800_maths8(cpu, cpu->a, cpu->b, cpu->a + cpu->b);
         return clocks;
     case 0x181C:  /* BSET indexed,Y */
-        data16 = cpu->y + m6800_do_read(cpu, cpu->pc++);
-        tmp8 = m6800_do_read(cpu, cpu->pc++);
-        tmp8 = m6800_do_read(cpu, data16) | tmp8;
+        data16 = cpu->y + m6800_rd(cpu, cpu->pc++);
+        tmp8 = m6800_rd(cpu, cpu->pc++);
+        tmp8 = m6800_rd(cpu, data16) | tmp8;
         m6800_logic8(cpu, tmp8);
-        m6800_do_write(cpu, data16, tmp8);
+        m6800_wr(cpu, data16, tmp8);
         return clocks;
     case 0x1C:  /* BSET indexed */
-        data16 = cpu->x + m6800_do_read(cpu, cpu->pc++);
-        tmp8 = m6800_do_read(cpu, cpu->pc++);
-        tmp8 = m6800_do_read(cpu, data16) | tmp8;
+        data16 = cpu->x + m6800_rd(cpu, cpu->pc++);
+        tmp8 = m6800_rd(cpu, cpu->pc++);
+        tmp8 = m6800_rd(cpu, data16) | tmp8;
         m6800_logic8(cpu, tmp8);
-        m6800_do_write(cpu, data16, tmp8);
+        m6800_wr(cpu, data16, tmp8);
         return clocks;
     case 0x181D:  /* BCLR indexed,Y */
-        data16 = cpu->y + m6800_do_read(cpu, cpu->pc++);
-        tmp8 = m6800_do_read(cpu, cpu->pc++);
-        tmp8 = m6800_do_read(cpu, data16) & ~tmp8;
+        data16 = cpu->y + m6800_rd(cpu, cpu->pc++);
+        tmp8 = m6800_rd(cpu, cpu->pc++);
+        tmp8 = m6800_rd(cpu, data16) & ~tmp8;
         m6800_logic8(cpu, tmp8);
-        m6800_do_write(cpu, data16, tmp8);
+        m6800_wr(cpu, data16, tmp8);
         return clocks;
     case 0x1D:  /* BCLR indexed */
-        data16 = cpu->x + m6800_do_read(cpu, cpu->pc++);
-        tmp8 = m6800_do_read(cpu, cpu->pc++);
-        tmp8 = m6800_do_read(cpu, data16) & ~tmp8;
+        data16 = cpu->x + m6800_rd(cpu, cpu->pc++);
+        tmp8 = m6800_rd(cpu, cpu->pc++);
+        tmp8 = m6800_rd(cpu, data16) & ~tmp8;
         m6800_logic8(cpu, tmp8);
-        m6800_do_write(cpu, data16, tmp8);
+        m6800_wr(cpu, data16, tmp8);
         return clocks;
     case 0x181E:
-        data8 = m6800_do_read(cpu, cpu->y + m6800_do_read(cpu, cpu->pc++));
-        if((data8 & m6800_do_read(cpu, cpu->pc++)) == data8)
-            m6800_bra(cpu, m6800_do_read(cpu, cpu->pc++), 1);
+        data8 = m6800_rd(cpu, cpu->y + m6800_rd(cpu, cpu->pc++));
+        if((data8 & m6800_rd(cpu, cpu->pc++)) == data8)
+            m6800_bra(cpu, m6800_rd(cpu, cpu->pc++), 1);
         else
             cpu->pc++;
         return clocks;
@@ -2246,16 +2321,16 @@ static int m6800_execute_one(struct m6800 *cpu)
             m6800_logic8(cpu, cpu->b);
             return clocks;
         }
-        data8 = m6800_do_read(cpu, cpu->x + m6800_do_read(cpu, cpu->pc++));
-        if((data8 & m6800_do_read(cpu, cpu->pc++)) == data8)
-            m6800_bra(cpu, m6800_do_read(cpu, cpu->pc++), 1);
+        data8 = m6800_rd(cpu, cpu->x + m6800_rd(cpu, cpu->pc++));
+        if((data8 & m6800_rd(cpu, cpu->pc++)) == data8)
+            m6800_bra(cpu, m6800_rd(cpu, cpu->pc++), 1);
         else
             cpu->pc++;
         return clocks;
     case 0x181F:
-        data8 = m6800_do_read(cpu, cpu->y + m6800_do_read(cpu, cpu->pc++));
-        if((data8 & m6800_do_read(cpu, cpu->pc++)) == 0)
-            m6800_bra(cpu, m6800_do_read(cpu, cpu->pc++), 1);
+        data8 = m6800_rd(cpu, cpu->y + m6800_rd(cpu, cpu->pc++));
+        if((data8 & m6800_rd(cpu, cpu->pc++)) == 0)
+            m6800_bra(cpu, m6800_rd(cpu, cpu->pc++), 1);
         else
             cpu->pc++;
         return clocks;
@@ -2268,9 +2343,9 @@ static int m6800_execute_one(struct m6800 *cpu)
             cpu->p |= P_C;
             return clocks;
         }
-        data8 = m6800_do_read(cpu, cpu->x + m6800_do_read(cpu, cpu->pc++));
-        if((data8 & m6800_do_read(cpu, cpu->pc++)) == 0)
-            m6800_bra(cpu, m6800_do_read(cpu, cpu->pc++), 1);
+        data8 = m6800_rd(cpu, cpu->x + m6800_rd(cpu, cpu->pc++));
+        if((data8 & m6800_rd(cpu, cpu->pc++)) == 0)
+            m6800_bra(cpu, m6800_rd(cpu, cpu->pc++), 1);
         else
             cpu->pc++;
         return clocks;
@@ -2437,11 +2512,11 @@ static int m6800_execute_one(struct m6800 *cpu)
         m6800_push_interrupt(cpu);
         cpu->p |= P_I;
         if (cpu->type == CPU_68HC11) {
-            cpu->pc = m6800_do_read(cpu, 0xFFF7);
-            cpu->pc |= m6800_do_read(cpu, 0xFFF6) << 8;
+            cpu->pc = m6800_rd(cpu, 0xFFF7);
+            cpu->pc |= m6800_rd(cpu, 0xFFF6) << 8;
         } else {
-            cpu->pc = m6800_do_read(cpu, 0xFFFB);
-            cpu->pc |= m6800_do_read(cpu, 0xFFFA) << 8;
+            cpu->pc = m6800_rd(cpu, 0xFFFB);
+            cpu->pc |= m6800_rd(cpu, 0xFFFA) << 8;
         }
         return clocks;
     /* Implicit logic on A */
@@ -2595,172 +2670,172 @@ static int m6800_execute_one(struct m6800 *cpu)
     case 0x60:	/* NEG ,X */
     case 0x70:	/* NEG addr */
         /* FIXME: check flags on NEG */
-        tmp8 = m6800_do_read(cpu, data16);
-        m6800_do_write(cpu, data16, m6800_maths8_noh(cpu, 0, tmp8, -tmp8));
+        tmp8 = m6800_rd(cpu, data16);
+        m6800_wr(cpu, data16, m6800_maths8_noh(cpu, 0, tmp8, -tmp8));
         return clocks;
     case 0x61:	/* AIM direct (6303) and also BCLR */
         if (cpu->type == CPU_6803) {
             /* TST undoc alias */
-            tmp8 = m6800_do_read(cpu, data16);
+            tmp8 = m6800_rd(cpu, data16);
             m6800_logic8(cpu, tmp8);
             cpu->p &= ~P_C;
             return clocks;
         }
         /* These have strange encodings of the data */
-        data16 = cpu->x + m6800_do_read(cpu, cpu->pc++);
-        tmp8 = m6800_do_read(cpu, data16);
+        data16 = cpu->x + m6800_rd(cpu, cpu->pc++);
+        tmp8 = m6800_rd(cpu, data16);
         tmp8 &= data8;
-        m6800_do_write(cpu, data16 & 0xFF, tmp8);
+        m6800_wr(cpu, data16 & 0xFF, tmp8);
         m6800_logic8(cpu, tmp8);
         return clocks;
     case 0x71: /* AIM ,X (6303) and also BCLR */
         /* These have strange encodings of the data */
-        tmp8 = m6800_do_read(cpu, data16 & 0xFF);
+        tmp8 = m6800_rd(cpu, data16 & 0xFF);
         tmp8 &= data16 >> 8;
-        m6800_do_write(cpu, data16 & 0xFF, tmp8);
+        m6800_wr(cpu, data16 & 0xFF, tmp8);
         m6800_logic8(cpu, tmp8);
         return clocks;
     case 0x62:	/* OIM direct (6303) and also BSET */
         if (cpu->type == CPU_6803) {
             /* NEG x */
-            tmp8 = m6800_do_read(cpu, data16);
-            m6800_do_write(cpu, data16, m6800_maths8_noh(cpu, 0, tmp8, -tmp8 - CARRY));
+            tmp8 = m6800_rd(cpu, data16);
+            m6800_wr(cpu, data16, m6800_maths8_noh(cpu, 0, tmp8, -tmp8 - CARRY));
             return clocks;
         }
         /* These have strange encodings of the data */
-        data16 = cpu->x + m6800_do_read(cpu, cpu->pc++);
-        tmp8 = m6800_do_read(cpu, data16);
+        data16 = cpu->x + m6800_rd(cpu, cpu->pc++);
+        tmp8 = m6800_rd(cpu, data16);
         tmp8 |= data8;
-        m6800_do_write(cpu, data16 & 0xFF, tmp8);
+        m6800_wr(cpu, data16 & 0xFF, tmp8);
         m6800_logic8(cpu, tmp8);
         return clocks;
     case 0x72: /* OIM ,X (6303) and also BSET */
         if (cpu->type == CPU_6803) {
             /* NEG x */
-            tmp8 = m6800_do_read(cpu, data16);
-            m6800_do_write(cpu, data16, m6800_maths8_noh(cpu, 0, tmp8, -tmp8 - CARRY));
+            tmp8 = m6800_rd(cpu, data16);
+            m6800_wr(cpu, data16, m6800_maths8_noh(cpu, 0, tmp8, -tmp8 - CARRY));
             return clocks;
         }
         /* These have strange encodings of the data */
-        tmp8 = m6800_do_read(cpu, data16 & 0xFF);
+        tmp8 = m6800_rd(cpu, data16 & 0xFF);
         tmp8 |= data16 >> 8;
-        m6800_do_write(cpu, data16 & 0xFF, tmp8);
+        m6800_wr(cpu, data16 & 0xFF, tmp8);
         m6800_logic8(cpu, tmp8);
         return clocks;
     case 0x1863:/* COM ,Y */
     case 0x63:	/* COM ,X */
     case 0x73:	/* COM addr */
-        tmp8 = ~m6800_do_read(cpu, data16);
-        m6800_do_write(cpu, data16, tmp8);
+        tmp8 = ~m6800_rd(cpu, data16);
+        m6800_wr(cpu, data16, tmp8);
         m6800_logic8(cpu, tmp8);
         cpu->p |= P_C;
         return clocks;
     case 0x1864:/* LSR ,Y */
     case 0x64:	/* LSR ,X */
     case 0x74:	/* LSR addr */
-        tmp8 = m6800_do_read(cpu, data16);
+        tmp8 = m6800_rd(cpu, data16);
         tmpc = tmp8 & 0x01;
         tmp8 >>= 1;
-        m6800_do_write(cpu, data16, tmp8);
+        m6800_wr(cpu, data16, tmp8);
         m6800_shift8(cpu, tmp8, tmpc);
         return clocks;
     case 0x65:	/* EIM direct (6303) and also BTGL */
         if (cpu->type == CPU_6803) {
             /* Undoc aliases of LSR on 6803 */
-            tmp8 = m6800_do_read(cpu, data16);
+            tmp8 = m6800_rd(cpu, data16);
             tmpc = tmp8 & 0x01;
             tmp8 >>= 1;
-            m6800_do_write(cpu, data16, tmp8);
+            m6800_wr(cpu, data16, tmp8);
             m6800_shift8(cpu, tmp8, tmpc);
             return clocks;
         }
         /* These have strange encodings of the data */
-        data16 = cpu->x + m6800_do_read(cpu, cpu->pc++);
-        tmp8 = m6800_do_read(cpu, data16);
+        data16 = cpu->x + m6800_rd(cpu, cpu->pc++);
+        tmp8 = m6800_rd(cpu, data16);
         tmp8 ^= data8;
-        m6800_do_write(cpu, data16 & 0xFF, tmp8);
+        m6800_wr(cpu, data16 & 0xFF, tmp8);
         m6800_logic8(cpu, tmp8);
         return clocks;
     case 0x75: /* EIM ,X (6303) and also BTGL */
         if (cpu->type == CPU_6803) {
             /* Undoc aliases of LSR on 6803 */
-            tmp8 = m6800_do_read(cpu, data16);
+            tmp8 = m6800_rd(cpu, data16);
             tmpc = tmp8 & 0x01;
             tmp8 >>= 1;
-            m6800_do_write(cpu, data16, tmp8);
+            m6800_wr(cpu, data16, tmp8);
             m6800_shift8(cpu, tmp8, tmpc);
             return clocks;
         }
         /* These have strange encodings of the data */
-        tmp8 = m6800_do_read(cpu, data16 & 0xFF);
+        tmp8 = m6800_rd(cpu, data16 & 0xFF);
         tmp8 = data16 >> 8;
-        m6800_do_write(cpu, data16 & 0xFF, tmp8);
+        m6800_wr(cpu, data16 & 0xFF, tmp8);
         m6800_logic8(cpu, tmp8);
         return clocks;
     case 0x1866:/* ROR, Y */
     case 0x66:	/* ROR ,X */
     case 0x76:	/* ROR addr */
-        tmp8 = m6800_do_read(cpu, data16);
+        tmp8 = m6800_rd(cpu, data16);
         tmpc = tmp8 & 0x01;
         tmp8 >>= 1;
         if (CARRY)
             tmp8 |= 0x80;
         m6800_shift8(cpu, tmp8, tmpc);
-        m6800_do_write(cpu, data16, tmp8);
+        m6800_wr(cpu, data16, tmp8);
         return clocks;
     case 0x1867: /* ASR ,Y */
     case 0x67:	/* ASR ,X */
     case 0x77:	/* ASR addr */
-        tmp8 = m6800_do_read(cpu, data16);
+        tmp8 = m6800_rd(cpu, data16);
         tmpc = tmp8 & 0x01;
         if (tmp8 & 0x80)
             tmp8 = (tmp8 >> 1) | 0x80;
         else
             tmp8 >>= 1;
         m6800_shift8(cpu, tmp8, tmpc);
-        m6800_do_write(cpu, data16, tmp8);
+        m6800_wr(cpu, data16, tmp8);
         return clocks;
     case 0x1868: /* ASL ,Y */
     case 0x68:	/* ASL ,X */
     case 0x78:	/* ASL addr */
-        tmp16 = m6800_do_read(cpu, data16);
+        tmp16 = m6800_rd(cpu, data16);
         tmp16 <<= 1;
         m6800_shift8(cpu, tmp16 & 0xFF, tmp16 & 0x100);
-        m6800_do_write(cpu, data16, (uint8_t)tmp16);
+        m6800_wr(cpu, data16, (uint8_t)tmp16);
         return clocks;
     case 0x1869:/* ROL ,Y */
     case 0x69:	/* ROL ,X */
     case 0x79:	/* ROL addr */
-        tmp8 = m6800_do_read(cpu, data16);
+        tmp8 = m6800_rd(cpu, data16);
         tmpc = tmp8 & 0x80;
         tmp8 = (tmp8 << 1) | CARRY;
-        m6800_do_write(cpu, data16, tmp8);
+        m6800_wr(cpu, data16, tmp8);
         m6800_shift8(cpu, tmp8, tmpc);
         return clocks;
     case 0x186A:/* DEC ,Y */
     case 0x6A: 	/* DEC ,X */
     case 0x7A:	/* DEC addr */
         /* Weird as the don't affect C */
-        tmp8 = m6800_do_read(cpu, data16) - 1;
+        tmp8 = m6800_rd(cpu, data16) - 1;
         m6800_logic8(cpu, tmp8);
         if (tmp8 == 0x7F)	/* DEC from 0x80) */
             cpu->p |= P_V;
-        m6800_do_write(cpu, data16, tmp8);
+        m6800_wr(cpu, data16, tmp8);
         return clocks;
     case 0x6B:	/* BTST direct (6303) and TIM */
         if (cpu->type == CPU_6803) {
             /* Undoc aliases of DEC on 6803 */
             /* Weird as the don't affect C */
-            tmp8 = m6800_do_read(cpu, data16) - 1;
+            tmp8 = m6800_rd(cpu, data16) - 1;
             m6800_logic8(cpu, tmp8);
             if (tmp8 == 0x7F)	/* DEC from 0x80) */
                 cpu->p |= P_V;
-            m6800_do_write(cpu, data16, tmp8);
+            m6800_wr(cpu, data16, tmp8);
             return clocks;
         }
         /* These have strange encodings of the data */
-        data16 = cpu->x + m6800_do_read(cpu, cpu->pc++);
-        tmp8 = m6800_do_read(cpu, data16);
+        data16 = cpu->x + m6800_rd(cpu, cpu->pc++);
+        tmp8 = m6800_rd(cpu, data16);
         tmp8 &= data8;
         m6800_logic8(cpu, tmp8);
         return clocks;
@@ -2768,32 +2843,32 @@ static int m6800_execute_one(struct m6800 *cpu)
         if (cpu->type == CPU_6803) {
             /* Undoc aliases of DEC on 6803 */
             /* Weird as the don't affect C */
-            tmp8 = m6800_do_read(cpu, data16) - 1;
+            tmp8 = m6800_rd(cpu, data16) - 1;
             m6800_logic8(cpu, tmp8);
             if (tmp8 == 0x7F)	/* DEC from 0x80) */
                 cpu->p |= P_V;
-            m6800_do_write(cpu, data16, tmp8);
+            m6800_wr(cpu, data16, tmp8);
             return clocks;
         }
         /* These have strange encodings of the data */
-        tmp8 = m6800_do_read(cpu, data16 & 0xFF);
+        tmp8 = m6800_rd(cpu, data16 & 0xFF);
         tmp8 &= data16 >> 8;
         m6800_logic8(cpu, tmp8);
         return clocks;
     case 0x186C:/* INC ,Y */
     case 0x6C:	/* INC ,X */
     case 0x7C:	/* INC addr */
-        tmp8 = m6800_do_read(cpu, data16);
+        tmp8 = m6800_rd(cpu, data16);
         tmp8++;
         m6800_logic8(cpu, tmp8);
         if (tmp8 == 0x80)	/* INC from 0x7F) */
             cpu->p |= P_V;
-        m6800_do_write(cpu, data16, tmp8);
+        m6800_wr(cpu, data16, tmp8);
         return clocks;
     case 0x186D:
     case 0x6D:	/* TST ,X */
     case 0x7D:	/* TST addr */
-        tmp8 = m6800_do_read(cpu, data16);
+        tmp8 = m6800_rd(cpu, data16);
         m6800_logic8(cpu, tmp8);
         cpu->p &= ~P_C;
         return clocks;
@@ -2806,7 +2881,7 @@ static int m6800_execute_one(struct m6800 *cpu)
     case 0x186F:/* CLR ,Y */
     case 0x6F:	/* CLR ,X */
     case 0x7F:	/* CLR addr */
-        m6800_do_write(cpu, data16, 0);
+        m6800_wr(cpu, data16, 0);
         cpu->p &= ~(P_N|P_V|P_C);
         cpu->p |= P_Z;
         return clocks;
@@ -2842,7 +2917,7 @@ static int m6800_execute_one(struct m6800 *cpu)
         return clocks;
     case 0x87:	/* Undocumented: STAA immed */
         cpu->pc++;
-        m6800_do_write(cpu, cpu->pc++, cpu->a);
+        m6800_wr(cpu, cpu->pc++, cpu->a);
         return clocks;
     case 0x88:	/* EORA */
         cpu->a ^= data8;
@@ -2886,8 +2961,8 @@ static int m6800_execute_one(struct m6800 *cpu)
         if (cpu->type != CPU_68HC11) {
             /* On 6800 it's STS immed - undocumented */
             cpu->pc++;
-            m6800_do_write(cpu, cpu->pc++, cpu->s >> 8);
-            m6800_do_write(cpu, cpu->pc++, cpu->s);
+            m6800_wr(cpu, cpu->pc++, cpu->s >> 8);
+            m6800_wr(cpu, cpu->pc++, cpu->s);
         } else {
             tmp16 = cpu->x;
             cpu->x = (cpu->a << 8) | cpu->b;
@@ -2897,73 +2972,73 @@ static int m6800_execute_one(struct m6800 *cpu)
         return clocks;
     /* Same again for direct */
     case 0x90:	/* SUBA dir */
-        tmp8 = m6800_do_read(cpu, data8);
+        tmp8 = m6800_rd(cpu, data8);
         cpu->a = m6800_maths8_noh(cpu, cpu->a, tmp8, cpu->a - tmp8);
         return clocks;
     case 0x91:	/* CMPA dir */
-        tmp8 = m6800_do_read(cpu, data8);
+        tmp8 = m6800_rd(cpu, data8);
         m6800_maths8_noh(cpu, cpu->a, tmp8, cpu->a - tmp8);
         return clocks;
     case 0x92:	/* SBCA dir */
-        tmp8 = m6800_do_read(cpu, data8);
+        tmp8 = m6800_rd(cpu, data8);
         cpu->a = m6800_maths8_noh(cpu, cpu->a, tmp8, cpu->a - tmp8 - CARRY);
         return clocks;
     case 0x1A93: /* CPD dir */
-        tmp16 = m6800_do_read(cpu, data8) << 8;
-        tmp16 |= m6800_do_read(cpu, data8 + 1);
+        tmp16 = m6800_rd(cpu, data8) << 8;
+        tmp16 |= m6800_rd(cpu, data8 + 1);
         m6800_maths16_noh(cpu, REG_D, tmp16, REG_D - tmp16);
         return clocks;
     case 0x93:	/* SUBD dir */
-        tmp16 = m6800_do_read(cpu, data8) << 8;
-        tmp16 |= m6800_do_read(cpu, data8 + 1);
+        tmp16 = m6800_rd(cpu, data8) << 8;
+        tmp16 |= m6800_rd(cpu, data8 + 1);
         tmp16 = m6800_maths16_noh(cpu, REG_D, tmp16, REG_D - tmp16);
         cpu->a = tmp16 >> 8;
         cpu->b = tmp16;
         return clocks;
     case 0x94:	/* ANDA dir */
-        tmp8 = m6800_do_read(cpu, data8);
+        tmp8 = m6800_rd(cpu, data8);
         cpu->a &= tmp8;
         m6800_logic8(cpu, cpu->a);
         return clocks;
     case 0x95:	/* BITA */
-        tmp8 = m6800_do_read(cpu, data8);
+        tmp8 = m6800_rd(cpu, data8);
         m6800_logic8(cpu, cpu->a & tmp8);
         return clocks;
     case 0x96:	/* LDAA */
-        tmp8 = m6800_do_read(cpu, data8);
+        tmp8 = m6800_rd(cpu, data8);
         cpu->a = tmp8;
         m6800_logic8(cpu, cpu->a);
         return clocks;
     case 0x97:	/* STAA */
-        m6800_do_write(cpu, data8, cpu->a);
+        m6800_wr(cpu, data8, cpu->a);
         m6800_logic8(cpu, cpu->a);
         return clocks;
     case 0x98:	/* EORA */
-        tmp8 = m6800_do_read(cpu, data8);
+        tmp8 = m6800_rd(cpu, data8);
         cpu->a ^= tmp8;
         m6800_logic8(cpu, cpu->a);
         return clocks;
     case 0x99:	/* ADCA */
-        tmp8 = m6800_do_read(cpu, data8);
+        tmp8 = m6800_rd(cpu, data8);
         cpu->a = m6800_maths8(cpu, cpu->a, tmp8, cpu->a + tmp8 + CARRY);
         return clocks;
     case 0x9A:	/* ORAA */
-        tmp8 = m6800_do_read(cpu, data8);
+        tmp8 = m6800_rd(cpu, data8);
         cpu->a |= tmp8;
         m6800_logic8(cpu, cpu->a);
         return clocks;
     case 0x9B:	/* ADDA */
-        tmp8 = m6800_do_read(cpu, data8);
+        tmp8 = m6800_rd(cpu, data8);
         cpu->a = m6800_maths8(cpu, cpu->a, tmp8, cpu->a + tmp8);
         return clocks;
     case 0x189C:/* CPY */
-        tmp16 = m6800_do_read(cpu, data8) << 8;
-        tmp16 |= m6800_do_read(cpu, data8 + 1);
+        tmp16 = m6800_rd(cpu, data8) << 8;
+        tmp16 |= m6800_rd(cpu, data8 + 1);
         m6800_cpx(cpu, cpu->y, tmp16);
         return clocks;
     case 0x9C:	/* CPX */
-        tmp16 = m6800_do_read(cpu, data8) << 8;
-        tmp16 |= m6800_do_read(cpu, data8 + 1);
+        tmp16 = m6800_rd(cpu, data8) << 8;
+        tmp16 |= m6800_rd(cpu, data8 + 1);
         m6800_cpx(cpu, cpu->x, tmp16);
         return clocks;
     case 0x9D:	/* JSR */
@@ -2974,105 +3049,105 @@ static int m6800_execute_one(struct m6800 *cpu)
         /* No flags */
         return clocks;
     case 0x9E:	/* LDS */
-        tmp16 = m6800_do_read(cpu, data8) << 8;
-        tmp16 |= m6800_do_read(cpu, data8 + 1);
+        tmp16 = m6800_rd(cpu, data8) << 8;
+        tmp16 |= m6800_rd(cpu, data8 + 1);
         /* Weirdly LDS *does* affect flags */
         cpu->s = tmp16;
         m6800_logic16(cpu, cpu->s);
         return clocks;
     case 0x9F:	/* STS */
-        m6800_do_write(cpu, data8, cpu->s >> 8);
-        m6800_do_write(cpu, data8 + 1, cpu->s);	/* Do these wrap ?? */
+        m6800_wr(cpu, data8, cpu->s >> 8);
+        m6800_wr(cpu, data8 + 1, cpu->s);	/* Do these wrap ?? */
         m6800_logic16(cpu, cpu->s);
         return clocks;
     /* 0xAX: indexed version */
     case 0x18A0:
     case 0xA0:	/* SUBA indexed */
-        tmp8 = m6800_do_read(cpu, data16);
+        tmp8 = m6800_rd(cpu, data16);
         cpu->a = m6800_maths8_noh(cpu, cpu->a, tmp8, cpu->a - tmp8);
         return clocks;
     case 0x18A1:/* CMPA ,Y */
     case 0xA1:	/* CMPA indexed */
-        tmp8 = m6800_do_read(cpu, data16);
+        tmp8 = m6800_rd(cpu, data16);
         m6800_maths8_noh(cpu, cpu->a, tmp8, cpu->a - tmp8);
         return clocks;
     case 0x18A2:
     case 0xA2:	/* SBCA indexed */
-        tmp8 = m6800_do_read(cpu, data16);
+        tmp8 = m6800_rd(cpu, data16);
         cpu->a = m6800_maths8_noh(cpu, cpu->a, tmp8, cpu->a - tmp8 - CARRY);
         return clocks;
     case 0x1AA3: /* CPD indexed */
-        tmp16 = m6800_do_read(cpu, data16) << 8;
-        tmp16 |= m6800_do_read(cpu, data16 + 1);
+        tmp16 = m6800_rd(cpu, data16) << 8;
+        tmp16 |= m6800_rd(cpu, data16 + 1);
         m6800_maths16_noh(cpu, REG_D, tmp16, REG_D - tmp16);
         return clocks;
     case 0xCDA3: /* CPD indexed,Y */
-        tmp16 = m6800_do_read(cpu, data16) << 8;
-        tmp16 |= m6800_do_read(cpu, data16 + 1);
+        tmp16 = m6800_rd(cpu, data16) << 8;
+        tmp16 |= m6800_rd(cpu, data16 + 1);
         tmp16 = m6800_maths16_noh(cpu, REG_D, tmp16, REG_D - tmp16);
         return clocks;
     case 0x18A3:
     case 0xA3:	/* SUBD indexed */
-        tmp16 = m6800_do_read(cpu, data16) << 8;
-        tmp16 |= m6800_do_read(cpu, data16 + 1);
+        tmp16 = m6800_rd(cpu, data16) << 8;
+        tmp16 |= m6800_rd(cpu, data16 + 1);
         tmp16 = m6800_maths16_noh(cpu, REG_D, tmp16, REG_D - tmp16);
         cpu->a = tmp16 >> 8;
         cpu->b = tmp16;
         return clocks;
     case 0x18A4:/* ANDA index,Y */
     case 0xA4:	/* ANDA indexed */
-        tmp8 = m6800_do_read(cpu, data16);
+        tmp8 = m6800_rd(cpu, data16);
         cpu->a &= tmp8;
         m6800_logic8(cpu, cpu->a);
         return clocks;
     case 0x18A5:/* BITA */
     case 0xA5:	/* BITA */
-        tmp8 = m6800_do_read(cpu, data16);
+        tmp8 = m6800_rd(cpu, data16);
         m6800_logic8(cpu, cpu->a & tmp8);
         return clocks;
     case 0x18A6:
     case 0xA6:	/* LDAA */
-        tmp8 = m6800_do_read(cpu, data16);
+        tmp8 = m6800_rd(cpu, data16);
         cpu->a = tmp8;
         m6800_logic8(cpu, cpu->a);
         return clocks;
     case 0x18A7:
     case 0xA7:	/* STAA */
-        m6800_do_write(cpu, data16, cpu->a);
+        m6800_wr(cpu, data16, cpu->a);
         m6800_logic8(cpu, cpu->a);
         return clocks;
     case 0x18A8:
     case 0xA8:	/* EORA */
-        tmp8 = m6800_do_read(cpu, data16);
+        tmp8 = m6800_rd(cpu, data16);
         cpu->a ^= tmp8;
         m6800_logic8(cpu, cpu->a);
         return clocks;
     case 0x18A9:/* ABCA index,Y */
     case 0xA9:	/* ADCA */
-        tmp8 = m6800_do_read(cpu, data16);
+        tmp8 = m6800_rd(cpu, data16);
         cpu->a = m6800_maths8(cpu, cpu->a, tmp8, cpu->a + tmp8 + CARRY);
         return clocks;
     case 0x18AA: /* ORA ,Y */
     case 0xAA:	/* ORAA */
-        tmp8 = m6800_do_read(cpu, data16);
+        tmp8 = m6800_rd(cpu, data16);
         cpu->a |= tmp8;
         m6800_logic8(cpu, cpu->a);
         return clocks;
     case 0x18AB:/* ADDA index,Y */
     case 0xAB:	/* ADDA */
-        tmp8 = m6800_do_read(cpu, data16);
+        tmp8 = m6800_rd(cpu, data16);
         cpu->a = m6800_maths8(cpu, cpu->a, tmp8, cpu->a + tmp8);
         return clocks;
     case 0x1AAC:/* CPY ,X */
     case 0x18AC:/* CPY ,Y*/
-        tmp16 = m6800_do_read(cpu, data16) << 8;
-        tmp16 |= m6800_do_read(cpu, data16 + 1);
+        tmp16 = m6800_rd(cpu, data16) << 8;
+        tmp16 |= m6800_rd(cpu, data16 + 1);
         m6800_cpx(cpu, cpu->y, tmp16);
         return clocks;
     case 0xCDAC:/* CPX ,Y */
     case 0xAC:	/* CPX ,X*/
-        tmp16 = m6800_do_read(cpu, data16) << 8;
-        tmp16 |= m6800_do_read(cpu, data16 + 1);
+        tmp16 = m6800_rd(cpu, data16) << 8;
+        tmp16 |= m6800_rd(cpu, data16 + 1);
         m6800_cpx(cpu, cpu->x, tmp16);
         return clocks;
     case 0x18AD:/* JSR ,Y */
@@ -3083,87 +3158,87 @@ static int m6800_execute_one(struct m6800 *cpu)
         return clocks;
     case 0x18AE:
     case 0xAE:	/* LDS */
-        tmp16 = m6800_do_read(cpu, data16) << 8;
-        tmp16 |= m6800_do_read(cpu, data16 + 1);
+        tmp16 = m6800_rd(cpu, data16) << 8;
+        tmp16 |= m6800_rd(cpu, data16 + 1);
         /* Weirdly LDS *does* affect flags */
         cpu->s = tmp16;
         m6800_logic16(cpu, cpu->s);
         return clocks;
     case 0x18AF:
     case 0xAF:	/* STS */
-        m6800_do_write(cpu, data16, cpu->s >> 8);
-        m6800_do_write(cpu, data16 + 1, cpu->s);
+        m6800_wr(cpu, data16, cpu->s >> 8);
+        m6800_wr(cpu, data16 + 1, cpu->s);
         m6800_logic16(cpu, cpu->s);
         return clocks;
     /* 0xBX: extended */
     case 0xB0:	/* SUBA extended */
-        tmp8 = m6800_do_read(cpu, data16);
+        tmp8 = m6800_rd(cpu, data16);
         cpu->a = m6800_maths8_noh(cpu, cpu->a, tmp8, cpu->a - tmp8);
         return clocks;
     case 0xB1:	/* CMPA extended */
-        tmp8 = m6800_do_read(cpu, data16);
+        tmp8 = m6800_rd(cpu, data16);
         m6800_maths8_noh(cpu, cpu->a, tmp8, cpu->a - tmp8);
         return clocks;
     case 0xB2:	/* SBCA extended */
-        tmp8 = m6800_do_read(cpu, data16);
+        tmp8 = m6800_rd(cpu, data16);
         cpu->a = m6800_maths8_noh(cpu, cpu->a, tmp8, cpu->a - tmp8 - CARRY);
         return clocks;
     case 0x1AB3: /* CPD extended */
-        tmp16 = m6800_do_read(cpu, data16) << 8;
-        tmp16 |= m6800_do_read(cpu, data16 + 1);
+        tmp16 = m6800_rd(cpu, data16) << 8;
+        tmp16 |= m6800_rd(cpu, data16 + 1);
         m6800_maths16_noh(cpu, REG_D, tmp16, REG_D - tmp16);
         return clocks;
     case 0xB3:	/* SUBD extended */
-        tmp16 = m6800_do_read(cpu, data16) << 8;
-        tmp16 |= m6800_do_read(cpu, data16 + 1);
+        tmp16 = m6800_rd(cpu, data16) << 8;
+        tmp16 |= m6800_rd(cpu, data16 + 1);
         tmp16 = m6800_maths16_noh(cpu, REG_D, tmp16, REG_D - tmp16);
         cpu->a = tmp16 >> 8;
         cpu->b = tmp16;
         return clocks;
     case 0xB4:	/* ANDA extended */
-        tmp8 = m6800_do_read(cpu, data16);
+        tmp8 = m6800_rd(cpu, data16);
         cpu->a &= tmp8;
         m6800_logic8(cpu, cpu->a);
         return clocks;
     case 0xB5:	/* BITA */
-        tmp8 = m6800_do_read(cpu, data16);
+        tmp8 = m6800_rd(cpu, data16);
         m6800_logic8(cpu, cpu->a & tmp8);
         return clocks;
     case 0xB6:	/* LDAA */
-        tmp8 = m6800_do_read(cpu, data16);
+        tmp8 = m6800_rd(cpu, data16);
         cpu->a = tmp8;
         m6800_logic8(cpu, cpu->a);
         return clocks;
     case 0xB7:	/* STAA */
-        m6800_do_write(cpu, data16, cpu->a);
+        m6800_wr(cpu, data16, cpu->a);
         m6800_logic8(cpu, cpu->a);
         return clocks;
     case 0xB8:	/* EORA */
-        tmp8 = m6800_do_read(cpu, data16);
+        tmp8 = m6800_rd(cpu, data16);
         cpu->a ^= tmp8;
         m6800_logic8(cpu, cpu->a);
         return clocks;
     case 0xB9:	/* ADCA */
-        tmp8 = m6800_do_read(cpu, data16);
+        tmp8 = m6800_rd(cpu, data16);
         cpu->a = m6800_maths8(cpu, cpu->a, tmp8, cpu->a + tmp8 + CARRY);
         return clocks;
     case 0xBA:	/* ORAA */
-        tmp8 = m6800_do_read(cpu, data16);
+        tmp8 = m6800_rd(cpu, data16);
         cpu->a |= tmp8;
         m6800_logic8(cpu, cpu->a);
         return clocks;
     case 0xBB:	/* ADDA */
-        tmp8 = m6800_do_read(cpu, data16);
+        tmp8 = m6800_rd(cpu, data16);
         cpu->a = m6800_maths8(cpu, cpu->a, tmp8, cpu->a + tmp8);
         return clocks;
     case 0x18BC:/* CPY */
-        tmp16 = m6800_do_read(cpu, data16) << 8;
-        tmp16 |= m6800_do_read(cpu, data16 + 1);
+        tmp16 = m6800_rd(cpu, data16) << 8;
+        tmp16 |= m6800_rd(cpu, data16 + 1);
         m6800_cpx(cpu, cpu->y, tmp16);
         return clocks;
     case 0xBC:	/* CPX */
-        tmp16 = m6800_do_read(cpu, data16) << 8;
-        tmp16 |= m6800_do_read(cpu, data16 + 1);
+        tmp16 = m6800_rd(cpu, data16) << 8;
+        tmp16 |= m6800_rd(cpu, data16 + 1);
         m6800_cpx(cpu, cpu->x, tmp16);
         return clocks;
     case 0xBD:	/* JSR ext */
@@ -3172,14 +3247,14 @@ static int m6800_execute_one(struct m6800 *cpu)
         /* No flags */
         return clocks;
     case 0xBE: /* LDS */
-        tmp16 = m6800_do_read(cpu, data16) << 8;
-        tmp16 |= m6800_do_read(cpu, data16 + 1);
+        tmp16 = m6800_rd(cpu, data16) << 8;
+        tmp16 |= m6800_rd(cpu, data16 + 1);
         cpu->s = tmp16;
         m6800_logic16(cpu, cpu->s);
         return clocks;
     case 0xBF:	/* STS */
-        m6800_do_write(cpu, data16, cpu->s >> 8);
-        m6800_do_write(cpu, data16 + 1, cpu->s);
+        m6800_wr(cpu, data16, cpu->s >> 8);
+        m6800_wr(cpu, data16 + 1, cpu->s);
         m6800_logic16(cpu, cpu->s);
         return clocks;
     /* And then repeat for B instead of A and X instead of S, and ADDD not
@@ -3211,7 +3286,7 @@ static int m6800_execute_one(struct m6800 *cpu)
         return clocks;
     case 0xC7:	/* Undocumented: STAB immed */
         cpu->pc++;
-        m6800_do_write(cpu, cpu->pc++, cpu->a);
+        m6800_wr(cpu, cpu->pc++, cpu->a);
         return clocks;
     case 0xC8:	/* EORB */
         cpu->b ^= data8;
@@ -3249,286 +3324,286 @@ static int m6800_execute_one(struct m6800 *cpu)
         }
         /* Non 6800 this is the bizarre undocumented STX pc+2 */
         cpu->pc++;
-        m6800_do_write(cpu, cpu->pc++, cpu->x >> 8);
-        m6800_do_write(cpu, cpu->pc++, cpu->x);
+        m6800_wr(cpu, cpu->pc++, cpu->x >> 8);
+        m6800_wr(cpu, cpu->pc++, cpu->x);
         m6800_logic16(cpu, cpu->x);
         return clocks;
     /* Same again for direct */
     case 0xD0:	/* SUBB dir */
-        tmp8 = m6800_do_read(cpu, data8);
+        tmp8 = m6800_rd(cpu, data8);
         cpu->b = m6800_maths8_noh(cpu, cpu->b, tmp8, cpu->b - tmp8);
         return clocks;
     case 0xD1:	/* CMPB dir */
-        tmp8 = m6800_do_read(cpu, data8);
+        tmp8 = m6800_rd(cpu, data8);
         m6800_maths8_noh(cpu, cpu->b, tmp8, cpu->b - tmp8);
         return clocks;
     case 0xD2:	/* SBCB dir */
-        tmp8 = m6800_do_read(cpu, data8);
+        tmp8 = m6800_rd(cpu, data8);
         cpu->b = m6800_maths8_noh(cpu, cpu->b, tmp8, cpu->b - tmp8 - CARRY);
         return clocks;
     case 0xD3:	/* ADDD dir */
-        tmp16 = m6800_do_read(cpu, data8) << 8;
-        tmp16 |= m6800_do_read(cpu, data8 + 1);
+        tmp16 = m6800_rd(cpu, data8) << 8;
+        tmp16 |= m6800_rd(cpu, data8 + 1);
         tmp16 = m6800_maths16_add(cpu, REG_D, tmp16, REG_D + tmp16);
         cpu->a = tmp16 >> 8;
         cpu->b = tmp16;
         return clocks;
     case 0xD4:	/* ANDB dir */
-        tmp8 = m6800_do_read(cpu, data8);
+        tmp8 = m6800_rd(cpu, data8);
         cpu->b &= tmp8;
         m6800_logic8(cpu, cpu->b);
         return clocks;
     case 0xD5:	/* BITB */
-        tmp8 = m6800_do_read(cpu, data8);
+        tmp8 = m6800_rd(cpu, data8);
         m6800_logic8(cpu, cpu->b & tmp8);
         return clocks;
     case 0xD6:	/* LDAB */
-        tmp8 = m6800_do_read(cpu, data8);
+        tmp8 = m6800_rd(cpu, data8);
         cpu->b = tmp8;
         m6800_logic8(cpu, cpu->b);
         return clocks;
     case 0xD7:	/* STAB */
-        m6800_do_write(cpu, data8, cpu->b);
+        m6800_wr(cpu, data8, cpu->b);
         m6800_logic8(cpu, cpu->b);
         return clocks;
     case 0xD8:	/* EORB */
-        tmp8 = m6800_do_read(cpu, data8);
+        tmp8 = m6800_rd(cpu, data8);
         cpu->b ^= tmp8;
         m6800_logic8(cpu, cpu->b);
         return clocks;
     case 0xD9:	/* ADCB */
-        tmp8 = m6800_do_read(cpu, data8);
+        tmp8 = m6800_rd(cpu, data8);
         cpu->b = m6800_maths8(cpu, cpu->b, tmp8, cpu->b + tmp8 + CARRY);
         return clocks;
     case 0xDA:	/* ORAB */
-        tmp8 = m6800_do_read(cpu, data8);
+        tmp8 = m6800_rd(cpu, data8);
         cpu->b |= tmp8;
         m6800_logic8(cpu, cpu->b);
         return clocks;
     case 0xDB:	/* ADDB */
-        tmp8 = m6800_do_read(cpu, data8);
+        tmp8 = m6800_rd(cpu, data8);
         cpu->b = m6800_maths8(cpu, cpu->b, tmp8, cpu->b + tmp8);
         return clocks;
     case 0xDC:	/* LDD direct */
-        cpu->a = m6800_do_read(cpu, data8);
-        cpu->b = m6800_do_read(cpu, data8 + 1);
+        cpu->a = m6800_rd(cpu, data8);
+        cpu->b = m6800_rd(cpu, data8 + 1);
         m6800_logic16(cpu, REG_D);
         return clocks;
     case 0xDD:	/* STD direct */
         if (cpu->type == CPU_6800)
             m6800_hcf(cpu);
-        m6800_do_write(cpu, data8, cpu->a);
-        m6800_do_write(cpu, data8 + 1, cpu->b);
+        m6800_wr(cpu, data8, cpu->a);
+        m6800_wr(cpu, data8 + 1, cpu->b);
         m6800_logic16(cpu, REG_D);
         return clocks;
     case 0x18DE:/* LDY direct */
-        cpu->y = m6800_do_read(cpu, data8) << 8; 
-        cpu->y |= m6800_do_read(cpu, data8 + 1);
+        cpu->y = m6800_rd(cpu, data8) << 8; 
+        cpu->y |= m6800_rd(cpu, data8 + 1);
         m6800_logic16(cpu, cpu->y);
         return clocks;
     case 0xDE:	/* LDX direct */
-        cpu->x = m6800_do_read(cpu, data8) << 8; 
-        cpu->x |= m6800_do_read(cpu, data8 + 1);
+        cpu->x = m6800_rd(cpu, data8) << 8; 
+        cpu->x |= m6800_rd(cpu, data8 + 1);
         m6800_logic16(cpu, cpu->x);
         return clocks;
     case 0x18DF: /* STY direct */
-        m6800_do_write(cpu, data8, cpu->y >> 8);
-        m6800_do_write(cpu, data8 + 1, cpu->y);
+        m6800_wr(cpu, data8, cpu->y >> 8);
+        m6800_wr(cpu, data8 + 1, cpu->y);
         m6800_logic16(cpu, cpu->y);
         return clocks;
     case 0xDF: /* STX direct */
-        m6800_do_write(cpu, data8, cpu->x >> 8);
-        m6800_do_write(cpu, data8 + 1, cpu->x);
+        m6800_wr(cpu, data8, cpu->x >> 8);
+        m6800_wr(cpu, data8 + 1, cpu->x);
         m6800_logic16(cpu, cpu->x);
         return clocks;
     /* 0xEX: indexed version */
     case 0x18E0:
     case 0xE0:	/* SUBB indexed */
-        tmp8 = m6800_do_read(cpu, data16);
+        tmp8 = m6800_rd(cpu, data16);
         cpu->b = m6800_maths8_noh(cpu, cpu->b, tmp8, cpu->b - tmp8);
         return clocks;
     case 0x18E1:/* CMPB ,Y */
     case 0xE1:	/* CMPB indexed */
-        tmp8 = m6800_do_read(cpu, data16);
+        tmp8 = m6800_rd(cpu, data16);
         m6800_maths8_noh(cpu, cpu->b, tmp8, cpu->b - tmp8);
         return clocks;
     case 0x18E2:
     case 0xE2:	/* SBCB indexed */
-        tmp8 = m6800_do_read(cpu, data16);
+        tmp8 = m6800_rd(cpu, data16);
         cpu->b = m6800_maths8_noh(cpu, cpu->b, tmp8, cpu->b - tmp8 - CARRY);
         return clocks;
     case 0x18E3:/* ADDD index,Y */
     case 0xE3:	/* ADDD indexed */
-        tmp16 = m6800_do_read(cpu, data16) << 8;
-        tmp16 |= m6800_do_read(cpu, data16 + 1);
+        tmp16 = m6800_rd(cpu, data16) << 8;
+        tmp16 |= m6800_rd(cpu, data16 + 1);
         tmp16 = m6800_maths16_add(cpu, REG_D, tmp16, REG_D + tmp16);
         cpu->a = tmp16 >> 8;
         cpu->b = tmp16;
         return clocks;
     case 0x18E4:/* ANDB index,Y */
     case 0xE4:	/* ANDB indexed */
-        tmp8 = m6800_do_read(cpu, data16);
+        tmp8 = m6800_rd(cpu, data16);
         cpu->b &= tmp8;
         m6800_logic8(cpu, cpu->b);
         return clocks;
     case 0x18E5:/* BITB */
     case 0xE5:	/* BITB */
-        tmp8 = m6800_do_read(cpu, data16);
+        tmp8 = m6800_rd(cpu, data16);
         m6800_logic8(cpu, cpu->b & tmp8);
         return clocks;
     case 0x18E6:
     case 0xE6:	/* LDAB */
-        tmp8 = m6800_do_read(cpu, data16);
+        tmp8 = m6800_rd(cpu, data16);
         cpu->b = tmp8;
         m6800_logic8(cpu, cpu->b);
         return clocks;
     case 0x18E7:
     case 0xE7:	/* STAB */
-        m6800_do_write(cpu, data16, cpu->b);
+        m6800_wr(cpu, data16, cpu->b);
         m6800_logic8(cpu, cpu->b);
         return clocks;
     case 0x18E8:
     case 0xE8:	/* EORB */
-        tmp8 = m6800_do_read(cpu, data16);
+        tmp8 = m6800_rd(cpu, data16);
         cpu->b ^= tmp8;
         m6800_logic8(cpu, cpu->b);
         return clocks;
     case 0x18E9:/* ABCA index,Y */
     case 0xE9:	/* ADCB */
-        tmp8 = m6800_do_read(cpu, data16);
+        tmp8 = m6800_rd(cpu, data16);
         cpu->b = m6800_maths8(cpu, cpu->b, tmp8, cpu->b + tmp8 + CARRY);
         return clocks;
     case 0x18EA: /* ORAB index,Y */
     case 0xEA:	/* ORAB */
-        tmp8 = m6800_do_read(cpu, data16);
+        tmp8 = m6800_rd(cpu, data16);
         cpu->b |= tmp8;
         m6800_logic8(cpu, cpu->b);
         return clocks;
     case 0x18EB:/* ADDA index,Y */
     case 0xEB:	/* ADDB */
-        tmp8 = m6800_do_read(cpu, data16);
+        tmp8 = m6800_rd(cpu, data16);
         cpu->b = m6800_maths8(cpu, cpu->b, tmp8, cpu->b + tmp8);
         return clocks;
     case 0x18EC:
     case 0xEC:	/* LDD indexed */
-        cpu->a = m6800_do_read(cpu, data16);
-        cpu->b = m6800_do_read(cpu, data16 + 1);
+        cpu->a = m6800_rd(cpu, data16);
+        cpu->b = m6800_rd(cpu, data16 + 1);
         m6800_logic16(cpu, REG_D);
         return clocks;
     case 0x18ED:
     case 0xED:	/* STD indexed */
-        m6800_do_write(cpu, data16, cpu->a);
-        m6800_do_write(cpu, data16 + 1, cpu->b);
+        m6800_wr(cpu, data16, cpu->a);
+        m6800_wr(cpu, data16 + 1, cpu->b);
         m6800_logic16(cpu, REG_D);
         return clocks;
     case 0x18EE: /* LDY index,Y */
     case 0x1AEE: /* LDY index,X */
-        cpu->y = m6800_do_read(cpu, data16) << 8;
-        cpu->y |= m6800_do_read(cpu, data16 + 1);
+        cpu->y = m6800_rd(cpu, data16) << 8;
+        cpu->y |= m6800_rd(cpu, data16 + 1);
         m6800_logic16(cpu, cpu->y);
         return clocks;
     case 0xCDEE: /* LDX index,Y */
     case 0xEE:	/* LDX indexed */
-        cpu->x = m6800_do_read(cpu, data16) << 8;
-        cpu->x |= m6800_do_read(cpu, data16 + 1);
+        cpu->x = m6800_rd(cpu, data16) << 8;
+        cpu->x |= m6800_rd(cpu, data16 + 1);
         m6800_logic16(cpu, cpu->x);
         return clocks;
     case 0x1AEF:/* STY ,X */
     case 0x18EF:/* STY ,Y */
-        m6800_do_write(cpu, data16, cpu->y >> 8);
-        m6800_do_write(cpu, data16 + 1, cpu->y);
+        m6800_wr(cpu, data16, cpu->y >> 8);
+        m6800_wr(cpu, data16 + 1, cpu->y);
         m6800_logic16(cpu, cpu->y);
         return clocks;
     case 0xCDEF:/* STX index,Y */
     case 0xEF:	/* STX indexed */
-        m6800_do_write(cpu, data16, cpu->x >> 8);
-        m6800_do_write(cpu, data16 + 1, cpu->x);
+        m6800_wr(cpu, data16, cpu->x >> 8);
+        m6800_wr(cpu, data16 + 1, cpu->x);
         m6800_logic16(cpu, cpu->x);
         return clocks;
     /* 0xFX: extended */
     case 0xF0:	/* SUBB extended */
-        tmp8 = m6800_do_read(cpu, data16);
+        tmp8 = m6800_rd(cpu, data16);
         cpu->b = m6800_maths8_noh(cpu, cpu->b, tmp8, cpu->b - tmp8);
         return clocks;
     case 0xF1:	/* CMPB extended */
-        tmp8 = m6800_do_read(cpu, data16);
+        tmp8 = m6800_rd(cpu, data16);
         m6800_maths8_noh(cpu, cpu->b, tmp8, cpu->b - tmp8);
         return clocks;
     case 0xF2:	/* SBCB extended */
-        tmp8 = m6800_do_read(cpu, data16);
+        tmp8 = m6800_rd(cpu, data16);
         cpu->b = m6800_maths8_noh(cpu, cpu->b, tmp8, cpu->b - tmp8 - CARRY);
         return clocks;
     case 0xF3:	/* ADDD extended */
-        tmp16 = m6800_do_read(cpu, data16) << 8;
-        tmp16 |= m6800_do_read(cpu, data16 + 1);
+        tmp16 = m6800_rd(cpu, data16) << 8;
+        tmp16 |= m6800_rd(cpu, data16 + 1);
         tmp16 = m6800_maths16_add(cpu, REG_D, tmp16, REG_D + tmp16);
         cpu->a = tmp16 >> 8;
         cpu->b = tmp16;
         return clocks;
     case 0xF4:	/* ANDB extended */
-        tmp8 = m6800_do_read(cpu, data16);
+        tmp8 = m6800_rd(cpu, data16);
         cpu->b &= tmp8;
         m6800_logic8(cpu, cpu->b);
         return clocks;
     case 0xF5:	/* BITB */
-        tmp8 = m6800_do_read(cpu, data16);
+        tmp8 = m6800_rd(cpu, data16);
         m6800_logic8(cpu, cpu->b & tmp8);
         return clocks;
     case 0xF6:	/* LDAB */
-        tmp8 = m6800_do_read(cpu, data16);
+        tmp8 = m6800_rd(cpu, data16);
         cpu->b = tmp8;
         m6800_logic8(cpu, cpu->b);
         return clocks;
     case 0xF7:	/* STAB */
-        m6800_do_write(cpu, data16, cpu->b);
+        m6800_wr(cpu, data16, cpu->b);
         m6800_logic8(cpu, cpu->b);
         return clocks;
     case 0xF8:	/* EORB */
-        tmp8 = m6800_do_read(cpu, data16);
+        tmp8 = m6800_rd(cpu, data16);
         cpu->b ^= tmp8;
         m6800_logic8(cpu, cpu->b);
         return clocks;
     case 0xF9:	/* ADCB */
-        tmp8 = m6800_do_read(cpu, data16);
+        tmp8 = m6800_rd(cpu, data16);
         cpu->b = m6800_maths8(cpu, cpu->b, tmp8, cpu->b + tmp8 + CARRY);
         return clocks;
     case 0xFA:	/* ORAB */
-        tmp8 = m6800_do_read(cpu, data16);
+        tmp8 = m6800_rd(cpu, data16);
         cpu->b |= tmp8;
         m6800_logic8(cpu, cpu->b);
         return clocks;
     case 0xFB:	/* ADDB */
-        tmp8 = m6800_do_read(cpu, data16);
+        tmp8 = m6800_rd(cpu, data16);
         cpu->b = m6800_maths8(cpu, cpu->b, tmp8, cpu->b + tmp8);
         return clocks;
     case 0xFC:	/* LDD extended */
-        cpu->a = m6800_do_read(cpu, data16);
-        cpu->b = m6800_do_read(cpu, data16 + 1);
+        cpu->a = m6800_rd(cpu, data16);
+        cpu->b = m6800_rd(cpu, data16 + 1);
         m6800_logic16(cpu, REG_D);
         return clocks;
     case 0xFD:	/* STD extended */
-        m6800_do_write(cpu, data16, cpu->a);
-        m6800_do_write(cpu, data16 + 1, cpu->b);
+        m6800_wr(cpu, data16, cpu->a);
+        m6800_wr(cpu, data16 + 1, cpu->b);
         m6800_logic16(cpu, REG_D);
         return clocks;
     case 0x18FE:/* LDY extended */
-        cpu->y = m6800_do_read(cpu, data16) << 8;
-        cpu->y |= m6800_do_read(cpu, data16 + 1);
+        cpu->y = m6800_rd(cpu, data16) << 8;
+        cpu->y |= m6800_rd(cpu, data16 + 1);
         m6800_logic16(cpu, cpu->y);
         return clocks;
     case 0xFE:	/* LDX extended */
-        cpu->x = m6800_do_read(cpu, data16) << 8;
-        cpu->x |= m6800_do_read(cpu, data16 + 1);
+        cpu->x = m6800_rd(cpu, data16) << 8;
+        cpu->x |= m6800_rd(cpu, data16 + 1);
         m6800_logic16(cpu, cpu->x);
         return clocks;
     case 0x18FF:/* STY extened */
-        m6800_do_write(cpu, data16, cpu->y >> 8 );
-        m6800_do_write(cpu, data16 + 1, cpu->y);
+        m6800_wr(cpu, data16, cpu->y >> 8 );
+        m6800_wr(cpu, data16 + 1, cpu->y);
         m6800_logic16(cpu, cpu->y);
         return clocks;
     case 0xFF:	/* STX extened */
-        m6800_do_write(cpu, data16, cpu->x >> 8 );
-        m6800_do_write(cpu, data16 + 1, cpu->x);
+        m6800_wr(cpu, data16, cpu->x >> 8 );
+        m6800_wr(cpu, data16 + 1, cpu->x);
         m6800_logic16(cpu, cpu->x);
         return clocks;
     default:
@@ -3663,6 +3738,138 @@ int m6800_execute(struct m6800 *cpu)
     return cycles;
 }
 
+/*
+ *	Run instructions until at least cycles clocks have passed, and
+ *	return how many did.
+ */
+int m6800_run(struct m6800 *cpu, int cycles)
+{
+    int done = 0;
+
+    while (done < cycles)
+        done += m6800_execute(cpu);
+    return done;
+}
+
+/*
+ *	Work out what the CPU sees in each page. Anything internal that only
+ *	covers part of a page or has side effects leaves the page to the slow
+ *	path. This must be redone whenever the internal memory map changes.
+ */
+
+#ifdef WITH_HC11
+/* 0 - no overlap, 1 - partly covers the page, 2 - covers all of it */
+static int page_overlap(uint32_t addr, uint32_t base, uint32_t end)
+{
+    if (end < addr || base > addr + 0xFF)
+        return 0;
+    if (base <= addr && end >= addr + 0xFF)
+        return 2;
+    return 1;
+}
+
+static const uint8_t *m68hc11_rd_page(struct m6800 *cpu, unsigned page)
+{
+    uint32_t addr = page << 8;
+    int n;
+
+    if (page_overlap(addr, cpu->io.iobase, cpu->io.ioend))
+        return NULL;
+    n = page_overlap(addr, cpu->io.irambase, cpu->io.iramend);
+    if (n == 2)
+        return cpu->iram + addr - cpu->io.irambase;
+    if (n)
+        return NULL;
+    if (cpu->io.config_latch & CFG_EEON) {
+        n = page_overlap(addr, cpu->io.erombase, cpu->io.eromend);
+        if (n == 2 && cpu->io.eerom)
+            return cpu->io.eerom + addr - cpu->io.erombase;
+        if (n)
+            return NULL;
+    }
+    if (page == 0xBF && (cpu->io.hprio & HPRIO_RBOOT))
+        return cpu->io.bootrom;
+    if (cpu->io.config_latch & CFG_ROMON) {
+        n = page_overlap(addr, cpu->io.rombase, 0xFFFF);
+        if (n == 2 && cpu->io.rom)
+            return cpu->io.rom + addr - cpu->io.rombase;
+        if (n)
+            return NULL;
+    }
+    return cpu->ext_rd[page];
+}
+
+static uint8_t *m68hc11_wr_page(struct m6800 *cpu, unsigned page)
+{
+    uint32_t addr = page << 8;
+    int n;
+
+    /* Writes to the ROMs are ignored, let the slow path do that */
+    if ((cpu->io.config_latch & CFG_ROMON) &&
+        page_overlap(addr, cpu->io.rombase, 0xFFFF))
+        return NULL;
+    if ((cpu->io.config_latch & CFG_EEON) &&
+        page_overlap(addr, cpu->io.erombase, cpu->io.eromend))
+        return NULL;
+    if (page_overlap(addr, cpu->io.iobase, cpu->io.ioend))
+        return NULL;
+    n = page_overlap(addr, cpu->io.irambase, cpu->io.iramend);
+    if (n == 2)
+        return cpu->iram + addr - cpu->io.irambase;
+    if (n)
+        return NULL;
+    if (page == 0xBF && (cpu->io.hprio & HPRIO_RBOOT))
+        return NULL;
+    return cpu->ext_wr[page];
+}
+#endif
+
+static void m6800_remap_page(struct m6800 *cpu, unsigned page)
+{
+    switch (cpu->intio) {
+    case INTIO_6802:
+    case INTIO_6803:
+        /* Internal RAM and I/O live in page 0 */
+        if (page == 0) {
+            cpu->rd[0] = NULL;
+            cpu->wr[0] = NULL;
+            return;
+        }
+        /* Fall through */
+    case INTIO_NONE:
+    default:
+        cpu->rd[page] = cpu->ext_rd[page];
+        cpu->wr[page] = cpu->ext_wr[page];
+        break;
+#ifdef WITH_HC11
+    case INTIO_HC11:
+        cpu->rd[page] = m68hc11_rd_page(cpu, page);
+        cpu->wr[page] = m68hc11_wr_page(cpu, page);
+        break;
+#endif
+    }
+}
+
+static void m6800_remap(struct m6800 *cpu)
+{
+    unsigned i;
+
+    for (i = 0; i < 256; i++)
+        m6800_remap_page(cpu, i);
+}
+
+/*
+ *	Give the CPU direct access to a page of board memory. Writes to a
+ *	page with no wr pointer (ROM, I/O, trapped RAM) still go through
+ *	m6800_write. Call after the CPU reset as reset clears the map.
+ */
+void m6800_map_page(struct m6800 *cpu, unsigned page, const uint8_t *rd, uint8_t *wr)
+{
+    cpu->ext_rd[page] = rd;
+    cpu->ext_wr[page] = wr;
+    m6800_remap_page(cpu, page);
+}
+
 void m6800_reset(struct m6800 *cpu, int type, int io, int mode)
 {
     memset(cpu, 0, sizeof(*cpu));
@@ -3680,6 +3887,7 @@ void m6800_reset(struct m6800 *cpu, int type, int io, int mode)
     cpu->p2ddr = 0;
     cpu->p1ddr = 0;
     cpu->iram_base = 0x80;	/* We don't yet emulate X/Y1 CPUs */
+    m6800_remap(cpu);
     cpu->pc = m6800_do_read(cpu, 0xFFFE) << 8;
     cpu->pc |= m6800_do_read(cpu, 0xFFFF);
 }
@@ -3687,47 +3895,170 @@ void m6800_reset(struct m6800 *cpu, int type, int io, int mode)
 #ifdef WITH_HC11
 
 /*
- *	Model a 68HC11 E clock
+ *	Model the 68HC11 timer chain
  *
  *	See Figure 10-1 in the M68HC11 RM
+ *
+ *	Rather than clocking the chain every E cycle we keep a count of the
+ *	E clocks the timers have run for (eclock) and only bring the timer
+ *	state up to date when someone looks at it, or when we reach the next
+ *	point at which an enabled interrupt source could change (deadline).
+ *	The internal I/O accessors sync before touching anything so the guest
+ *	sees the same values as if we had stepped each clock.
  */
 
-static int prescaler(struct prescaler *p)
+/* E clocks until the prescaler produces another n output ticks */
+static uint64_t prescaler_ticks(struct prescaler *p, uint32_t n)
+{
+    return (uint64_t)n * p->limit - p->count;
+}
+
+/* Run a prescaler for n input clocks and return the output ticks */
+static uint64_t prescaler_run(struct prescaler *p, uint64_t n)
+{
+    n += p->count;
+    p->count = n % p->limit;
+    return n / p->limit;
+}
+
+/* Ticks of the free running counter until it next reads as v */
+static uint32_t m68hc11_tcnt_distance(struct m6800 *cpu, uint16_t v)
+{
+    uint16_t d = v - cpu->io.tcnt;
+    if (d == 0)
+        return 0x10000;
+    return d;
+}
+
+/* Turn the timer flags and masks into IRQ bits. Only called when
+   one of them changes */
+static void m68hc11_timer_ints(struct m6800 *cpu)
 {
-    if (p->count++ >= p->limit) {
-        p->count = 0;
-        return 1;
+    static const uint32_t irq1[8] = {
+        IRQ_IC3, IRQ_IC2, IRQ_IC1, IRQ_IC4OC5,
+        IRQ_OC4, IRQ_OC3, IRQ_OC2, IRQ_OC1
+    };
+    static const uint32_t irq2[8] = {
+        0, 0, 0, 0,
+        IRQ_PAI, IRQ_PAOV, IRQ_RTI, IRQ_TOF
+    };
+    uint8_t f1 = cpu->io.tflg1 & cpu->io.tmsk1;
+    uint8_t f2 = cpu->io.tflg2 & cpu->io.tmsk2;
+    uint32_t irq = 0;
+    unsigned int i;
+
+    for (i = 0; i < 8; i++) {
+        if (f1 & (1 << i))
+            irq |= irq1[i];
+        if (f2 & (1 << i))
+            irq |= irq2[i];
     }
-    return 0;
+    cpu->irq &= ~(IRQ_OC1|IRQ_OC2|IRQ_OC3|IRQ_OC4|IRQ_IC4OC5|IRQ_IC1|
+        IRQ_IC2|IRQ_IC3|IRQ_TOF|IRQ_RTI|IRQ_PAOV|IRQ_PAI);
+    cpu->irq |= irq;
 }
 
-static void m68hc11_e_clock(struct m6800 *cpu)
+/* Work out when something we need to act upon next happens */
+static void m68hc11_timer_schedule(struct m6800 *cpu)
 {
+    static const uint8_t ocf[5] = {
+        TF1_OC1F, TF1_OC2F, TF1_OC3F, TF1_OC4F, TF1_OC5F
+    };
+    uint16_t *toc = &cpu->io.toc1;
+    uint64_t d = UINT64_MAX;
+    uint64_t t;
+    unsigned int i;
+
+    if (cpu->io.spi_ticks)
+        d = cpu->io.spi_ticks;
+    /* Flags that are already set or masked can't change the IRQ state
+       so we can leave them until someone reads the registers */
+    if ((cpu->io.tmsk2 & ~cpu->io.tflg2) & TF2_RTIF) {
+        t = prescaler_ticks(&cpu->io.e13, 1) +
+            (uint64_t)(cpu->io.rti.limit - cpu->io.rti.count - 1) * cpu->io.e13.limit;
+        if (t < d)
+            d = t;
+    }
+    if ((cpu->io.tmsk2 & ~cpu->io.tflg2) & TF2_TOF) {
+        t = prescaler_ticks(&cpu->io.pr_tcnt, m68hc11_tcnt_distance(cpu, 0));
+        if (t < d)
+            d = t;
+    }
+    for (i = 0; i < 5; i++) {
+        if ((cpu->io.tmsk1 & ~cpu->io.tflg1) & ocf[i]) {
+            t = prescaler_ticks(&cpu->io.pr_tcnt, m68hc11_tcnt_distance(cpu, toc[i]));
+            if (t < d)
+                d = t;
+        }
+    }
+    if (d == UINT64_MAX)
+        cpu->io.deadline = UINT64_MAX;
+    else
+        cpu->io.deadline = cpu->io.synced + d;
+}
+
+/* A divider changed: if we are past the new limit tick on the next clock */
+static void prescaler_clamp(struct prescaler *p)
+{
+    if (p->count >= p->limit)
+        p->count = p->limit - 1;
+}
+
+/* Flags or masks changed */
+static void m68hc11_timer_update(struct m6800 *cpu)
+{
+    m68hc11_timer_ints(cpu);
+    m68hc11_timer_schedule(cpu);
+}
+
+/* Bring the timer chain up to date with eclock */
+static void m68hc11_timer_sync(struct m6800 *cpu)
+{
+    static const uint8_t ocf[5] = {
+        TF1_OC1F, TF1_OC2F, TF1_OC3F, TF1_OC4F, TF1_OC5F
+    };
+    uint16_t *toc = &cpu->io.toc1;
+    uint64_t n = cpu->io.eclock - cpu->io.synced;
+    uint64_t t;
+    uint8_t f1 = cpu->io.tflg1;
+    uint8_t f2 = cpu->io.tflg2;
+    unsigned int i;
+
+    if (n == 0)
+        return;
+    cpu->io.synced = cpu->io.eclock;
+
     /* Our emulation timer for an SPI transfer. This counts down E clocks
        between the start and end of an SPI transfer (master emulated only) */
     if (cpu->io.spi_ticks) {
-        if (!--cpu->io.spi_ticks) {
+        if (n >= cpu->io.spi_ticks) {
+            cpu->io.spi_ticks = 0;
             /* An SPI transfer completed: we don't emulate any double
                buffering */
             cpu->io.spdr_r = m68hc11_spi_done(cpu);
             cpu->io.spsr |= SPSR_SPIF;
             if (cpu->io.spcr & SPCR_SPIE)
                 m6800_raise_interrupt(cpu, IRQ_SPI);
-        }
+        } else
+            cpu->io.spi_ticks -= n;
     }
 
     /* 64 cycle lock */
-    if (cpu->io.lock)
-        cpu->io.lock--;
+    if (cpu->io.lock) {
+        if (n >= cpu->io.lock)
+            cpu->io.lock = 0;
+        else
+            cpu->io.lock -= n;
+    }
 
     /* A 2^13 divider feeds into the RTI and COP */
-    if (prescaler(&cpu->io.e13)) {
+    t = prescaler_run(&cpu->io.e13, n);
+    if (t) {
         /* 1 2 4 or 8 fom RTR[1:0] */
-        if (prescaler(&cpu->io.rti)) {
+        if (prescaler_run(&cpu->io.rti, t))
             cpu->io.tflg2 |= TF2_RTIF;
-        }
         /* Always by 4 then by 1/4/16/64 ccording to CR[1:0] */
-        if (prescaler(&cpu->io.cop)) {
+        if (prescaler_run(&cpu->io.cop, t)) {
             if (!(cpu->io.config_latch & CFG_NOCOP)) {
                 /* We took a COP reset */
                 /* TODO */
@@ -3736,79 +4067,25 @@ static void m68hc11_e_clock(struct m6800 *cpu)
     }
 
     /* The tcnt scaler affects all of the ic/oc side */
-    if (!prescaler(&cpu->io.pr_tcnt))
-        return;
-    /* Free running counter */
-    cpu->io.tcnt++;
-    if (cpu->io.tcnt == 0)
-        cpu->io.tflg2 |= TF2_TOF;
-    /* Comparators. Set the relevant flags, we will compute their effects
-       later on */
-    if (cpu->io.tcnt == cpu->io.toc1)
-        cpu->io.tflg1 |= TF1_OC1F;
-    if (cpu->io.tcnt == cpu->io.toc2)
-        cpu->io.tflg1 |= TF1_OC2F;
-    if (cpu->io.tcnt == cpu->io.toc3)
-        cpu->io.tflg1 |= TF1_OC3F;
-    if (cpu->io.tcnt == cpu->io.toc4)
-        cpu->io.tflg1 |= TF1_OC4F;
-    if (cpu->io.tcnt == cpu->io.toc5)
-        cpu->io.tflg1 |= TF1_OC5F;
-    /* We don't model input counts on IC1-IC3 but if we did it would go
-       here */
-
-    /* Turn compare flags into IRQ bits */
-    if ((cpu->io.tflg1 & cpu->io.tmsk1) & 0x80)
-        m6800_raise_interrupt(cpu, IRQ_OC1);
-    else
-        m6800_clear_interrupt(cpu, IRQ_OC1);
-    if ((cpu->io.tflg1 & cpu->io.tmsk1) & 0x40)
-        m6800_raise_interrupt(cpu, IRQ_OC2);
-    else
-        m6800_clear_interrupt(cpu, IRQ_OC2);
-    if ((cpu->io.tflg1 & cpu->io.tmsk1) & 0x20)
-        m6800_raise_interrupt(cpu, IRQ_OC3);
-    else
-        m6800_clear_interrupt(cpu, IRQ_OC3);
-    if ((cpu->io.tflg1 & cpu->io.tmsk1) & 0x10)
-        m6800_raise_interrupt(cpu, IRQ_OC4);
-    else
-        m6800_clear_interrupt(cpu, IRQ_OC4);
-    /* This one is special - its OC5 or IC4  */
-    if ((cpu->io.tflg1 & cpu->io.tmsk1) & 0x08)
-        m6800_raise_interrupt(cpu, IRQ_IC4OC5);
-    else
-        m6800_clear_interrupt(cpu, IRQ_IC4OC5);
-    if ((cpu->io.tflg1 & cpu->io.tmsk1) & 0x04)
-        m6800_raise_interrupt(cpu, IRQ_IC1);
-    else
-        m6800_clear_interrupt(cpu, IRQ_IC1);
-    if ((cpu->io.tflg1 & cpu->io.tmsk1) & 0x02)
-        m6800_raise_interrupt(cpu, IRQ_IC2);
-    else
-        m6800_clear_interrupt(cpu, IRQ_IC2);
-    if ((cpu->io.tflg1 & cpu->io.tmsk1) & 0x01)
-        m6800_raise_interrupt(cpu, IRQ_IC3);
-    else
-        m6800_clear_interrupt(cpu, IRQ_IC3);
-    if ((cpu->io.tflg2 & cpu->io.tmsk2) & 0x80)
-        m6800_raise_interrupt(cpu, IRQ_TOF);
-    else
-        m6800_clear_interrupt(cpu, IRQ_TOF);
-    if ((cpu->io.tflg2 & cpu->io.tmsk2) & 0x40)
-        m6800_raise_interrupt(cpu, IRQ_RTI);
-    else
-        m6800_clear_interrupt(cpu, IRQ_RTI);
-    if ((cpu->io.tflg2 & cpu->io.tmsk2) & 0x20)
-        m6800_raise_interrupt(cpu, IRQ_PAOV);
-    else
-        m6800_clear_interrupt(cpu, IRQ_PAOV);
-    if ((cpu->io.tflg2 & cpu->io.tmsk2) & 0x10)
-        m6800_raise_interrupt(cpu, IRQ_PAI);
-    else
-        m6800_clear_interrupt(cpu, IRQ_PAI);
-}
+    t = prescaler_run(&cpu->io.pr_tcnt, n);
+    if (t) {
+        /* Comparators. Set the relevant flag if the counter went past
+           the compare value during this period */
+        for (i = 0; i < 5; i++)
+            if (t >= m68hc11_tcnt_distance(cpu, toc[i]))
+                cpu->io.tflg1 |= ocf[i];
+        /* We don't model input counts on IC1-IC3 but if we did it would go
+           here */
+        /* Free running counter */
+        if (t >= m68hc11_tcnt_distance(cpu, 0))
+            cpu->io.tflg2 |= TF2_TOF;
+        cpu->io.tcnt += t;
+    }
 
+    if (cpu->io.tflg1 != f1 || cpu->io.tflg2 != f2)
+        m68hc11_timer_ints(cpu);
+    m68hc11_timer_schedule(cpu);
+}
 
 /*
  *	Execute a machine cycle and return how many clocks
@@ -3817,7 +4094,7 @@ static void m68hc11_e_clock(struct m6800 *cpu)
  
 int m68hc11_execute(struct m6800 *cpu)
 {
-    int cycles, i;
+    int cycles;
 
     /* Interrupts ? */
     cycles = m68hc11_pre_execute(cpu);
@@ -3832,13 +4109,23 @@ int m68hc11_execute(struct m6800 *cpu)
     if (cpu->wait && (cpu->p & P_I))
         return cycles;
 
-    /* Run the timers for these E cycles */
-    for (i = 0; i < cycles; i++)
-        m68hc11_e_clock(cpu);
-        
+    /* Account for these E cycles and only do the work if something
+       interesting happens in them */
+    cpu->io.eclock += cycles;
+    if (cpu->io.eclock >= cpu->io.deadline)
+        m68hc11_timer_sync(cpu);
     return cycles;
 }
 
+int m68hc11_run(struct m6800 *cpu, int cycles)
+{
+    int done = 0;
+
+    while (done < cycles)
+        done += m68hc11_execute(cpu);
+    return done;
+}
+
 void m68hc11e_reset(struct m6800 *cpu, int type, uint8_t cfg, const uint8_t *rom, uint8_t *eerom)
 {
     memset(cpu, 0, sizeof(*cpu));
@@ -3893,7 +4180,7 @@ void m68hc11e_reset(struct m6800 *cpu, int type, uint8_t cfg, const uint8_t *rom
     cpu->io.pr_tcnt.count = 0;
     cpu->io.pr_tcnt.limit = 1;	/* tmsk2 starts 0 so we start divide by 1 */
     cpu->io.e13.count = 0;
-    cpu->io.e13.limit = 16384;	/* 2^13 divider */
+    cpu->io.e13.limit = 8192;	/* 2^13 divider */
     cpu->io.rti.count = 0;
     cpu->io.rti.limit = 1;	/* pactl starts 0 so we start divide by 1 */
     cpu->io.cop.count = 0;
@@ -3910,15 +4197,18 @@ void m68hc11e_reset(struct m6800 *cpu, int type, uint8_t cfg, const uint8_t *rom
         cpu->io.erombase = 0xB600;
         cpu->io.eromend = 0xB7FF;
     case 0:	/* 68HC11E0, 512 bytes IRAM no ROM/EPROM/EEPROM */
-        cpu->io.iramend = cpu->io.iramsize = 512;
+        cpu->io.iramsize = 512;
+        cpu->io.iramend = 511;
         break;
 #if 0
     case 20:	/* 768 bytes RAM, 20K EPROM : not emulated yet */
-        cpu->io.iramend = cpu->io.iramsize = 768;
+        cpu->io.iramsize = 768;
+        cpu->io.iramend = 767;
         break;
 #endif
     case 2:	/* 256 bytes RAM, 2K EEPROM  68HC811E2 */
-        cpu->io.iramend = cpu->io.iramsize = 256;
+        cpu->io.iramsize = 256;
+        cpu->io.iramend = 255;
         /* The EEPROM location is configurable */
         cpu->io.erombase = 0x0800 + ((cfg & 0xF0) << 8);
         cpu->io.eromend = 0x0FFF + ((cfg & 0xF0) << 8);
@@ -3931,6 +4221,8 @@ void m68hc11e_reset(struct m6800 *cpu, int type, uint8_t cfg, const uint8_t *rom
 
     cpu->io.lock = 64;		/* Some stuff locks after 64 cycles */
 
+    m6800_remap(cpu);
+
     /* Must be last so the CPU config is correct for things like internal ROM */
     cpu->pc = m6800_do_read(cpu, 0xFFFE) << 8;
     cpu->pc |= m6800_do_read(cpu, 0xFFFF);
@@ -3992,7 +4284,7 @@ void m68hc11a_reset(struct m6800 *cpu, int type, uint8_t cfg, const uint8_t *rom
     cpu->io.pr_tcnt.count = 0;
     cpu->io.pr_tcnt.limit = 1;	/* tmsk2 starts 0 so we start divide by 1 */
     cpu->io.e13.count = 0;
-    cpu->io.e13.limit = 16384;	/* 2^13 divider */
+    cpu->io.e13.limit = 8192;	/* 2^13 divider */
     cpu->io.rti.count = 0;
     cpu->io.rti.limit = 1;	/* pactl starts 0 so we start divide by 1 */
     cpu->io.cop.count = 0;
@@ -4009,7 +4301,8 @@ void m68hc11a_reset(struct m6800 *cpu, int type, uint8_t cfg, const uint8_t *rom
         cpu->io.erombase = 0xB600;
         cpu->io.eromend = 0xB6FF;
     case 0:	/* 68HC11A0, 256 bytes IRAM no ROM/EPROM/EEPROM */
-        cpu->io.iramend = cpu->io.iramsize = 256;
+        cpu->io.iramsize = 256;
+        cpu->io.iramend = 255;
         break;
     default:
         fprintf(stderr, "Invalid 68HC11A variant.\n");
@@ -4018,6 +4311,8 @@ void m68hc11a_reset(struct m6800 *cpu, int type, uint8_t cfg, const uint8_t *rom
 
     cpu->io.lock = 64;		/* Some stuff locks after 64 cycles */
 
+    m6800_remap(cpu);
+
     /* Must be last so the CPU config is correct for things like internal ROM */
     cpu->pc = m6800_do_read(cpu, 0xFFFE) << 8;
     cpu->pc |= m6800_do_read(cpu, 0xFFFF);
@@ -4307,6 +4602,8 @@ static uint8_t m68hc11_read_io(struct m6800 *cpu, uint8_t addr)
     uint8_t val;
     uint8_t mask;
 
+    m68hc11_timer_sync(cpu);
+
     switch(addr) {
         case 0x00:	/* Port A */
             /* Port A bits 2, 1, 0 */
@@ -4345,7 +4642,7 @@ static uint8_t m68hc11_read_io(struct m6800 *cpu, uint8_t addr)
             return cpu->io.oc1m;
         case 0x0D:
             return cpu->io.oc1d;
-        /* Note: the fact we simulate tcnt by instruction not clock means
+        /* Note: the timers are only advanced between instructions so
            the LDD behaviour works for now */
         case 0x0E:
             return cpu->io.tcnt >> 8;
@@ -4460,6 +4757,9 @@ static uint8_t m68hc11_read_io(struct m6800 *cpu, uint8_t addr)
 static void m68hc11_write_io(struct m6800 *cpu, uint8_t addr, uint8_t val)
 {
     static const unsigned int cop_limit[4] = { 1, 4, 16, 64 };
+
+    m68hc11_timer_sync(cpu);
+
     switch(addr) {
         case 0x00:
             cpu->io.padr = val;
@@ -4515,43 +4815,53 @@ static void m68hc11_write_io(struct m6800 *cpu, uint8_t addr, uint8_t val)
             break;
         case 0x16:	/* Timer output compare */
             cpu->io.toc1 &= 0xFF;
-            cpu->io.toc1 |= val;
+            cpu->io.toc1 |= val << 8;
+            m68hc11_timer_schedule(cpu);
             break;
         case 0x17:
             cpu->io.toc1 &= 0xFF00;
             cpu->io.toc1 |= val;
+            m68hc11_timer_schedule(cpu);
             break;
         case 0x18:
             cpu->io.toc2 &= 0xFF;
             cpu->io.toc2 |= val << 8;
+            m68hc11_timer_schedule(cpu);
             break;
         case 0x19:
             cpu->io.toc2 &= 0xFF00;
             cpu->io.toc2 |= val;
+            m68hc11_timer_schedule(cpu);
             break;
         case 0x1A:
             cpu->io.toc3 &= 0xFF;
             cpu->io.toc3 |= val << 8;
+            m68hc11_timer_schedule(cpu);
             break;
         case 0x1B:
             cpu->io.toc3 &= 0xFF00;
             cpu->io.toc3 |= val;
+            m68hc11_timer_schedule(cpu);
             break;
         case 0x1C:
             cpu->io.toc4 &= 0xFF;
             cpu->io.toc4 |= val << 8;
+            m68hc11_timer_schedule(cpu);
             break;
         case 0x1D:
             cpu->io.toc4 &= 0xFF00;
             cpu->io.toc4 |= val;
+            m68hc11_timer_schedule(cpu);
             break;
         case 0x1E:
             cpu->io.toc5 &= 0xFF;
             cpu->io.toc5 |= val << 8;
+            m68hc11_timer_schedule(cpu);
             break;
         case 0x1F:
             cpu->io.toc5 &= 0xFF00;
             cpu->io.toc5 |= val;
+            m68hc11_timer_schedule(cpu);
             break;
         case 0x20:	/* tctl1/2 */
             cpu->io.tctl1 = val;
@@ -4562,10 +4872,12 @@ static void m68hc11_write_io(struct m6800 *cpu, uint8_t addr, uint8_t val)
             break;
         case 0x22:
             cpu->io.tmsk1 = val;
+            m68hc11_timer_update(cpu);
             break;
         case 0x23:
             /* Clear flags by writing a 1 bit to the bits to clear */
             cpu->io.tflg1 &= ~val;
+            m68hc11_timer_update(cpu);
             break;
         case 0x24:
             if (!cpu->io.lock && !(cpu->io.hprio & HPRIO_SMOD)) {
@@ -4588,15 +4900,20 @@ static void m68hc11_write_io(struct m6800 *cpu, uint8_t addr, uint8_t val)
                 cpu->io.pr_tcnt.limit = 16;
                 break;
             }
+            prescaler_clamp(&cpu->io.pr_tcnt);
+            m68hc11_timer_update(cpu);
             break;
         case 0x25:
             /* Clear flags by writing a 1 bit into the bit position */
             cpu->io.tflg2 &= ~(val & 0xF0);
+            m68hc11_timer_update(cpu);
             break;
         case 0x26:
             cpu->io.pactl = val;
             /* Adjust the rti scaling */
             cpu->io.rti.limit = 1 << (val & 3);
+            prescaler_clamp(&cpu->io.rti);
+            m68hc11_timer_schedule(cpu);
             break;
         case 0x27:
             cpu->io.pacnt = val;
@@ -4628,6 +4945,7 @@ static void m68hc11_write_io(struct m6800 *cpu, uint8_t addr, uint8_t val)
                 cpu->io.spi_ticks <<= 1;
             if (cpu->io.spcr & 2)	/* Divide by 8 */
                 cpu->io.spi_ticks <<= 3;
+            m68hc11_timer_schedule(cpu);
             break;
         case 0x2B:	/* Baud rate */
             cpu->io.baud = val;
@@ -4683,6 +5001,7 @@ static void m68hc11_write_io(struct m6800 *cpu, uint8_t addr, uint8_t val)
             }
             cpu->io.option = val & 0xFB;
             cpu->io.cop.limit = cop_limit[val & 3];
+            prescaler_clamp(&cpu->io.cop);
             break;
         case 0x3A:
             if (cpu->io.coprst == 0x55 && val == 0xAA)
@@ -4700,6 +5019,7 @@ static void m68hc11_write_io(struct m6800 *cpu, uint8_t addr, uint8_t val)
                 val |= cpu->io.hprio & HPRIO_MDA;
             }
             cpu->io.hprio = val;
+            m6800_remap(cpu);
             break;
         case 0x3D:
             if (!cpu->io.lock && !(cpu->io.hprio & HPRIO_SMOD))
@@ -4709,6 +5029,7 @@ static void m68hc11_write_io(struct m6800 *cpu, uint8_t addr, uint8_t val)
             cpu->io.ioend = cpu->io.iobase + 0x3F;
             cpu->io.irambase = (val & 0xF0U) << 8;
             cpu->io.iramend = cpu->io.irambase + cpu->io.iramsize - 1;
+            m6800_remap(cpu);
             break;
         case 0x3E:
             /* This is actually test1 if we ever care */
@@ -4725,6 +5046,7 @@ static void m68hc11_write_io(struct m6800 *cpu, uint8_t addr, uint8_t val)
                     cpu->io.erombase = 0x0800 + ((cpu->io.config & 0xF0) << 8);
                     cpu->io.eromend = 0x0FFF + ((cpu->io.config & 0xF0) << 8);
                 }
+                m6800_remap(cpu);
             }
             break;
     }
@@ -4758,7 +5080,7 @@ uint8_t m6800_do_read(struct m6800 *cpu, uint16_t addr)
         if (addr >= cpu->io.iobase && addr <= cpu->io.ioend)
             return m68hc11_read_io(cpu, addr);
         if (addr >= cpu->io.irambase && addr <= cpu->io.iramend)
-            return cpu->iram[addr];
+            return cpu->iram[addr - cpu->io.irambase];
         if (addr >= cpu->io.erombase && addr <= cpu->io.eromend &&
                 (cpu->io.config_latch & CFG_EEON))
             return cpu->io.eerom[addr - cpu->io.erombase];
@@ -4804,7 +5126,7 @@ void m6800_do_write(struct m6800 *cpu, uint16_t addr, uint8_t val)
         if (addr >= cpu->io.iobase && addr <= cpu->io.ioend)
             m68hc11_write_io(cpu, addr, val);
         else if (addr >= cpu->io.irambase && addr <= cpu->io.iramend)
-            cpu->iram[addr] = val;
+            cpu->iram[addr - cpu->io.irambase] = val;
         else if (addr >= 0xBF00 && addr <= 0xBFFF && (cpu->io.hprio & HPRIO_RBOOT))
             return;
         else
@@ -4838,7 +5160,7 @@ uint8_t m6800_do_debug_read(struct m6800 *cpu, uint16_t addr)
         if (addr >= cpu->io.iobase && addr <= cpu->io.ioend)
             return 0xff;
         if (addr >= cpu->io.irambase && addr <= cpu->io.iramend)
-            return cpu->iram[addr];
+            return cpu->iram[addr - cpu->io.irambase];
         if (addr >= cpu->io.erombase && addr <= cpu->io.eromend &&
                 (cpu->io.config_latch & CFG_EEON))
             return cpu->io.eerom[addr - cpu->io.erombase];
@@ -13,6 +13,9 @@ struct  m68hc11 {
     struct prescaler e13;
     struct prescaler rti;
     struct prescaler cop;
+    uint64_t eclock;		/* E clocks the timers have run */
+    uint64_t synced;		/* eclock the timer state reflects */
+    uint64_t deadline;		/* eclock of the next event we care about */
 
     uint16_t lock;
     uint16_t flags;
@@ -220,6 +223,14 @@ struct m6800 {
 
     struct m68hc11 io;		/* Need to make this a nice union of CPU
                                    variants eventually */
+
+    /* Host memory for each 256 byte page, or NULL to use the callbacks.
+       ext_ is what the board gave us, rd/wr have the internal RAM, I/O
+       and ROM windows laid over it and are what the CPU uses */
+    const uint8_t *ext_rd[256];
+    uint8_t *ext_wr[256];
+    const uint8_t *rd[256];
+    uint8_t *wr[256];
 };
 
 #define P_C		1
@@ -295,6 +306,9 @@ extern void m68hc11a_reset(struct m6800 *cpu, int variant, uint8_t cfg, const ui
 extern void m68hc11e_reset(struct m6800 *cpu, int variant, uint8_t cfg, const uint8_t *rom, uint8_t *eerom);
 extern int m6800_execute(struct m6800 *cpu);
 extern int m68hc11_execute(struct m6800 *cpu);
+extern int m6800_run(struct m6800 *cpu, int cycles);
+extern int m68hc11_run(struct m6800 *cpu, int cycles);
+extern void m6800_map_page(struct m6800 *cpu, unsigned page, const uint8_t *rd, uint8_t *wr);
 extern void m6800_clear_interrupt(struct m6800 *cpu, int irq);
 extern void m6800_raise_interrupt(struct m6800 *cpu, int irq);
 extern void m6800_rx_byte(struct m6800 *cpu, uint8_t byte);
@@ -11,13 +11,17 @@
  *	Fairly minimal model for now. We just emulate mode 0 1x - bit I/O without
  *	extra buffering.
  *
- *	TODO: interrupts on timer.
+ *	The timer is only brought up to date when it is looked at or when it
+ *	reaches zero, so ticking it is cheap however often the board does it.
  */
 
 
 struct m68230 {
     uint8_t reg[32];
     uint8_t pre;
+    uint64_t clock;
+    uint64_t synced;
+    uint64_t deadline;
     unsigned trace;
 };
 
@@ -43,14 +47,76 @@ struct m68230 {
 #define CNTR(x)	(23 + (x))
 #define TSR	26
 
+static uint32_t m68230_get24(struct m68230 *pit, unsigned r)
+{
+    return (pit->reg[r] << 16) | (pit->reg[r + 1] << 8) | pit->reg[r + 2];
+}
+
+static void m68230_put24(struct m68230 *pit, unsigned r, uint32_t v)
+{
+    pit->reg[r] = v >> 16;
+    pit->reg[r + 1] = v >> 8;
+    pit->reg[r + 2] = v;
+}
+
+/* Enabled and counting CLK through the prescaler. The TIN modes are not
+   modelled */
+static unsigned m68230_timer_on(struct m68230 *pit)
+{
+    return (pit->reg[TCR] & 0x07) == 0x01;
+}
+
+static void m68230_schedule(struct m68230 *pit)
+{
+    uint64_t n;
+
+    /* Nothing new can happen until the status is cleared */
+    if (!m68230_timer_on(pit) || pit->reg[TSR]) {
+        pit->deadline = UINT64_MAX;
+        return;
+    }
+    /* Zero detect is on the count after the counter reaches 0 */
+    n = (uint64_t)m68230_get24(pit, CNTR(0)) + 1;
+    pit->deadline = pit->synced + (n << 5) - pit->pre;
+}
+
+static void m68230_sync(struct m68230 *pit)
+{
+    uint64_t n = pit->clock - pit->synced;
+    uint32_t cnt, cpr;
+
+    if (n == 0)
+        return;
+    pit->synced = pit->clock;
+    if (!m68230_timer_on(pit))
+        return;
+    /* CLK and prescaler are used */
+    n += pit->pre;
+    pit->pre = n & 0x1F;
+    n >>= 5;
+
+    cnt = m68230_get24(pit, CNTR(0));
+    if (n > cnt) {
+        /* Zero detect, reload from the preload registers */
+        n -= cnt + 1;
+        pit->reg[TSR] = 1;
+        cpr = m68230_get24(pit, CPR(0));
+        cnt = cpr - n % ((uint64_t)cpr + 1);
+    } else
+        cnt -= n;
+    m68230_put24(pit, CNTR(0), cnt);
+    m68230_schedule(pit);
+}
+
 void m68230_write(struct m68230 *pit, unsigned addr, uint8_t val)
 {
     addr &= 0x1F;
 
+    m68230_sync(pit);
     if (pit->trace)
         fprintf(stderr, "pit: W %02X <- %02X\n", addr, val);
     /* CNTR is not writeable, and we keep the working value in here (or will do) */
-    if (addr >= CNTR(0) && addr <= CNTR(3))
+    if (addr >= CNTR(0) && addr <= CNTR(2))
         return;
 
     if (addr == PGCR) {
@@ -78,11 +144,13 @@ void m68230_write(struct m68230 *pit, unsigned addr, uint8_t val)
     if (addr == TSR)
         val = 0;
     pit->reg[addr] = val;
+    m68230_schedule(pit);
 }
 
 uint8_t m68230_read(struct m68230 *pit, unsigned addr)
 {
     addr &= 0x1F;
+    m68230_sync(pit);
     /* Sample the I/O lines. We just emulate mode 0 sub 1 for now */
     if (addr == PADR || addr == PBDR) {
         uint8_t r = m68230_read_port(pit, addr - PADR);
@@ -115,59 +183,32 @@ uint8_t m68230_read(struct m68230 *pit, unsigned addr)
     return pit->reg[addr];
 }
 
-static void m68230_tick_once(struct m68230 *pit)
-{
-    /* We assume this will be called a lot for small values or we could optimize a lot */
-    if (pit->reg[CNTR(2)] == 0x00) {
-        if(pit->reg[CNTR(1)] == 0x00) {
-            if (pit->reg[CNTR(0)] == 0x00) {
-                pit->reg[TSR] = 1;
-                pit->reg[CNTR(0)] = pit->reg[CPR(0)];
-                pit->reg[CNTR(1)] = pit->reg[CPR(1)];
-                pit->reg[CNTR(2)] = pit->reg[CPR(2)];
-                return;
-            }
-            pit->reg[CNTR(0)]--;
-        } 
-        pit->reg[CNTR(1)]--;
-    }
-    pit->reg[CNTR(2)]--;
+void m68230_tick(struct m68230 *pit, unsigned cycles)
+{
+    pit->clock += cycles;
+    if (pit->clock >= pit->deadline)
+        m68230_sync(pit);
 }
 
-void m68230_tick(struct m68230 *pit, unsigned cycles)
+/* Cycles until the timer next interrupts, 0 if it will not */
+unsigned m68230_next_event(struct m68230 *pit)
 {
-    if ((pit->reg[TCR] & 1) == 0)
-        return;
-    switch(pit->reg[TCR & 0x06]) {
-    case 0:
-        /* CLK and prescaler are used */
-        cycles += pit->pre;
-        pit->pre = cycles & 0x1F;
-        cycles >>= 5;
-        while(cycles) {
-            pit->pre++;
-            if (pit->pre == 0x20) {
-                pit->pre = 0;
-                m68230_tick_once(pit);
-            }
-        }
-        return;
-    case 2:
-        /* CLK and prescalar are used, PC2/TIN determines on off state - not modelled */
-        return;
-    case 4:
-        /* PC2/TIN is timer and prescaled, not modelled */
-        return;
-    case 6:
-        /* PC2/TIN is timer - not modelled */
-        return;
-    }
+    uint64_t n;
+
+    if (pit->deadline == UINT64_MAX)
+        return 0;
+    n = pit->deadline - pit->clock;
+    if (n > UINT32_MAX)
+        return UINT32_MAX;
+    return n;
 }
-    
+
 void m68230_reset(struct m68230 *pit)
 {
+     m68230_sync(pit);
      pit->reg[PIVR] = 0x0F;
      pit->reg[TIVR] = 0x0F;
+     m68230_schedule(pit);
 }
 
 struct m68230 *m68230_create(void)
@@ -178,6 +219,7 @@ struct m68230 *m68230_create(void)
         exit(1);
     }
     memset(pit, 0, sizeof(*pit));
+    pit->deadline = UINT64_MAX;
     m68230_reset(pit);
     return pit;
 }
@@ -3,6 +3,7 @@ struct m68230;
 extern void m68230_write(struct m68230 *pit, unsigned addr, uint8_t val);
 extern uint8_t m68230_read(struct m68230 *pit, unsigned addr);
 extern void m68230_tick(struct m68230 *pit, unsigned cycles);
+extern unsigned m68230_next_event(struct m68230 *pit);
 extern void m68230_reset(struct m68230 *pit);
 extern struct m68230 *m68230_create(void);
 extern void m68230_free(struct m68230 *m);
@@ -7,6 +7,14 @@
 
 /*
  *	Motorola 6840 PTM
+ *
+ *	The counters are advanced by whole runs of clocks rather than one
+ *	clock at a time. For the internally clocked timers we just count
+ *	the E clocks we are given (clock) and catch the timers up (synced)
+ *	when the registers are accessed or when we reach the next point an
+ *	enabled interrupt or output pin could change (deadline). If an
+ *	output is enabled the run is split at each output change so that
+ *	the board sees every edge.
  */
 
 struct ptm_timer {
@@ -28,6 +36,10 @@ struct m6840 {
     
     unsigned int trace;
     unsigned int lastout;
+
+    uint64_t clock;
+    uint64_t synced;
+    uint64_t deadline;
 };
 
 static void m6840_calc_irq(struct m6840 *ptm)
@@ -81,121 +93,278 @@ static void m6840_calc_outputs(struct m6840 *ptm)
     }
 }
 
-/* Count a timer in 16 or 8x8 bit mode */
-static void m6840_timer_count(struct ptm_timer *p, int restart)
+/* Is the timer in a mode where it counts */
+static int m6840_counting(struct ptm_timer *p)
+{
+    switch((p->ctrl >> 3) & 7) {
+        case 0:	/* Continuous */
+        case 2:	/* Continuous - not reset by write to latches */
+        case 4:	/* One shot, reset by write to latches */
+        case 6:	/* One shot, reset by gate/reset only */
+            return 1;
+        /* Frequency and pulse width compare are not supported yet */
+    }
+    return 0;
+}
+
+/* The one shot modes do not reload from the latches */
+static int m6840_restart(struct ptm_timer *p)
+{
+    return !(p->ctrl & 0x20);
+}
+
+/*
+ *	In 8x8 mode the low byte counts down to zero and reloads from the
+ *	latch each time the high byte is decremented. This is the number
+ *	of clocks until both are zero.
+ */
+static uint32_t m6840_dual_left(struct ptm_timer *p)
+{
+    return (p->timer & 0xFF) + (p->timer >> 8) * ((p->wlatch & 0xFF) + 1);
+}
+
+/* And back again, valid once the low byte has reloaded at least once */
+static uint16_t m6840_dual_value(struct ptm_timer *p, uint32_t left)
+{
+    uint32_t l = (p->wlatch & 0xFF) + 1;
+    return ((left / l) << 8) | (left % l);
+}
+
+/* Clocks until the timer next counts through zero */
+static uint32_t m6840_timer_event(struct ptm_timer *p)
 {
+    if (!(p->ctrl & 0x04))
+        return p->timer + 1;
+    return m6840_dual_left(p) + 1;
+}
+
+/* Clocks until the output pin next changes, 0 if it won't */
+static uint32_t m6840_timer_output(struct ptm_timer *p)
+{
+    /* In 16 bit mode the output toggles each time through zero */
+    if (!(p->ctrl & 0x04))
+        return p->timer + 1;
+    /* In 8x8 mode it goes high as the high byte reaches zero and low
+       again if the reload puts a non zero high byte back */
+    if ((p->timer & 0xFF00) && p->output)
+        return 1;
+    if (p->timer & 0xFF00)
+        return (p->timer & 0xFF) + ((p->timer >> 8) - 1) * ((p->wlatch & 0xFF) + 1) + 1;
+    if (!p->output)
+        return 1;
+    if (m6840_restart(p) && (p->wlatch & 0xFF00))
+        return m6840_dual_left(p) + 1;
+    return 0;
+}
+
+/* Count a timer in 16 or 8x8 bit mode for n clocks */
+static void m6840_timer_count(struct ptm_timer *p, uint32_t n)
+{
+    int restart = m6840_restart(p);
+    uint32_t left, period;
+
+    if (n == 0)
+        return;
     if (!(p->ctrl & 0x04)) {
-        /* The check occurs before the count down */
-        if (p->timer == 0) {
-            p->event = 1;
-            p->output ^= 1;
-            if (p->event && restart)
-                p->timer = p->wlatch;
-        }
-        p->timer--;
-    } else {
-        if ((p->timer & 0xFF) != 0)
-            p->timer--;
-        else {
-            p->timer &= 0xFF00;
-            if (p->timer) {
-                p->timer -= 0x0100;
-                p->timer |= p->wlatch & 0xFF;
-            } else {
-                p->event = 1;
-                if (restart)
-                    p->timer = p->wlatch;
-            }
+        /* The check for zero occurs before the count down */
+        if (n <= p->timer) {
+            p->timer -= n;
+            return;
         }
-        if ((p->timer & 0xFF00) == 0)
-            p->output = 1;
+        n -= p->timer + 1;
+        period = restart ? p->wlatch + 1 : 0x10000;
+        /* One event for reaching zero then one per whole period */
+        if (((n / period) & 1) == 0)
+            p->output ^= 1;
+        p->event = 1;
+        n %= period;
+        p->timer = period - 1 - n;
+        return;
+    }
+    left = m6840_dual_left(p);
+    if (n <= left) {
+        if (n <= (p->timer & 0xFF))
+            p->timer -= n;
         else
-            p->output = 0;
+            p->timer = m6840_dual_value(p, left - n);
+    } else {
+        p->event = 1;
+        if (restart) {
+            n -= left + 1;
+            period = (uint32_t)((p->wlatch >> 8) + 1) * ((p->wlatch & 0xFF) + 1);
+            p->timer = m6840_dual_value(p, period - 1 - n % period);
+        } else
+            p->timer = 0;
+    }
+    if ((p->timer & 0xFF00) == 0)
+        p->output = 1;
+    else
+        p->output = 0;
+}
+
+/* Clocks until something we need to act upon happens to this timer */
+static uint32_t m6840_timer_next(struct m6840 *ptm, unsigned int n)
+{
+    struct ptm_timer *p = &ptm->timer[n];
+    uint32_t d = 0;
+    uint32_t t;
+
+    if (!m6840_counting(p))
+        return 0;
+    /* A flag already set can't change the IRQ */
+    if ((p->ctrl & 0x40) && !(ptm->sr & (1 << (n - 1))))
+        d = m6840_timer_event(p);
+    if (p->ctrl & 0x80) {
+        t = m6840_timer_output(p);
+        if (t && (d == 0 || t < d))
+            d = t;
     }
-    if (p->event && restart)
-        p->timer = p->wlatch;
+    return d;
 }
 
 /*
- *	Handle a timer being clocked by something
+ *	Run a set of timers for n clocks. If any of them has its output
+ *	enabled we stop at each change so the board sees every edge.
  */
-static void m6840_timer_clock(struct ptm_timer *p)
+static void m6840_run(struct m6840 *ptm, unsigned int mask, uint64_t n)
 {
-    switch((p->ctrl >> 3) & 7) {
-        case 0:	/* Continuous */
-            m6840_timer_count(p, 1);
-            break;
-        case 1:	/* Frequency compare (not supported yet) */
-            break;
-        case 2:	/* Continuous - not reset by write to latches */
-            m6840_timer_count(p, 1);
-            break;
-        case 3:	/* Pulse width compare (not supported yet) */
-            break;
-        case 4:	/* One shot, reset by write to latches */
-            m6840_timer_count(p, 0);
-            break;
-        case 5:	/* Frequency comparison (not supported yet) */
-            break;
-        case 6:	/* One shot, reset by gate/reset only */
-            m6840_timer_count(p, 0);
-        case 7:	/* Pulse width compare (not supported yet) */
-            break;
+    unsigned int i;
+    uint64_t step;
+    uint32_t t;
+
+    while (n) {
+        step = n;
+        for (i = 1; i <= 3; i++) {
+            if (!(mask & (1 << i)) || !(ptm->timer[i].ctrl & 0x80))
+                continue;
+            if (!m6840_counting(&ptm->timer[i]))
+                continue;
+            t = m6840_timer_output(&ptm->timer[i]);
+            if (t && t < step)
+                step = t;
+        }
+        if (step > 0x10000000)
+            step = 0x10000000;
+        for (i = 1; i <= 3; i++)
+            if ((mask & (1 << i)) && m6840_counting(&ptm->timer[i]))
+                m6840_timer_count(&ptm->timer[i], step);
+        n -= step;
+        m6840_calc_irq(ptm);
+        m6840_calc_outputs(ptm);
     }
 }
 
-/* Perform an event tick on a timer */
-static void m6840_event_tick(struct ptm_timer *p)
+/* Timers running from the E clock */
+static unsigned int m6840_internal(struct m6840 *ptm)
 {
-    /* Internal clock ? */
-    if (p->ctrl & 2)
-        return;
-    m6840_timer_clock(p);
+    unsigned int mask = 0;
+    unsigned int i;
+    for (i = 1; i <= 3; i++)
+        if (ptm->timer[i].ctrl & 2)
+            mask |= 1 << i;
+    return mask;
+}
+
+static void m6840_schedule(struct m6840 *ptm)
+{
+    unsigned int mask = m6840_internal(ptm);
+    uint32_t d = 0;
+    uint32_t t;
+    unsigned int i;
+
+    for (i = 1; i <= 3; i++) {
+        if (!(mask & (1 << i)))
+            continue;
+        t = m6840_timer_next(ptm, i);
+        if (t && (d == 0 || t < d))
+            d = t;
+    }
+    if (d == 0)
+        ptm->deadline = UINT64_MAX;
+    else
+        ptm->deadline = ptm->synced + d;
 }
 
-/* Perform internal tick on a timer */
-static void m6840_timer_tick(struct ptm_timer *p)
+/* Bring the internally clocked timers up to date */
+static void m6840_sync(struct m6840 *ptm)
 {
-    /* External clock */
-    if (!(p->ctrl & 2))
+    uint64_t n = ptm->clock - ptm->synced;
+    if (n == 0)
         return;
-    m6840_timer_clock(p);
+    ptm->synced = ptm->clock;
+    m6840_run(ptm, m6840_internal(ptm), n);
+    m6840_schedule(ptm);
 }
 
 /* Runs for every E clock */
 void m6840_tick(struct m6840 *ptm, int tstates)
 {
-    while(tstates--) {
-        m6840_timer_tick(&ptm->timer[1]);
-        m6840_timer_tick(&ptm->timer[2]);
-        m6840_timer_tick(&ptm->timer[3]);
-    }
-    m6840_calc_irq(ptm);
-    m6840_calc_outputs(ptm);
+    ptm->clock += tstates;
+    if (ptm->clock >= ptm->deadline)
+        m6840_sync(ptm);
 }
 
-/* External clock event */
-void m6840_external_clock(struct m6840 *ptm, int timer)
+/* E clocks until a timer interrupt or output change, 0 if none due */
+unsigned int m6840_next_event(struct m6840 *ptm)
 {
+    uint64_t n;
+
+    if (ptm->deadline == UINT64_MAX)
+        return 0;
+    n = ptm->deadline - ptm->clock;
+    if (n > UINT32_MAX)
+        return UINT32_MAX;
+    return n;
+}
+
+/* External clock events */
+void m6840_external_clocks(struct m6840 *ptm, int timer, unsigned int n)
+{
+    uint32_t t;
+
+    m6840_sync(ptm);
     /* Timer 3 has an external pre-scaler option */
     if (timer == 3 && (ptm->timer[3].ctrl & 0x01)) {
-        ptm->prescale++;
-        ptm->prescale &= 7;
-        if (ptm->prescale)
-            return;
+        t = ptm->prescale + n;
+        ptm->prescale = t & 7;
+        n = t >> 3;
     }
-    m6840_event_tick(&ptm->timer[timer]);
-    m6840_calc_irq(ptm);
-    m6840_calc_outputs(ptm);
+    /* Internal clock ? */
+    if (ptm->timer[timer].ctrl & 2)
+        return;
+    m6840_run(ptm, 1 << timer, n);
+    m6840_schedule(ptm);
+}
+
+void m6840_external_clock(struct m6840 *ptm, int timer)
+{
+    m6840_external_clocks(ptm, timer, 1);
+}
+
+/* External clocks until the timer next needs attention, 0 if never */
+unsigned int m6840_next_clock(struct m6840 *ptm, int timer)
+{
+    uint32_t t;
+
+    m6840_sync(ptm);
+    /* Internal clock ? */
+    if (ptm->timer[timer].ctrl & 2)
+        return 0;
+    t = m6840_timer_next(ptm, timer);
+    if (t && timer == 3 && (ptm->timer[3].ctrl & 0x01))
+        t = t * 8 - ptm->prescale;
+    return t;
 }
 
 /* High to low transition on gate */    
 void m6840_external_gate(struct m6840 *ptm, int gate)
 {
+    m6840_sync(ptm);
     if (ptm->timer[gate].ctrl & 8) {
         ptm->timer[gate].timer = ptm->timer[gate].wlatch;
         /* IRQ clear ? */
     }
+    m6840_schedule(ptm);
 }
 
 static void m6840_soft_reset(struct m6840 *ptm)
@@ -210,11 +379,14 @@ static void m6840_soft_reset(struct m6840 *ptm)
 
 void m6840_reset(struct m6840 *ptm)
 {
+    m6840_sync(ptm);
     ptm->timer[0].wlatch = 0xFFFF;
     ptm->timer[1].wlatch = 0xFFFF;
     ptm->timer[2].wlatch = 0xFFFF;
     m6840_soft_reset(ptm);
     ptm->lastout = 0x100;	/* Impossible value to force update */
+    m6840_calc_outputs(ptm);
+    m6840_schedule(ptm);
 }
 
 uint8_t m6840_read(struct m6840 *ptm, uint8_t addr)
@@ -223,6 +395,7 @@ uint8_t m6840_read(struct m6840 *ptm, uint8_t addr)
     addr &= 7;
     if (addr == 0)
         return 0xFF;		/* Probably tri-stated */
+    m6840_sync(ptm);
     if (addr == 1) {
         if (ptm->trace)
             fprintf(stderr, "[PTM]: Read status register %02X\n", ptm->sr);
@@ -235,6 +408,7 @@ uint8_t m6840_read(struct m6840 *ptm, uint8_t addr)
     ptm->lsb = p->timer;
     ptm->sr &= ~(1 << (addr - 1));	/* And clear the interrupt */
     m6840_calc_irq(ptm);
+    m6840_schedule(ptm);
     if (ptm->trace)
         fprintf(stderr, "[PTM] Read timer %d IRQ now %02X\n", addr, ptm->sr);
     return p->timer >> 8;
@@ -244,6 +418,7 @@ void m6840_write(struct m6840 *ptm, uint8_t addr, uint8_t val)
 {
     struct ptm_timer *p;
     addr &= 7;
+    m6840_sync(ptm);
     if (addr > 1) {
         if ((addr & 1) == 0)
             ptm->msb = val;
@@ -262,6 +437,7 @@ void m6840_write(struct m6840 *ptm, uint8_t addr, uint8_t val)
                 m6840_calc_outputs(ptm);
             }
         }
+        m6840_schedule(ptm);
         return;
     }
     if (addr == 0) {
@@ -278,6 +454,8 @@ void m6840_write(struct m6840 *ptm, uint8_t addr, uint8_t val)
     if (addr == 1 && (val & 1))
         m6840_soft_reset(ptm);
     m6840_calc_irq(ptm);
+    m6840_calc_outputs(ptm);
+    m6840_schedule(ptm);
 }
 
 void m6840_trace(struct m6840 *ptm, int onoff)
@@ -289,6 +467,7 @@ struct m6840 *m6840_create(void)
 {
     struct m6840 *ptm = malloc(sizeof(struct m6840));
     memset(ptm, 0x00, sizeof(struct m6840));
+    ptm->deadline = UINT64_MAX;
     m6840_reset(ptm);
     return ptm;
 }
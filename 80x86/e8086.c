@@ -77,6 +77,7 @@ void e86_init (e8086_t *c)
 
 	c->pq_size = 4;
 	c->pq_fill = 6;
+	c->pq = c->pq_buf;
 
 	c->irq = 0;
 
@@ -529,6 +530,15 @@ void e86_execute (e8086_t *c)
 
 void e86_clock (e8086_t *c, unsigned n)
 {
+	/* HLT with no interrupt to take: each execute would just burn
+	   2 clocks, so do the lot at once */
+	if ((c->state & E86_STATE_HALT) && !(c->irq && e86_get_if (c)) && n >= c->delay) {
+		n -= c->delay;
+		c->clock += c->delay + (n & ~1U);
+		n &= 1;
+		c->delay = 2;
+	}
+
 	while (n >= c->delay) {
 		n -= c->delay;
 		c->clock += c->delay;
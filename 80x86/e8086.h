@@ -35,6 +35,7 @@
 #define E86_CPU_INT7       0x10		/* throw escape opcode exception */
 #define E86_CPU_FLAGS286   0x20         /* Allow clearing flags 12-15 */
 #define E86_CPU_8BIT       0x40		/* 16 bit accesses take more time */
+#define E86_CPU_FAST_FETCH 0x80		/* decode straight from ram[] */
 
 /* CPU flags */
 #define E86_FLG_C 0x0001
@@ -139,7 +140,8 @@ typedef struct e8086_t {
 	unsigned         pq_size;
 	unsigned         pq_fill;
 	unsigned         pq_cnt;
-	unsigned char    pq[E86_PQ_MAX];
+	unsigned char    *pq;
+	unsigned char    pq_buf[E86_PQ_MAX];
 
 	unsigned         prefix;
 
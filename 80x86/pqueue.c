@@ -35,6 +35,11 @@
  * The prefetch buffer is filled with pq_fill instead of pq_size bytes
  * so that there is always at least one entire instruction in the
  * prefetch buffer. Yes, this is ugly.
+ *
+ * With E86_CPU_FAST_FETCH set and the instruction bytes entirely within
+ * ram[], pq is pointed straight at the host memory instead and the queue
+ * is left empty. Code that modifies the bytes just ahead of itself then
+ * sees the new bytes, so leave the option off when that matters.
  */
 
 
@@ -65,6 +70,14 @@ void e86_pq_fill (e8086_t *c)
 
 		addr = e86_get_linear (seg, ofs) & c->addr_mask;
 
+		if ((c->cpu & E86_CPU_FAST_FETCH) && (addr + cnt) <= c->ram_cnt) {
+			c->pq = c->ram + addr;
+			c->pq_cnt = 0;
+			return;
+		}
+
+		c->pq = c->pq_buf;
+
 		if ((addr + cnt) <= c->ram_cnt) {
 			for (i = c->pq_cnt; i < cnt; i++) {
 				c->pq[i] = c->ram[addr + i];
@@ -81,6 +94,8 @@ void e86_pq_fill (e8086_t *c)
 		}
 	}
 	else {
+		c->pq = c->pq_buf;
+
 		i = c->pq_cnt;
 		while (i < cnt) {
 			val = e86_get_mem16 (c, seg, ofs + i);
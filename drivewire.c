@@ -8,6 +8,7 @@
 #include <unistd.h>
 
 #include "drivewire.h"
+#include "wallclock.h"
 
 #define DW_IDLE		0
 #define DW_DATA_OUT	1
@@ -34,10 +35,7 @@ static unsigned dw_len;
 
 static void dw_setup_time(void)
 {
-	time_t t;
-	struct tm *tm;
-	time(&t);
-	tm = localtime(&t);
+	struct tm *tm = wallclock_localtime();
 	if (tm == NULL) {
 		memset(dw_buf, 0, 7);
 		return;
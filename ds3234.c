@@ -6,6 +6,7 @@
 #include <unistd.h>
 #include <fcntl.h>
 #include "ds3234.h"
+#include "wallclock.h"
 
 struct ds3234 {
 	uint8_t ram[256];
@@ -133,9 +134,7 @@ void ds3234_spi_cs(struct ds3234 *rtc, unsigned cs)
 	if (rtc->cs && !cs) {
 		if (rtc->trace)
 			fprintf(stderr, "ds3234: CS goes low, latch time.\n");
-		time_t t;
-		time(&t);
-		rtc->tm = gmtime(&t);
+		rtc->tm = wallclock_gmtime();
 	}
 	if (cs) {
 		if (rtc->trace)
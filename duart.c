@@ -3,6 +3,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include "serialdevice.h"
 #include "duart.h"
 
 /* 68681 DUART */
@@ -16,6 +17,7 @@ struct duart_port {
 	uint8_t mrp;
 	uint8_t txdis;
 	uint8_t rxdis;
+	struct serial_device *dev;	/* If not using the console */
 };
 
 struct duart {
@@ -25,6 +27,12 @@ struct duart {
 	int32_t ct;		/* We overflow this temporarily */
 	uint16_t ctr;
 	uint8_t ctstop;
+	uint8_t ctpre;		/* X1 clocks towards the next /16 count */
+	uint32_t x1frac;	/* Part of an X1 clock owed, in CPU Hz units */
+	uint32_t hz;		/* CPU clock rate */
+	uint64_t clock;		/* CPU cycles we have been given */
+	uint64_t synced;	/* CPU cycles the counter is up to date with */
+	uint64_t deadline;	/* When the counter interrupt next fires */
 	uint8_t imr;
 	uint8_t ivr;
 	uint8_t opcr;
@@ -81,7 +89,9 @@ static void duart_output(struct duart *d, int port, int value)
 	if (d->port[port].txdis)
 		return;
 	if (d->port[port].sr & 0x04) {
-		if (d->input - 1 == port) {
+		if (d->port[port].dev)
+			d->port[port].dev->put(d->port[port].dev, value);
+		else if (d->input - 1 == port) {
 			uint8_t v = value & 0xFF;
 			write(1, &v, 1);
 		}
@@ -126,81 +136,153 @@ static void duart_command(struct duart *d, int port, int value)
 		d->port[port].txdis = 1;
 }
 
-/* Simulate 1/100th second of action */
-static void duart_count(struct duart *d, int n)
-{
-	/* We are clocked at ??? so divide as needed */
-	uint16_t clock = 184;	/* 1843200 so not entirely accurate
-				   FIXME: we could track partial clocks */
-	if (n == 16)
-		clock /= 16;	/* Again needs accuracy sorting */
+#define DUART_X1	1843200
 
+/* Divider from X1 for the counter/timer, 0 if it is not counting */
+static unsigned duart_ct_divider(struct duart *d)
+{
 	/* Counter mode can be stopped */
 	if (!(d->acr & 0x40))
 		if (d->ctstop)
-			return;
-
-	d->ct -= clock;
-	if (d->ct < 0) {
-		/* Our couunt overran so we compute the remainder */
-		if (d->ctr) {
-			d->ct %= d->ctr;	/* Negative clocks left */
-			d->ct += d->ctr;	/* Plus next cycle */
-		} else
-			d->ct = 0;
-		/* And raise the event */
-		duart_irq_raise(d, 0x08);
-	}
-}
-
-void duart_tick(struct duart *d)
-{
-	uint8_t r = check_chario();
-	if (r & 1) {
-		if (d->input == 1 && d->port[0].rxdis == 0) {
-		    d->port[0].rx = next_char();
-		    d->port[0].sr |= 0x01;
-		    duart_irq_raise(d, 0x02);
-                } else if (d->input == 2 && d->port[1].rxdis == 0) {
-		    d->port[1].rx = next_char();
-		    d->port[1].sr |= 0x01;
-		    duart_irq_raise(d, 0x20);
-                }
-	}
-	if (r & 2) {
-		if (!d->port[0].txdis && !(d->port[0].sr & 0x04))
-			duart_irq_raise(d, 0x01);
-		d->port[0].sr |= 0x0C;
-		if (!d->port[1].txdis && !(d->port[1].sr & 0x04))
-			duart_irq_raise(d, 0x10);
-		d->port[1].sr |= 0x0C;
-	}
+			return 0;
 	switch ((d->acr & 0x70) >> 4) {
 		/* Clock and timer modes */
 	case 0:		/* Counting IP2 */
-		break;
 	case 1:		/* Counting TxCA */
-		break;
 	case 2:		/* Counting TxCB */
-		break;
-	case 3:		/* Counting EXT/x1 clock  / 16 */
-		duart_count(d, 16);
-		break;
 	case 4:		/* Timer on IP2 */
-		break;
 	case 5:		/* Timer on IP2/16 */
-		break;
+		return 0;
+	case 3:		/* Counting EXT/x1 clock  / 16 */
+		return 16;
 	case 6:		/* Timer on X1/CLK */
-		duart_count(d, 1);
-		break;
+		return 1;
 	case 7:		/* Timer on X1/CLK / 16 */
-		duart_count(d, 16);
-		break;
+		return 16;
+	}
+	return 0;
+}
+
+/* Count the counter/timer down n times */
+static void duart_count(struct duart *d, uint64_t n)
+{
+	if (n <= (uint64_t)d->ct) {
+		d->ct -= n;
+		return;
+	}
+	/* Our count overran so we compute the remainder */
+	n -= d->ct + 1;
+	if (d->ctr)
+		d->ct = d->ctr - 1 - n % d->ctr;
+	else
+		d->ct = 0;
+	/* And raise the event */
+	duart_irq_raise(d, 0x08);
+}
+
+/* Work out when the counter will next interrupt if anyone cares */
+static void duart_schedule(struct duart *d)
+{
+	unsigned div = duart_ct_divider(d);
+	uint64_t x1;
+
+	if (div == 0 || !(d->imr & 0x08) || (d->isr & 0x08)) {
+		d->deadline = UINT64_MAX;
+		return;
+	}
+	x1 = ((uint64_t)d->ct + 1) * div;
+	if (div == 16)
+		x1 -= d->ctpre;
+	/* Round up to the CPU cycle in which that X1 edge falls */
+	d->deadline = d->synced + (x1 * d->hz - d->x1frac + DUART_X1 - 1) / DUART_X1;
+}
+
+/* Bring the counter up to date with the CPU cycles we have been given */
+static void duart_sync(struct duart *d)
+{
+	uint64_t n = d->clock - d->synced;
+	unsigned div;
+
+	if (n == 0)
+		return;
+	d->synced = d->clock;
+	n = n * DUART_X1 + d->x1frac;
+	d->x1frac = n % d->hz;
+	n /= d->hz;
+	div = duart_ct_divider(d);
+	if (div == 16) {
+		n += d->ctpre;
+		d->ctpre = n & 15;
+		n >>= 4;
 	}
+	if (div && n)
+		duart_count(d, n);
+	duart_schedule(d);
+}
+
+/* Run the counter/timer on by some CPU cycles */
+void duart_tick(struct duart *d, unsigned cycles)
+{
+	d->clock += cycles;
+	if (d->clock >= d->deadline)
+		duart_sync(d);
+}
+
+/* CPU cycles until the counter/timer interrupts, 0 if it is not going to */
+unsigned duart_next_event(struct duart *d)
+{
+	uint64_t n;
+
+	if (d->deadline == UINT64_MAX)
+		return 0;
+	n = d->deadline - d->clock;
+	if (n > UINT32_MAX)
+		return UINT32_MAX;
+	return n;
+}
+
+/* Look for console and link traffic. This costs a system call so the
+   board should only call it every so often */
+void duart_poll(struct duart *d)
+{
+	uint8_t r = check_chario();
+	struct duart_port *p;
+	unsigned s;
+	int i;
+
+	for (i = 0; i < 2; i++) {
+		p = &d->port[i];
+		s = r;
+		if (p->dev)
+			s = p->dev->ready(p->dev);
+		else if (d->input != i + 1)
+			s &= 2;
+		/* A link holds on to the byte until we have room for it */
+		if ((s & 1) && p->rxdis == 0 && !(p->dev && (p->sr & 0x01))) {
+			p->rx = p->dev ? p->dev->get(p->dev) : next_char();
+			p->sr |= 0x01;
+			duart_irq_raise(d, 0x02 << (4 * i));
+		}
+		if (s & 2) {
+			if (!p->txdis && !(p->sr & 0x04))
+				duart_irq_raise(d, 0x01 << (4 * i));
+			p->sr |= 0x0C;
+		}
+	}
+}
+
+/* Set the CPU clock the ticks are counted in */
+void duart_set_clock(struct duart *d, uint32_t hz)
+{
+	duart_sync(d);
+	d->hz = hz;
+	d->x1frac = 0;
+	duart_schedule(d);
 }
 
 void duart_reset(struct duart *d)
 {
+	duart_sync(d);
 	d->ctr = 0xFFFF;
 	d->ct = 0x0000;
 	d->acr = 0xFF;
@@ -211,6 +293,7 @@ void duart_reset(struct duart *d)
 	d->port[0].sr = 0x00;
 	d->port[1].mrp = 0;
 	d->port[1].sr = 0x00;
+	duart_schedule(d);
 }
 
 uint8_t do_duart_read(struct duart *d, uint16_t address)
@@ -262,7 +345,11 @@ uint8_t do_duart_read(struct duart *d, uint16_t address)
 
 uint8_t duart_read(struct duart *d, uint16_t address)
 {
-	uint8_t value = do_duart_read(d, address);
+	uint8_t value;
+
+	duart_sync(d);
+	value = do_duart_read(d, address);
+	duart_schedule(d);
 	if (d->trace)
 		fprintf(stderr, "duart: read reg %02X -> %02X\n",
 			address >> 1, value);
@@ -275,6 +362,7 @@ void duart_write(struct duart *d, uint16_t address, uint8_t value)
 
 	value &= 0xFF;
 
+	duart_sync(d);
 	if (d->trace)
 		fprintf(stderr, "duart: write reg %02X <- %02X\n",
 			address >> 1, value);
@@ -345,6 +433,7 @@ void duart_write(struct duart *d, uint16_t address, uint8_t value)
 		fprintf(stderr, "BGR %d\n", d->acr >> 7);
 		fprintf(stderr, "CSR %d\n", d->port[0].csr >> 4);
 	}
+	duart_schedule(d);
 }
 
 void duart_set_input(struct duart *duart, int port)
@@ -352,6 +441,12 @@ void duart_set_input(struct duart *duart, int port)
 	duart->input = port;
 }
 
+/* Connect a port to something other than the console */
+void duart_attach(struct duart *duart, int port, struct serial_device *dev)
+{
+	duart->port[port].dev = dev;
+}
+
 void duart_trace(struct duart *duart, int onoff)
 {	
 	duart->trace = onoff;
@@ -370,6 +465,8 @@ struct duart *duart_create(void)
 		exit(1);
 	}
 	memset(d, 0, sizeof(*d));
+	d->hz = 10000000;
+	d->deadline = UINT64_MAX;
 	duart_reset(d);
 	return d;
 }
@@ -1,14 +1,19 @@
 struct duart;
+struct serial_device;
 
 extern struct duart *duart_create(void);
 extern void duart_free(struct duart *duart);
 extern void duart_trace(struct duart *duart, int onoff);
 extern uint8_t duart_read(struct duart *duart, uint16_t addr);
 extern void duart_write(struct duart *duart, uint16_t addr, uint8_t val);
-extern void duart_tick(struct duart *duart);
+extern void duart_tick(struct duart *duart, unsigned cycles);
+extern unsigned duart_next_event(struct duart *duart);
+extern void duart_poll(struct duart *duart);
+extern void duart_set_clock(struct duart *duart, uint32_t hz);
 extern void duart_reset(struct duart *duart);
 extern uint8_t duart_irq_pending(struct duart *duart);
 extern void duart_set_input(struct duart *duart, int port);
+extern void duart_attach(struct duart *duart, int port, struct serial_device *dev);
 extern uint8_t duart_vector(struct duart *duart);
 
 /* Caller proviced */
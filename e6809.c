@@ -13,6 +13,8 @@
  */
 
 #define einline __inline
+/* For the instruction body we want two copies of, with and without tracing */
+#define eforceinline __inline __attribute__((always_inline))
 
 enum {
 	FLAG_E		= 0x80,
@@ -71,6 +73,13 @@ static unsigned *rptr_xyus[4] = {
 
 static unsigned trace_cpu;
 
+/* host memory for each 256 byte page, if the board has mapped it. A NULL
+ * entry sends the access to the user defined functions.
+ */
+
+static uint8_t *map_rd[256];
+static uint8_t *map_wr[256];
+
 /* user defined read and write functions */
 
 unsigned char e6809_read8(unsigned address);
@@ -177,6 +186,10 @@ static einline void set_reg_d (unsigned value)
 
 static einline unsigned read8 (unsigned address)
 {
+	uint8_t *p = map_rd[(address >> 8) & 0xff];
+
+	if (p)
+		return p[address & 0xff];
 	return e6809_read8(address & 0xffff);
 }
 
@@ -186,7 +199,12 @@ static einline unsigned read8 (unsigned address)
 
 static einline void write8 (unsigned address, unsigned data)
 {
-	e6809_write8(address & 0xffff, (unsigned char) data);
+	uint8_t *p = map_wr[(address >> 8) & 0xff];
+
+	if (p)
+		p[address & 0xff] = data;
+	else
+		e6809_write8(address & 0xffff, (unsigned char) data);
 }
 
 static einline unsigned read16 (unsigned address)
@@ -1127,9 +1145,12 @@ void e6809_reset (int trace)
 	reg_pc = read16 (0xfffe);
 }
 
-/* execute a single instruction or handle interrupts and return */
+/* execute a single instruction or handle interrupts and return. trace is
+ * always a constant so the copy used by e6809_run has no trace hook.
+ */
 
-unsigned e6809_sstep (unsigned irq_i, unsigned irq_f)
+static eforceinline unsigned e6809_execute (unsigned irq_i, unsigned irq_f,
+											const int trace)
 {
 	unsigned op;
 	unsigned cycles = 0;
@@ -1182,7 +1203,8 @@ unsigned e6809_sstep (unsigned irq_i, unsigned irq_f)
 		return cycles + 1;
 	}
 
-	e6809_instruction(reg_pc);
+	if (trace)
+		e6809_instruction(reg_pc);
 	op = pc_read8 ();
 
 	switch (op) {
@@ -2635,6 +2657,38 @@ unsigned e6809_sstep (unsigned irq_i, unsigned irq_f)
 	return cycles;
 }
 
+unsigned e6809_sstep (unsigned irq_i, unsigned irq_f)
+{
+	return e6809_execute (irq_i, irq_f, 1);
+}
+
+/* run instructions until at least cycles have passed and return how many
+ * did. The interrupt lines are looked at before each instruction so that
+ * I/O done along the way is seen. e6809_instruction is not called.
+ */
+
+unsigned e6809_run (unsigned cycles, const uint8_t *irq_i,
+					const uint8_t *irq_f)
+{
+	unsigned done = 0;
+
+	while (done < cycles)
+		done += e6809_execute (irq_i ? *irq_i : 0, irq_f ? *irq_f : 0, 0);
+
+	return done;
+}
+
+/* point a 256 byte page of the 6809 address space at host memory. rd or wr
+ * may be NULL to use e6809_read8/e6809_write8 for that direction, which is
+ * how I/O, ROM write protection and memory tracing are done.
+ */
+
+void e6809_map_page (unsigned page, uint8_t *rd, uint8_t *wr)
+{
+	map_rd[page & 0xff] = rd;
+	map_wr[page & 0xff] = wr;
+}
+
 struct reg6809 *e6809_get_regs(void)
 {
 	static struct reg6809 r;
@@ -12,6 +12,8 @@ extern void e6809_instruction(unsigned address);
 
 void e6809_reset (int trace);
 unsigned e6809_sstep (unsigned irq_i, unsigned irq_f);
+unsigned e6809_run (unsigned cycles, const uint8_t *irq_i, const uint8_t *irq_f);
+void e6809_map_page (unsigned page, uint8_t *rd, uint8_t *wr);
 
 struct reg6809 {
     uint16_t pc;
@@ -0,0 +1,631 @@
+/*
+ *	Run a set of emulator console tests in parallel
+ *
+ *	emurun [-j jobs] [-o tap|junit] [-s suite] [-T timeout] test...
+ *
+ *	Each test is a script of one command per line
+ *
+ *	run command		start the emulator (via /bin/sh)
+ *	timeout seconds		time allowed for each following expect
+ *	expect text		wait until the console output contains text
+ *	send text		write text to the console
+ *
+ *	Text may be quoted and takes C style \r \n \t \\ \" and \xHH escapes.
+ *	Blank lines and lines starting with # are ignored. A test passes
+ *	when the script runs off the end, at which point the emulator is
+ *	killed. It fails if an expect times out or the emulator exits
+ *	first.
+ *
+ *	The console is the emulator stdin and stdout, stderr goes into the
+ *	same pipe so any diagnostics end up in the failure report. Up to
+ *	jobs tests (default one per CPU) run at a time. The results come out
+ *	in test order on stdout as TAP or JUnit XML with the wall time of
+ *	each test and of the whole suite.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#define OP_RUN		0
+#define OP_TIMEOUT	1
+#define OP_EXPECT	2
+#define OP_SEND		3
+
+/* Output kept for matching and for the failure report */
+#define OUTMAX		65536
+
+struct step {
+	unsigned op;
+	char *text;
+	unsigned len;
+	unsigned timeout;
+};
+
+struct test {
+	const char *path;
+	struct step *step;
+	unsigned nstep;
+	unsigned cur;
+	/* Runtime */
+	pid_t pid;
+	int in;
+	int out;
+	char *buf;
+	unsigned buflen;
+	unsigned matched;	/* Output before this has been matched */
+	const char *pend;	/* Console input not yet taken */
+	unsigned pendlen;
+	double start;
+	unsigned armed;		/* Step the deadline belongs to */
+	double deadline;
+	double time;
+	unsigned done;
+	const char *fail;
+};
+
+static struct test *tests;
+static unsigned ntests;
+static unsigned running;
+static unsigned default_timeout = 60;
+
+static double now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1E9;
+}
+
+static int hexval(char c)
+{
+	if (c >= '0' && c <= '9')
+		return c - '0';
+	if (c >= 'a' && c <= 'f')
+		return c - 'a' + 10;
+	if (c >= 'A' && c <= 'F')
+		return c - 'A' + 10;
+	return -1;
+}
+
+/* Decode the text argument in place and return its length */
+static unsigned unescape(char *p)
+{
+	char *o = p;
+	char *s = p;
+	size_t l = strlen(p);
+
+	if (l >= 2 && *p == '"' && p[l - 1] == '"') {
+		p[l - 1] = 0;
+		p++;
+	}
+	while (*p) {
+		if (*p != '\\' || p[1] == 0) {
+			*o++ = *p++;
+			continue;
+		}
+		p++;
+		switch (*p) {
+		case 'r':
+			*o++ = '\r';
+			break;
+		case 'n':
+			*o++ = '\n';
+			break;
+		case 't':
+			*o++ = '\t';
+			break;
+		case 'x':
+			if (hexval(p[1]) >= 0 && hexval(p[2]) >= 0) {
+				*o++ = (hexval(p[1]) << 4) | hexval(p[2]);
+				p += 2;
+				break;
+			}
+			/* Fall through */
+		default:
+			*o++ = *p;
+		}
+		p++;
+	}
+	*o = 0;
+	return o - s;
+}
+
+static void load_test(struct test *t, const char *path)
+{
+	char buf[1024];
+	unsigned line = 0;
+	unsigned size = 0;
+	unsigned timeout = default_timeout;
+	FILE *fp;
+
+	t->path = path;
+	fp = fopen(path, "r");
+	if (fp == NULL) {
+		perror(path);
+		exit(1);
+	}
+	while (fgets(buf, sizeof(buf), fp)) {
+		struct step *s;
+		char *p = buf + strlen(buf);
+		char *arg;
+
+		line++;
+		while (p > buf && (p[-1] == '\n' || p[-1] == '\r'))
+			*--p = 0;
+		p = buf + strspn(buf, " \t");
+		if (*p == 0 || *p == '#')
+			continue;
+		arg = p + strcspn(p, " \t");
+		if (*arg)
+			*arg++ = 0;
+		arg += strspn(arg, " \t");
+
+		if (t->nstep == size) {
+			size = size ? size * 2 : 16;
+			t->step = realloc(t->step, size * sizeof(struct step));
+			if (t->step == NULL) {
+				fprintf(stderr, "emurun: out of memory.\n");
+				exit(1);
+			}
+		}
+		s = t->step + t->nstep;
+		if (strcmp(p, "run") == 0)
+			s->op = OP_RUN;
+		else if (strcmp(p, "timeout") == 0) {
+			s->op = OP_TIMEOUT;
+			timeout = atoi(arg);
+		} else if (strcmp(p, "expect") == 0)
+			s->op = OP_EXPECT;
+		else if (strcmp(p, "send") == 0)
+			s->op = OP_SEND;
+		else {
+			fprintf(stderr, "%s:%u: unknown command '%s'.\n", path, line, p);
+			exit(1);
+		}
+		s->text = strdup(arg);
+		if (s->text == NULL) {
+			fprintf(stderr, "emurun: out of memory.\n");
+			exit(1);
+		}
+		if (s->op == OP_RUN)
+			s->len = strlen(s->text);
+		else
+			s->len = unescape(s->text);
+		s->timeout = timeout;
+		t->nstep++;
+	}
+	fclose(fp);
+	if (t->nstep == 0 || t->step[0].op != OP_RUN) {
+		fprintf(stderr, "%s: must start with a run command.\n", path);
+		exit(1);
+	}
+}
+
+static void finish(struct test *t, const char *fail)
+{
+	int status;
+
+	t->fail = fail;
+	t->done = 1;
+	t->time = now() - t->start;
+	if (t->pid > 0) {
+		/* Take out the shell and anything it started */
+		kill(-t->pid, SIGKILL);
+		waitpid(t->pid, &status, 0);
+	}
+	close(t->in);
+	close(t->out);
+	running--;
+	fprintf(stderr, "%s: %s (%.2fs)\n", t->path, fail ? fail : "ok", t->time);
+}
+
+static char *find(char *p, unsigned len, const char *s, unsigned slen)
+{
+	while (len >= slen) {
+		char *x = memchr(p, *s, len - slen + 1);
+		if (x == NULL)
+			return NULL;
+		if (memcmp(x, s, slen) == 0)
+			return x;
+		len -= x + 1 - p;
+		p = x + 1;
+	}
+	return NULL;
+}
+
+/* The time allowed runs from when we first have to wait on a step, not
+   from the latest output */
+static void arm(struct test *t, struct step *s)
+{
+	if (t->armed != t->cur) {
+		t->armed = t->cur;
+		t->deadline = now() + s->timeout;
+	}
+}
+
+/* Feed as much pending console input as the emulator will take. Returns
+   -1 on error */
+static int flush_input(struct test *t)
+{
+	while (t->pendlen) {
+		ssize_t l = write(t->in, t->pend, t->pendlen);
+		if (l < 0) {
+			if (errno == EAGAIN || errno == EINTR)
+				return 0;
+			return -1;
+		}
+		t->pend += l;
+		t->pendlen -= l;
+	}
+	return 0;
+}
+
+/* Work through the script until we have to wait for output or are done */
+static void advance(struct test *t)
+{
+	while (t->cur < t->nstep) {
+		struct step *s = t->step + t->cur;
+		switch (s->op) {
+		case OP_RUN:
+		case OP_TIMEOUT:
+			break;
+		case OP_SEND:
+			/* An emulator that is not reading its console must
+			   not hold up the other tests */
+			if (t->armed != t->cur) {
+				t->pend = s->text;
+				t->pendlen = s->len;
+			}
+			if (flush_input(t)) {
+				finish(t, "console write failed");
+				return;
+			}
+			if (t->pendlen) {
+				arm(t, s);
+				return;
+			}
+			break;
+		case OP_EXPECT:
+			if (s->len) {
+				char *p = find(t->buf + t->matched,
+					t->buflen - t->matched, s->text, s->len);
+				if (p == NULL) {
+					arm(t, s);
+					return;
+				}
+				t->matched = p + s->len - t->buf;
+			}
+			break;
+		}
+		t->cur++;
+	}
+	finish(t, NULL);
+}
+
+static void start(struct test *t)
+{
+	int in[2], out[2];
+	const char *cmd = t->step[0].text;
+
+	t->buf = malloc(OUTMAX);
+	if (t->buf == NULL || pipe(in) || pipe(out)) {
+		fprintf(stderr, "emurun: unable to set up %s.\n", t->path);
+		exit(1);
+	}
+	t->start = now();
+	t->pid = fork();
+	if (t->pid == -1) {
+		perror("fork");
+		exit(1);
+	}
+	/* Both sides set the group so it exists before we could kill it */
+	if (t->pid == 0) {
+		setpgid(0, 0);
+		dup2(in[0], 0);
+		dup2(out[1], 1);
+		dup2(out[1], 2);
+		close(in[0]);
+		close(in[1]);
+		close(out[0]);
+		close(out[1]);
+		execl("/bin/sh", "sh", "-c", cmd, (char *)NULL);
+		perror("/bin/sh");
+		_exit(127);
+	}
+	setpgid(t->pid, t->pid);
+	close(in[0]);
+	close(out[1]);
+	t->in = in[1];
+	t->out = out[0];
+	fcntl(t->in, F_SETFL, O_NONBLOCK);
+	fcntl(t->out, F_SETFL, O_NONBLOCK);
+	/* Don't leak our ends into the next test or a finished test never
+	   sees end of file */
+	fcntl(t->in, F_SETFD, FD_CLOEXEC);
+	fcntl(t->out, F_SETFD, FD_CLOEXEC);
+	running++;
+	t->cur = 1;
+	advance(t);
+}
+
+/* Keep the most recent output if the buffer fills. Anything already
+   matched goes first */
+static void make_room(struct test *t, unsigned want)
+{
+	unsigned drop;
+
+	if (t->buflen + want <= OUTMAX)
+		return;
+	drop = t->buflen + want - OUTMAX;
+	if (drop < t->matched)
+		drop = t->matched;
+	if (drop > t->buflen)
+		drop = t->buflen;
+	memmove(t->buf, t->buf + drop, t->buflen - drop);
+	t->buflen -= drop;
+	t->matched = t->matched > drop ? t->matched - drop : 0;
+}
+
+static void collect(struct test *t)
+{
+	char tmp[4096];
+	ssize_t l = read(t->out, tmp, sizeof(tmp));
+
+	if (l == 0) {
+		finish(t, "emulator exited");
+		return;
+	}
+	if (l < 0) {
+		if (errno == EAGAIN || errno == EINTR)
+			return;
+		finish(t, "console read failed");
+		return;
+	}
+	make_room(t, l);
+	memcpy(t->buf + t->buflen, tmp, l);
+	t->buflen += l;
+	advance(t);
+}
+
+static void run_all(unsigned jobs)
+{
+	/* Each test waits on its output and maybe its input */
+	struct pollfd *pfd = calloc(2 * ntests, sizeof(struct pollfd));
+	unsigned *map = calloc(2 * ntests, sizeof(unsigned));
+	unsigned next = 0;
+
+	if (pfd == NULL || map == NULL) {
+		fprintf(stderr, "emurun: out of memory.\n");
+		exit(1);
+	}
+	while (next < ntests || running) {
+		unsigned i, n = 0;
+		double t = now();
+		double wait = 1.0;
+
+		while (next < ntests && running < jobs)
+			start(tests + next++);
+		for (i = 0; i < ntests; i++) {
+			struct test *p = tests + i;
+			if (p->pid == 0 || p->done)
+				continue;
+			if (t >= p->deadline) {
+				finish(p, "timed out");
+				continue;
+			}
+			if (p->deadline - t < wait)
+				wait = p->deadline - t;
+			pfd[n].fd = p->out;
+			pfd[n].events = POLLIN;
+			map[n++] = i;
+			if (p->pendlen) {
+				pfd[n].fd = p->in;
+				pfd[n].events = POLLOUT;
+				map[n++] = i;
+			}
+		}
+		if (n == 0)
+			continue;
+		if (poll(pfd, n, wait * 1000 + 1) < 0) {
+			if (errno == EINTR)
+				continue;
+			perror("poll");
+			exit(1);
+		}
+		for (i = 0; i < n; i++) {
+			struct test *p = tests + map[i];
+			if (pfd[i].revents == 0 || p->done)
+				continue;
+			if (pfd[i].fd == p->in)
+				advance(p);
+			else
+				collect(p);
+		}
+	}
+	free(pfd);
+	free(map);
+}
+
+/* The output tail for a failure report, made printable */
+static void print_tail(struct test *t, const char *prefix, unsigned xml)
+{
+	unsigned i = t->buflen > 512 ? t->buflen - 512 : 0;
+	unsigned sol = 1;
+
+	for (; i < t->buflen; i++) {
+		unsigned char c = t->buf[i];
+		if (sol)
+			fputs(prefix, stdout);
+		sol = 0;
+		if (c == '\n') {
+			putchar('\n');
+			sol = 1;
+		} else if (c < 32 || c > 126)
+			continue;
+		else if (xml && c == '<')
+			fputs("&lt;", stdout);
+		else if (xml && c == '>')
+			fputs("&gt;", stdout);
+		else if (xml && c == '&')
+			fputs("&amp;", stdout);
+		else
+			putchar(c);
+	}
+	if (!sol)
+		putchar('\n');
+}
+
+static void print_xml(const char *s)
+{
+	for (; *s; s++) {
+		switch (*s) {
+		case '<':
+			fputs("&lt;", stdout);
+			break;
+		case '>':
+			fputs("&gt;", stdout);
+			break;
+		case '&':
+			fputs("&amp;", stdout);
+			break;
+		case '"':
+			fputs("&quot;", stdout);
+			break;
+		default:
+			putchar(*s);
+		}
+	}
+}
+
+static const char *waiting_for(struct test *t)
+{
+	if (t->cur < t->nstep && t->step[t->cur].op == OP_EXPECT)
+		return t->step[t->cur].text;
+	return "";
+}
+
+static void report_tap(double total)
+{
+	unsigned i;
+
+	printf("1..%u\n", ntests);
+	for (i = 0; i < ntests; i++) {
+		struct test *t = tests + i;
+		if (t->fail == NULL) {
+			printf("ok %u - %s # %.2fs\n", i + 1, t->path, t->time);
+			continue;
+		}
+		printf("not ok %u - %s # %.2fs\n", i + 1, t->path, t->time);
+		printf("#   %s waiting for '%s'\n", t->fail, waiting_for(t));
+		print_tail(t, "#   | ", 0);
+	}
+	printf("# suite wall time %.2fs\n", total);
+}
+
+static void report_junit(const char *suite, double total)
+{
+	unsigned i;
+	unsigned fails = 0;
+
+	for (i = 0; i < ntests; i++)
+		if (tests[i].fail)
+			fails++;
+	printf("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
+	printf("<testsuite name=\"");
+	print_xml(suite);
+	printf("\" tests=\"%u\" failures=\"%u\" time=\"%.3f\">\n",
+		ntests, fails, total);
+	for (i = 0; i < ntests; i++) {
+		struct test *t = tests + i;
+		printf("  <testcase name=\"");
+		print_xml(t->path);
+		printf("\" time=\"%.3f\"", t->time);
+		if (t->fail == NULL) {
+			printf("/>\n");
+			continue;
+		}
+		printf(">\n    <failure message=\"%s waiting for '", t->fail);
+		print_xml(waiting_for(t));
+		printf("'\">\n");
+		print_tail(t, "", 1);
+		printf("    </failure>\n  </testcase>\n");
+	}
+	printf("</testsuite>\n");
+}
+
+static void usage(void)
+{
+	fprintf(stderr, "emurun: [-j jobs] [-o tap|junit] [-s suite] [-T timeout] test...\n");
+	exit(EXIT_FAILURE);
+}
+
+int main(int argc, char *argv[])
+{
+	long jobs = sysconf(_SC_NPROCESSORS_ONLN);
+	const char *suite = "emurun";
+	unsigned junit = 0;
+	unsigned i;
+	unsigned fails = 0;
+	double t;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "j:o:s:T:")) != -1) {
+		switch (opt) {
+		case 'j':
+			jobs = atol(optarg);
+			break;
+		case 'o':
+			if (strcmp(optarg, "junit") == 0)
+				junit = 1;
+			else if (strcmp(optarg, "tap") == 0)
+				junit = 0;
+			else
+				usage();
+			break;
+		case 's':
+			suite = optarg;
+			break;
+		case 'T':
+			default_timeout = atoi(optarg);
+			break;
+		default:
+			usage();
+		}
+	}
+	if (optind == argc)
+		usage();
+	if (jobs < 1)
+		jobs = 1;
+
+	ntests = argc - optind;
+	tests = calloc(ntests, sizeof(struct test));
+	if (tests == NULL) {
+		fprintf(stderr, "emurun: out of memory.\n");
+		exit(1);
+	}
+	for (i = 0; i < ntests; i++)
+		load_test(tests + i, argv[optind + i]);
+
+	signal(SIGPIPE, SIG_IGN);
+	t = now();
+	run_all(jobs);
+	t = now() - t;
+
+	if (junit)
+		report_junit(suite, t);
+	else
+		report_tap(t);
+	for (i = 0; i < ntests; i++)
+		if (tests[i].fail)
+			fails++;
+	return fails ? 1 : 0;
+}
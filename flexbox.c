@@ -417,6 +417,23 @@ void m6800_write(struct m6800 *cpu, uint16_t addr, uint8_t val)
 	}
 }
 
+/* Let the CPU at the RAM and ROM directly. I/O, ROM writes and memory
+   tracing still come through us */
+static void remap(void)
+{
+	unsigned int page;
+	uint16_t addr;
+
+	for (page = 0; page < 256; page++) {
+		addr = page << 8;
+		if ((trace & TRACE_MEM) || (addr >= 0x8000 && addr < 0xA000))
+			m6800_map_page(&cpu, page, NULL, NULL);
+		else
+			m6800_map_page(&cpu, page, ramrom + addr,
+				addr >= 0xE000 ? NULL : ramrom + addr);
+	}
+}
+
 static void poll_irq_event(void)
 {
 }
@@ -525,6 +542,7 @@ int main(int argc, char *argv[])
 	}
 
 	m6800_reset(&cpu, CPU_6800, INTIO_NONE, 3);
+	remap();
 
 	acia = acia_create();
 
@@ -546,8 +564,8 @@ int main(int argc, char *argv[])
 	while (!done) {
 		unsigned int i;
 		for (i = 0; i < 100; i++) {
-			while (cycles < clockrate)
-				cycles += m6800_execute(&cpu);
+			if (cycles < clockrate)
+				cycles += m6800_run(&cpu, clockrate - cycles);
 			cycles -= clockrate;
 		}
 		/* Drive the internal serial */
@@ -0,0 +1,158 @@
+/*
+ *	Guest memory allocation
+ *
+ *	Large static arrays are already zero fill on demand, but the boards
+ *	then wrote a pattern over every byte at start up, and every process
+ *	read its own copy of the ROM. With a lot of emulators on one host
+ *	that is a lot of memory and start up time for nothing.
+ *
+ *	RAM is now an anonymous mapping that only fills in as the guest uses
+ *	it. ROM images are mapped privately from the file so clean pages
+ *	come from the page cache and are shared between processes. Where a
+ *	board keeps ROM and RAM in one array the mapping is writable and a
+ *	page only becomes private if the guest writes to it.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "guestmem.h"
+
+static int guestmem_do_fill;
+static int guestmem_merge;
+
+int guestmem_option(const char *arg)
+{
+	if (strcmp(arg, "fill") == 0) {
+		guestmem_do_fill = 1;
+		return 0;
+	}
+	if (strcmp(arg, "merge") == 0) {
+		guestmem_merge = 1;
+		return 0;
+	}
+	fprintf(stderr, "guestmem: memory option must be fill or merge.\n");
+	return -1;
+}
+
+static size_t guestmem_pagesize(void)
+{
+	static size_t pagesize;
+
+	if (pagesize == 0)
+		pagesize = sysconf(_SC_PAGESIZE);
+	return pagesize;
+}
+
+static uint8_t *guestmem_map(size_t size, int prot)
+{
+	uint8_t *p = mmap(NULL, size, prot, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (p == MAP_FAILED) {
+		fprintf(stderr, "Out of memory.\n");
+		exit(1);
+	}
+#ifdef MADV_MERGEABLE
+	/* Only a hint: kernels without KSM just say no */
+	if (guestmem_merge)
+		madvise(p, size, MADV_MERGEABLE);
+#endif
+	return p;
+}
+
+/* Zero filled RAM, allocated as the guest touches it */
+uint8_t *guestmem_alloc(size_t size)
+{
+	return guestmem_map(size, PROT_READ | PROT_WRITE);
+}
+
+/* Only does anything if asked for. A pattern of -1 is random data */
+void guestmem_fill(uint8_t *p, size_t size, int pattern)
+{
+	if (!guestmem_do_fill)
+		return;
+	if (pattern != -1) {
+		memset(p, pattern, size);
+		return;
+	}
+	while (size--)
+		*p++ = rand();
+}
+
+/* Map up to size bytes of the file at off over p. Returns how much of
+   the file there was or -1 on error. Anything that cannot be mapped,
+   such as a pipe or an unaligned offset, is read instead */
+static ssize_t guestmem_map_file(uint8_t *p, int fd, off_t off, size_t size, int prot)
+{
+	size_t pg = guestmem_pagesize();
+	struct stat st;
+	size_t len;
+	ssize_t r;
+
+	if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) &&
+		((uintptr_t)p & (pg - 1)) == 0 && (off & (pg - 1)) == 0) {
+		if (st.st_size <= off)
+			return 0;
+		len = st.st_size - off;
+		if (len > size)
+			len = size;
+		/* The tail of the last page past the end of file reads as
+		   zero. Whole pages past it are left as they were */
+		if (mmap(p, (len + pg - 1) & ~(pg - 1), prot,
+			MAP_PRIVATE | MAP_FIXED, fd, off) != MAP_FAILED)
+			return len;
+	}
+	if (mprotect(p, size, PROT_READ | PROT_WRITE) == -1)
+		return -1;
+	r = pread(fd, p, size, off);
+	mprotect(p, size, prot);
+	return r;
+}
+
+/* A read only ROM image of size bytes. *len is set to how much of it
+   came from the file. The rest reads as zero */
+uint8_t *guestmem_rom(const char *path, size_t size, size_t *len)
+{
+	uint8_t *p;
+	ssize_t l;
+	int fd;
+
+	fd = open(path, O_RDONLY);
+	if (fd == -1) {
+		perror(path);
+		return NULL;
+	}
+	p = guestmem_map(size, PROT_READ);
+	l = guestmem_map_file(p, fd, 0, size, PROT_READ);
+	close(fd);
+	if (l == -1) {
+		perror(path);
+		munmap(p, size);
+		return NULL;
+	}
+	*len = l;
+	return p;
+}
+
+/* Load part of a file into guest memory from guestmem_alloc. Returns the
+   number of bytes loaded or -1 having reported the error */
+int guestmem_load(uint8_t *p, const char *path, off_t off, size_t size)
+{
+	ssize_t l;
+	int fd;
+
+	fd = open(path, O_RDONLY);
+	if (fd == -1) {
+		perror(path);
+		return -1;
+	}
+	l = guestmem_map_file(p, fd, off, size, PROT_READ | PROT_WRITE);
+	close(fd);
+	if (l == -1)
+		perror(path);
+	return l;
+}
@@ -0,0 +1,19 @@
+/*
+ *	Guest memory
+ *
+ *	RAM comes from anonymous mappings so it costs nothing until the
+ *	guest touches it, and ROM images are mapped privately from the file
+ *	so every emulator running the same image shares one copy.
+ *
+ *	fill	fill RAM with a pattern at start up as the boards used to
+ *	merge	offer RAM to the kernel for same page merging
+ */
+
+#include <stdint.h>
+#include <sys/types.h>
+
+extern int guestmem_option(const char *arg);
+extern uint8_t *guestmem_alloc(size_t size);
+extern void guestmem_fill(uint8_t *p, size_t size, int pattern);
+extern uint8_t *guestmem_rom(const char *path, size_t size, size_t *len);
+extern int guestmem_load(uint8_t *p, const char *path, off_t off, size_t size);
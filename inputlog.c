@@ -0,0 +1,251 @@
+/*
+ *	Console and keyboard input record/replay
+ *
+ *	The log is text, one event per line
+ *
+ *	cycle T byte		console byte (hex)
+ *	cycle D sym scan mod	key down
+ *	cycle U sym scan mod	key up
+ *
+ *	For console input the cycle logged is the one at which the machine
+ *	first polled the byte as ready, not when it read it. That is the
+ *	point the guest behaviour forks on, so presenting it as ready from
+ *	that cycle on replays the run exactly. Key events are logged when
+ *	the board hands them to the emulated keyboard, which it does at
+ *	fixed points in the run loop.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "serialdevice.h"
+#include "inputlog.h"
+
+#define EV_TTY		'T'
+#define EV_DOWN		'D'
+#define EV_UP		'U'
+
+struct inputlog_ev {
+	uint64_t cycle;
+	char type;
+	unsigned val;
+	struct inputlog_key key;
+};
+
+unsigned inputlog_mode;
+
+static uint64_t (*inputlog_clock)(void);
+static FILE *inputlog_fp;
+
+/* Record state */
+static unsigned tty_pending;
+static uint64_t tty_arrival;
+
+/* Replay state: the whole log with a cursor for each stream */
+static struct inputlog_ev *events;
+static unsigned int nevents;
+static unsigned int tty_next;
+static unsigned int key_next;
+static unsigned tty_last;
+
+static struct serial_device *inputlog_dev;
+
+static void inputlog_load(const char *path)
+{
+	char buf[128];
+	unsigned int size = 0;
+	unsigned long long cycle;
+	char type;
+	int sym;
+	unsigned val, scan, mod;
+	unsigned int line = 0;
+
+	while (fgets(buf, sizeof(buf), inputlog_fp)) {
+		line++;
+		if (*buf == '#' || *buf == '\n')
+			continue;
+		if (nevents == size) {
+			size = size ? size * 2 : 256;
+			events = realloc(events, size * sizeof(*events));
+			if (events == NULL) {
+				fprintf(stderr, "Out of memory.\n");
+				exit(1);
+			}
+		}
+		if (sscanf(buf, "%llu %c", &cycle, &type) != 2)
+			goto bad;
+		events[nevents].cycle = cycle;
+		events[nevents].type = type;
+		if (type == EV_TTY) {
+			if (sscanf(buf, "%*u %*c %x", &val) != 1)
+				goto bad;
+			events[nevents].val = val;
+		} else if (type == EV_DOWN || type == EV_UP) {
+			if (sscanf(buf, "%*u %*c %d %u %u", &sym, &scan, &mod) != 3)
+				goto bad;
+			events[nevents].key.up = type == EV_UP;
+			events[nevents].key.sym = sym;
+			events[nevents].key.scancode = scan;
+			events[nevents].key.mod = mod;
+		} else
+			goto bad;
+		nevents++;
+	}
+	return;
+bad:
+	fprintf(stderr, "%s: bad input log entry at line %u.\n", path, line);
+	exit(1);
+}
+
+void inputlog_init(const char *path, unsigned mode, uint64_t (*clock)(void))
+{
+	inputlog_fp = fopen(path, mode == INPUTLOG_REPLAY ? "r" : "w");
+	if (inputlog_fp == NULL) {
+		perror(path);
+		exit(1);
+	}
+	inputlog_clock = clock;
+	inputlog_mode = mode;
+	if (mode == INPUTLOG_REPLAY) {
+		inputlog_load(path);
+		fclose(inputlog_fp);
+		inputlog_fp = NULL;
+	} else
+		fprintf(inputlog_fp, "# inputlog 1\n");
+}
+
+/* Find the next event of a type at or after *ptr that is due by now */
+static struct inputlog_ev *inputlog_due(unsigned int *ptr, int (*match)(char))
+{
+	while (*ptr < nevents && !match(events[*ptr].type))
+		(*ptr)++;
+	if (*ptr == nevents || events[*ptr].cycle > inputlog_clock())
+		return NULL;
+	return events + *ptr;
+}
+
+static int is_tty(char type)
+{
+	return type == EV_TTY;
+}
+
+static int is_key(char type)
+{
+	return type == EV_DOWN || type == EV_UP;
+}
+
+/*
+ *	Filter the ready bits from a check_chario style poll. Bit 0 is
+ *	input ready, the others are passed through.
+ */
+unsigned inputlog_chario(unsigned r)
+{
+	switch(inputlog_mode) {
+	case INPUTLOG_RECORD:
+		if ((r & 1) && !tty_pending) {
+			tty_pending = 1;
+			tty_arrival = inputlog_clock();
+		}
+		break;
+	case INPUTLOG_REPLAY:
+		r &= ~1;
+		if (inputlog_due(&tty_next, is_tty))
+			r |= 1;
+		break;
+	}
+	return r;
+}
+
+/*
+ *	Pass a console byte through the log. When recording the byte
+ *	read is logged. When replaying the caller does not read the
+ *	console and we return the logged byte instead.
+ */
+unsigned inputlog_char(unsigned c)
+{
+	struct inputlog_ev *ev;
+
+	switch(inputlog_mode) {
+	case INPUTLOG_RECORD:
+		/* Read without a ready poll first */
+		if (!tty_pending)
+			tty_arrival = inputlog_clock();
+		tty_pending = 0;
+		fprintf(inputlog_fp, "%llu %c %02X\n",
+			(unsigned long long)tty_arrival, EV_TTY, c & 0xFF);
+		fflush(inputlog_fp);
+		break;
+	case INPUTLOG_REPLAY:
+		ev = inputlog_due(&tty_next, is_tty);
+		if (ev) {
+			tty_last = ev->val;
+			tty_next++;
+		}
+		c = tty_last;
+		break;
+	}
+	return c;
+}
+
+void inputlog_key_record(struct inputlog_key *k)
+{
+	if (inputlog_mode != INPUTLOG_RECORD)
+		return;
+	fprintf(inputlog_fp, "%llu %c %d %u %u\n",
+		(unsigned long long)inputlog_clock(), k->up ? EV_UP : EV_DOWN,
+		(int)k->sym, k->scancode, k->mod);
+	fflush(inputlog_fp);
+}
+
+/* Returns 1 and fills in k for each logged key event now due */
+int inputlog_key_replay(struct inputlog_key *k)
+{
+	struct inputlog_ev *ev;
+
+	if (inputlog_mode != INPUTLOG_REPLAY)
+		return 0;
+	ev = inputlog_due(&key_next, is_key);
+	if (ev == NULL)
+		return 0;
+	*k = ev->key;
+	key_next++;
+	return 1;
+}
+
+/*
+ *	Wrap a serial device so that its input goes through the log. Output
+ *	is passed straight through.
+ */
+static unsigned inputlog_sready(struct serial_device *dev)
+{
+	return inputlog_chario(inputlog_dev->ready(inputlog_dev));
+}
+
+static uint8_t inputlog_sget(struct serial_device *dev)
+{
+	if (inputlog_mode == INPUTLOG_REPLAY)
+		return inputlog_char(0);
+	return inputlog_char(inputlog_dev->get(inputlog_dev));
+}
+
+static void inputlog_sput(struct serial_device *dev, uint8_t c)
+{
+	inputlog_dev->put(inputlog_dev, c);
+}
+
+static struct serial_device inputlog_serialdev = {
+	"Console (logged)",
+	NULL,
+	inputlog_sget,
+	inputlog_sput,
+	inputlog_sready
+};
+
+struct serial_device *inputlog_serial(struct serial_device *dev)
+{
+	if (inputlog_mode == INPUTLOG_OFF)
+		return dev;
+	inputlog_dev = dev;
+	return &inputlog_serialdev;
+}
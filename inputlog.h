@@ -0,0 +1,34 @@
+/*
+ *	Console and keyboard input record/replay
+ *
+ *	In record mode each input byte or key event is logged against the
+ *	emulated cycle count at which the machine first saw it. In replay
+ *	mode the live input is ignored and the logged input is presented
+ *	at exactly the same cycles, so a run executes the same instruction
+ *	stream every time.
+ */
+
+#include <stdint.h>
+
+#define INPUTLOG_OFF		0
+#define INPUTLOG_RECORD		1
+#define INPUTLOG_REPLAY		2
+
+/* A key event, kept free of SDL types so non SDL builds can link it */
+struct inputlog_key {
+	unsigned up;
+	int32_t sym;
+	uint16_t scancode;
+	uint16_t mod;
+};
+
+struct serial_device;
+
+extern unsigned inputlog_mode;
+
+extern void inputlog_init(const char *path, unsigned mode, uint64_t (*clock)(void));
+extern unsigned inputlog_chario(unsigned r);
+extern unsigned inputlog_char(unsigned c);
+extern struct serial_device *inputlog_serial(struct serial_device *dev);
+extern void inputlog_key_record(struct inputlog_key *k);
+extern int inputlog_key_replay(struct inputlog_key *k);
@@ -0,0 +1,9 @@
+#ifndef LIB65816_CONFIG_H
+#define LIB65816_CONFIG_H
+/* DO NOT MODIFY THIS FILE; THIS FILE IS AUTOMATICALLY GENERATED. */
+
+#define SIZEOF_LONG  8
+#define SIZEOF_INT   4
+#define SIZEOF_SHORT 2
+#define DEBUG        1
+#endif
@@ -175,7 +175,9 @@ debug_resume:
     if (cpu_nmi) goto nmi;
     if (cpu_irq) goto irq;
 irq_return:
-    if (cpu_wait) { cpu_cycle_count++; goto dispatch; }
+    /* WAI: nothing changes until E_UPDATE raises an interrupt so go
+       straight to the next update */
+    if (cpu_wait) { cpu_cycle_count = next_update; goto dispatch; }
     opcode = M_READ_OPCODE(PC.A);
     PC.W.PC++;
 
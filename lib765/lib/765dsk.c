@@ -61,25 +61,165 @@ fdc_byte fdd_drive_status(FLOPPY_DRIVE *fd)
 }
 
 
-/* Reset variables: No DSK loaded. Called on eject and on initialisation */
+/* Images that are open, so dirty tracks can be written back at exit */
+static DSK_FLOPPY_DRIVE *fdd_open_list;
+static int fdd_atexit_done;
+
+static void fdd_close(DSK_FLOPPY_DRIVE *fdd);
+
+/* Reset variables: No DSK loaded. Called on eject and on initialisation.
+ * Anything still loaded is written back and taken off the open list
+ * first, so this is safe on a drive in use */
 static void fdd_reset(FLOPPY_DRIVE *fd)
 {
 	DSK_FLOPPY_DRIVE *fdd = (DSK_FLOPPY_DRIVE *)fd;
 
+	if (fdd->fdd_fp) fdd_close(fdd);
         fdd->fdd_filename[0] = 0;
         fdd->fdd_fp = NULL;
         memset(fdd->fdd_disk_header,  0, sizeof(fdd->fdd_disk_header));
-        memset(fdd->fdd_track_header, 0, sizeof(fdd->fdd_track_header));
+        memset(fdd->fdd_track_dirty,  0, sizeof(fdd->fdd_track_dirty));
+	fdd->fdd_track_header = NULL;
+	fdd->fdd_image = NULL;
+	fdd->fdd_image_len = 0;
+	fdd->fdd_header_dirty = 0;
+	fdd->fdd_cur_track = -1;
+}
+
+
+/* Work out where each CPCEMU "track" starts in the file. This only changes
+ * when the DSK header does (on load and on format) so the sector paths
+ * never walk the EXTENDED track size table. */
+static void fdd_index_tracks(DSK_FLOPPY_DRIVE *fdd)
+{
+	fdc_byte *b = fdd->fdd_disk_header + 0x34;
+	long trk_offset = 256;	/* DSK header = 256 bytes */
+	long trk_len;
+	int ext = !memcmp(fdd->fdd_disk_header, "EXTENDED", 8);
+	int nt;
+
+	/* Normal; all tracks have the same length */
+	trk_len = (fdd->fdd_disk_header[0x33] * 256);
+	trk_len += fdd->fdd_disk_header[0x32];
+
+	for (nt = 0; nt < DSK_MAX_TRACKS; nt++)
+	{
+		if (ext) trk_len = 256 * (1 + b[nt]);
+		fdd->fdd_track_offset[nt] = trk_offset;
+		trk_offset += trk_len;
+	}
+	/* Any cached track header may have moved */
+	fdd->fdd_track_header = NULL;
+	fdd->fdd_cur_track = -1;
+}
+
+
+/* Make sure the image covers len bytes. The file itself grows when the
+ * track is written back. */
+static int fdd_image_grow(DSK_FLOPPY_DRIVE *fdd, long len)
+{
+	fdc_byte *p;
+
+	if (len <= fdd->fdd_image_len) return 0;
+	p = realloc(fdd->fdd_image, len);
+	if (!p) return -1;
+	memset(p + fdd->fdd_image_len, 0, len - fdd->fdd_image_len);
+	fdd->fdd_image = p;
+	fdd->fdd_image_len = len;
+	if (fdd->fdd_cur_track >= 0)
+		fdd->fdd_track_header = p + 
+			fdd->fdd_track_offset[fdd->fdd_cur_track];
+	return 0;
+}
+
+
+/* Copy out of the image, returning how much of it was there */
+static long fdd_image_read(DSK_FLOPPY_DRIVE *fdd, long pos, fdc_byte *buf,
+			   long len)
+{
+	if (pos >= fdd->fdd_image_len) return 0;
+	if (pos + len > fdd->fdd_image_len) len = fdd->fdd_image_len - pos;
+	memcpy(buf, fdd->fdd_image + pos, len);
+	return len;
+}
+
+
+/* Note that part of a track has changed */
+static void fdd_track_touch(DSK_FLOPPY_DRIVE *fdd, int track, long end)
+{
+	if (fdd->fdd_track_dirty[track] < end)
+		fdd->fdd_track_dirty[track] = end;
+	fdd->fdd_dirty = 1;
+}
+
+
+/* Write changed tracks and the DSK header back to the file */
+static void fdd_flush(DSK_FLOPPY_DRIVE *fdd)
+{
+	long offs, len;
+	int nt;
+
+	if (!fdd->fdd_fp) return;
+	for (nt = 0; nt < DSK_MAX_TRACKS; nt++)
+	{
+		if (!fdd->fdd_track_dirty[nt]) continue;
+		offs = fdd->fdd_track_offset[nt];
+		len  = fdd->fdd_track_dirty[nt] - offs;
+		fdd->fdd_track_dirty[nt] = 0;
+		if (fseek(fdd->fdd_fp, offs, SEEK_SET) ||
+		    fwrite(fdd->fdd_image + offs, 1, len, fdd->fdd_fp) < len)
+			fdc_dprintf(0, "Could not write track %d of %s\n",
+					nt, fdd->fdd_filename);
+	}
+	if (fdd->fdd_header_dirty)
+	{
+		fdd->fdd_header_dirty = 0;
+		if (fseek(fdd->fdd_fp, 0, SEEK_SET) ||
+		    fwrite(fdd->fdd_disk_header, 1, 256, fdd->fdd_fp) < 256)
+			fdc_dprintf(0, "Could not write DSK header of %s\n",
+					fdd->fdd_filename);
+	}
+	fflush(fdd->fdd_fp);
+}
+
+
+static void fdd_flush_all(void)
+{
+	DSK_FLOPPY_DRIVE *fdd;
+
+	for (fdd = fdd_open_list; fdd; fdd = fdd->fdd_next)
+		fdd_flush(fdd);
 }
 
 
+/* Write back and discard the image. The caller resets the rest */
+static void fdd_close(DSK_FLOPPY_DRIVE *fdd)
+{
+	DSK_FLOPPY_DRIVE **p;
+
+	fdd_flush(fdd);
+	for (p = &fdd_open_list; *p; p = &(*p)->fdd_next)
+	{
+		if (*p == fdd)
+		{
+			*p = fdd->fdd_next;
+			break;
+		}
+	}
+	if (fdd->fdd_fp) fclose(fdd->fdd_fp);
+	free(fdd->fdd_image);
+	fdd->fdd_fp = NULL;
+	fdd->fdd_image = NULL;
+}
+
 
 /* Return 1 if this drive is ready, else 0
- * Attempts to open the DSK and load its DSK header, and must
+ * Attempts to open the DSK and load it into memory, and must
  * therefore be called before any attempted DSK file access. */
 static int fdd_isready(FLOPPY_DRIVE *fd)
 {
 	DSK_FLOPPY_DRIVE *fdd = (DSK_FLOPPY_DRIVE *)fd;
+	long len;
 
 	if (!fd->fd_motor) return 0;	/* Motor is not running */
 
@@ -103,41 +243,61 @@ static int fdd_isready(FLOPPY_DRIVE *fd)
 		fdd_reset(fd);
 		return 0;
 	}
-/* File has been newly opened. Read in its header */
-	fseek(fdd->fdd_fp, 0, SEEK_SET);
-	if (fread(fdd->fdd_disk_header, 1, 256, fdd->fdd_fp) < 256)
+/* File has been newly opened. Read all of it in */
+	len = -1;
+	if (fseek(fdd->fdd_fp, 0, SEEK_END) == 0)
+		len = ftell(fdd->fdd_fp);
+	if (len < 256 || fseek(fdd->fdd_fp, 0, SEEK_SET))
 	{
 		fdc_dprintf(0, "Could not load DSK file header: %s\n", 
 				fdd->fdd_filename);
+		fdd_close(fdd);
 		fdd_reset(fd);
 		return 0;	
 	}
+	fdd->fdd_image = malloc(len);
+	if (!fdd->fdd_image || 
+	    fread(fdd->fdd_image, 1, len, fdd->fdd_fp) < len)
+	{
+		fdc_dprintf(0, "Could not load DSK file: %s\n", 
+				fdd->fdd_filename);
+		fdd_close(fdd);
+		fdd_reset(fd);
+		return 0;
+	}
+	fdd->fdd_image_len = len;
+	memcpy(fdd->fdd_disk_header, fdd->fdd_image, 256);
 	if (memcmp("MV - CPC", fdd->fdd_disk_header, 8) &&
 	    memcmp("EXTENDED", fdd->fdd_disk_header, 8)) 
 	{
 		fdc_dprintf(0, "File %s is not in DSK or extended DSK format\n",
 				fdd->fdd_filename);
+		fdd_close(fdd);
 		fdd_reset(fd);
 		return 0;
 	} 
 /* File loaded OK. */
-	fdd->fdd_track_header[0] = 0;	/* Track header not loaded */
-	
+	fdd_index_tracks(fdd);
+
+	fdd->fdd_next = fdd_open_list;
+	fdd_open_list = fdd;
+	if (!fdd_atexit_done)
+	{
+		atexit(fdd_flush_all);
+		fdd_atexit_done = 1;
+	}
         return 1;
 }
 
-/* Find the offset in a DSK for a particular cylinder/head. 
+/* Find the CPCEMU track number for a particular cylinder/head. 
  *
  * CPCEMU DSK files work in "tracks". For a single-sided disk, track number
  * is the same as cylinder number. For a double-sided disk, track number is
  * (2 * cylinder + head). This is independent of disc format.
  */
-static long fdd_lookup_track(DSK_FLOPPY_DRIVE *fdd, int cylinder, int head)
+static int fdd_lookup_track(DSK_FLOPPY_DRIVE *fdd, int cylinder, int head)
 {
-	fdc_byte *b;
 	int track;
-	long trk_offset;
-	int nt;
 	if (!fdd->fdd_fp) return -1;
 
 	/* Seek off the edge of the drive */
@@ -161,41 +321,19 @@ static long fdd_lookup_track(DSK_FLOPPY_DRIVE *fdd, int cylinder, int head)
 	if (fdd->fdd_disk_header[0x31] > 1) track *= 2;
 	track += head;
 
-        /* Look up the cylinder and head using the header. This behaves 
-         * differently in normal and extended DSK files */
-	
-	if (!memcmp(fdd->fdd_disk_header, "EXTENDED", 8))
-	{
-		trk_offset = 256;	/* DSK header = 256 bytes */
-		b = fdd->fdd_disk_header + 0x34;
-		for (nt = 0; nt < track; nt++)
-		{
-			trk_offset += 256 * (1 + b[nt]);
-		}
-	}
-	else	/* Normal; all tracks have the same length */
-	{
-		trk_offset = (fdd->fdd_disk_header[0x33] * 256);
-		trk_offset += fdd->fdd_disk_header[0x32];
-
-		trk_offset *= track;		/* No. of tracks */
-		trk_offset += 256;		/* DSK header */	
-	}
-	return trk_offset;
+	if (track >= DSK_MAX_TRACKS) return -1;
+	return track;
 }
 
 
 static unsigned char *sector_head(DSK_FLOPPY_DRIVE *fdd, int sector)
 {
-        int ms = fdd->fdd_track_header[0x15];
-        int sec;
+	int n;
 
-        for (sec = 0; sec < ms; sec++)
-        {
-                if (fdd->fdd_track_header[0x1A + 8 * sec] == sector)
-                        return fdd->fdd_track_header + 0x18 + 8 * sec;
-        }
-        return NULL;
+	if (sector < 0 || sector > 255) return NULL;
+	n = fdd->fdd_sector_map[sector];
+	if (n < 0) return NULL;
+	return fdd->fdd_track_header + 0x18 + 8 * n;
 }
 
 
@@ -210,7 +348,7 @@ static unsigned char *sector_head(DSK_FLOPPY_DRIVE *fdd, int sector)
 static fd_err_t fdd_seek_cylinder(FLOPPY_DRIVE *fd, int cylinder)
 {
 	int req_cyl = cylinder;
-	long nr;
+	int nr;
         DSK_FLOPPY_DRIVE *fdd = (DSK_FLOPPY_DRIVE *)fd;
 
 	fdc_dprintf(4, "fdd_seek_cylinder: cylinder=%d\n",cylinder);
@@ -230,20 +368,51 @@ static fd_err_t fdd_seek_cylinder(FLOPPY_DRIVE *fd, int cylinder)
 	return 0;
 }
 
-/* Load the "Track-Info" header for the current cylinder and given head */
+/* Find the "Track-Info" header for the current cylinder and given head,
+ * and index its sectors. This is a no-op if it is already the current
+ * track. */
 static fd_err_t fdd_load_track_header(DSK_FLOPPY_DRIVE *fdd, int head)
 {
-        long track = fdd_lookup_track(fdd, fdd->fdd.fd_cylinder, head);
+        int track = fdd_lookup_track(fdd, fdd->fdd.fd_cylinder, head);
+	fdc_byte *th, *secid;
+	long offs, pos;
+	int n, maxsec, seclen;
+
         if (track < 0) return FD_E_SEEKFAIL;       /* Bad track */
-        fseek(fdd->fdd_fp, track, SEEK_SET);
-        if (fread(fdd->fdd_track_header, 1, 256, fdd->fdd_fp) < 256)
+	if (track == fdd->fdd_cur_track) return 0;
+
+	offs = fdd->fdd_track_offset[track];
+	if (offs + 256 > fdd->fdd_image_len)
                 return FD_E_NOADDR;              /* Missing address mark */
-        if (memcmp(fdd->fdd_track_header, "Track-Info", 10))
+	th = fdd->fdd_image + offs;
+        if (memcmp(th, "Track-Info", 10))
         {
                 fdc_dprintf(0, "FDC: Did not find track %d header at 0x%lx in %s\n",
-                        fdd->fdd.fd_cylinder, track, fdd->fdd_filename);
+                        fdd->fdd.fd_cylinder, offs, fdd->fdd_filename);
                 return FD_E_NOADDR;
         }
+	fdd->fdd_track_header = th;
+	fdd->fdd_cur_track = track;
+
+	/* Sector data follows the header in ID order. Extended DSKs have
+	 * individual sector sizes. If an ID repeats the first one wins. */
+	memset(fdd->fdd_sector_map, -1, sizeof(fdd->fdd_sector_map));
+	maxsec = th[0x15];
+	if (maxsec > DSK_MAX_SECTORS) maxsec = DSK_MAX_SECTORS;
+	seclen = (0x80 << th[0x14]);
+	pos = offs + 256;
+	secid = th + 0x18;
+	for (n = 0; n < maxsec; n++)
+	{
+		if (!memcmp(fdd->fdd_disk_header, "EXTENDED", 8))
+			seclen = secid[7] + 256 * secid[8];
+		if (fdd->fdd_sector_map[secid[2]] < 0)
+			fdd->fdd_sector_map[secid[2]] = n;
+		fdd->fdd_sector_pos[n] = pos;
+		fdd->fdd_sector_len[n] = seclen;
+		pos   += seclen;
+		secid += 8;
+	}
 	return 0;
 }
 
@@ -265,62 +434,23 @@ static fd_err_t fdd_read_id(FLOPPY_DRIVE *fd, int head, int sector, fdc_byte *bu
 }
 
 
-/* Find the offset of a sector in the current track 
- * Enter with fdd_track_header loaded and the file pointer 
- * just after it (ie, you have just called fdd_load_track_header() ) */
-
-static long fdd_sector_offset(DSK_FLOPPY_DRIVE *fdd, int sector, int *seclen,
-			      fdc_byte **secid)
-{
-	int maxsec = fdd->fdd_track_header[0x15];
-	long offset = 0;
-	int n;
-
-	/* Pointer to sector details */
-	*secid = fdd->fdd_track_header + 0x18;
-
-	/* Length of sector */	
-	*seclen = (0x80 << fdd->fdd_track_header[0x14]);
-
-	/* Extended DSKs have individual sector sizes */
-	if (!memcmp(fdd->fdd_disk_header, "EXTENDED", 8))
-	{
-		for (n = 0; n < maxsec; n++)
-		{
-			*seclen = (*secid)[7] + 256 * (*secid)[8];
-                       if ((*secid)[2] == sector) return offset;
-			offset   += (*seclen);
-			(*secid) += 8;
-		}
-	}
-	else	/* Non-extended, all sector sizes are the same */
-	{
-		for (n = 0; n < maxsec; n++)
-		{
-			if ((*secid)[2] == sector) return offset;
-			offset   += (*seclen);
-			(*secid) += 8;
-		}
-	}
-	return -1;	/* Sector not found */
-}
-
-
-
-/* Seek within the DSK file to a given head & sector in the current cylinder.
- * Then check that "xhead" and "xcylinder" match the sector's ID fields */
+/* Find a given head & sector in the current cylinder and return where
+ * its data lives in the image. Then check that "xhead" and "xcylinder"
+ * match the sector's ID fields */
 static fd_err_t fdd_seekto_sector(FLOPPY_DRIVE *fd, int xcylinder, int xhead,
-		int head, int sector, fdc_byte *buf, int *len)
+		int head, int sector, int *len, long *pos)
 {
         DSK_FLOPPY_DRIVE *fdd = (DSK_FLOPPY_DRIVE *)fd;
-        int n, offs, seclen;
+        int n, seclen;
 	fd_err_t err = FD_E_OK;
 	fdc_byte *secid;
 
         n = fdd_load_track_header(fdd, head);
         if (n < 0) return n;
-	offs = fdd_sector_offset(fdd, sector, &seclen, &secid);
-	if (offs < 0) return FD_E_NOSECTOR;	/* Sector not found */
+	secid = sector_head(fdd, sector);
+	if (!secid) return FD_E_NOSECTOR;	/* Sector not found */
+	n = fdd->fdd_sector_map[sector];
+	seclen = fdd->fdd_sector_len[n];
 
 	if (xcylinder != secid[0] || xhead != secid[1])
 	{
@@ -338,8 +468,7 @@ static fd_err_t fdd_seekto_sector(FLOPPY_DRIVE *fd, int xcylinder, int xhead,
 		err = FD_E_DATAERR;
 		seclen = *len;
 	}	
-	offs += ftell(fdd->fdd_fp);	
-	fseek(fdd->fdd_fp, offs, SEEK_SET);				
+	*pos = fdd->fdd_sector_pos[n];
 	return err;			
 }
 
@@ -354,6 +483,7 @@ static fd_err_t fdd_read_sector(FLOPPY_DRIVE *fd, int xcylinder, int xhead,
         DSK_FLOPPY_DRIVE *fdd = (DSK_FLOPPY_DRIVE *)fd;
 	unsigned char *sh;
 	fd_err_t err;
+	long pos;
 
 	fdc_dprintf(4, "fdd_read_sector: Expected cyl=%d head=%d sector=%d\n",
 			xcylinder, xhead, sector);
@@ -362,7 +492,7 @@ static fd_err_t fdd_read_sector(FLOPPY_DRIVE *fd, int xcylinder, int xhead,
 	do
 	{
 		err  = fdd_seekto_sector(fd,xcylinder,xhead,head,
-							sector,buf,&len);
+							sector,&len,&pos);
 /* Are we retrying because we are looking for deleted data and found 
  * nondeleted or vice versa?
  *
@@ -391,7 +521,7 @@ static fd_err_t fdd_read_sector(FLOPPY_DRIVE *fd, int xcylinder, int xhead,
                         }
 			else *deleted = 1;
                 }
-		if (fread(buf, 1, len, ((DSK_FLOPPY_DRIVE *)fd)->fdd_fp) < len) 
+		if (fdd_image_read(fdd, pos, buf, len) < len) 
 			err = FD_E_DATAERR;
 	} while (try_again);
 	return err;
@@ -440,7 +570,10 @@ static fd_err_t fdd_read_track(FLOPPY_DRIVE *fd, int xcylinder, int xhead,
 
         if (err == FD_E_DATAERR || err == FD_E_OK)
         {
-                if (fread(buf, 1, trklen, fdd->fdd_fp) < (*len))
+		/* The track data follows its header */
+                if (fdd_image_read(fdd, 
+			fdd->fdd_track_offset[fdd->fdd_cur_track] + 256,
+			buf, trklen) < (*len))
 			err = FD_E_DATAERR;
         }
         return err;
@@ -455,35 +588,31 @@ static fd_err_t fdd_write_sector(FLOPPY_DRIVE *fd, int xcylinder, int xhead,
 {
 	fd_err_t err;
 	DSK_FLOPPY_DRIVE *fdd = (DSK_FLOPPY_DRIVE *)fd;
+	long pos;
 
         fdc_dprintf(4, "fdd_write_sector: Expected cyl=%d head=%d sector=%d\n",
                         xcylinder, xhead, sector);
 
-	err = fdd_seekto_sector(fd,xcylinder,xhead,head,sector,buf,
-						&len);
+	err = fdd_seekto_sector(fd,xcylinder,xhead,head,sector,&len,&pos);
 
 	if (fd->fd_readonly) return FD_E_READONLY;
 	if (err == FD_E_DATAERR || err == 0)
 	{
-                unsigned char odel, *sh = sector_head(fdd, sector);
-		if (fwrite(buf, 1, len, fdd->fdd_fp) < len)
-			err = FD_E_READONLY;
-		fdd->fdd_dirty = 1;
+                unsigned char *sh;
+		long end = pos + len;
+
+		/* The header is part of the track so is written back
+		 * with it if the deleted flag changes */
+		if (fdd_image_grow(fdd, end)) return FD_E_READONLY;
+		memcpy(fdd->fdd_image + pos, buf, len);
+		if (end < fdd->fdd_track_offset[fdd->fdd_cur_track] + 256)
+			end = fdd->fdd_track_offset[fdd->fdd_cur_track] + 256;
+		fdd_track_touch(fdd, fdd->fdd_cur_track, end);
 
 /* If writing deleted data, update the sector header accordingly */
-                odel = sh[5];
+                sh = sector_head(fdd, sector);
                 if (deleted) sh[5] |= 0x40;
                 else         sh[5] &= ~0x40;
-
-                if (sh[5] != odel)
-                {
-                        long track = fdd_lookup_track(fdd, fd->fd_cylinder, head);
-                        if (track < 0) return FD_E_SEEKFAIL;       /* Bad track */
-                        fseek(fdd->fdd_fp, track, SEEK_SET);
-                        if (fwrite(fdd->fdd_track_header, 1, 256, fdd->fdd_fp) < 256)
-                                return FD_E_DATAERR; 
-                }
-
 	}
 	return err;
 }
@@ -496,6 +625,7 @@ static fd_err_t fdd_format_track(FLOPPY_DRIVE *fd, int head,
 	DSK_FLOPPY_DRIVE *fdd = (DSK_FLOPPY_DRIVE *)fd;
 	int n, img_trklen, trklen, trkoff, trkno, ext, seclen;
 	fdc_byte oldhead[256];     
+	fdc_byte *th;
 
         fdc_dprintf(4, "fdd_format_track: head=%d sectors=%d\n",
                         head, sectors); 
@@ -523,6 +653,11 @@ static fd_err_t fdd_format_track(FLOPPY_DRIVE *fd, int head,
 	trkno = fd->fd_cylinder;
 	trkno *= fdd->fdd_disk_header[0x31];
 	trkno += head;
+	if (trkno >= DSK_MAX_TRACKS)
+	{
+		memcpy(fdd->fdd_disk_header, oldhead, 256);
+		return FD_E_READONLY;
+	}
 
 	printf("fdc_format: %d, %d -> %d [%d]\n", fd->fd_cylinder, head, trkno,
 		sectors);
@@ -601,66 +736,50 @@ static fd_err_t fdd_format_track(FLOPPY_DRIVE *fd, int head,
 	}
 	printf("trklen=%x trkno=%d img_trklen=%x trkoff=%x\n", 
 		trklen, trkno, img_trklen, trkoff);
-/* Seek to the track. Note: We do NOT double-step while formatting, because
+/* Find the track. Note: We do NOT double-step while formatting, because
  * we can't tell between a DSK with 40 tracks that's finished, and one with
  * 40 tracks that will grow to 80 tracks */
-	fseek(fdd->fdd_fp, trkoff, SEEK_SET);
-	/* Now generate and write a Track-Info buffer */
-	memset(fdd->fdd_track_header, 0, sizeof(fdd->fdd_track_header));
-
-	strcpy((char *)fdd->fdd_track_header, "Track-Info\r\n");	
-	
-	fdd->fdd_track_header[0x10] = fd->fd_cylinder;
-	fdd->fdd_track_header[0x11] = head;
-	fdd->fdd_track_header[0x14] = track[3];
-	fdd->fdd_track_header[0x15] = sectors;
-	fdd->fdd_track_header[0x16] = track[2];
-	fdd->fdd_track_header[0x17] = filler;
-	for (n = 0; n < sectors; n++)
-	{
-		fdd->fdd_track_header[0x18 + 8*n] = track[4*n];
-		fdd->fdd_track_header[0x19 + 8*n] = track[4*n+1];
-		fdd->fdd_track_header[0x1A + 8*n] = track[4*n+2];
-		fdd->fdd_track_header[0x1B + 8*n] = track[4*n+3];
-		if (ext)
-		{
-			seclen = 128 << track[4 * n + 3];
-			fdd->fdd_track_header[0x1E + 8 * n] = seclen & 0xFF;
-			fdd->fdd_track_header[0x1F + 8 * n] = seclen >> 8;
-		}
-	}
-	if (fwrite(fdd->fdd_track_header, 1, 256, fdd->fdd_fp) < 256)
+	if (fdd_image_grow(fdd, trkoff + trklen))
 	{
 		memcpy(fdd->fdd_disk_header, oldhead, 256);
 		return FD_E_READONLY;
 	}
-	fdd->fdd_dirty = 1;
+	/* Now generate a Track-Info buffer */
+	th = fdd->fdd_image + trkoff;
+	memset(th, 0, 256);
 
-	/* Track header written. Write sectors */
+	strcpy((char *)th, "Track-Info\r\n");	
+	
+	th[0x10] = fd->fd_cylinder;
+	th[0x11] = head;
+	th[0x14] = track[3];
+	th[0x15] = sectors;
+	th[0x16] = track[2];
+	th[0x17] = filler;
 	for (n = 0; n < sectors; n++)
 	{
-		int m;
-		seclen = 128 << track[4 * n + 3];
-		for (m = 0; m < seclen; m++)
+		th[0x18 + 8*n] = track[4*n];
+		th[0x19 + 8*n] = track[4*n+1];
+		th[0x1A + 8*n] = track[4*n+2];
+		th[0x1B + 8*n] = track[4*n+3];
+		if (ext)
 		{
-			if (fputc(filler, fdd->fdd_fp) == EOF) 
-			{
-				memcpy(fdd->fdd_disk_header, oldhead, 256);
-				return FD_E_READONLY;
-			}
+			seclen = 128 << track[4 * n + 3];
+			th[0x1E + 8 * n] = seclen & 0xFF;
+			th[0x1F + 8 * n] = seclen >> 8;
 		}
 	}
+	/* Track header done. Fill the sectors */
+	memset(th + 256, filler, trklen - 256);
+
 	if (fd->fd_cylinder >= fdd->fdd_disk_header[0x30])
 	{
 		fdd->fdd_disk_header[0x30] = fd->fd_cylinder + 1;
 	}
-	/* Track formatted OK. Now write back the modified DSK header */
-	fseek(fdd->fdd_fp, 0, SEEK_SET);
-	if (fwrite(fdd->fdd_disk_header, 1, 256, fdd->fdd_fp) < 256)
-	{
-		memcpy(fdd->fdd_disk_header, oldhead, 256);
-		return FD_E_READONLY;
-	}
+	/* Track formatted OK. The DSK header is written back with it */
+	fdd->fdd_header_dirty = 1;
+	fdd_index_tracks(fdd);
+	fdd_track_touch(fdd, trkno, trkoff + trklen);
 	return FD_E_OK;
 }
 
@@ -671,12 +790,12 @@ static int fdd_dirty(FLOPPY_DRIVE *fd)
 	return fdd->fdd_dirty ? FD_D_DIRTY : FD_D_CLEAN;
 }
 
-/* Eject a DSK - close the image file */
+/* Eject a DSK - write back any changes and close the image file */
 static void fdd_eject(FLOPPY_DRIVE *fd)
 {
         DSK_FLOPPY_DRIVE *fdd = (DSK_FLOPPY_DRIVE *)fd;
 
-	if (fdd->fdd_fp) fclose(fdd->fdd_fp);
+	if (fdd->fdd_fp) fdd_close(fdd);
 
 	fdd_reset(fd);
 }
@@ -702,8 +821,13 @@ static FLOPPY_DRIVE_VTABLE fdv_dsk =
 FDRV_PTR fd_newdsk(void)
 {
 	FDRV_PTR p = fd_inew(sizeof(DSK_FLOPPY_DRIVE));
+	DSK_FLOPPY_DRIVE *fdd = (DSK_FLOPPY_DRIVE *)p;
 
 	p->fd_vtable = &fdv_dsk;
+	/* Nothing is loaded and it is not on the open list yet */
+	fdd->fdd_fp = NULL;
+	fdd->fdd_image = NULL;
+	fdd->fdd_next = NULL;
 	fd_reset(p);
 	return p;
 }
@@ -88,6 +88,9 @@ typedef struct floppy_drive
 /* Subclass of FLOPPY_DRIVE: a drive which emulates discs using the CPCEMU 
  * .DSK format */
 
+#define DSK_MAX_TRACKS	204	/* Size of the EXTENDED track size table */
+#define DSK_MAX_SECTORS	29	/* Sector IDs that fit in a Track-Info block */
+
 typedef struct dsk_floppy_drive
 {
 /* PUBLIC variables: */
@@ -98,8 +101,21 @@ typedef struct dsk_floppy_drive
 /* PRIVATE variables: */
 	FILE *fdd_fp;			/* File of the .DSK file */
 	fdc_byte fdd_disk_header[256];	/* .DSK header */
-	fdc_byte fdd_track_header[256];	/* .DSK track header */
+	fdc_byte *fdd_track_header;	/* .DSK track header, in fdd_image */
 	int fdd_dirty;			/* Has this disk been written to? */
+	/* The whole file is held in memory. Tracks that are written are
+	 * marked dirty and copied back to the file on eject or exit */
+	fdc_byte *fdd_image;		/* File contents, at file offsets */
+	long fdd_image_len;
+	long fdd_track_offset[DSK_MAX_TRACKS];	/* From the DSK header */
+	long fdd_track_dirty[DSK_MAX_TRACKS];	/* End of dirty data or 0 */
+	int fdd_header_dirty;
+	/* Sector index for the track whose header is loaded */
+	int fdd_cur_track;		/* -1 if none */
+	signed char fdd_sector_map[256];	/* Sector ID to slot, or -1 */
+	long fdd_sector_pos[DSK_MAX_SECTORS];
+	int fdd_sector_len[DSK_MAX_SECTORS];
+	struct dsk_floppy_drive *fdd_next;	/* Open images, for exit */
 } DSK_FLOPPY_DRIVE;
 
 #ifdef DSK_ERR_OK	/* LIBDSK headers included */
@@ -0,0 +1,5397 @@
+static void ADC_A_off_HL (Z180Context* ctx)
+{
+	BR.A = doArithmetic(ctx, read8(ctx, WR.HL), F1_ADC, F2_ADC);
+}
+
+
+static void ADC_A_off_IX_d (Z180Context* ctx)
+{
+	ctx->tstates += 5;
+	signed char displacement = read8(ctx, ctx->PC++);
+	BR.A = doArithmetic(ctx, read8(ctx, WR.IX + displacement), F1_ADC, F2_ADC);
+	
+}
+
+
+static void ADC_A_off_IY_d (Z180Context* ctx)
+{
+	ctx->tstates += 5;
+	signed char displacement = read8(ctx, ctx->PC++);
+	BR.A = doArithmetic(ctx, read8(ctx, WR.IY + displacement), F1_ADC, F2_ADC);
+	
+}
+
+
+static void ADC_A_A (Z180Context* ctx)
+{
+	BR.A = doArithmetic(ctx, BR.A, F1_ADC, F2_ADC);
+}
+
+
+static void ADC_A_B (Z180Context* ctx)
+{
+	BR.A = doArithmetic(ctx, BR.B, F1_ADC, F2_ADC);
+}
+
+
+static void ADC_A_C (Z180Context* ctx)
+{
+	BR.A = doArithmetic(ctx, BR.C, F1_ADC, F2_ADC);
+}
+
+
+static void ADC_A_D (Z180Context* ctx)
+{
+	BR.A = doArithmetic(ctx, BR.D, F1_ADC, F2_ADC);
+}
+
+
+static void ADC_A_E (Z180Context* ctx)
+{
+	BR.A = doArithmetic(ctx, BR.E, F1_ADC, F2_ADC);
+}
+
+
+static void ADC_A_H (Z180Context* ctx)
+{
+	BR.A = doArithmetic(ctx, BR.H, F1_ADC, F2_ADC);
+}
+
+
+static void ADC_A_L (Z180Context* ctx)
+{
+	BR.A = doArithmetic(ctx, BR.L, F1_ADC, F2_ADC);
+}
+
+
+static void ADC_A_n (Z180Context* ctx)
+{
+	BR.A = doArithmetic(ctx, read8(ctx, ctx->PC++), F1_ADC, F2_ADC);
+}
+
+
+static void ADC_HL_BC (Z180Context* ctx)
+{
+	ctx->tstates += 7;
+	WR.HL = doAddWord(ctx, WR.HL, WR.BC, F1_ADC, F2_ADC);
+}
+
+
+static void ADC_HL_DE (Z180Context* ctx)
+{
+	ctx->tstates += 7;
+	WR.HL = doAddWord(ctx, WR.HL, WR.DE, F1_ADC, F2_ADC);
+}
+
+
+static void ADC_HL_HL (Z180Context* ctx)
+{
+	ctx->tstates += 7;
+	WR.HL = doAddWord(ctx, WR.HL, WR.HL, F1_ADC, F2_ADC);
+}
+
+
+static void ADC_HL_SP (Z180Context* ctx)
+{
+	ctx->tstates += 7;
+	WR.HL = doAddWord(ctx, WR.HL, WR.SP, F1_ADC, F2_ADC);
+}
+
+
+static void ADD_A_off_HL (Z180Context* ctx)
+{
+	BR.A = doArithmetic(ctx, read8(ctx, WR.HL), F1_ADD, F2_ADD);
+}
+
+
+static void ADD_A_off_IX_d (Z180Context* ctx)
+{
+	ctx->tstates += 5;
+	signed char displacement = read8(ctx, ctx->PC++);
+	BR.A = doArithmetic(ctx, read8(ctx, WR.IX + displacement), F1_ADD, F2_ADD);
+	
+}
+
+
+static void ADD_A_off_IY_d (Z180Context* ctx)
+{
+	ctx->tstates += 5;
+	signed char displacement = read8(ctx, ctx->PC++);
+	BR.A = doArithmetic(ctx, read8(ctx, WR.IY + displacement), F1_ADD, F2_ADD);
+	
+}
+
+
+static void ADD_A_A (Z180Context* ctx)
+{
+	BR.A = doArithmetic(ctx, BR.A, F1_ADD, F2_ADD);
+}
+
+
+static void ADD_A_B (Z180Context* ctx)
+{
+	BR.A = doArithmetic(ctx, BR.B, F1_ADD, F2_ADD);
+}
+
+
+static void ADD_A_C (Z180Context* ctx)
+{
+	BR.A = doArithmetic(ctx, BR.C, F1_ADD, F2_ADD);
+}
+
+
+static void ADD_A_D (Z180Context* ctx)
+{
+	BR.A = doArithmetic(ctx, BR.D, F1_ADD, F2_ADD);
+}
+
+
+static void ADD_A_E (Z180Context* ctx)
+{
+	BR.A = doArithmetic(ctx, BR.E, F1_ADD, F2_ADD);
+}
+
+
+static void ADD_A_H (Z180Context* ctx)
+{
+	BR.A = doArithmetic(ctx, BR.H, F1_ADD, F2_ADD);
+}
+
+
+static void ADD_A_L (Z180Context* ctx)
+{
+	BR.A = doArithmetic(ctx, BR.L, F1_ADD, F2_ADD);
+}
+
+
+static void ADD_A_n (Z180Context* ctx)
+{
+	BR.A = doArithmetic(ctx, read8(ctx, ctx->PC++), F1_ADD, F2_ADD);
+}
+
+
+static void ADD_HL_BC (Z180Context* ctx)
+{
+	ctx->tstates += 7;
+	WR.HL = doAddWord(ctx, WR.HL, WR.BC, F1_ADD, F2_ADD);
+}
+
+
+static void ADD_HL_DE (Z180Context* ctx)
+{
+	ctx->tstates += 7;
+	WR.HL = doAddWord(ctx, WR.HL, WR.DE, F1_ADD, F2_ADD);
+}
+
+
+static void ADD_HL_HL (Z180Context* ctx)
+{
+	ctx->tstates += 7;
+	WR.HL = doAddWord(ctx, WR.HL, WR.HL, F1_ADD, F2_ADD);
+}
+
+
+static void ADD_HL_SP (Z180Context* ctx)
+{
+	ctx->tstates += 7;
+	WR.HL = doAddWord(ctx, WR.HL, WR.SP, F1_ADD, F2_ADD);
+}
+
+
+static void ADD_IX_BC (Z180Context* ctx)
+{
+	ctx->tstates += 7;
+	WR.IX = doAddWord(ctx, WR.IX, WR.BC, 0, 0);
+}
+
+
+static void ADD_IX_DE (Z180Context* ctx)
+{
+	ctx->tstates += 7;
+	WR.IX = doAddWord(ctx, WR.IX, WR.DE, 0, 0);
+}
+
+
+static void ADD_IX_IX (Z180Context* ctx)
+{
+	ctx->tstates += 7;
+	WR.IX = doAddWord(ctx, WR.IX, WR.IX, 0, 0);
+}
+
+
+static void ADD_IX_SP (Z180Context* ctx)
+{
+	ctx->tstates += 7;
+	WR.IX = doAddWord(ctx, WR.IX, WR.SP, 0, 0);
+}
+
+
+static void ADD_IY_BC (Z180Context* ctx)
+{
+	ctx->tstates += 7;
+	WR.IY = doAddWord(ctx, WR.IY, WR.BC, 0, 0);
+}
+
+
+static void ADD_IY_DE (Z180Context* ctx)
+{
+	ctx->tstates += 7;
+	WR.IY = doAddWord(ctx, WR.IY, WR.DE, 0, 0);
+}
+
+
+static void ADD_IY_IY (Z180Context* ctx)
+{
+	ctx->tstates += 7;
+	WR.IY = doAddWord(ctx, WR.IY, WR.IY, 0, 0);
+}
+
+
+static void ADD_IY_SP (Z180Context* ctx)
+{
+	ctx->tstates += 7;
+	WR.IY = doAddWord(ctx, WR.IY, WR.SP, 0, 0);
+}
+
+
+static void AND_off_HL (Z180Context* ctx)
+{
+	doAND(ctx, read8(ctx, WR.HL));
+}
+
+
+static void AND_off_IX_d (Z180Context* ctx)
+{
+	ctx->tstates += 5;
+	doAND(ctx, read8(ctx, WR.IX + (signed char) read8(ctx, ctx->PC++)));
+}
+
+
+static void AND_off_IY_d (Z180Context* ctx)
+{
+	ctx->tstates += 5;
+	doAND(ctx, read8(ctx, WR.IY + (signed char) read8(ctx, ctx->PC++)));
+}
+
+
+static void AND_A (Z180Context* ctx)
+{
+	doAND(ctx, BR.A);
+}
+
+
+static void AND_B (Z180Context* ctx)
+{
+	doAND(ctx, BR.B);
+}
+
+
+static void AND_C (Z180Context* ctx)
+{
+	doAND(ctx, BR.C);
+}
+
+
+static void AND_D (Z180Context* ctx)
+{
+	doAND(ctx, BR.D);
+}
+
+
+static void AND_E (Z180Context* ctx)
+{
+	doAND(ctx, BR.E);
+}
+
+
+static void AND_H (Z180Context* ctx)
+{
+	doAND(ctx, BR.H);
+}
+
+
+static void AND_L (Z180Context* ctx)
+{
+	doAND(ctx, BR.L);
+}
+
+
+static void AND_n (Z180Context* ctx)
+{
+	doAND(ctx, read8(ctx, ctx->PC++));
+}
+
+
+static void BIT_0_off_HL (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	doBIT_r(ctx, 0, read8(ctx, WR.HL));
+}
+
+
+static void BIT_0_off_IX_d (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	ushort address = WR.IX + (signed char) read8(ctx, ctx->PC++);
+	doBIT_indexed(ctx, 0, address);
+}
+
+
+static void BIT_0_off_IY_d (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	ushort address = WR.IY + (signed char) read8(ctx, ctx->PC++);
+	doBIT_indexed(ctx, 0, address);
+}
+
+
+static void BIT_0_A (Z180Context* ctx)
+{
+	doBIT_r(ctx, 0, BR.A);
+}
+
+
+static void BIT_0_B (Z180Context* ctx)
+{
+	doBIT_r(ctx, 0, BR.B);
+}
+
+
+static void BIT_0_C (Z180Context* ctx)
+{
+	doBIT_r(ctx, 0, BR.C);
+}
+
+
+static void BIT_0_D (Z180Context* ctx)
+{
+	doBIT_r(ctx, 0, BR.D);
+}
+
+
+static void BIT_0_E (Z180Context* ctx)
+{
+	doBIT_r(ctx, 0, BR.E);
+}
+
+
+static void BIT_0_H (Z180Context* ctx)
+{
+	doBIT_r(ctx, 0, BR.H);
+}
+
+
+static void BIT_0_L (Z180Context* ctx)
+{
+	doBIT_r(ctx, 0, BR.L);
+}
+
+
+static void BIT_1_off_HL (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	doBIT_r(ctx, 1, read8(ctx, WR.HL));
+}
+
+
+static void BIT_1_off_IX_d (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	ushort address = WR.IX + (signed char) read8(ctx, ctx->PC++);
+	doBIT_indexed(ctx, 1, address);
+}
+
+
+static void BIT_1_off_IY_d (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	ushort address = WR.IY + (signed char) read8(ctx, ctx->PC++);
+	doBIT_indexed(ctx, 1, address);
+}
+
+
+static void BIT_1_A (Z180Context* ctx)
+{
+	doBIT_r(ctx, 1, BR.A);
+}
+
+
+static void BIT_1_B (Z180Context* ctx)
+{
+	doBIT_r(ctx, 1, BR.B);
+}
+
+
+static void BIT_1_C (Z180Context* ctx)
+{
+	doBIT_r(ctx, 1, BR.C);
+}
+
+
+static void BIT_1_D (Z180Context* ctx)
+{
+	doBIT_r(ctx, 1, BR.D);
+}
+
+
+static void BIT_1_E (Z180Context* ctx)
+{
+	doBIT_r(ctx, 1, BR.E);
+}
+
+
+static void BIT_1_H (Z180Context* ctx)
+{
+	doBIT_r(ctx, 1, BR.H);
+}
+
+
+static void BIT_1_L (Z180Context* ctx)
+{
+	doBIT_r(ctx, 1, BR.L);
+}
+
+
+static void BIT_2_off_HL (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	doBIT_r(ctx, 2, read8(ctx, WR.HL));
+}
+
+
+static void BIT_2_off_IX_d (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	ushort address = WR.IX + (signed char) read8(ctx, ctx->PC++);
+	doBIT_indexed(ctx, 2, address);
+}
+
+
+static void BIT_2_off_IY_d (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	ushort address = WR.IY + (signed char) read8(ctx, ctx->PC++);
+	doBIT_indexed(ctx, 2, address);
+}
+
+
+static void BIT_2_A (Z180Context* ctx)
+{
+	doBIT_r(ctx, 2, BR.A);
+}
+
+
+static void BIT_2_B (Z180Context* ctx)
+{
+	doBIT_r(ctx, 2, BR.B);
+}
+
+
+static void BIT_2_C (Z180Context* ctx)
+{
+	doBIT_r(ctx, 2, BR.C);
+}
+
+
+static void BIT_2_D (Z180Context* ctx)
+{
+	doBIT_r(ctx, 2, BR.D);
+}
+
+
+static void BIT_2_E (Z180Context* ctx)
+{
+	doBIT_r(ctx, 2, BR.E);
+}
+
+
+static void BIT_2_H (Z180Context* ctx)
+{
+	doBIT_r(ctx, 2, BR.H);
+}
+
+
+static void BIT_2_L (Z180Context* ctx)
+{
+	doBIT_r(ctx, 2, BR.L);
+}
+
+
+static void BIT_3_off_HL (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	doBIT_r(ctx, 3, read8(ctx, WR.HL));
+}
+
+
+static void BIT_3_off_IX_d (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	ushort address = WR.IX + (signed char) read8(ctx, ctx->PC++);
+	doBIT_indexed(ctx, 3, address);
+}
+
+
+static void BIT_3_off_IY_d (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	ushort address = WR.IY + (signed char) read8(ctx, ctx->PC++);
+	doBIT_indexed(ctx, 3, address);
+}
+
+
+static void BIT_3_A (Z180Context* ctx)
+{
+	doBIT_r(ctx, 3, BR.A);
+}
+
+
+static void BIT_3_B (Z180Context* ctx)
+{
+	doBIT_r(ctx, 3, BR.B);
+}
+
+
+static void BIT_3_C (Z180Context* ctx)
+{
+	doBIT_r(ctx, 3, BR.C);
+}
+
+
+static void BIT_3_D (Z180Context* ctx)
+{
+	doBIT_r(ctx, 3, BR.D);
+}
+
+
+static void BIT_3_E (Z180Context* ctx)
+{
+	doBIT_r(ctx, 3, BR.E);
+}
+
+
+static void BIT_3_H (Z180Context* ctx)
+{
+	doBIT_r(ctx, 3, BR.H);
+}
+
+
+static void BIT_3_L (Z180Context* ctx)
+{
+	doBIT_r(ctx, 3, BR.L);
+}
+
+
+static void BIT_4_off_HL (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	doBIT_r(ctx, 4, read8(ctx, WR.HL));
+}
+
+
+static void BIT_4_off_IX_d (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	ushort address = WR.IX + (signed char) read8(ctx, ctx->PC++);
+	doBIT_indexed(ctx, 4, address);
+}
+
+
+static void BIT_4_off_IY_d (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	ushort address = WR.IY + (signed char) read8(ctx, ctx->PC++);
+	doBIT_indexed(ctx, 4, address);
+}
+
+
+static void BIT_4_A (Z180Context* ctx)
+{
+	doBIT_r(ctx, 4, BR.A);
+}
+
+
+static void BIT_4_B (Z180Context* ctx)
+{
+	doBIT_r(ctx, 4, BR.B);
+}
+
+
+static void BIT_4_C (Z180Context* ctx)
+{
+	doBIT_r(ctx, 4, BR.C);
+}
+
+
+static void BIT_4_D (Z180Context* ctx)
+{
+	doBIT_r(ctx, 4, BR.D);
+}
+
+
+static void BIT_4_E (Z180Context* ctx)
+{
+	doBIT_r(ctx, 4, BR.E);
+}
+
+
+static void BIT_4_H (Z180Context* ctx)
+{
+	doBIT_r(ctx, 4, BR.H);
+}
+
+
+static void BIT_4_L (Z180Context* ctx)
+{
+	doBIT_r(ctx, 4, BR.L);
+}
+
+
+static void BIT_5_off_HL (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	doBIT_r(ctx, 5, read8(ctx, WR.HL));
+}
+
+
+static void BIT_5_off_IX_d (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	ushort address = WR.IX + (signed char) read8(ctx, ctx->PC++);
+	doBIT_indexed(ctx, 5, address);
+}
+
+
+static void BIT_5_off_IY_d (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	ushort address = WR.IY + (signed char) read8(ctx, ctx->PC++);
+	doBIT_indexed(ctx, 5, address);
+}
+
+
+static void BIT_5_A (Z180Context* ctx)
+{
+	doBIT_r(ctx, 5, BR.A);
+}
+
+
+static void BIT_5_B (Z180Context* ctx)
+{
+	doBIT_r(ctx, 5, BR.B);
+}
+
+
+static void BIT_5_C (Z180Context* ctx)
+{
+	doBIT_r(ctx, 5, BR.C);
+}
+
+
+static void BIT_5_D (Z180Context* ctx)
+{
+	doBIT_r(ctx, 5, BR.D);
+}
+
+
+static void BIT_5_E (Z180Context* ctx)
+{
+	doBIT_r(ctx, 5, BR.E);
+}
+
+
+static void BIT_5_H (Z180Context* ctx)
+{
+	doBIT_r(ctx, 5, BR.H);
+}
+
+
+static void BIT_5_L (Z180Context* ctx)
+{
+	doBIT_r(ctx, 5, BR.L);
+}
+
+
+static void BIT_6_off_HL (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	doBIT_r(ctx, 6, read8(ctx, WR.HL));
+}
+
+
+static void BIT_6_off_IX_d (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	ushort address = WR.IX + (signed char) read8(ctx, ctx->PC++);
+	doBIT_indexed(ctx, 6, address);
+}
+
+
+static void BIT_6_off_IY_d (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	ushort address = WR.IY + (signed char) read8(ctx, ctx->PC++);
+	doBIT_indexed(ctx, 6, address);
+}
+
+
+static void BIT_6_A (Z180Context* ctx)
+{
+	doBIT_r(ctx, 6, BR.A);
+}
+
+
+static void BIT_6_B (Z180Context* ctx)
+{
+	doBIT_r(ctx, 6, BR.B);
+}
+
+
+static void BIT_6_C (Z180Context* ctx)
+{
+	doBIT_r(ctx, 6, BR.C);
+}
+
+
+static void BIT_6_D (Z180Context* ctx)
+{
+	doBIT_r(ctx, 6, BR.D);
+}
+
+
+static void BIT_6_E (Z180Context* ctx)
+{
+	doBIT_r(ctx, 6, BR.E);
+}
+
+
+static void BIT_6_H (Z180Context* ctx)
+{
+	doBIT_r(ctx, 6, BR.H);
+}
+
+
+static void BIT_6_L (Z180Context* ctx)
+{
+	doBIT_r(ctx, 6, BR.L);
+}
+
+
+static void BIT_7_off_HL (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	doBIT_r(ctx, 7, read8(ctx, WR.HL));
+}
+
+
+static void BIT_7_off_IX_d (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	ushort address = WR.IX + (signed char) read8(ctx, ctx->PC++);
+	doBIT_indexed(ctx, 7, address);
+}
+
+
+static void BIT_7_off_IY_d (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	ushort address = WR.IY + (signed char) read8(ctx, ctx->PC++);
+	doBIT_indexed(ctx, 7, address);
+}
+
+
+static void BIT_7_A (Z180Context* ctx)
+{
+	doBIT_r(ctx, 7, BR.A);
+}
+
+
+static void BIT_7_B (Z180Context* ctx)
+{
+	doBIT_r(ctx, 7, BR.B);
+}
+
+
+static void BIT_7_C (Z180Context* ctx)
+{
+	doBIT_r(ctx, 7, BR.C);
+}
+
+
+static void BIT_7_D (Z180Context* ctx)
+{
+	doBIT_r(ctx, 7, BR.D);
+}
+
+
+static void BIT_7_E (Z180Context* ctx)
+{
+	doBIT_r(ctx, 7, BR.E);
+}
+
+
+static void BIT_7_H (Z180Context* ctx)
+{
+	doBIT_r(ctx, 7, BR.H);
+}
+
+
+static void BIT_7_L (Z180Context* ctx)
+{
+	doBIT_r(ctx, 7, BR.L);
+}
+
+
+static void CALL_off_nn (Z180Context* ctx)
+{
+	ushort addr = read16(ctx, ctx->PC);
+	ctx->PC += 2;
+	if (condition(ctx, C_))
+	{
+		ctx->tstates += 1;
+		doPush(ctx, ctx->PC);
+		ctx->PC = addr;
+	}
+	
+}
+
+
+static void CALL_C_off_nn (Z180Context* ctx)
+{
+	ushort addr = read16(ctx, ctx->PC);
+	ctx->PC += 2;
+	if (condition(ctx, C_C))
+	{
+		ctx->tstates += 1;
+		doPush(ctx, ctx->PC);
+		ctx->PC = addr;
+	}
+	
+}
+
+
+static void CALL_M_off_nn (Z180Context* ctx)
+{
+	ushort addr = read16(ctx, ctx->PC);
+	ctx->PC += 2;
+	if (condition(ctx, C_M))
+	{
+		ctx->tstates += 1;
+		doPush(ctx, ctx->PC);
+		ctx->PC = addr;
+	}
+	
+}
+
+
+static void CALL_NC_off_nn (Z180Context* ctx)
+{
+	ushort addr = read16(ctx, ctx->PC);
+	ctx->PC += 2;
+	if (condition(ctx, C_NC))
+	{
+		ctx->tstates += 1;
+		doPush(ctx, ctx->PC);
+		ctx->PC = addr;
+	}
+	
+}
+
+
+static void CALL_NZ_off_nn (Z180Context* ctx)
+{
+	ushort addr = read16(ctx, ctx->PC);
+	ctx->PC += 2;
+	if (condition(ctx, C_NZ))
+	{
+		ctx->tstates += 1;
+		doPush(ctx, ctx->PC);
+		ctx->PC = addr;
+	}
+	
+}
+
+
+static void CALL_P_off_nn (Z180Context* ctx)
+{
+	ushort addr = read16(ctx, ctx->PC);
+	ctx->PC += 2;
+	if (condition(ctx, C_P))
+	{
+		ctx->tstates += 1;
+		doPush(ctx, ctx->PC);
+		ctx->PC = addr;
+	}
+	
+}
+
+
+static void CALL_PE_off_nn (Z180Context* ctx)
+{
+	ushort addr = read16(ctx, ctx->PC);
+	ctx->PC += 2;
+	if (condition(ctx, C_PE))
+	{
+		ctx->tstates += 1;
+		doPush(ctx, ctx->PC);
+		ctx->PC = addr;
+	}
+	
+}
+
+
+static void CALL_PO_off_nn (Z180Context* ctx)
+{
+	ushort addr = read16(ctx, ctx->PC);
+	ctx->PC += 2;
+	if (condition(ctx, C_PO))
+	{
+		ctx->tstates += 1;
+		doPush(ctx, ctx->PC);
+		ctx->PC = addr;
+	}
+	
+}
+
+
+static void CALL_Z_off_nn (Z180Context* ctx)
+{
+	ushort addr = read16(ctx, ctx->PC);
+	ctx->PC += 2;
+	if (condition(ctx, C_Z))
+	{
+		ctx->tstates += 1;
+		doPush(ctx, ctx->PC);
+		ctx->PC = addr;
+	}
+	
+}
+
+
+static void CCF (Z180Context* ctx)
+{
+	VALFLAG(F_C, (1 - (byte)GETFLAG(F_C) != 0));
+	RESFLAG(F_N);
+	adjustFlags(ctx, BR.A);
+}
+
+
+static void CP_off_HL (Z180Context* ctx)
+{
+	doCP_HL(ctx);
+}
+
+
+static void CP_off_IX_d (Z180Context* ctx)
+{
+	ctx->tstates += 5;
+	signed char displacement = read8(ctx, ctx->PC++);
+	byte val = read8(ctx, WR.IX + displacement);
+	doArithmetic(ctx, val, 0, 1);	
+	adjustFlags(ctx, val);
+}
+
+
+static void CP_off_IY_d (Z180Context* ctx)
+{
+	ctx->tstates += 5;
+	signed char displacement = read8(ctx, ctx->PC++);
+	byte val = read8(ctx, WR.IY + displacement);
+	doArithmetic(ctx, val, 0, 1);	
+	adjustFlags(ctx, val);
+}
+
+
+static void CP_A (Z180Context* ctx)
+{
+	doArithmetic(ctx, BR.A, 0, 1);	
+	adjustFlags(ctx, BR.A);
+}
+
+
+static void CP_B (Z180Context* ctx)
+{
+	doArithmetic(ctx, BR.B, 0, 1);	
+	adjustFlags(ctx, BR.B);
+}
+
+
+static void CP_C (Z180Context* ctx)
+{
+	doArithmetic(ctx, BR.C, 0, 1);	
+	adjustFlags(ctx, BR.C);
+}
+
+
+static void CP_D (Z180Context* ctx)
+{
+	doArithmetic(ctx, BR.D, 0, 1);	
+	adjustFlags(ctx, BR.D);
+}
+
+
+static void CP_E (Z180Context* ctx)
+{
+	doArithmetic(ctx, BR.E, 0, 1);	
+	adjustFlags(ctx, BR.E);
+}
+
+
+static void CP_H (Z180Context* ctx)
+{
+	doArithmetic(ctx, BR.H, 0, 1);	
+	adjustFlags(ctx, BR.H);
+}
+
+
+static void CP_L (Z180Context* ctx)
+{
+	doArithmetic(ctx, BR.L, 0, 1);	
+	adjustFlags(ctx, BR.L);
+}
+
+
+static void CP_n (Z180Context* ctx)
+{
+	byte val = read8(ctx, ctx->PC++);
+	doArithmetic(ctx, val, 0, 1);	
+	adjustFlags(ctx, val);
+}
+
+
+static void CPD (Z180Context* ctx)
+{
+	ctx->tstates += 5;
+	int carry = GETFLAG(F_C);
+	byte value = doCP_HL(ctx);
+	if(GETFLAG(F_H))
+		value--;
+	WR.HL--;
+	WR.BC--;
+	VALFLAG(F_PV, WR.BC != 0);
+	if(carry)
+		SETFLAG(F_C);
+	else
+		RESFLAG(F_C);
+	VALFLAG(F_5, value & (1 << 1));
+	VALFLAG(F_3, value & (1 << 3));
+}
+
+
+static void CPDR (Z180Context* ctx)
+{
+	CPD(ctx);
+	if (WR.BC != 0 && !GETFLAG(F_Z))
+	{
+		ctx->tstates += 5;
+		ctx->PC -= 2;
+	}
+}
+
+
+static void CPI (Z180Context* ctx)
+{
+	ctx->tstates += 5;
+	int carry = GETFLAG(F_C);
+	byte value = doCP_HL(ctx);
+	if(GETFLAG(F_H))
+		value--;
+	WR.HL++;
+	WR.BC--;
+	VALFLAG(F_PV, WR.BC != 0);
+	VALFLAG(F_C, carry);
+	VALFLAG(F_5, value & (1 << 2));
+	VALFLAG(F_3, value & (1 << 3));
+}
+
+
+static void CPIR (Z180Context* ctx)
+{
+	CPI(ctx);
+	if (WR.BC != 0 && !GETFLAG(F_Z))
+	{
+		ctx->tstates += 5;
+		ctx->PC -= 2;
+	}
+}
+
+
+static void CPL (Z180Context* ctx)
+{
+	BR.A = ~BR.A;
+	SETFLAG(F_H | F_N);
+	adjustFlags(ctx, BR.A);
+	
+}
+
+
+static void DAA (Z180Context* ctx)
+{
+	doDAA(ctx);
+	
+}
+
+
+static void DEC_off_HL (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	byte value = read8(ctx, WR.HL);
+	write8(ctx, WR.HL, doIncDec(ctx, value, ID_DEC));
+}
+
+
+static void DEC_off_IX_d (Z180Context* ctx)
+{
+	ctx->tstates += 6;
+	signed char off = read8(ctx, ctx->PC++);
+	byte value = read8(ctx, WR.IX + off);
+	write8(ctx, WR.IX + off, doIncDec(ctx, value, ID_DEC));
+	
+}
+
+
+static void DEC_off_IY_d (Z180Context* ctx)
+{
+	ctx->tstates += 6;
+	signed char off = read8(ctx, ctx->PC++);
+	byte value = read8(ctx, WR.IY + off);
+	write8(ctx, WR.IY + off, doIncDec(ctx, value, ID_DEC));
+	
+}
+
+
+static void DEC_A (Z180Context* ctx)
+{
+	BR.A = doIncDec(ctx, BR.A, ID_DEC);
+}
+
+
+static void DEC_B (Z180Context* ctx)
+{
+	BR.B = doIncDec(ctx, BR.B, ID_DEC);
+}
+
+
+static void DEC_BC (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	WR.BC--;
+}
+
+
+static void DEC_C (Z180Context* ctx)
+{
+	BR.C = doIncDec(ctx, BR.C, ID_DEC);
+}
+
+
+static void DEC_D (Z180Context* ctx)
+{
+	BR.D = doIncDec(ctx, BR.D, ID_DEC);
+}
+
+
+static void DEC_DE (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	WR.DE--;
+}
+
+
+static void DEC_E (Z180Context* ctx)
+{
+	BR.E = doIncDec(ctx, BR.E, ID_DEC);
+}
+
+
+static void DEC_H (Z180Context* ctx)
+{
+	BR.H = doIncDec(ctx, BR.H, ID_DEC);
+}
+
+
+static void DEC_HL (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	WR.HL--;
+}
+
+
+static void DEC_IX (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	WR.IX--;
+}
+
+
+static void DEC_IY (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	WR.IY--;
+}
+
+
+static void DEC_L (Z180Context* ctx)
+{
+	BR.L = doIncDec(ctx, BR.L, ID_DEC);
+}
+
+
+static void DEC_SP (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	WR.SP--;
+}
+
+
+static void DI (Z180Context* ctx)
+{
+	ctx->IFF1 = ctx->IFF2 = IE_DI;
+	ctx->defer_int = 1;
+}
+
+
+static void DJNZ_off_PC_e (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	signed char off = read8(ctx, ctx->PC++);
+	BR.B--;
+	if (BR.B)
+	{
+		ctx->tstates += 5;
+		ctx->PC += off;
+	}
+}
+
+
+static void EI (Z180Context* ctx)
+{
+	ctx->IFF1 = ctx->IFF2 = IE_EI;
+	ctx->defer_int = 1;
+}
+
+
+static void EX_off_SP_HL (Z180Context* ctx)
+{
+	ctx->tstates += 3;
+	ushort tmp = read16(ctx, WR.SP);
+	write16(ctx, WR.SP, WR.HL);
+	WR.HL = tmp;
+}
+
+
+static void EX_off_SP_IX (Z180Context* ctx)
+{
+	ctx->tstates += 3;
+	ushort tmp = read16(ctx, WR.SP);
+	write16(ctx, WR.SP, WR.IX);
+	WR.IX = tmp;
+}
+
+
+static void EX_off_SP_IY (Z180Context* ctx)
+{
+	ctx->tstates += 3;
+	ushort tmp = read16(ctx, WR.SP);
+	write16(ctx, WR.SP, WR.IY);
+	WR.IY = tmp;
+}
+
+
+static void EX_AF_AF_ (Z180Context* ctx)
+{
+	ushort tmp = ctx->R1.wr.AF;
+	ctx->R1.wr.AF = ctx->R2.wr.AF;
+	ctx->R2.wr.AF = tmp;
+}
+
+
+static void EX_DE_HL (Z180Context* ctx)
+{
+	ushort tmp = WR.DE;
+	WR.DE = WR.HL;
+	WR.HL = tmp;
+}
+
+
+static void EXX (Z180Context* ctx)
+{
+	ushort tmp;	
+	tmp = ctx->R1.wr.BC;
+	ctx->R1.wr.BC = ctx->R2.wr.BC;
+	ctx->R2.wr.BC = tmp;	
+	
+	tmp = ctx->R1.wr.DE;
+	ctx->R1.wr.DE = ctx->R2.wr.DE;
+	ctx->R2.wr.DE = tmp;	
+	
+	tmp = ctx->R1.wr.HL;
+	ctx->R1.wr.HL = ctx->R2.wr.HL;
+	ctx->R2.wr.HL = tmp;
+}
+
+
+static void HALT (Z180Context* ctx)
+{
+	ctx->halted = 1;
+	ctx->PC--;
+}
+
+
+static void IM_0 (Z180Context* ctx)
+{
+	ctx->IM = 0;
+}
+
+
+static void IM_1 (Z180Context* ctx)
+{
+	ctx->IM = 1;
+}
+
+
+static void IM_2 (Z180Context* ctx)
+{
+	ctx->IM = 2;
+}
+
+
+static void IN_A_off_C (Z180Context* ctx)
+{
+	BR.A = ioRead(ctx, WR.BC);
+	RESFLAG(F_H | F_N);
+	adjustFlagSZP(ctx, BR.A);
+	adjustFlags(ctx, BR.A);
+}
+
+
+static void IN_A_off_n (Z180Context* ctx)
+{
+	byte port = read8(ctx, ctx->PC++);	
+	BR.A = ioRead(ctx, BR.A << 8 | port);
+}
+
+
+static void IN_B_off_C (Z180Context* ctx)
+{
+	BR.B = ioRead(ctx, WR.BC);
+	RESFLAG(F_H | F_N);
+	adjustFlagSZP(ctx, BR.B);
+	adjustFlags(ctx, BR.B);
+}
+
+
+static void IN_C_off_C (Z180Context* ctx)
+{
+	BR.C = ioRead(ctx, WR.BC);
+	RESFLAG(F_H | F_N);
+	adjustFlagSZP(ctx, BR.C);
+	adjustFlags(ctx, BR.C);
+}
+
+
+static void IN_D_off_C (Z180Context* ctx)
+{
+	BR.D = ioRead(ctx, WR.BC);
+	RESFLAG(F_H | F_N);
+	adjustFlagSZP(ctx, BR.D);
+	adjustFlags(ctx, BR.D);
+}
+
+
+static void IN_E_off_C (Z180Context* ctx)
+{
+	BR.E = ioRead(ctx, WR.BC);
+	RESFLAG(F_H | F_N);
+	adjustFlagSZP(ctx, BR.E);
+	adjustFlags(ctx, BR.E);
+}
+
+
+static void IN_F_off_C (Z180Context* ctx)
+{
+	BR.F = ioRead(ctx, WR.BC);
+	RESFLAG(F_H | F_N);
+	adjustFlagSZP(ctx, BR.F);
+	adjustFlags(ctx, BR.F);
+}
+
+
+static void IN_H_off_C (Z180Context* ctx)
+{
+	BR.H = ioRead(ctx, WR.BC);
+	RESFLAG(F_H | F_N);
+	adjustFlagSZP(ctx, BR.H);
+	adjustFlags(ctx, BR.H);
+}
+
+
+static void IN_L_off_C (Z180Context* ctx)
+{
+	BR.L = ioRead(ctx, WR.BC);
+	RESFLAG(F_H | F_N);
+	adjustFlagSZP(ctx, BR.L);
+	adjustFlags(ctx, BR.L);
+}
+
+
+static void INC_off_HL (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	byte value = read8(ctx, WR.HL);
+	write8(ctx, WR.HL, doIncDec(ctx, value, ID_INC));
+}
+
+
+static void INC_off_IX_d (Z180Context* ctx)
+{
+	ctx->tstates += 6;
+	signed char off = read8(ctx, ctx->PC++);
+	byte value = read8(ctx, WR.IX + off);
+	write8(ctx, WR.IX + off, doIncDec(ctx, value, ID_INC));
+	
+}
+
+
+static void INC_off_IY_d (Z180Context* ctx)
+{
+	ctx->tstates += 6;
+	signed char off = read8(ctx, ctx->PC++);
+	byte value = read8(ctx, WR.IY + off);
+	write8(ctx, WR.IY + off, doIncDec(ctx, value, ID_INC));
+	
+}
+
+
+static void INC_A (Z180Context* ctx)
+{
+	BR.A = doIncDec(ctx, BR.A, ID_INC);
+}
+
+
+static void INC_B (Z180Context* ctx)
+{
+	BR.B = doIncDec(ctx, BR.B, ID_INC);
+}
+
+
+static void INC_BC (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	WR.BC++;
+}
+
+
+static void INC_C (Z180Context* ctx)
+{
+	BR.C = doIncDec(ctx, BR.C, ID_INC);
+}
+
+
+static void INC_D (Z180Context* ctx)
+{
+	BR.D = doIncDec(ctx, BR.D, ID_INC);
+}
+
+
+static void INC_DE (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	WR.DE++;
+}
+
+
+static void INC_E (Z180Context* ctx)
+{
+	BR.E = doIncDec(ctx, BR.E, ID_INC);
+}
+
+
+static void INC_H (Z180Context* ctx)
+{
+	BR.H = doIncDec(ctx, BR.H, ID_INC);
+}
+
+
+static void INC_HL (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	WR.HL++;
+}
+
+
+static void INC_IX (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	WR.IX++;
+}
+
+
+static void INC_IY (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	WR.IY++;
+}
+
+
+static void INC_L (Z180Context* ctx)
+{
+	BR.L = doIncDec(ctx, BR.L, ID_INC);
+}
+
+
+static void INC_SP (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	WR.SP++;
+}
+
+
+static void IND (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	byte val = ioRead(ctx, WR.BC);
+	write8(ctx, WR.HL, val);
+	WR.HL--;
+	BR.B = doIncDec(ctx, BR.B, ID_DEC);
+	VALFLAG(F_N, (val & 0x80) != 0);
+	int flagval = val + ((BR.C - 1) & 0xff);
+	VALFLAG(F_H, flagval > 0xff);
+	VALFLAG(F_C, flagval > 0xff);
+	VALFLAG(F_PV, parityBit[(flagval & 7) ^ BR.B]);
+}
+
+
+static void INDR (Z180Context* ctx)
+{
+	IND(ctx);
+	if (BR.B != 0)
+	{
+		ctx->tstates += 5;
+		ctx->PC -= 2;
+	}
+}
+
+
+static void INI (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	byte val = ioRead(ctx, WR.BC);
+	write8(ctx, WR.HL, val);
+	WR.HL++;
+	BR.B = doIncDec(ctx, BR.B, ID_DEC);
+	VALFLAG(F_N, (val & 0x80) != 0);
+	int flagval = val + ((BR.C + 1) & 0xff);
+	VALFLAG(F_H, flagval > 0xff);
+	VALFLAG(F_C, flagval > 0xff);
+	VALFLAG(F_PV, parityBit[(flagval & 7) ^ BR.B]);
+}
+
+
+static void INIR (Z180Context* ctx)
+{
+	INI(ctx);
+	if (BR.B != 0)
+	{
+		ctx->tstates += 5;
+		ctx->PC -= 2;
+	}
+}
+
+
+static void JP_off_HL (Z180Context* ctx)
+{
+	ctx->PC = WR.HL;
+	
+}
+
+
+static void JP_off_IX (Z180Context* ctx)
+{
+	ctx->PC = WR.IX;
+	
+}
+
+
+static void JP_off_IY (Z180Context* ctx)
+{
+	ctx->PC = WR.IY;
+	
+}
+
+
+static void JP_off_nn (Z180Context* ctx)
+{
+	ushort addr = read16(ctx, ctx->PC);
+	ctx->PC += 2;
+	if (condition(ctx, C_))
+		ctx->PC = addr;
+	
+}
+
+
+static void JP_C_off_nn (Z180Context* ctx)
+{
+	ushort addr = read16(ctx, ctx->PC);
+	ctx->PC += 2;
+	if (condition(ctx, C_C))
+		ctx->PC = addr;
+	
+}
+
+
+static void JP_M_off_nn (Z180Context* ctx)
+{
+	ushort addr = read16(ctx, ctx->PC);
+	ctx->PC += 2;
+	if (condition(ctx, C_M))
+		ctx->PC = addr;
+	
+}
+
+
+static void JP_NC_off_nn (Z180Context* ctx)
+{
+	ushort addr = read16(ctx, ctx->PC);
+	ctx->PC += 2;
+	if (condition(ctx, C_NC))
+		ctx->PC = addr;
+	
+}
+
+
+static void JP_NZ_off_nn (Z180Context* ctx)
+{
+	ushort addr = read16(ctx, ctx->PC);
+	ctx->PC += 2;
+	if (condition(ctx, C_NZ))
+		ctx->PC = addr;
+	
+}
+
+
+static void JP_P_off_nn (Z180Context* ctx)
+{
+	ushort addr = read16(ctx, ctx->PC);
+	ctx->PC += 2;
+	if (condition(ctx, C_P))
+		ctx->PC = addr;
+	
+}
+
+
+static void JP_PE_off_nn (Z180Context* ctx)
+{
+	ushort addr = read16(ctx, ctx->PC);
+	ctx->PC += 2;
+	if (condition(ctx, C_PE))
+		ctx->PC = addr;
+	
+}
+
+
+static void JP_PO_off_nn (Z180Context* ctx)
+{
+	ushort addr = read16(ctx, ctx->PC);
+	ctx->PC += 2;
+	if (condition(ctx, C_PO))
+		ctx->PC = addr;
+	
+}
+
+
+static void JP_Z_off_nn (Z180Context* ctx)
+{
+	ushort addr = read16(ctx, ctx->PC);
+	ctx->PC += 2;
+	if (condition(ctx, C_Z))
+		ctx->PC = addr;
+	
+}
+
+
+static void JR_off_PC_e (Z180Context* ctx)
+{
+	int off = doComplement(read8(ctx, ctx->PC++));
+	if (condition(ctx, C_))
+	{
+		ctx->tstates += 5;
+		ctx->PC += off;
+	}
+}
+
+
+static void JR_C_off_PC_e (Z180Context* ctx)
+{
+	int off = doComplement(read8(ctx, ctx->PC++));
+	if (condition(ctx, C_C))
+	{
+		ctx->tstates += 5;
+		ctx->PC += off;
+	}
+}
+
+
+static void JR_NC_off_PC_e (Z180Context* ctx)
+{
+	int off = doComplement(read8(ctx, ctx->PC++));
+	if (condition(ctx, C_NC))
+	{
+		ctx->tstates += 5;
+		ctx->PC += off;
+	}
+}
+
+
+static void JR_NZ_off_PC_e (Z180Context* ctx)
+{
+	int off = doComplement(read8(ctx, ctx->PC++));
+	if (condition(ctx, C_NZ))
+	{
+		ctx->tstates += 5;
+		ctx->PC += off;
+	}
+}
+
+
+static void JR_Z_off_PC_e (Z180Context* ctx)
+{
+	int off = doComplement(read8(ctx, ctx->PC++));
+	if (condition(ctx, C_Z))
+	{
+		ctx->tstates += 5;
+		ctx->PC += off;
+	}
+}
+
+
+static void LD_off_BC_A (Z180Context* ctx)
+{
+	write8(ctx, WR.BC, BR.A);
+}
+
+
+static void LD_off_DE_A (Z180Context* ctx)
+{
+	write8(ctx, WR.DE, BR.A);
+}
+
+
+static void LD_off_HL_A (Z180Context* ctx)
+{
+	write8(ctx, WR.HL, BR.A);
+}
+
+
+static void LD_off_HL_B (Z180Context* ctx)
+{
+	write8(ctx, WR.HL, BR.B);
+}
+
+
+static void LD_off_HL_C (Z180Context* ctx)
+{
+	write8(ctx, WR.HL, BR.C);
+}
+
+
+static void LD_off_HL_D (Z180Context* ctx)
+{
+	write8(ctx, WR.HL, BR.D);
+}
+
+
+static void LD_off_HL_E (Z180Context* ctx)
+{
+	write8(ctx, WR.HL, BR.E);
+}
+
+
+static void LD_off_HL_H (Z180Context* ctx)
+{
+	write8(ctx, WR.HL, BR.H);
+}
+
+
+static void LD_off_HL_L (Z180Context* ctx)
+{
+	write8(ctx, WR.HL, BR.L);
+}
+
+
+static void LD_off_HL_n (Z180Context* ctx)
+{
+	write8(ctx, WR.HL, read8(ctx, ctx->PC++));
+	
+}
+
+
+static void LD_off_IX_d_A (Z180Context* ctx)
+{
+	ctx->tstates += 5;
+	write8(ctx, WR.IX + (signed char) read8(ctx, ctx->PC++), BR.A);
+	
+}
+
+
+static void LD_off_IX_d_B (Z180Context* ctx)
+{
+	ctx->tstates += 5;
+	write8(ctx, WR.IX + (signed char) read8(ctx, ctx->PC++), BR.B);
+	
+}
+
+
+static void LD_off_IX_d_C (Z180Context* ctx)
+{
+	ctx->tstates += 5;
+	write8(ctx, WR.IX + (signed char) read8(ctx, ctx->PC++), BR.C);
+	
+}
+
+
+static void LD_off_IX_d_D (Z180Context* ctx)
+{
+	ctx->tstates += 5;
+	write8(ctx, WR.IX + (signed char) read8(ctx, ctx->PC++), BR.D);
+	
+}
+
+
+static void LD_off_IX_d_E (Z180Context* ctx)
+{
+	ctx->tstates += 5;
+	write8(ctx, WR.IX + (signed char) read8(ctx, ctx->PC++), BR.E);
+	
+}
+
+
+static void LD_off_IX_d_H (Z180Context* ctx)
+{
+	ctx->tstates += 5;
+	write8(ctx, WR.IX + (signed char) read8(ctx, ctx->PC++), BR.H);
+	
+}
+
+
+static void LD_off_IX_d_L (Z180Context* ctx)
+{
+	ctx->tstates += 5;
+	write8(ctx, WR.IX + (signed char) read8(ctx, ctx->PC++), BR.L);
+	
+}
+
+
+static void LD_off_IX_d_n (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	signed char offset = read8(ctx, ctx->PC++);
+	byte n = read8(ctx, ctx->PC++);
+	write8(ctx, WR.IX + offset, n);
+	
+}
+
+
+static void LD_off_IY_d_A (Z180Context* ctx)
+{
+	ctx->tstates += 5;
+	write8(ctx, WR.IY + (signed char) read8(ctx, ctx->PC++), BR.A);
+	
+}
+
+
+static void LD_off_IY_d_B (Z180Context* ctx)
+{
+	ctx->tstates += 5;
+	write8(ctx, WR.IY + (signed char) read8(ctx, ctx->PC++), BR.B);
+	
+}
+
+
+static void LD_off_IY_d_C (Z180Context* ctx)
+{
+	ctx->tstates += 5;
+	write8(ctx, WR.IY + (signed char) read8(ctx, ctx->PC++), BR.C);
+	
+}
+
+
+static void LD_off_IY_d_D (Z180Context* ctx)
+{
+	ctx->tstates += 5;
+	write8(ctx, WR.IY + (signed char) read8(ctx, ctx->PC++), BR.D);
+	
+}
+
+
+static void LD_off_IY_d_E (Z180Context* ctx)
+{
+	ctx->tstates += 5;
+	write8(ctx, WR.IY + (signed char) read8(ctx, ctx->PC++), BR.E);
+	
+}
+
+
+static void LD_off_IY_d_H (Z180Context* ctx)
+{
+	ctx->tstates += 5;
+	write8(ctx, WR.IY + (signed char) read8(ctx, ctx->PC++), BR.H);
+	
+}
+
+
+static void LD_off_IY_d_L (Z180Context* ctx)
+{
+	ctx->tstates += 5;
+	write8(ctx, WR.IY + (signed char) read8(ctx, ctx->PC++), BR.L);
+	
+}
+
+
+static void LD_off_IY_d_n (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	signed char offset = read8(ctx, ctx->PC++);
+	byte n = read8(ctx, ctx->PC++);
+	write8(ctx, WR.IY + offset, n);
+	
+}
+
+
+static void LD_off_nn_A (Z180Context* ctx)
+{
+	write8(ctx, read16(ctx, ctx->PC), BR.A);
+	ctx->PC += 2;
+	
+}
+
+
+static void LD_off_nn_BC (Z180Context* ctx)
+{
+	write16(ctx, read16(ctx, ctx->PC), WR.BC);
+	ctx->PC += 2;
+	
+}
+
+
+static void LD_off_nn_DE (Z180Context* ctx)
+{
+	write16(ctx, read16(ctx, ctx->PC), WR.DE);
+	ctx->PC += 2;
+	
+}
+
+
+static void LD_off_nn_HL (Z180Context* ctx)
+{
+	write16(ctx, read16(ctx, ctx->PC), WR.HL);
+	ctx->PC += 2;
+	
+}
+
+
+static void LD_off_nn_IX (Z180Context* ctx)
+{
+	write16(ctx, read16(ctx, ctx->PC), WR.IX);
+	ctx->PC += 2;
+	
+}
+
+
+static void LD_off_nn_IY (Z180Context* ctx)
+{
+	write16(ctx, read16(ctx, ctx->PC), WR.IY);
+	ctx->PC += 2;
+	
+}
+
+
+static void LD_off_nn_SP (Z180Context* ctx)
+{
+	write16(ctx, read16(ctx, ctx->PC), WR.SP);
+	ctx->PC += 2;
+	
+}
+
+
+static void LD_A_off_BC (Z180Context* ctx)
+{
+	BR.A = read8(ctx, WR.BC);
+}
+
+
+static void LD_A_off_DE (Z180Context* ctx)
+{
+	BR.A = read8(ctx, WR.DE);
+}
+
+
+static void LD_A_off_HL (Z180Context* ctx)
+{
+	BR.A = read8(ctx, WR.HL);
+}
+
+
+static void LD_A_off_IX_d (Z180Context* ctx)
+{
+	ctx->tstates += 5;
+	BR.A = read8(ctx, WR.IX + (signed char) read8(ctx, ctx->PC++));
+}
+
+
+static void LD_A_off_IY_d (Z180Context* ctx)
+{
+	ctx->tstates += 5;
+	BR.A = read8(ctx, WR.IY + (signed char) read8(ctx, ctx->PC++));
+}
+
+
+static void LD_A_off_nn (Z180Context* ctx)
+{
+	BR.A = read8(ctx, read16(ctx, ctx->PC));
+	ctx->PC += 2;
+	
+}
+
+
+static void LD_A_A (Z180Context* ctx)
+{
+	BR.A = BR.A;
+}
+
+
+static void LD_A_B (Z180Context* ctx)
+{
+	BR.A = BR.B;
+}
+
+
+static void LD_A_C (Z180Context* ctx)
+{
+	BR.A = BR.C;
+}
+
+
+static void LD_A_D (Z180Context* ctx)
+{
+	BR.A = BR.D;
+}
+
+
+static void LD_A_E (Z180Context* ctx)
+{
+	BR.A = BR.E;
+}
+
+
+static void LD_A_H (Z180Context* ctx)
+{
+	BR.A = BR.H;
+}
+
+
+static void LD_A_I (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	BR.A = ctx->I;
+	adjustFlags(ctx, BR.A);
+	RESFLAG(F_H | F_N);
+	VALFLAG(F_PV, ctx->IFF2);
+	VALFLAG(F_S, (BR.A & 0x80) != 0);
+	VALFLAG(F_Z, (BR.A == 0));
+	
+}
+
+
+static void LD_A_L (Z180Context* ctx)
+{
+	BR.A = BR.L;
+}
+
+
+static void LD_A_n (Z180Context* ctx)
+{
+	BR.A = read8(ctx, ctx->PC++);
+	
+}
+
+
+static void LD_A_R (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	BR.A = ctx->R;
+	adjustFlags(ctx, BR.A);
+	RESFLAG(F_H | F_N);
+	VALFLAG(F_PV, ctx->IFF2);
+	VALFLAG(F_S, (BR.A & 0x80) != 0);
+	VALFLAG(F_Z, (BR.A == 0));
+	
+}
+
+
+static void LD_B_off_HL (Z180Context* ctx)
+{
+	BR.B = read8(ctx, WR.HL);
+}
+
+
+static void LD_B_off_IX_d (Z180Context* ctx)
+{
+	ctx->tstates += 5;
+	BR.B = read8(ctx, WR.IX + (signed char) read8(ctx, ctx->PC++));
+}
+
+
+static void LD_B_off_IY_d (Z180Context* ctx)
+{
+	ctx->tstates += 5;
+	BR.B = read8(ctx, WR.IY + (signed char) read8(ctx, ctx->PC++));
+}
+
+
+static void LD_B_A (Z180Context* ctx)
+{
+	BR.B = BR.A;
+}
+
+
+static void LD_B_B (Z180Context* ctx)
+{
+	BR.B = BR.B;
+}
+
+
+static void LD_B_C (Z180Context* ctx)
+{
+	BR.B = BR.C;
+}
+
+
+static void LD_B_D (Z180Context* ctx)
+{
+	BR.B = BR.D;
+}
+
+
+static void LD_B_E (Z180Context* ctx)
+{
+	BR.B = BR.E;
+}
+
+
+static void LD_B_H (Z180Context* ctx)
+{
+	BR.B = BR.H;
+}
+
+
+static void LD_B_L (Z180Context* ctx)
+{
+	BR.B = BR.L;
+}
+
+
+static void LD_B_n (Z180Context* ctx)
+{
+	BR.B = read8(ctx, ctx->PC++);
+	
+}
+
+
+static void LD_BC_off_nn (Z180Context* ctx)
+{
+	ushort addr = read16(ctx, ctx->PC);
+	ctx->PC += 2;
+	WR.BC = read16(ctx, addr);	
+}
+
+
+static void LD_BC_nn (Z180Context* ctx)
+{
+	WR.BC = read16(ctx, ctx->PC);
+	ctx->PC += 2;
+	
+}
+
+
+static void LD_C_off_HL (Z180Context* ctx)
+{
+	BR.C = read8(ctx, WR.HL);
+}
+
+
+static void LD_C_off_IX_d (Z180Context* ctx)
+{
+	ctx->tstates += 5;
+	BR.C = read8(ctx, WR.IX + (signed char) read8(ctx, ctx->PC++));
+}
+
+
+static void LD_C_off_IY_d (Z180Context* ctx)
+{
+	ctx->tstates += 5;
+	BR.C = read8(ctx, WR.IY + (signed char) read8(ctx, ctx->PC++));
+}
+
+
+static void LD_C_A (Z180Context* ctx)
+{
+	BR.C = BR.A;
+}
+
+
+static void LD_C_B (Z180Context* ctx)
+{
+	BR.C = BR.B;
+}
+
+
+static void LD_C_C (Z180Context* ctx)
+{
+	BR.C = BR.C;
+}
+
+
+static void LD_C_D (Z180Context* ctx)
+{
+	BR.C = BR.D;
+}
+
+
+static void LD_C_E (Z180Context* ctx)
+{
+	BR.C = BR.E;
+}
+
+
+static void LD_C_H (Z180Context* ctx)
+{
+	BR.C = BR.H;
+}
+
+
+static void LD_C_L (Z180Context* ctx)
+{
+	BR.C = BR.L;
+}
+
+
+static void LD_C_n (Z180Context* ctx)
+{
+	BR.C = read8(ctx, ctx->PC++);
+	
+}
+
+
+static void LD_D_off_HL (Z180Context* ctx)
+{
+	BR.D = read8(ctx, WR.HL);
+}
+
+
+static void LD_D_off_IX_d (Z180Context* ctx)
+{
+	ctx->tstates += 5;
+	BR.D = read8(ctx, WR.IX + (signed char) read8(ctx, ctx->PC++));
+}
+
+
+static void LD_D_off_IY_d (Z180Context* ctx)
+{
+	ctx->tstates += 5;
+	BR.D = read8(ctx, WR.IY + (signed char) read8(ctx, ctx->PC++));
+}
+
+
+static void LD_D_A (Z180Context* ctx)
+{
+	BR.D = BR.A;
+}
+
+
+static void LD_D_B (Z180Context* ctx)
+{
+	BR.D = BR.B;
+}
+
+
+static void LD_D_C (Z180Context* ctx)
+{
+	BR.D = BR.C;
+}
+
+
+static void LD_D_D (Z180Context* ctx)
+{
+	BR.D = BR.D;
+}
+
+
+static void LD_D_E (Z180Context* ctx)
+{
+	BR.D = BR.E;
+}
+
+
+static void LD_D_H (Z180Context* ctx)
+{
+	BR.D = BR.H;
+}
+
+
+static void LD_D_L (Z180Context* ctx)
+{
+	BR.D = BR.L;
+}
+
+
+static void LD_D_n (Z180Context* ctx)
+{
+	BR.D = read8(ctx, ctx->PC++);
+	
+}
+
+
+static void LD_DE_off_nn (Z180Context* ctx)
+{
+	ushort addr = read16(ctx, ctx->PC);
+	ctx->PC += 2;
+	WR.DE = read16(ctx, addr);	
+}
+
+
+static void LD_DE_nn (Z180Context* ctx)
+{
+	WR.DE = read16(ctx, ctx->PC);
+	ctx->PC += 2;
+	
+}
+
+
+static void LD_E_off_HL (Z180Context* ctx)
+{
+	BR.E = read8(ctx, WR.HL);
+}
+
+
+static void LD_E_off_IX_d (Z180Context* ctx)
+{
+	ctx->tstates += 5;
+	BR.E = read8(ctx, WR.IX + (signed char) read8(ctx, ctx->PC++));
+}
+
+
+static void LD_E_off_IY_d (Z180Context* ctx)
+{
+	ctx->tstates += 5;
+	BR.E = read8(ctx, WR.IY + (signed char) read8(ctx, ctx->PC++));
+}
+
+
+static void LD_E_A (Z180Context* ctx)
+{
+	BR.E = BR.A;
+}
+
+
+static void LD_E_B (Z180Context* ctx)
+{
+	BR.E = BR.B;
+}
+
+
+static void LD_E_C (Z180Context* ctx)
+{
+	BR.E = BR.C;
+}
+
+
+static void LD_E_D (Z180Context* ctx)
+{
+	BR.E = BR.D;
+}
+
+
+static void LD_E_E (Z180Context* ctx)
+{
+	BR.E = BR.E;
+}
+
+
+static void LD_E_H (Z180Context* ctx)
+{
+	BR.E = BR.H;
+}
+
+
+static void LD_E_L (Z180Context* ctx)
+{
+	BR.E = BR.L;
+}
+
+
+static void LD_E_n (Z180Context* ctx)
+{
+	BR.E = read8(ctx, ctx->PC++);
+	
+}
+
+
+static void LD_H_off_HL (Z180Context* ctx)
+{
+	BR.H = read8(ctx, WR.HL);
+}
+
+
+static void LD_H_off_IX_d (Z180Context* ctx)
+{
+	ctx->tstates += 5;
+	BR.H = read8(ctx, WR.IX + (signed char) read8(ctx, ctx->PC++));
+}
+
+
+static void LD_H_off_IY_d (Z180Context* ctx)
+{
+	ctx->tstates += 5;
+	BR.H = read8(ctx, WR.IY + (signed char) read8(ctx, ctx->PC++));
+}
+
+
+static void LD_H_A (Z180Context* ctx)
+{
+	BR.H = BR.A;
+}
+
+
+static void LD_H_B (Z180Context* ctx)
+{
+	BR.H = BR.B;
+}
+
+
+static void LD_H_C (Z180Context* ctx)
+{
+	BR.H = BR.C;
+}
+
+
+static void LD_H_D (Z180Context* ctx)
+{
+	BR.H = BR.D;
+}
+
+
+static void LD_H_E (Z180Context* ctx)
+{
+	BR.H = BR.E;
+}
+
+
+static void LD_H_H (Z180Context* ctx)
+{
+	BR.H = BR.H;
+}
+
+
+static void LD_H_L (Z180Context* ctx)
+{
+	BR.H = BR.L;
+}
+
+
+static void LD_H_n (Z180Context* ctx)
+{
+	BR.H = read8(ctx, ctx->PC++);
+	
+}
+
+
+static void LD_HL_off_nn (Z180Context* ctx)
+{
+	ushort addr = read16(ctx, ctx->PC);
+	ctx->PC += 2;
+	WR.HL = read16(ctx, addr);	
+}
+
+
+static void LD_HL_nn (Z180Context* ctx)
+{
+	WR.HL = read16(ctx, ctx->PC);
+	ctx->PC += 2;
+	
+}
+
+
+static void LD_I_A (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	ctx->I = BR.A;
+}
+
+
+static void LD_IX_off_nn (Z180Context* ctx)
+{
+	ushort addr = read16(ctx, ctx->PC);
+	ctx->PC += 2;
+	WR.IX = read16(ctx, addr);	
+}
+
+
+static void LD_IX_nn (Z180Context* ctx)
+{
+	WR.IX = read16(ctx, ctx->PC);
+	ctx->PC += 2;
+	
+}
+
+
+static void LD_IY_off_nn (Z180Context* ctx)
+{
+	ushort addr = read16(ctx, ctx->PC);
+	ctx->PC += 2;
+	WR.IY = read16(ctx, addr);	
+}
+
+
+static void LD_IY_nn (Z180Context* ctx)
+{
+	WR.IY = read16(ctx, ctx->PC);
+	ctx->PC += 2;
+	
+}
+
+
+static void LD_L_off_HL (Z180Context* ctx)
+{
+	BR.L = read8(ctx, WR.HL);
+}
+
+
+static void LD_L_off_IX_d (Z180Context* ctx)
+{
+	ctx->tstates += 5;
+	BR.L = read8(ctx, WR.IX + (signed char) read8(ctx, ctx->PC++));
+}
+
+
+static void LD_L_off_IY_d (Z180Context* ctx)
+{
+	ctx->tstates += 5;
+	BR.L = read8(ctx, WR.IY + (signed char) read8(ctx, ctx->PC++));
+}
+
+
+static void LD_L_A (Z180Context* ctx)
+{
+	BR.L = BR.A;
+}
+
+
+static void LD_L_B (Z180Context* ctx)
+{
+	BR.L = BR.B;
+}
+
+
+static void LD_L_C (Z180Context* ctx)
+{
+	BR.L = BR.C;
+}
+
+
+static void LD_L_D (Z180Context* ctx)
+{
+	BR.L = BR.D;
+}
+
+
+static void LD_L_E (Z180Context* ctx)
+{
+	BR.L = BR.E;
+}
+
+
+static void LD_L_H (Z180Context* ctx)
+{
+	BR.L = BR.H;
+}
+
+
+static void LD_L_L (Z180Context* ctx)
+{
+	BR.L = BR.L;
+}
+
+
+static void LD_L_n (Z180Context* ctx)
+{
+	BR.L = read8(ctx, ctx->PC++);
+	
+}
+
+
+static void LD_R_A (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	ctx->R = BR.A;
+}
+
+
+static void LD_SP_off_nn (Z180Context* ctx)
+{
+	ushort addr = read16(ctx, ctx->PC);
+	ctx->PC += 2;
+	WR.SP = read16(ctx, addr);	
+}
+
+
+static void LD_SP_HL (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	WR.SP = WR.HL;
+}
+
+
+static void LD_SP_IX (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	WR.SP = WR.IX;
+}
+
+
+static void LD_SP_IY (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	WR.SP = WR.IY;
+}
+
+
+static void LD_SP_nn (Z180Context* ctx)
+{
+	WR.SP = read16(ctx, ctx->PC);
+	ctx->PC += 2;
+	
+}
+
+
+static void LDD (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	byte val = read8(ctx, WR.HL);
+	write8(ctx, WR.DE, val);
+	WR.DE--;
+	WR.HL--;
+	WR.BC--;
+	VALFLAG(F_5, ((BR.A + val) & 0x02) != 0);
+	VALFLAG(F_3, ((BR.A + val) & F_3) != 0);
+	RESFLAG(F_H | F_N);
+	VALFLAG(F_PV, WR.BC != 0);
+}
+
+
+static void LDDR (Z180Context* ctx)
+{
+	LDD(ctx);
+	if (WR.BC != 0)
+	{
+		ctx->tstates += 5;
+		ctx->PC -= 2;
+	}
+}
+
+
+static void LDI (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	byte val = read8(ctx, WR.HL);
+	write8(ctx, WR.DE, val);
+	WR.DE++;
+	WR.HL++;
+	WR.BC--;
+	VALFLAG(F_5, (BR.A + val) & 0x02);
+	VALFLAG(F_3, ((BR.A + val) & F_3) != 0);
+	RESFLAG(F_H | F_N);
+	VALFLAG(F_PV, WR.BC != 0);
+}
+
+
+static void LDIR (Z180Context* ctx)
+{
+	LDI(ctx);
+	if (WR.BC != 0)
+	{
+		ctx->tstates += 5;
+		ctx->PC -= 2;
+	}
+}
+
+
+static void NEG (Z180Context* ctx)
+{
+	int temp = BR.A;
+	BR.A = 0;
+	BR.A = doArithmetic(ctx, temp, 0, 1);
+	SETFLAG(F_N);
+}
+
+
+static void NOP (Z180Context* ctx)
+{
+	/* NOP */
+	
+}
+
+
+static void OR_off_HL (Z180Context* ctx)
+{
+	doOR(ctx, read8(ctx, WR.HL));
+}
+
+
+static void OR_off_IX_d (Z180Context* ctx)
+{
+	ctx->tstates += 5;
+	doOR(ctx, read8(ctx, WR.IX + (signed char) read8(ctx, ctx->PC++)));
+}
+
+
+static void OR_off_IY_d (Z180Context* ctx)
+{
+	ctx->tstates += 5;
+	doOR(ctx, read8(ctx, WR.IY + (signed char) read8(ctx, ctx->PC++)));
+}
+
+
+static void OR_A (Z180Context* ctx)
+{
+	doOR(ctx, BR.A);
+}
+
+
+static void OR_B (Z180Context* ctx)
+{
+	doOR(ctx, BR.B);
+}
+
+
+static void OR_C (Z180Context* ctx)
+{
+	doOR(ctx, BR.C);
+}
+
+
+static void OR_D (Z180Context* ctx)
+{
+	doOR(ctx, BR.D);
+}
+
+
+static void OR_E (Z180Context* ctx)
+{
+	doOR(ctx, BR.E);
+}
+
+
+static void OR_H (Z180Context* ctx)
+{
+	doOR(ctx, BR.H);
+}
+
+
+static void OR_L (Z180Context* ctx)
+{
+	doOR(ctx, BR.L);
+}
+
+
+static void OR_n (Z180Context* ctx)
+{
+	doOR(ctx, read8(ctx, ctx->PC++));
+}
+
+
+static void OTDR (Z180Context* ctx)
+{
+	OUTD(ctx);
+	if (BR.B != 0)
+	{
+		ctx->tstates += 5;
+		ctx->PC -= 2;
+	}
+}
+
+
+static void OTIR (Z180Context* ctx)
+{
+	OUTI(ctx);
+	if (BR.B != 0)
+	{
+		ctx->tstates += 5;
+		ctx->PC -= 2;
+	}
+}
+
+
+static void OUT_off_C_A (Z180Context* ctx)
+{
+	ioWrite(ctx, WR.BC, BR.A);
+}
+
+
+static void OUT_off_C_B (Z180Context* ctx)
+{
+	ioWrite(ctx, WR.BC, BR.B);
+}
+
+
+static void OUT_off_C_C (Z180Context* ctx)
+{
+	ioWrite(ctx, WR.BC, BR.C);
+}
+
+
+static void OUT_off_C_D (Z180Context* ctx)
+{
+	ioWrite(ctx, WR.BC, BR.D);
+}
+
+
+static void OUT_off_C_E (Z180Context* ctx)
+{
+	ioWrite(ctx, WR.BC, BR.E);
+}
+
+
+static void OUT_off_C_H (Z180Context* ctx)
+{
+	ioWrite(ctx, WR.BC, BR.H);
+}
+
+
+static void OUT_off_C_L (Z180Context* ctx)
+{
+	ioWrite(ctx, WR.BC, BR.L);
+}
+
+
+static void OUT_off_n_A (Z180Context* ctx)
+{
+	ioWrite(ctx, BR.A << 8 | read8(ctx, ctx->PC++), BR.A);
+}
+
+
+static void OUTD (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	byte value = read8(ctx, WR.HL);
+	BR.B = doIncDec(ctx, BR.B, 1);
+	ioWrite(ctx, WR.BC, value);
+	WR.HL--;
+	int flag_value = value + BR.L;
+	VALFLAG(F_N, value & 0x80);
+	VALFLAG(F_H, flag_value > 0xff);
+	VALFLAG(F_C, flag_value > 0xff);
+	VALFLAG(F_PV, parityBit[(flag_value & 7) ^ BR.B]);
+	adjustFlags(ctx, BR.B);
+}
+
+
+static void OUTI (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	byte value = read8(ctx, WR.HL);
+	BR.B = doIncDec(ctx, BR.B, 1);
+	ioWrite(ctx, WR.BC, value);
+	WR.HL++;
+	int flag_value = value + BR.L;
+	VALFLAG(F_N, value & 0x80);
+	VALFLAG(F_H, flag_value > 0xff);
+	VALFLAG(F_C, flag_value > 0xff);
+	VALFLAG(F_PV, parityBit[(flag_value & 7) ^ BR.B]);
+	adjustFlags(ctx, BR.B);
+}
+
+
+static void POP_AF (Z180Context* ctx)
+{
+	WR.AF = doPop(ctx);
+}
+
+
+static void POP_BC (Z180Context* ctx)
+{
+	WR.BC = doPop(ctx);
+}
+
+
+static void POP_DE (Z180Context* ctx)
+{
+	WR.DE = doPop(ctx);
+}
+
+
+static void POP_HL (Z180Context* ctx)
+{
+	WR.HL = doPop(ctx);
+}
+
+
+static void POP_IX (Z180Context* ctx)
+{
+	WR.IX = doPop(ctx);
+}
+
+
+static void POP_IY (Z180Context* ctx)
+{
+	WR.IY = doPop(ctx);
+}
+
+
+static void PUSH_AF (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	doPush(ctx, WR.AF);
+}
+
+
+static void PUSH_BC (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	doPush(ctx, WR.BC);
+}
+
+
+static void PUSH_DE (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	doPush(ctx, WR.DE);
+}
+
+
+static void PUSH_HL (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	doPush(ctx, WR.HL);
+}
+
+
+static void PUSH_IX (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	doPush(ctx, WR.IX);
+}
+
+
+static void PUSH_IY (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	doPush(ctx, WR.IY);
+}
+
+
+static void RES_0_off_HL (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	write8(ctx, WR.HL, doSetRes(ctx, SR_RES, 0, read8(ctx, WR.HL)));
+}
+
+
+static void RES_0_off_IX_d (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	signed char off = read8(ctx, ctx->PC++);
+	write8(ctx, WR.IX + off, doSetRes(ctx, SR_RES, 0, read8(ctx, WR.IX + off)));
+	
+	
+}
+
+
+static void RES_0_off_IY_d (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	signed char off = read8(ctx, ctx->PC++);
+	write8(ctx, WR.IY + off, doSetRes(ctx, SR_RES, 0, read8(ctx, WR.IY + off)));
+	
+	
+}
+
+
+static void RES_0_A (Z180Context* ctx)
+{
+	BR.A = doSetRes(ctx, SR_RES, 0, BR.A);
+}
+
+
+static void RES_0_B (Z180Context* ctx)
+{
+	BR.B = doSetRes(ctx, SR_RES, 0, BR.B);
+}
+
+
+static void RES_0_C (Z180Context* ctx)
+{
+	BR.C = doSetRes(ctx, SR_RES, 0, BR.C);
+}
+
+
+static void RES_0_D (Z180Context* ctx)
+{
+	BR.D = doSetRes(ctx, SR_RES, 0, BR.D);
+}
+
+
+static void RES_0_E (Z180Context* ctx)
+{
+	BR.E = doSetRes(ctx, SR_RES, 0, BR.E);
+}
+
+
+static void RES_0_H (Z180Context* ctx)
+{
+	BR.H = doSetRes(ctx, SR_RES, 0, BR.H);
+}
+
+
+static void RES_0_L (Z180Context* ctx)
+{
+	BR.L = doSetRes(ctx, SR_RES, 0, BR.L);
+}
+
+
+static void RES_1_off_HL (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	write8(ctx, WR.HL, doSetRes(ctx, SR_RES, 1, read8(ctx, WR.HL)));
+}
+
+
+static void RES_1_off_IX_d (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	signed char off = read8(ctx, ctx->PC++);
+	write8(ctx, WR.IX + off, doSetRes(ctx, SR_RES, 1, read8(ctx, WR.IX + off)));
+	
+	
+}
+
+
+static void RES_1_off_IY_d (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	signed char off = read8(ctx, ctx->PC++);
+	write8(ctx, WR.IY + off, doSetRes(ctx, SR_RES, 1, read8(ctx, WR.IY + off)));
+	
+	
+}
+
+
+static void RES_1_A (Z180Context* ctx)
+{
+	BR.A = doSetRes(ctx, SR_RES, 1, BR.A);
+}
+
+
+static void RES_1_B (Z180Context* ctx)
+{
+	BR.B = doSetRes(ctx, SR_RES, 1, BR.B);
+}
+
+
+static void RES_1_C (Z180Context* ctx)
+{
+	BR.C = doSetRes(ctx, SR_RES, 1, BR.C);
+}
+
+
+static void RES_1_D (Z180Context* ctx)
+{
+	BR.D = doSetRes(ctx, SR_RES, 1, BR.D);
+}
+
+
+static void RES_1_E (Z180Context* ctx)
+{
+	BR.E = doSetRes(ctx, SR_RES, 1, BR.E);
+}
+
+
+static void RES_1_H (Z180Context* ctx)
+{
+	BR.H = doSetRes(ctx, SR_RES, 1, BR.H);
+}
+
+
+static void RES_1_L (Z180Context* ctx)
+{
+	BR.L = doSetRes(ctx, SR_RES, 1, BR.L);
+}
+
+
+static void RES_2_off_HL (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	write8(ctx, WR.HL, doSetRes(ctx, SR_RES, 2, read8(ctx, WR.HL)));
+}
+
+
+static void RES_2_off_IX_d (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	signed char off = read8(ctx, ctx->PC++);
+	write8(ctx, WR.IX + off, doSetRes(ctx, SR_RES, 2, read8(ctx, WR.IX + off)));
+	
+	
+}
+
+
+static void RES_2_off_IY_d (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	signed char off = read8(ctx, ctx->PC++);
+	write8(ctx, WR.IY + off, doSetRes(ctx, SR_RES, 2, read8(ctx, WR.IY + off)));
+	
+	
+}
+
+
+static void RES_2_A (Z180Context* ctx)
+{
+	BR.A = doSetRes(ctx, SR_RES, 2, BR.A);
+}
+
+
+static void RES_2_B (Z180Context* ctx)
+{
+	BR.B = doSetRes(ctx, SR_RES, 2, BR.B);
+}
+
+
+static void RES_2_C (Z180Context* ctx)
+{
+	BR.C = doSetRes(ctx, SR_RES, 2, BR.C);
+}
+
+
+static void RES_2_D (Z180Context* ctx)
+{
+	BR.D = doSetRes(ctx, SR_RES, 2, BR.D);
+}
+
+
+static void RES_2_E (Z180Context* ctx)
+{
+	BR.E = doSetRes(ctx, SR_RES, 2, BR.E);
+}
+
+
+static void RES_2_H (Z180Context* ctx)
+{
+	BR.H = doSetRes(ctx, SR_RES, 2, BR.H);
+}
+
+
+static void RES_2_L (Z180Context* ctx)
+{
+	BR.L = doSetRes(ctx, SR_RES, 2, BR.L);
+}
+
+
+static void RES_3_off_HL (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	write8(ctx, WR.HL, doSetRes(ctx, SR_RES, 3, read8(ctx, WR.HL)));
+}
+
+
+static void RES_3_off_IX_d (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	signed char off = read8(ctx, ctx->PC++);
+	write8(ctx, WR.IX + off, doSetRes(ctx, SR_RES, 3, read8(ctx, WR.IX + off)));
+	
+	
+}
+
+
+static void RES_3_off_IY_d (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	signed char off = read8(ctx, ctx->PC++);
+	write8(ctx, WR.IY + off, doSetRes(ctx, SR_RES, 3, read8(ctx, WR.IY + off)));
+	
+	
+}
+
+
+static void RES_3_A (Z180Context* ctx)
+{
+	BR.A = doSetRes(ctx, SR_RES, 3, BR.A);
+}
+
+
+static void RES_3_B (Z180Context* ctx)
+{
+	BR.B = doSetRes(ctx, SR_RES, 3, BR.B);
+}
+
+
+static void RES_3_C (Z180Context* ctx)
+{
+	BR.C = doSetRes(ctx, SR_RES, 3, BR.C);
+}
+
+
+static void RES_3_D (Z180Context* ctx)
+{
+	BR.D = doSetRes(ctx, SR_RES, 3, BR.D);
+}
+
+
+static void RES_3_E (Z180Context* ctx)
+{
+	BR.E = doSetRes(ctx, SR_RES, 3, BR.E);
+}
+
+
+static void RES_3_H (Z180Context* ctx)
+{
+	BR.H = doSetRes(ctx, SR_RES, 3, BR.H);
+}
+
+
+static void RES_3_L (Z180Context* ctx)
+{
+	BR.L = doSetRes(ctx, SR_RES, 3, BR.L);
+}
+
+
+static void RES_4_off_HL (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	write8(ctx, WR.HL, doSetRes(ctx, SR_RES, 4, read8(ctx, WR.HL)));
+}
+
+
+static void RES_4_off_IX_d (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	signed char off = read8(ctx, ctx->PC++);
+	write8(ctx, WR.IX + off, doSetRes(ctx, SR_RES, 4, read8(ctx, WR.IX + off)));
+	
+	
+}
+
+
+static void RES_4_off_IY_d (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	signed char off = read8(ctx, ctx->PC++);
+	write8(ctx, WR.IY + off, doSetRes(ctx, SR_RES, 4, read8(ctx, WR.IY + off)));
+	
+	
+}
+
+
+static void RES_4_A (Z180Context* ctx)
+{
+	BR.A = doSetRes(ctx, SR_RES, 4, BR.A);
+}
+
+
+static void RES_4_B (Z180Context* ctx)
+{
+	BR.B = doSetRes(ctx, SR_RES, 4, BR.B);
+}
+
+
+static void RES_4_C (Z180Context* ctx)
+{
+	BR.C = doSetRes(ctx, SR_RES, 4, BR.C);
+}
+
+
+static void RES_4_D (Z180Context* ctx)
+{
+	BR.D = doSetRes(ctx, SR_RES, 4, BR.D);
+}
+
+
+static void RES_4_E (Z180Context* ctx)
+{
+	BR.E = doSetRes(ctx, SR_RES, 4, BR.E);
+}
+
+
+static void RES_4_H (Z180Context* ctx)
+{
+	BR.H = doSetRes(ctx, SR_RES, 4, BR.H);
+}
+
+
+static void RES_4_L (Z180Context* ctx)
+{
+	BR.L = doSetRes(ctx, SR_RES, 4, BR.L);
+}
+
+
+static void RES_5_off_HL (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	write8(ctx, WR.HL, doSetRes(ctx, SR_RES, 5, read8(ctx, WR.HL)));
+}
+
+
+static void RES_5_off_IX_d (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	signed char off = read8(ctx, ctx->PC++);
+	write8(ctx, WR.IX + off, doSetRes(ctx, SR_RES, 5, read8(ctx, WR.IX + off)));
+	
+	
+}
+
+
+static void RES_5_off_IY_d (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	signed char off = read8(ctx, ctx->PC++);
+	write8(ctx, WR.IY + off, doSetRes(ctx, SR_RES, 5, read8(ctx, WR.IY + off)));
+	
+	
+}
+
+
+static void RES_5_A (Z180Context* ctx)
+{
+	BR.A = doSetRes(ctx, SR_RES, 5, BR.A);
+}
+
+
+static void RES_5_B (Z180Context* ctx)
+{
+	BR.B = doSetRes(ctx, SR_RES, 5, BR.B);
+}
+
+
+static void RES_5_C (Z180Context* ctx)
+{
+	BR.C = doSetRes(ctx, SR_RES, 5, BR.C);
+}
+
+
+static void RES_5_D (Z180Context* ctx)
+{
+	BR.D = doSetRes(ctx, SR_RES, 5, BR.D);
+}
+
+
+static void RES_5_E (Z180Context* ctx)
+{
+	BR.E = doSetRes(ctx, SR_RES, 5, BR.E);
+}
+
+
+static void RES_5_H (Z180Context* ctx)
+{
+	BR.H = doSetRes(ctx, SR_RES, 5, BR.H);
+}
+
+
+static void RES_5_L (Z180Context* ctx)
+{
+	BR.L = doSetRes(ctx, SR_RES, 5, BR.L);
+}
+
+
+static void RES_6_off_HL (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	write8(ctx, WR.HL, doSetRes(ctx, SR_RES, 6, read8(ctx, WR.HL)));
+}
+
+
+static void RES_6_off_IX_d (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	signed char off = read8(ctx, ctx->PC++);
+	write8(ctx, WR.IX + off, doSetRes(ctx, SR_RES, 6, read8(ctx, WR.IX + off)));
+	
+	
+}
+
+
+static void RES_6_off_IY_d (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	signed char off = read8(ctx, ctx->PC++);
+	write8(ctx, WR.IY + off, doSetRes(ctx, SR_RES, 6, read8(ctx, WR.IY + off)));
+	
+	
+}
+
+
+static void RES_6_A (Z180Context* ctx)
+{
+	BR.A = doSetRes(ctx, SR_RES, 6, BR.A);
+}
+
+
+static void RES_6_B (Z180Context* ctx)
+{
+	BR.B = doSetRes(ctx, SR_RES, 6, BR.B);
+}
+
+
+static void RES_6_C (Z180Context* ctx)
+{
+	BR.C = doSetRes(ctx, SR_RES, 6, BR.C);
+}
+
+
+static void RES_6_D (Z180Context* ctx)
+{
+	BR.D = doSetRes(ctx, SR_RES, 6, BR.D);
+}
+
+
+static void RES_6_E (Z180Context* ctx)
+{
+	BR.E = doSetRes(ctx, SR_RES, 6, BR.E);
+}
+
+
+static void RES_6_H (Z180Context* ctx)
+{
+	BR.H = doSetRes(ctx, SR_RES, 6, BR.H);
+}
+
+
+static void RES_6_L (Z180Context* ctx)
+{
+	BR.L = doSetRes(ctx, SR_RES, 6, BR.L);
+}
+
+
+static void RES_7_off_HL (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	write8(ctx, WR.HL, doSetRes(ctx, SR_RES, 7, read8(ctx, WR.HL)));
+}
+
+
+static void RES_7_off_IX_d (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	signed char off = read8(ctx, ctx->PC++);
+	write8(ctx, WR.IX + off, doSetRes(ctx, SR_RES, 7, read8(ctx, WR.IX + off)));
+	
+	
+}
+
+
+static void RES_7_off_IY_d (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	signed char off = read8(ctx, ctx->PC++);
+	write8(ctx, WR.IY + off, doSetRes(ctx, SR_RES, 7, read8(ctx, WR.IY + off)));
+	
+	
+}
+
+
+static void RES_7_A (Z180Context* ctx)
+{
+	BR.A = doSetRes(ctx, SR_RES, 7, BR.A);
+}
+
+
+static void RES_7_B (Z180Context* ctx)
+{
+	BR.B = doSetRes(ctx, SR_RES, 7, BR.B);
+}
+
+
+static void RES_7_C (Z180Context* ctx)
+{
+	BR.C = doSetRes(ctx, SR_RES, 7, BR.C);
+}
+
+
+static void RES_7_D (Z180Context* ctx)
+{
+	BR.D = doSetRes(ctx, SR_RES, 7, BR.D);
+}
+
+
+static void RES_7_E (Z180Context* ctx)
+{
+	BR.E = doSetRes(ctx, SR_RES, 7, BR.E);
+}
+
+
+static void RES_7_H (Z180Context* ctx)
+{
+	BR.H = doSetRes(ctx, SR_RES, 7, BR.H);
+}
+
+
+static void RES_7_L (Z180Context* ctx)
+{
+	BR.L = doSetRes(ctx, SR_RES, 7, BR.L);
+}
+
+
+static void RET (Z180Context* ctx)
+{
+	ctx->PC = doPop(ctx);
+}
+
+
+static void RET_C (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	if (condition(ctx, C_C))
+		ctx->PC = doPop(ctx);
+		
+}
+
+
+static void RET_M (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	if (condition(ctx, C_M))
+		ctx->PC = doPop(ctx);
+		
+}
+
+
+static void RET_NC (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	if (condition(ctx, C_NC))
+		ctx->PC = doPop(ctx);
+		
+}
+
+
+static void RET_NZ (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	if (condition(ctx, C_NZ))
+		ctx->PC = doPop(ctx);
+		
+}
+
+
+static void RET_P (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	if (condition(ctx, C_P))
+		ctx->PC = doPop(ctx);
+		
+}
+
+
+static void RET_PE (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	if (condition(ctx, C_PE))
+		ctx->PC = doPop(ctx);
+		
+}
+
+
+static void RET_PO (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	if (condition(ctx, C_PO))
+		ctx->PC = doPop(ctx);
+		
+}
+
+
+static void RET_Z (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	if (condition(ctx, C_Z))
+		ctx->PC = doPop(ctx);
+		
+}
+
+
+static void RETI (Z180Context* ctx)
+{
+	ctx->IFF1 = ctx->IFF2;
+	ctx->tstates += 8;
+	RET		(ctx);
+		
+}
+
+
+static void RETN (Z180Context* ctx)
+{
+	ctx->IFF1 = ctx->IFF2;
+	RET(ctx);
+}
+
+
+static void RL_off_HL (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	write8(ctx, WR.HL, doRL(ctx, 1, read8(ctx, WR.HL)));
+	
+}
+
+
+static void RL_off_IX_d (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	signed char off = read8(ctx, ctx->PC++);
+	write8(ctx, WR.IX + off, doRL(ctx, 1, read8(ctx, WR.IX + off)));
+}
+
+
+static void RL_off_IY_d (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	signed char off = read8(ctx, ctx->PC++);
+	write8(ctx, WR.IY + off, doRL(ctx, 1, read8(ctx, WR.IY + off)));
+}
+
+
+static void RL_A (Z180Context* ctx)
+{
+	BR.A = doRL(ctx, 1, BR.A);
+}
+
+
+static void RL_B (Z180Context* ctx)
+{
+	BR.B = doRL(ctx, 1, BR.B);
+}
+
+
+static void RL_C (Z180Context* ctx)
+{
+	BR.C = doRL(ctx, 1, BR.C);
+}
+
+
+static void RL_D (Z180Context* ctx)
+{
+	BR.D = doRL(ctx, 1, BR.D);
+}
+
+
+static void RL_E (Z180Context* ctx)
+{
+	BR.E = doRL(ctx, 1, BR.E);
+}
+
+
+static void RL_H (Z180Context* ctx)
+{
+	BR.H = doRL(ctx, 1, BR.H);
+}
+
+
+static void RL_L (Z180Context* ctx)
+{
+	BR.L = doRL(ctx, 1, BR.L);
+}
+
+
+static void RLA (Z180Context* ctx)
+{
+	BR.A = doRL(ctx, 0, BR.A);
+	
+	
+}
+
+
+static void RLC_off_HL (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	write8(ctx, WR.HL, doRLC(ctx, 1, read8(ctx, WR.HL)));
+	
+}
+
+
+static void RLC_off_IX_d (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	signed char off = read8(ctx, ctx->PC++);
+	write8(ctx, WR.IX + off, doRLC(ctx, 1, read8(ctx, WR.IX + off)));
+}
+
+
+static void RLC_off_IY_d (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	signed char off = read8(ctx, ctx->PC++);
+	write8(ctx, WR.IY + off, doRLC(ctx, 1, read8(ctx, WR.IY + off)));
+}
+
+
+static void RLC_A (Z180Context* ctx)
+{
+	BR.A = doRLC(ctx, 1, BR.A);
+}
+
+
+static void RLC_B (Z180Context* ctx)
+{
+	BR.B = doRLC(ctx, 1, BR.B);
+}
+
+
+static void RLC_C (Z180Context* ctx)
+{
+	BR.C = doRLC(ctx, 1, BR.C);
+}
+
+
+static void RLC_D (Z180Context* ctx)
+{
+	BR.D = doRLC(ctx, 1, BR.D);
+}
+
+
+static void RLC_E (Z180Context* ctx)
+{
+	BR.E = doRLC(ctx, 1, BR.E);
+}
+
+
+static void RLC_H (Z180Context* ctx)
+{
+	BR.H = doRLC(ctx, 1, BR.H);
+}
+
+
+static void RLC_L (Z180Context* ctx)
+{
+	BR.L = doRLC(ctx, 1, BR.L);
+}
+
+
+static void RLCA (Z180Context* ctx)
+{
+	BR.A = doRLC(ctx, 0, BR.A);
+	
+	
+}
+
+
+static void RLD (Z180Context* ctx)
+{
+	ctx->tstates += 4;
+	byte Ah = BR.A & 0x0f;
+	byte hl = read8(ctx, WR.HL);
+	BR.A = (BR.A & 0xf0) | ((hl & 0xf0) >> 4);
+	hl = (hl << 4) | Ah;
+	write8(ctx, WR.HL, hl);
+	RESFLAG(F_H | F_N);
+	adjustFlagSZP(ctx, hl);
+	adjustFlags(ctx, hl);
+}
+
+
+static void RR_off_HL (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	write8(ctx, WR.HL, doRR(ctx, 1, read8(ctx, WR.HL)));
+	
+}
+
+
+static void RR_off_IX_d (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	signed char off = read8(ctx, ctx->PC++);
+	write8(ctx, WR.IX + off, doRR(ctx, 1, read8(ctx, WR.IX + off)));
+}
+
+
+static void RR_off_IY_d (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	signed char off = read8(ctx, ctx->PC++);
+	write8(ctx, WR.IY + off, doRR(ctx, 1, read8(ctx, WR.IY + off)));
+}
+
+
+static void RR_A (Z180Context* ctx)
+{
+	BR.A = doRR(ctx, 1, BR.A);
+}
+
+
+static void RR_B (Z180Context* ctx)
+{
+	BR.B = doRR(ctx, 1, BR.B);
+}
+
+
+static void RR_C (Z180Context* ctx)
+{
+	BR.C = doRR(ctx, 1, BR.C);
+}
+
+
+static void RR_D (Z180Context* ctx)
+{
+	BR.D = doRR(ctx, 1, BR.D);
+}
+
+
+static void RR_E (Z180Context* ctx)
+{
+	BR.E = doRR(ctx, 1, BR.E);
+}
+
+
+static void RR_H (Z180Context* ctx)
+{
+	BR.H = doRR(ctx, 1, BR.H);
+}
+
+
+static void RR_L (Z180Context* ctx)
+{
+	BR.L = doRR(ctx, 1, BR.L);
+}
+
+
+static void RRA (Z180Context* ctx)
+{
+	BR.A = doRR(ctx, 0, BR.A);
+	
+	
+}
+
+
+static void RRC_off_HL (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	write8(ctx, WR.HL, doRRC(ctx, 1, read8(ctx, WR.HL)));
+	
+}
+
+
+static void RRC_off_IX_d (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	signed char off = read8(ctx, ctx->PC++);
+	write8(ctx, WR.IX + off, doRRC(ctx, 1, read8(ctx, WR.IX + off)));
+}
+
+
+static void RRC_off_IY_d (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	signed char off = read8(ctx, ctx->PC++);
+	write8(ctx, WR.IY + off, doRRC(ctx, 1, read8(ctx, WR.IY + off)));
+}
+
+
+static void RRC_A (Z180Context* ctx)
+{
+	BR.A = doRRC(ctx, 1, BR.A);
+}
+
+
+static void RRC_B (Z180Context* ctx)
+{
+	BR.B = doRRC(ctx, 1, BR.B);
+}
+
+
+static void RRC_C (Z180Context* ctx)
+{
+	BR.C = doRRC(ctx, 1, BR.C);
+}
+
+
+static void RRC_D (Z180Context* ctx)
+{
+	BR.D = doRRC(ctx, 1, BR.D);
+}
+
+
+static void RRC_E (Z180Context* ctx)
+{
+	BR.E = doRRC(ctx, 1, BR.E);
+}
+
+
+static void RRC_H (Z180Context* ctx)
+{
+	BR.H = doRRC(ctx, 1, BR.H);
+}
+
+
+static void RRC_L (Z180Context* ctx)
+{
+	BR.L = doRRC(ctx, 1, BR.L);
+}
+
+
+static void RRCA (Z180Context* ctx)
+{
+	BR.A = doRRC(ctx, 0, BR.A);
+	
+	
+}
+
+
+static void RRD (Z180Context* ctx)
+{
+	ctx->tstates += 4;
+	byte Ah = BR.A & 0x0f;
+	byte hl = read8(ctx, WR.HL);
+	BR.A = (BR.A & 0xf0) | (hl & 0x0f);
+	hl = (hl >> 4) | (Ah << 4);
+	write8(ctx, WR.HL, hl);
+	RESFLAG(F_H | F_N);
+	adjustFlagSZP(ctx, hl);
+}
+
+
+static void RST_0H (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	doPush(ctx, ctx->PC);
+	ctx->PC = 0x00;
+	
+	
+}
+
+
+static void RST_10H (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	doPush(ctx, ctx->PC);
+	ctx->PC = 0x010;
+	
+	
+}
+
+
+static void RST_18H (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	doPush(ctx, ctx->PC);
+	ctx->PC = 0x018;
+	
+	
+}
+
+
+static void RST_20H (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	doPush(ctx, ctx->PC);
+	ctx->PC = 0x020;
+	
+	
+}
+
+
+static void RST_28H (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	doPush(ctx, ctx->PC);
+	ctx->PC = 0x028;
+	
+	
+}
+
+
+static void RST_30H (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	doPush(ctx, ctx->PC);
+	ctx->PC = 0x030;
+	
+	
+}
+
+
+static void RST_38H (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	doPush(ctx, ctx->PC);
+	ctx->PC = 0x038;
+	
+	
+}
+
+
+static void RST_8H (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	doPush(ctx, ctx->PC);
+	ctx->PC = 0x08;
+	
+	
+}
+
+
+static void SBC_A_off_HL (Z180Context* ctx)
+{
+	BR.A = doArithmetic(ctx, read8(ctx, WR.HL), F1_SBC, F2_SBC);
+}
+
+
+static void SBC_A_off_IX_d (Z180Context* ctx)
+{
+	ctx->tstates += 5;
+	signed char displacement = read8(ctx, ctx->PC++);
+	BR.A = doArithmetic(ctx, read8(ctx, WR.IX + displacement), F1_SBC, F2_SBC);
+	
+}
+
+
+static void SBC_A_off_IY_d (Z180Context* ctx)
+{
+	ctx->tstates += 5;
+	signed char displacement = read8(ctx, ctx->PC++);
+	BR.A = doArithmetic(ctx, read8(ctx, WR.IY + displacement), F1_SBC, F2_SBC);
+	
+}
+
+
+static void SBC_A_A (Z180Context* ctx)
+{
+	BR.A = doArithmetic(ctx, BR.A, F1_SBC, F2_SBC);
+}
+
+
+static void SBC_A_B (Z180Context* ctx)
+{
+	BR.A = doArithmetic(ctx, BR.B, F1_SBC, F2_SBC);
+}
+
+
+static void SBC_A_C (Z180Context* ctx)
+{
+	BR.A = doArithmetic(ctx, BR.C, F1_SBC, F2_SBC);
+}
+
+
+static void SBC_A_D (Z180Context* ctx)
+{
+	BR.A = doArithmetic(ctx, BR.D, F1_SBC, F2_SBC);
+}
+
+
+static void SBC_A_E (Z180Context* ctx)
+{
+	BR.A = doArithmetic(ctx, BR.E, F1_SBC, F2_SBC);
+}
+
+
+static void SBC_A_H (Z180Context* ctx)
+{
+	BR.A = doArithmetic(ctx, BR.H, F1_SBC, F2_SBC);
+}
+
+
+static void SBC_A_L (Z180Context* ctx)
+{
+	BR.A = doArithmetic(ctx, BR.L, F1_SBC, F2_SBC);
+}
+
+
+static void SBC_A_n (Z180Context* ctx)
+{
+	BR.A = doArithmetic(ctx, read8(ctx, ctx->PC++), F1_SBC, F2_SBC);
+}
+
+
+static void SBC_HL_BC (Z180Context* ctx)
+{
+	ctx->tstates += 7;
+	WR.HL = doAddWord(ctx, WR.HL, WR.BC, F1_SBC, F2_SBC);
+}
+
+
+static void SBC_HL_DE (Z180Context* ctx)
+{
+	ctx->tstates += 7;
+	WR.HL = doAddWord(ctx, WR.HL, WR.DE, F1_SBC, F2_SBC);
+}
+
+
+static void SBC_HL_HL (Z180Context* ctx)
+{
+	ctx->tstates += 7;
+	WR.HL = doAddWord(ctx, WR.HL, WR.HL, F1_SBC, F2_SBC);
+}
+
+
+static void SBC_HL_SP (Z180Context* ctx)
+{
+	ctx->tstates += 7;
+	WR.HL = doAddWord(ctx, WR.HL, WR.SP, F1_SBC, F2_SBC);
+}
+
+
+static void SCF (Z180Context* ctx)
+{
+	SETFLAG(F_C);
+	RESFLAG(F_N | F_H);
+	adjustFlags(ctx, BR.A);
+}
+
+
+static void SET_0_off_HL (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	write8(ctx, WR.HL, doSetRes(ctx, SR_SET, 0, read8(ctx, WR.HL)));
+}
+
+
+static void SET_0_off_IX_d (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	signed char off = read8(ctx, ctx->PC++);
+	write8(ctx, WR.IX + off, doSetRes(ctx, SR_SET, 0, read8(ctx, WR.IX + off)));
+	
+	
+}
+
+
+static void SET_0_off_IY_d (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	signed char off = read8(ctx, ctx->PC++);
+	write8(ctx, WR.IY + off, doSetRes(ctx, SR_SET, 0, read8(ctx, WR.IY + off)));
+	
+	
+}
+
+
+static void SET_0_A (Z180Context* ctx)
+{
+	BR.A = doSetRes(ctx, SR_SET, 0, BR.A);
+}
+
+
+static void SET_0_B (Z180Context* ctx)
+{
+	BR.B = doSetRes(ctx, SR_SET, 0, BR.B);
+}
+
+
+static void SET_0_C (Z180Context* ctx)
+{
+	BR.C = doSetRes(ctx, SR_SET, 0, BR.C);
+}
+
+
+static void SET_0_D (Z180Context* ctx)
+{
+	BR.D = doSetRes(ctx, SR_SET, 0, BR.D);
+}
+
+
+static void SET_0_E (Z180Context* ctx)
+{
+	BR.E = doSetRes(ctx, SR_SET, 0, BR.E);
+}
+
+
+static void SET_0_H (Z180Context* ctx)
+{
+	BR.H = doSetRes(ctx, SR_SET, 0, BR.H);
+}
+
+
+static void SET_0_L (Z180Context* ctx)
+{
+	BR.L = doSetRes(ctx, SR_SET, 0, BR.L);
+}
+
+
+static void SET_1_off_HL (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	write8(ctx, WR.HL, doSetRes(ctx, SR_SET, 1, read8(ctx, WR.HL)));
+}
+
+
+static void SET_1_off_IX_d (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	signed char off = read8(ctx, ctx->PC++);
+	write8(ctx, WR.IX + off, doSetRes(ctx, SR_SET, 1, read8(ctx, WR.IX + off)));
+	
+	
+}
+
+
+static void SET_1_off_IY_d (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	signed char off = read8(ctx, ctx->PC++);
+	write8(ctx, WR.IY + off, doSetRes(ctx, SR_SET, 1, read8(ctx, WR.IY + off)));
+	
+	
+}
+
+
+static void SET_1_A (Z180Context* ctx)
+{
+	BR.A = doSetRes(ctx, SR_SET, 1, BR.A);
+}
+
+
+static void SET_1_B (Z180Context* ctx)
+{
+	BR.B = doSetRes(ctx, SR_SET, 1, BR.B);
+}
+
+
+static void SET_1_C (Z180Context* ctx)
+{
+	BR.C = doSetRes(ctx, SR_SET, 1, BR.C);
+}
+
+
+static void SET_1_D (Z180Context* ctx)
+{
+	BR.D = doSetRes(ctx, SR_SET, 1, BR.D);
+}
+
+
+static void SET_1_E (Z180Context* ctx)
+{
+	BR.E = doSetRes(ctx, SR_SET, 1, BR.E);
+}
+
+
+static void SET_1_H (Z180Context* ctx)
+{
+	BR.H = doSetRes(ctx, SR_SET, 1, BR.H);
+}
+
+
+static void SET_1_L (Z180Context* ctx)
+{
+	BR.L = doSetRes(ctx, SR_SET, 1, BR.L);
+}
+
+
+static void SET_2_off_HL (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	write8(ctx, WR.HL, doSetRes(ctx, SR_SET, 2, read8(ctx, WR.HL)));
+}
+
+
+static void SET_2_off_IX_d (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	signed char off = read8(ctx, ctx->PC++);
+	write8(ctx, WR.IX + off, doSetRes(ctx, SR_SET, 2, read8(ctx, WR.IX + off)));
+	
+	
+}
+
+
+static void SET_2_off_IY_d (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	signed char off = read8(ctx, ctx->PC++);
+	write8(ctx, WR.IY + off, doSetRes(ctx, SR_SET, 2, read8(ctx, WR.IY + off)));
+	
+	
+}
+
+
+static void SET_2_A (Z180Context* ctx)
+{
+	BR.A = doSetRes(ctx, SR_SET, 2, BR.A);
+}
+
+
+static void SET_2_B (Z180Context* ctx)
+{
+	BR.B = doSetRes(ctx, SR_SET, 2, BR.B);
+}
+
+
+static void SET_2_C (Z180Context* ctx)
+{
+	BR.C = doSetRes(ctx, SR_SET, 2, BR.C);
+}
+
+
+static void SET_2_D (Z180Context* ctx)
+{
+	BR.D = doSetRes(ctx, SR_SET, 2, BR.D);
+}
+
+
+static void SET_2_E (Z180Context* ctx)
+{
+	BR.E = doSetRes(ctx, SR_SET, 2, BR.E);
+}
+
+
+static void SET_2_H (Z180Context* ctx)
+{
+	BR.H = doSetRes(ctx, SR_SET, 2, BR.H);
+}
+
+
+static void SET_2_L (Z180Context* ctx)
+{
+	BR.L = doSetRes(ctx, SR_SET, 2, BR.L);
+}
+
+
+static void SET_3_off_HL (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	write8(ctx, WR.HL, doSetRes(ctx, SR_SET, 3, read8(ctx, WR.HL)));
+}
+
+
+static void SET_3_off_IX_d (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	signed char off = read8(ctx, ctx->PC++);
+	write8(ctx, WR.IX + off, doSetRes(ctx, SR_SET, 3, read8(ctx, WR.IX + off)));
+	
+	
+}
+
+
+static void SET_3_off_IY_d (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	signed char off = read8(ctx, ctx->PC++);
+	write8(ctx, WR.IY + off, doSetRes(ctx, SR_SET, 3, read8(ctx, WR.IY + off)));
+	
+	
+}
+
+
+static void SET_3_A (Z180Context* ctx)
+{
+	BR.A = doSetRes(ctx, SR_SET, 3, BR.A);
+}
+
+
+static void SET_3_B (Z180Context* ctx)
+{
+	BR.B = doSetRes(ctx, SR_SET, 3, BR.B);
+}
+
+
+static void SET_3_C (Z180Context* ctx)
+{
+	BR.C = doSetRes(ctx, SR_SET, 3, BR.C);
+}
+
+
+static void SET_3_D (Z180Context* ctx)
+{
+	BR.D = doSetRes(ctx, SR_SET, 3, BR.D);
+}
+
+
+static void SET_3_E (Z180Context* ctx)
+{
+	BR.E = doSetRes(ctx, SR_SET, 3, BR.E);
+}
+
+
+static void SET_3_H (Z180Context* ctx)
+{
+	BR.H = doSetRes(ctx, SR_SET, 3, BR.H);
+}
+
+
+static void SET_3_L (Z180Context* ctx)
+{
+	BR.L = doSetRes(ctx, SR_SET, 3, BR.L);
+}
+
+
+static void SET_4_off_HL (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	write8(ctx, WR.HL, doSetRes(ctx, SR_SET, 4, read8(ctx, WR.HL)));
+}
+
+
+static void SET_4_off_IX_d (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	signed char off = read8(ctx, ctx->PC++);
+	write8(ctx, WR.IX + off, doSetRes(ctx, SR_SET, 4, read8(ctx, WR.IX + off)));
+	
+	
+}
+
+
+static void SET_4_off_IY_d (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	signed char off = read8(ctx, ctx->PC++);
+	write8(ctx, WR.IY + off, doSetRes(ctx, SR_SET, 4, read8(ctx, WR.IY + off)));
+	
+	
+}
+
+
+static void SET_4_A (Z180Context* ctx)
+{
+	BR.A = doSetRes(ctx, SR_SET, 4, BR.A);
+}
+
+
+static void SET_4_B (Z180Context* ctx)
+{
+	BR.B = doSetRes(ctx, SR_SET, 4, BR.B);
+}
+
+
+static void SET_4_C (Z180Context* ctx)
+{
+	BR.C = doSetRes(ctx, SR_SET, 4, BR.C);
+}
+
+
+static void SET_4_D (Z180Context* ctx)
+{
+	BR.D = doSetRes(ctx, SR_SET, 4, BR.D);
+}
+
+
+static void SET_4_E (Z180Context* ctx)
+{
+	BR.E = doSetRes(ctx, SR_SET, 4, BR.E);
+}
+
+
+static void SET_4_H (Z180Context* ctx)
+{
+	BR.H = doSetRes(ctx, SR_SET, 4, BR.H);
+}
+
+
+static void SET_4_L (Z180Context* ctx)
+{
+	BR.L = doSetRes(ctx, SR_SET, 4, BR.L);
+}
+
+
+static void SET_5_off_HL (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	write8(ctx, WR.HL, doSetRes(ctx, SR_SET, 5, read8(ctx, WR.HL)));
+}
+
+
+static void SET_5_off_IX_d (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	signed char off = read8(ctx, ctx->PC++);
+	write8(ctx, WR.IX + off, doSetRes(ctx, SR_SET, 5, read8(ctx, WR.IX + off)));
+	
+	
+}
+
+
+static void SET_5_off_IY_d (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	signed char off = read8(ctx, ctx->PC++);
+	write8(ctx, WR.IY + off, doSetRes(ctx, SR_SET, 5, read8(ctx, WR.IY + off)));
+	
+	
+}
+
+
+static void SET_5_A (Z180Context* ctx)
+{
+	BR.A = doSetRes(ctx, SR_SET, 5, BR.A);
+}
+
+
+static void SET_5_B (Z180Context* ctx)
+{
+	BR.B = doSetRes(ctx, SR_SET, 5, BR.B);
+}
+
+
+static void SET_5_C (Z180Context* ctx)
+{
+	BR.C = doSetRes(ctx, SR_SET, 5, BR.C);
+}
+
+
+static void SET_5_D (Z180Context* ctx)
+{
+	BR.D = doSetRes(ctx, SR_SET, 5, BR.D);
+}
+
+
+static void SET_5_E (Z180Context* ctx)
+{
+	BR.E = doSetRes(ctx, SR_SET, 5, BR.E);
+}
+
+
+static void SET_5_H (Z180Context* ctx)
+{
+	BR.H = doSetRes(ctx, SR_SET, 5, BR.H);
+}
+
+
+static void SET_5_L (Z180Context* ctx)
+{
+	BR.L = doSetRes(ctx, SR_SET, 5, BR.L);
+}
+
+
+static void SET_6_off_HL (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	write8(ctx, WR.HL, doSetRes(ctx, SR_SET, 6, read8(ctx, WR.HL)));
+}
+
+
+static void SET_6_off_IX_d (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	signed char off = read8(ctx, ctx->PC++);
+	write8(ctx, WR.IX + off, doSetRes(ctx, SR_SET, 6, read8(ctx, WR.IX + off)));
+	
+	
+}
+
+
+static void SET_6_off_IY_d (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	signed char off = read8(ctx, ctx->PC++);
+	write8(ctx, WR.IY + off, doSetRes(ctx, SR_SET, 6, read8(ctx, WR.IY + off)));
+	
+	
+}
+
+
+static void SET_6_A (Z180Context* ctx)
+{
+	BR.A = doSetRes(ctx, SR_SET, 6, BR.A);
+}
+
+
+static void SET_6_B (Z180Context* ctx)
+{
+	BR.B = doSetRes(ctx, SR_SET, 6, BR.B);
+}
+
+
+static void SET_6_C (Z180Context* ctx)
+{
+	BR.C = doSetRes(ctx, SR_SET, 6, BR.C);
+}
+
+
+static void SET_6_D (Z180Context* ctx)
+{
+	BR.D = doSetRes(ctx, SR_SET, 6, BR.D);
+}
+
+
+static void SET_6_E (Z180Context* ctx)
+{
+	BR.E = doSetRes(ctx, SR_SET, 6, BR.E);
+}
+
+
+static void SET_6_H (Z180Context* ctx)
+{
+	BR.H = doSetRes(ctx, SR_SET, 6, BR.H);
+}
+
+
+static void SET_6_L (Z180Context* ctx)
+{
+	BR.L = doSetRes(ctx, SR_SET, 6, BR.L);
+}
+
+
+static void SET_7_off_HL (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	write8(ctx, WR.HL, doSetRes(ctx, SR_SET, 7, read8(ctx, WR.HL)));
+}
+
+
+static void SET_7_off_IX_d (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	signed char off = read8(ctx, ctx->PC++);
+	write8(ctx, WR.IX + off, doSetRes(ctx, SR_SET, 7, read8(ctx, WR.IX + off)));
+	
+	
+}
+
+
+static void SET_7_off_IY_d (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	signed char off = read8(ctx, ctx->PC++);
+	write8(ctx, WR.IY + off, doSetRes(ctx, SR_SET, 7, read8(ctx, WR.IY + off)));
+	
+	
+}
+
+
+static void SET_7_A (Z180Context* ctx)
+{
+	BR.A = doSetRes(ctx, SR_SET, 7, BR.A);
+}
+
+
+static void SET_7_B (Z180Context* ctx)
+{
+	BR.B = doSetRes(ctx, SR_SET, 7, BR.B);
+}
+
+
+static void SET_7_C (Z180Context* ctx)
+{
+	BR.C = doSetRes(ctx, SR_SET, 7, BR.C);
+}
+
+
+static void SET_7_D (Z180Context* ctx)
+{
+	BR.D = doSetRes(ctx, SR_SET, 7, BR.D);
+}
+
+
+static void SET_7_E (Z180Context* ctx)
+{
+	BR.E = doSetRes(ctx, SR_SET, 7, BR.E);
+}
+
+
+static void SET_7_H (Z180Context* ctx)
+{
+	BR.H = doSetRes(ctx, SR_SET, 7, BR.H);
+}
+
+
+static void SET_7_L (Z180Context* ctx)
+{
+	BR.L = doSetRes(ctx, SR_SET, 7, BR.L);
+}
+
+
+static void SLA_off_HL (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	write8(ctx, WR.HL, doSL(ctx, read8(ctx, WR.HL), IA_A));
+}
+
+
+static void SLA_off_IX_d (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	signed char off = read8(ctx, ctx->PC++);
+	write8(ctx, WR.IX + off, doSL(ctx, read8(ctx, WR.IX + off), IA_A));
+}
+
+
+static void SLA_off_IY_d (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	signed char off = read8(ctx, ctx->PC++);
+	write8(ctx, WR.IY + off, doSL(ctx, read8(ctx, WR.IY + off), IA_A));
+}
+
+
+static void SLA_A (Z180Context* ctx)
+{
+	BR.A = doSL(ctx, BR.A, IA_A);
+	
+}
+
+
+static void SLA_B (Z180Context* ctx)
+{
+	BR.B = doSL(ctx, BR.B, IA_A);
+	
+}
+
+
+static void SLA_C (Z180Context* ctx)
+{
+	BR.C = doSL(ctx, BR.C, IA_A);
+	
+}
+
+
+static void SLA_D (Z180Context* ctx)
+{
+	BR.D = doSL(ctx, BR.D, IA_A);
+	
+}
+
+
+static void SLA_E (Z180Context* ctx)
+{
+	BR.E = doSL(ctx, BR.E, IA_A);
+	
+}
+
+
+static void SLA_H (Z180Context* ctx)
+{
+	BR.H = doSL(ctx, BR.H, IA_A);
+	
+}
+
+
+static void SLA_L (Z180Context* ctx)
+{
+	BR.L = doSL(ctx, BR.L, IA_A);
+	
+}
+
+
+static void SLL_off_HL (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	write8(ctx, WR.HL, doSL(ctx, read8(ctx, WR.HL), IA_L));
+}
+
+
+static void SLL_off_IX_d (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	signed char off = read8(ctx, ctx->PC++);
+	write8(ctx, WR.IX + off, doSL(ctx, read8(ctx, WR.IX + off), IA_L));
+}
+
+
+static void SLL_off_IY_d (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	signed char off = read8(ctx, ctx->PC++);
+	write8(ctx, WR.IY + off, doSL(ctx, read8(ctx, WR.IY + off), IA_L));
+}
+
+
+static void SLL_A (Z180Context* ctx)
+{
+	BR.A = doSL(ctx, BR.A, IA_L);
+	
+}
+
+
+static void SLL_B (Z180Context* ctx)
+{
+	BR.B = doSL(ctx, BR.B, IA_L);
+	
+}
+
+
+static void SLL_C (Z180Context* ctx)
+{
+	BR.C = doSL(ctx, BR.C, IA_L);
+	
+}
+
+
+static void SLL_D (Z180Context* ctx)
+{
+	BR.D = doSL(ctx, BR.D, IA_L);
+	
+}
+
+
+static void SLL_E (Z180Context* ctx)
+{
+	BR.E = doSL(ctx, BR.E, IA_L);
+	
+}
+
+
+static void SLL_H (Z180Context* ctx)
+{
+	BR.H = doSL(ctx, BR.H, IA_L);
+	
+}
+
+
+static void SLL_L (Z180Context* ctx)
+{
+	BR.L = doSL(ctx, BR.L, IA_L);
+	
+}
+
+
+static void SRA_off_HL (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	write8(ctx, WR.HL, doSR(ctx, read8(ctx, WR.HL), IA_A));
+}
+
+
+static void SRA_off_IX_d (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	signed char off = read8(ctx, ctx->PC++);
+	write8(ctx, WR.IX + off, doSR(ctx, read8(ctx, WR.IX + off), IA_A));
+}
+
+
+static void SRA_off_IY_d (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	signed char off = read8(ctx, ctx->PC++);
+	write8(ctx, WR.IY + off, doSR(ctx, read8(ctx, WR.IY + off), IA_A));
+}
+
+
+static void SRA_A (Z180Context* ctx)
+{
+	BR.A = doSR(ctx, BR.A, IA_A);
+	
+}
+
+
+static void SRA_B (Z180Context* ctx)
+{
+	BR.B = doSR(ctx, BR.B, IA_A);
+	
+}
+
+
+static void SRA_C (Z180Context* ctx)
+{
+	BR.C = doSR(ctx, BR.C, IA_A);
+	
+}
+
+
+static void SRA_D (Z180Context* ctx)
+{
+	BR.D = doSR(ctx, BR.D, IA_A);
+	
+}
+
+
+static void SRA_E (Z180Context* ctx)
+{
+	BR.E = doSR(ctx, BR.E, IA_A);
+	
+}
+
+
+static void SRA_H (Z180Context* ctx)
+{
+	BR.H = doSR(ctx, BR.H, IA_A);
+	
+}
+
+
+static void SRA_L (Z180Context* ctx)
+{
+	BR.L = doSR(ctx, BR.L, IA_A);
+	
+}
+
+
+static void SRL_off_HL (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	write8(ctx, WR.HL, doSR(ctx, read8(ctx, WR.HL), IA_L));
+}
+
+
+static void SRL_off_IX_d (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	signed char off = read8(ctx, ctx->PC++);
+	write8(ctx, WR.IX + off, doSR(ctx, read8(ctx, WR.IX + off), IA_L));
+}
+
+
+static void SRL_off_IY_d (Z180Context* ctx)
+{
+	ctx->tstates += 2;
+	signed char off = read8(ctx, ctx->PC++);
+	write8(ctx, WR.IY + off, doSR(ctx, read8(ctx, WR.IY + off), IA_L));
+}
+
+
+static void SRL_A (Z180Context* ctx)
+{
+	BR.A = doSR(ctx, BR.A, IA_L);
+	
+}
+
+
+static void SRL_B (Z180Context* ctx)
+{
+	BR.B = doSR(ctx, BR.B, IA_L);
+	
+}
+
+
+static void SRL_C (Z180Context* ctx)
+{
+	BR.C = doSR(ctx, BR.C, IA_L);
+	
+}
+
+
+static void SRL_D (Z180Context* ctx)
+{
+	BR.D = doSR(ctx, BR.D, IA_L);
+	
+}
+
+
+static void SRL_E (Z180Context* ctx)
+{
+	BR.E = doSR(ctx, BR.E, IA_L);
+	
+}
+
+
+static void SRL_H (Z180Context* ctx)
+{
+	BR.H = doSR(ctx, BR.H, IA_L);
+	
+}
+
+
+static void SRL_L (Z180Context* ctx)
+{
+	BR.L = doSR(ctx, BR.L, IA_L);
+	
+}
+
+
+static void SUB_A_off_HL (Z180Context* ctx)
+{
+	BR.A = doArithmetic(ctx, read8(ctx, WR.HL), F1_SUB, F2_SUB);
+}
+
+
+static void SUB_A_off_IX_d (Z180Context* ctx)
+{
+	ctx->tstates += 5;
+	signed char displacement = read8(ctx, ctx->PC++);
+	BR.A = doArithmetic(ctx, read8(ctx, WR.IX + displacement), F1_SUB, F2_SUB);
+	
+}
+
+
+static void SUB_A_off_IY_d (Z180Context* ctx)
+{
+	ctx->tstates += 5;
+	signed char displacement = read8(ctx, ctx->PC++);
+	BR.A = doArithmetic(ctx, read8(ctx, WR.IY + displacement), F1_SUB, F2_SUB);
+	
+}
+
+
+static void SUB_A_A (Z180Context* ctx)
+{
+	BR.A = doArithmetic(ctx, BR.A, F1_SUB, F2_SUB);
+}
+
+
+static void SUB_A_B (Z180Context* ctx)
+{
+	BR.A = doArithmetic(ctx, BR.B, F1_SUB, F2_SUB);
+}
+
+
+static void SUB_A_C (Z180Context* ctx)
+{
+	BR.A = doArithmetic(ctx, BR.C, F1_SUB, F2_SUB);
+}
+
+
+static void SUB_A_D (Z180Context* ctx)
+{
+	BR.A = doArithmetic(ctx, BR.D, F1_SUB, F2_SUB);
+}
+
+
+static void SUB_A_E (Z180Context* ctx)
+{
+	BR.A = doArithmetic(ctx, BR.E, F1_SUB, F2_SUB);
+}
+
+
+static void SUB_A_H (Z180Context* ctx)
+{
+	BR.A = doArithmetic(ctx, BR.H, F1_SUB, F2_SUB);
+}
+
+
+static void SUB_A_L (Z180Context* ctx)
+{
+	BR.A = doArithmetic(ctx, BR.L, F1_SUB, F2_SUB);
+}
+
+
+static void SUB_A_n (Z180Context* ctx)
+{
+	BR.A = doArithmetic(ctx, read8(ctx, ctx->PC++), F1_SUB, F2_SUB);
+}
+
+
+static void XOR_off_HL (Z180Context* ctx)
+{
+	doXOR(ctx, read8(ctx, WR.HL));
+}
+
+
+static void XOR_off_IX_d (Z180Context* ctx)
+{
+	ctx->tstates += 5;
+	doXOR(ctx, read8(ctx, WR.IX + (signed char) read8(ctx, ctx->PC++)));
+}
+
+
+static void XOR_off_IY_d (Z180Context* ctx)
+{
+	ctx->tstates += 5;
+	doXOR(ctx, read8(ctx, WR.IY + (signed char) read8(ctx, ctx->PC++)));
+}
+
+
+static void XOR_A (Z180Context* ctx)
+{
+	doXOR(ctx, BR.A);
+}
+
+
+static void XOR_B (Z180Context* ctx)
+{
+	doXOR(ctx, BR.B);
+}
+
+
+static void XOR_C (Z180Context* ctx)
+{
+	doXOR(ctx, BR.C);
+}
+
+
+static void XOR_D (Z180Context* ctx)
+{
+	doXOR(ctx, BR.D);
+}
+
+
+static void XOR_E (Z180Context* ctx)
+{
+	doXOR(ctx, BR.E);
+}
+
+
+static void XOR_H (Z180Context* ctx)
+{
+	doXOR(ctx, BR.H);
+}
+
+
+static void XOR_L (Z180Context* ctx)
+{
+	doXOR(ctx, BR.L);
+}
+
+
+static void XOR_n (Z180Context* ctx)
+{
+	doXOR(ctx, read8(ctx, ctx->PC++));
+}
+
+
+static void IN0_B_off_n (Z180Context* ctx)
+{
+	BR.B = ioRead(ctx, read8(ctx, ctx->PC++));
+	RESFLAG(F_H | F_N);
+	adjustFlagSZP(ctx, BR.B);
+	adjustFlags(ctx, BR.B);
+}
+
+
+static void IN0_C_off_n (Z180Context* ctx)
+{
+	BR.C = ioRead(ctx, read8(ctx, ctx->PC++));
+	RESFLAG(F_H | F_N);
+	adjustFlagSZP(ctx, BR.C);
+	adjustFlags(ctx, BR.C);
+}
+
+
+static void IN0_D_off_n (Z180Context* ctx)
+{
+	BR.D = ioRead(ctx, read8(ctx, ctx->PC++));
+	RESFLAG(F_H | F_N);
+	adjustFlagSZP(ctx, BR.D);
+	adjustFlags(ctx, BR.D);
+}
+
+
+static void IN0_E_off_n (Z180Context* ctx)
+{
+	BR.E = ioRead(ctx, read8(ctx, ctx->PC++));
+	RESFLAG(F_H | F_N);
+	adjustFlagSZP(ctx, BR.E);
+	adjustFlags(ctx, BR.E);
+}
+
+
+static void IN0_H_off_n (Z180Context* ctx)
+{
+	BR.H = ioRead(ctx, read8(ctx, ctx->PC++));
+	RESFLAG(F_H | F_N);
+	adjustFlagSZP(ctx, BR.H);
+	adjustFlags(ctx, BR.H);
+}
+
+
+static void IN0_L_off_n (Z180Context* ctx)
+{
+	BR.L = ioRead(ctx, read8(ctx, ctx->PC++));
+	RESFLAG(F_H | F_N);
+	adjustFlagSZP(ctx, BR.L);
+	adjustFlags(ctx, BR.L);
+}
+
+
+static void IN0_F_off_n (Z180Context* ctx)
+{
+	BR.F = ioRead(ctx, read8(ctx, ctx->PC++));
+	RESFLAG(F_H | F_N);
+	adjustFlagSZP(ctx, BR.F);
+	adjustFlags(ctx, BR.F);
+}
+
+
+static void IN0_A_off_n (Z180Context* ctx)
+{
+	BR.A = ioRead(ctx, read8(ctx, ctx->PC++));
+	RESFLAG(F_H | F_N);
+	adjustFlagSZP(ctx, BR.A);
+	adjustFlags(ctx, BR.A);
+}
+
+
+static void MLT_BC (Z180Context* ctx)
+{
+	WR.BC = (WR.BC & 0xFF) * ((WR.BC) >> 8);
+	ctx->tstates += 10;
+}
+
+
+static void MLT_DE (Z180Context* ctx)
+{
+	WR.DE = (WR.DE & 0xFF) * ((WR.DE) >> 8);
+	ctx->tstates += 10;
+}
+
+
+static void MLT_HL (Z180Context* ctx)
+{
+	WR.HL = (WR.HL & 0xFF) * ((WR.HL) >> 8);
+	ctx->tstates += 10;
+}
+
+
+static void MLT_SP (Z180Context* ctx)
+{
+	WR.SP = (WR.SP & 0xFF) * ((WR.SP) >> 8);
+	ctx->tstates += 10;
+}
+
+
+static void OTDM (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	byte value = read8(ctx, WR.HL);
+	BR.B = doIncDec(ctx, BR.B, 1);
+	ioWrite(ctx, BR.C, value);
+	WR.HL--;
+	int flag_value = value + BR.L;
+	VALFLAG(F_N, value & 0x80);
+	VALFLAG(F_H, flag_value > 0xff);
+	VALFLAG(F_C, flag_value > 0xff);
+	VALFLAG(F_PV, parityBit[(flag_value & 7) ^ BR.B]);
+	adjustFlags(ctx, BR.B);
+}
+
+
+static void OTDMR (Z180Context* ctx)
+{
+	OTDM(ctx);
+	if (BR.B != 0)
+	{
+		ctx->tstates += 5;
+		ctx->PC -= 2;
+	}
+}
+
+
+static void OTIM (Z180Context* ctx)
+{
+	ctx->tstates += 1;
+	byte value = read8(ctx, WR.HL);
+	BR.B = doIncDec(ctx, BR.B, 1);
+	ioWrite(ctx, BR.C, value);
+	WR.HL++;
+	int flag_value = value + BR.L;
+	VALFLAG(F_N, value & 0x80);
+	VALFLAG(F_H, flag_value > 0xff);
+	VALFLAG(F_C, flag_value > 0xff);
+	VALFLAG(F_PV, parityBit[(flag_value & 7) ^ BR.B]);
+	adjustFlags(ctx, BR.B);
+}
+
+
+static void OTIMR (Z180Context* ctx)
+{
+	OTIM(ctx);
+	if (BR.B != 0)
+	{
+		ctx->tstates += 5;
+		ctx->PC -= 2;
+	}
+}
+
+
+static void OUT0_off_n_B (Z180Context* ctx)
+{
+	ioWrite(ctx, read8(ctx, ctx->PC++), BR.B);
+}
+
+
+static void OUT0_off_n_C (Z180Context* ctx)
+{
+	ioWrite(ctx, read8(ctx, ctx->PC++), BR.C);
+}
+
+
+static void OUT0_off_n_D (Z180Context* ctx)
+{
+	ioWrite(ctx, read8(ctx, ctx->PC++), BR.D);
+}
+
+
+static void OUT0_off_n_E (Z180Context* ctx)
+{
+	ioWrite(ctx, read8(ctx, ctx->PC++), BR.E);
+}
+
+
+static void OUT0_off_n_H (Z180Context* ctx)
+{
+	ioWrite(ctx, read8(ctx, ctx->PC++), BR.H);
+}
+
+
+static void OUT0_off_n_L (Z180Context* ctx)
+{
+	ioWrite(ctx, read8(ctx, ctx->PC++), BR.L);
+}
+
+
+static void OUT0_off_n_0 (Z180Context* ctx)
+{
+	ioWrite(ctx, read8(ctx, ctx->PC++), 0);
+}
+
+
+static void OUT0_off_n_A (Z180Context* ctx)
+{
+	ioWrite(ctx, read8(ctx, ctx->PC++), BR.A);
+}
+
+
+static void SLP (Z180Context* ctx)
+{
+	;
+}
+
+
+static void TST_B (Z180Context* ctx)
+{
+	adjustLogicResult(ctx, 0, BR.A & BR.B);
+}
+
+
+static void TST_C (Z180Context* ctx)
+{
+	adjustLogicResult(ctx, 0, BR.A & BR.C);
+}
+
+
+static void TST_D (Z180Context* ctx)
+{
+	adjustLogicResult(ctx, 0, BR.A & BR.D);
+}
+
+
+static void TST_E (Z180Context* ctx)
+{
+	adjustLogicResult(ctx, 0, BR.A & BR.E);
+}
+
+
+static void TST_H (Z180Context* ctx)
+{
+	adjustLogicResult(ctx, 0, BR.A & BR.H);
+}
+
+
+static void TST_L (Z180Context* ctx)
+{
+	adjustLogicResult(ctx, 0, BR.A & BR.L);
+}
+
+
+static void TST_off_HL (Z180Context* ctx)
+{
+	adjustLogicResult(ctx, 0, BR.A & read8(ctx, WR.HL));
+}
+
+
+static void TST_A (Z180Context* ctx)
+{
+	adjustLogicResult(ctx, 0, BR.A & BR.A);
+}
+
+
+static void TST_n (Z180Context* ctx)
+{
+	adjustLogicResult(ctx, 0, BR.A & read8(ctx, ctx->PC++));
+}
+
+
+static void TSTIO_off_C_n (Z180Context* ctx)
+{
+	adjustLogicResult(ctx, 0, ioRead(ctx, BR.C) & read8(ctx, ctx->PC++));
+}
+
+
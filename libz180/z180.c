@@ -23,6 +23,8 @@
  *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
  */
 
+#define _DEFAULT_SOURCE
+
 #include "z180.h"
 #include "string.h"
 
@@ -134,6 +136,10 @@ static void write8 (Z180Context* ctx, ushort addr, byte val)
 {
 	ctx->tstates += 3;
 	ctx->memWrite(ctx->memParam, addr, val);	
+	/* Interpreting an instruction for a translated block that has
+	   just written into itself */
+	if ((ushort)(addr - ctx->jit_pc) < ctx->jit_len)
+		ctx->jit_smc = 1;
 }
 
 
@@ -230,32 +236,28 @@ static int parityBit[256] = {
 	1, 0, 0, 1, 0, 1, 1, 0, 0, 1, 1, 0, 1, 0, 0, 1 };
 
 
+/* S, Z, 5 and 3 flags for a result */
+#define FLAGS_SZ53(v)	(((v) & (F_S | F_5 | F_3)) | ((v) ? 0 : F_Z))
+/* As above plus parity */
+#define FLAGS_SZ53P(v)	(FLAGS_SZ53(v) | (parityBit[v] ? F_PV : 0))
+
 static void adjustFlags (Z180Context* ctx, byte val)
 {
-	VALFLAG(F_5, (val & F_5) != 0);
-	VALFLAG(F_3, (val & F_3) != 0);
+	BR.F = (BR.F & ~(F_5 | F_3)) | (val & (F_5 | F_3));
 }
 
 
 static void adjustFlagSZP (Z180Context* ctx, byte val)
 {
-	VALFLAG(F_S, (val & 0x80) != 0);
-	VALFLAG(F_Z, (val == 0));
-	VALFLAG(F_PV, parityBit[val]);
+	BR.F = (BR.F & ~(F_S | F_Z | F_PV)) | (val & F_S) | (val ? 0 : F_Z) |
+		(parityBit[val] ? F_PV : 0);
 }
 
 
 /* Adjust flags after AND, OR, XOR, TST */
 static void adjustLogicResult (Z180Context* ctx, int flagH, byte res)
 {
-    VALFLAG(F_S, (res & 0x80) != 0);
-    VALFLAG(F_Z, (res == 0));
-    VALFLAG(F_H, flagH);
-    VALFLAG(F_N, 0);
-    VALFLAG(F_C, 0);
-    VALFLAG(F_PV, parityBit[res]);
-
-    adjustFlags(ctx, res);
+    BR.F = FLAGS_SZ53P(res) | (flagH ? F_H : 0);
 }
 
 static void adjustLogicFlag (Z180Context* ctx, int flagH)
@@ -332,40 +334,41 @@ static int doComplement(byte v)
 }
 
  
-/** Do an arithmetic operation (ADD, SUB, ADC, SBC y CP) */
+/** Do an arithmetic operation (ADD, SUB, ADC, SBC y CP)
+ *
+ * All the flags are affected so we build the new F in one go rather
+ * than a bit at a time. */
 static byte doArithmetic (Z180Context* ctx, byte value, int withCarry, int isSub)
 {
 	ushort res; /* To detect carry */
+	int carry = withCarry && GETFLAG(F_C);
+	byte f;
 
 	if (isSub)
 	{
-		SETFLAG(F_N);
-		VALFLAG(F_H, (((BR.A & 0x0F) - (value & 0x0F)) & 0x10) != 0);
-		res = BR.A - value;
-		if (withCarry && GETFLAG(F_C))
-			res--;
+		f = F_N;
+		if (((BR.A & 0x0F) - (value & 0x0F)) & 0x10)
+			f |= F_H;
+		res = BR.A - value - carry;
+		/* Overflow if the operands differ in sign and the result
+		   sign differs from the minuend */
+		if ((BR.A ^ value) & (BR.A ^ res) & 0x80)
+			f |= F_PV;
 	}
 	else
 	{
-		RESFLAG(F_N);
-		VALFLAG(F_H, (((BR.A & 0x0F) + (value & 0x0F)) & 0x10) != 0);
-		res = BR.A + value;
-		if (withCarry && GETFLAG(F_C))
-			res++;
+		f = 0;
+		if (((BR.A & 0x0F) + (value & 0x0F)) & 0x10)
+			f |= F_H;
+		res = BR.A + value + carry;
+		/* Overflow if the operands have the same sign and the result
+		   sign differs */
+		if (~(BR.A ^ value) & (BR.A ^ res) & 0x80)
+			f |= F_PV;
 	}
-	VALFLAG(F_S, ((res & 0x80) != 0));
-	VALFLAG(F_C, ((res & 0x100) != 0));
-	VALFLAG(F_Z, ((res & 0xff) == 0));
-	int minuend_sign = BR.A & 0x80;
-	int subtrahend_sign = value & 0x80;
-	int result_sign = res & 0x80;
-	int overflow;
-	if(isSub)
-		overflow = minuend_sign != subtrahend_sign && result_sign != minuend_sign;
-	else
-		overflow = minuend_sign == subtrahend_sign && result_sign != minuend_sign;
-	VALFLAG(F_PV, overflow);
-	adjustFlags(ctx, res);
+	if (res & 0x100)
+		f |= F_C;
+	BR.F = f | FLAGS_SZ53(res & 0xFF);
 
 	return (byte)(res & 0xFF);
 }
@@ -475,24 +478,28 @@ static byte doSetRes (Z180Context* ctx, int bit, int pos, byte val)
 
 static byte doIncDec (Z180Context* ctx, byte val, int isDec)
 {
+    /* Carry is preserved, everything else is set */
+    byte f = BR.F & F_C;
+
     if (isDec)
     {
-        VALFLAG(F_PV, (val & 0x80) && !((val - 1) & 0x80));
+        if (val == 0x80)
+            f |= F_PV;
         val--;
-        VALFLAG(F_H, (val & 0x0F) == 0x0F);
+        if ((val & 0x0F) == 0x0F)
+            f |= F_H;
+        f |= F_N;
     }
     else
     {
-        VALFLAG(F_PV, !(val & 0x80) && ((val + 1) & 0x80));
+        if (val == 0x7F)
+            f |= F_PV;
         val++;
-        VALFLAG(F_H, !(val & 0x0F));
+        if (!(val & 0x0F))
+            f |= F_H;
     }
 
-    VALFLAG(F_S, ((val & 0x80) != 0));
-    VALFLAG(F_Z, (val == 0));
-    VALFLAG(F_N, isDec);
-
-    adjustFlags(ctx, val);
+    BR.F = f | FLAGS_SZ53(val);
 
     return val;
 }
@@ -797,6 +804,9 @@ static void do_int(Z180Context* ctx)
 }
 
 
+#include "z180jit.c"
+
+
 unsigned Z180Execute (Z180Context* ctx)
 {
 	ctx->tstates = 0;
@@ -804,7 +814,7 @@ unsigned Z180Execute (Z180Context* ctx)
 		do_nmi(ctx);
 	else if (ctx->int_req && !ctx->defer_int && ctx->IFF1)
 		do_int(ctx);
-	else
+	else if (ctx->jit == NULL || !jit_run(ctx))
 	{
 		ctx->defer_int = 0;
 		do_execute(ctx);
@@ -40,6 +40,10 @@ typedef byte (*Z180DataIn) 	(int param, ushort address);
 typedef void (*Z180DataOut)	(int param, ushort address, byte data);
 
 
+/** Function type returning the host memory behind an address. */
+typedef byte *(*Z180MemMap)	(int param, ushort address);
+
+
 /** 
  * A Z180 register set.
  * An union is used since we want independent access to the high and low bytes of the 16-bit registers.
@@ -138,12 +142,33 @@ typedef struct
 
 	void (*trace)(unsigned int memparam);
 
+	/* Block translator state, see z180jit.c */
+	void *jit;
+	ushort jit_pc;
+	ushort jit_len;
+	byte jit_smc;
+	/* Operands of the last flag setting operation */
+	byte jit_fa;
+	byte jit_fb;
+	ushort jit_fw;
+	ushort jit_fx;
+
 } Z180Context;
 
 
-/** Execute the next instruction. */
+/** Execute the next instruction, or a translated block of them.
+ * Returns the number of tstates used. */
 unsigned Z180Execute (Z180Context* ctx);
 
+/** Translate hot code to host code and run that from Z180Execute().
+ * Only x86-64 hosts are supported. map returns a pointer to the byte at
+ * address, which must stay valid to the end of its 256 byte page, or
+ * NULL if the page is not plain memory or its mapping can be changed by
+ * a memory write. Code there is always interpreted. Blocks are not used
+ * while trace is set. Returns 0 on success.
+ */
+int Z180JitEnable(Z180Context* ctx, Z180MemMap map);
+
 /** Decode the next instruction to be executed.
  * dump and decode can be NULL if such information is not needed
  *
@@ -0,0 +1,1364 @@
+/* ---------------------------------------------------------
+ *  Block translator for x86-64 hosts
+ * ---------------------------------------------------------
+ *
+ * Included by z180.c so it can call the interpreter directly.
+ *
+ * This is the libz80 translator adapted to the Z180. Z180Execute() runs
+ * a whole block rather than one instruction when one is ready, and a
+ * block that loops back to its start keeps going until JIT_SLICE
+ * t-states have gone, so the caller still gets control often enough
+ * to step the DMA engines and timers.
+ *
+ * Code that has run JIT_HOT times through the interpreter is translated
+ * a block at a time into host code. A block never leaves the 256 byte
+ * page it starts in and ends before anything the interpreter has to see:
+ * IN and OUT, every ED instruction (RETI, RETN, block I/O, LD A,I/R,
+ * the mode changes and the Z180 additions), HALT, undefined opcodes
+ * which trap, and EI which ends the block after it so the next
+ * instruction and the interrupt check are interpreted. The common
+ * loads, 8 bit arithmetic and logic, 16 bit increments and adds, stack
+ * operations, jumps, calls and returns become host code. Everything
+ * else is left to the interpreter, called from within the block with
+ * PC pointing at the instruction.
+ *
+ * Flags are lazy. An operation saves its operands in the context and F
+ * is only built from the host flags when something reads it, before
+ * calling the interpreter, and on the way out of the block. An operation
+ * that replaces every flag throws away the pending one.
+ *
+ * T-states and R are block granular. The cost of each instruction is
+ * found when the block is translated by running it through the
+ * interpreter on a scratch context, both ways for conditional ones, so
+ * the totals match the interpreter exactly. They are added up as the
+ * block leaves, along with M1PC for the last instruction. Interrupts are
+ * only looked at between blocks.
+ *
+ * Data accesses still go through memRead and memWrite. The code bytes
+ * come from the memMap callback and a copy is kept with the block, which
+ * is only entered if the memory there still holds the same code. That
+ * takes care of bank switching, DMA and code loaded from disk. A write
+ * into the block that is running ends it after the instruction that
+ * made it.
+ */
+
+#if defined(__x86_64__)
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+
+#define JIT_HOT		8	/* Interpreted runs before we translate */
+#define JIT_SLICE	256	/* Looping stops after this many t-states */
+#define JIT_INSNS	48	/* Longest block */
+#define JIT_CODE	(4 << 20)	/* Host code cache */
+#define JIT_META	(1 << 20)	/* Block headers and code copies */
+#define JIT_MAXCODE	32768	/* Worst case host code for one block */
+#define JIT_EXITS	(JIT_INSNS * 2 + 1)
+
+#define O(x)		((unsigned)offsetof(Z180Context, x))
+
+/* Pending flag computations */
+#define JF_NONE		0
+#define JF_ADD		1
+#define JF_SUB		2
+#define JF_CP		3
+#define JF_AND		4
+#define JF_OR		5	/* OR and XOR */
+#define JF_INC		6
+#define JF_DEC		7
+#define JF_ADD16	8
+
+struct jit_block
+{
+	struct jit_block *next;		/* Other code at the same address */
+	void (*code)(Z180Context *ctx);
+	const byte *host;		/* Where the code was when translated */
+	ushort len;
+	byte bytes[1];			/* Copy of the code, len bytes */
+};
+
+struct z180jit
+{
+	Z180MemMap map;
+	byte *code;
+	unsigned code_used;
+	byte *meta;
+	unsigned meta_used;
+	struct jit_block *blocks[65536];
+	byte hot[65536];
+};
+
+/* An exit from the middle of a block, emitted after the main line */
+struct jit_exit
+{
+	unsigned patch;		/* rel32 to point at the exit code */
+	int pc;			/* PC to leave with, -1 if already stored */
+	unsigned tstates;
+	unsigned r;
+	int m1pc;
+	int flags;
+};
+
+struct jit_gen
+{
+	byte *p;
+	unsigned n;
+	ushort start;		/* Guest address of the block */
+	unsigned loop;		/* Host offset of the block body */
+	int flags;		/* Pending flag computation */
+	unsigned tstates;	/* Static cost so far */
+	unsigned r;		/* Opcode fetches so far */
+	int m1pc;		/* Last native instruction, -1 if interpreted */
+	struct jit_exit exit[JIT_EXITS];
+	unsigned nexit;
+};
+
+/* Guest register offsets in the order used by the opcode encodings */
+static const unsigned jit_r8[8] =
+{
+	O(R1.br.B), O(R1.br.C), O(R1.br.D), O(R1.br.E),
+	O(R1.br.H), O(R1.br.L), 0, O(R1.br.A)
+};
+
+static const unsigned jit_r16[4] =
+{
+	O(R1.wr.BC), O(R1.wr.DE), O(R1.wr.HL), O(R1.wr.SP)
+};
+
+/* Low and high bytes for PUSH and POP, where pair 3 is AF */
+static const unsigned jit_lo[4] =
+{
+	O(R1.br.C), O(R1.br.E), O(R1.br.L), O(R1.br.F)
+};
+
+static const unsigned jit_hi[4] =
+{
+	O(R1.br.B), O(R1.br.D), O(R1.br.H), O(R1.br.A)
+};
+
+
+/* ---------------------------------------------------------
+ *  Host code emission
+ * ---------------------------------------------------------
+ *
+ * rbx holds the context throughout. eax, ecx, edx, esi and edi are
+ * scratch and r12 keeps a value across a call.
+ */
+
+static void jb(struct jit_gen *g, unsigned v)
+{
+	g->p[g->n++] = v;
+}
+
+
+static void jw(struct jit_gen *g, unsigned v)
+{
+	jb(g, v);
+	jb(g, v >> 8);
+}
+
+
+static void jl(struct jit_gen *g, unsigned v)
+{
+	jw(g, v);
+	jw(g, v >> 16);
+}
+
+
+static void jq(struct jit_gen *g, unsigned long v)
+{
+	jl(g, v);
+	jl(g, v >> 32);
+}
+
+
+/* ModRM for [rbx + off] */
+static void jm(struct jit_gen *g, unsigned reg, unsigned off)
+{
+	if (off < 0x80)
+	{
+		jb(g, 0x43 | (reg << 3));
+		jb(g, off);
+	}
+	else
+	{
+		jb(g, 0x83 | (reg << 3));
+		jl(g, off);
+	}
+}
+
+
+/* movzx reg, byte [rbx + off] */
+static void j_ld8(struct jit_gen *g, unsigned reg, unsigned off)
+{
+	jb(g, 0x0F);
+	jb(g, 0xB6);
+	jm(g, reg, off);
+}
+
+
+/* movzx reg, word [rbx + off] */
+static void j_ld16(struct jit_gen *g, unsigned reg, unsigned off)
+{
+	jb(g, 0x0F);
+	jb(g, 0xB7);
+	jm(g, reg, off);
+}
+
+
+/* mov [rbx + off], reg8 */
+static void j_st8(struct jit_gen *g, unsigned reg, unsigned off)
+{
+	jb(g, 0x88);
+	jm(g, reg, off);
+}
+
+
+/* mov [rbx + off], reg16 */
+static void j_st16(struct jit_gen *g, unsigned reg, unsigned off)
+{
+	jb(g, 0x66);
+	jb(g, 0x89);
+	jm(g, reg, off);
+}
+
+
+static void j_st8i(struct jit_gen *g, unsigned off, unsigned v)
+{
+	jb(g, 0xC6);
+	jm(g, 0, off);
+	jb(g, v);
+}
+
+
+static void j_st16i(struct jit_gen *g, unsigned off, unsigned v)
+{
+	jb(g, 0x66);
+	jb(g, 0xC7);
+	jm(g, 0, off);
+	jw(g, v);
+}
+
+
+/* mov reg, imm32 */
+static void j_movi(struct jit_gen *g, unsigned reg, unsigned v)
+{
+	jb(g, 0xB8 + reg);
+	jl(g, v);
+}
+
+
+/* Call a C function with the context as its first argument */
+static void j_call(struct jit_gen *g, unsigned long fn)
+{
+	jb(g, 0x48);		/* mov rdi, rbx */
+	jb(g, 0x89);
+	jb(g, 0xDF);
+	jb(g, 0x48);		/* mov rax, fn */
+	jb(g, 0xB8);
+	jq(g, fn);
+	jb(g, 0xFF);		/* call rax */
+	jb(g, 0xD0);
+}
+
+
+/* Read guest memory at esi into eax */
+static void j_read(struct jit_gen *g)
+{
+	jb(g, 0x8B);		/* mov edi, memParam */
+	jm(g, 7, O(memParam));
+	jb(g, 0xFF);		/* call memRead */
+	jm(g, 2, O(memRead));
+	jb(g, 0x0F);		/* movzx eax, al */
+	jb(g, 0xB6);
+	jb(g, 0xC0);
+}
+
+
+/* Write guest memory, called with the address in esi and data in edx */
+static void jit_write(Z180Context *ctx, unsigned addr, unsigned val)
+{
+	ctx->memWrite(ctx->memParam, addr, val);
+	if ((ushort)(addr - ctx->jit_pc) < ctx->jit_len)
+		ctx->jit_smc = 1;
+}
+
+
+static void j_write(struct jit_gen *g)
+{
+	j_call(g, (unsigned long)jit_write);
+}
+
+
+/* esi = word [rbx + off] + 1, wrapped to 16 bits */
+static void j_next(struct jit_gen *g, unsigned off)
+{
+	j_ld16(g, 6, off);
+	jb(g, 0xFF);		/* inc esi */
+	jb(g, 0xC6);
+	jb(g, 0x0F);		/* movzx esi, si */
+	jb(g, 0xB7);
+	jb(g, 0xF6);
+}
+
+
+/* Read the word at SP into eax */
+static void j_pop(struct jit_gen *g)
+{
+	j_ld16(g, 6, O(R1.wr.SP));
+	j_read(g);
+	jb(g, 0x41);		/* mov r12d, eax */
+	jb(g, 0x89);
+	jb(g, 0xC4);
+	j_next(g, O(R1.wr.SP));
+	j_read(g);
+	jb(g, 0xC1);		/* shl eax, 8 */
+	jb(g, 0xE0);
+	jb(g, 0x08);
+	jb(g, 0x44);		/* or eax, r12d */
+	jb(g, 0x09);
+	jb(g, 0xE0);
+	jb(g, 0x66);		/* add word [SP], 2 */
+	jb(g, 0x83);
+	jm(g, 0, O(R1.wr.SP));
+	jb(g, 0x02);
+}
+
+
+/* SP -= 2 and write the low then the high byte as doPush does. The
+   bytes come from registers, or are constants if lo is -1 */
+static void j_push(struct jit_gen *g, int lo, unsigned hi)
+{
+	j_ld16(g, 0, O(R1.wr.SP));
+	jb(g, 0x83);		/* sub eax, 2 */
+	jb(g, 0xE8);
+	jb(g, 0x02);
+	j_st16(g, 0, O(R1.wr.SP));
+	jb(g, 0x0F);		/* movzx esi, ax */
+	jb(g, 0xB7);
+	jb(g, 0xF0);
+	if (lo < 0)
+		j_movi(g, 2, hi & 0xFF);
+	else
+		j_ld8(g, 2, lo);
+	j_write(g);
+	j_next(g, O(R1.wr.SP));
+	if (lo < 0)
+		j_movi(g, 2, hi >> 8);
+	else
+		j_ld8(g, 2, hi);
+	j_write(g);
+}
+
+
+/* Build F from the pending operation. Leaves the saved operands alone
+   so it can be emitted again on another path */
+static void j_flags(struct jit_gen *g, int flags)
+{
+	switch (flags)
+	{
+	case JF_NONE:
+		return;
+	case JF_ADD:
+	case JF_SUB:
+	case JF_CP:
+	case JF_INC:
+	case JF_DEC:
+		j_ld8(g, 0, O(jit_fa));
+		if (flags == JF_ADD)
+		{
+			jb(g, 0x02);	/* add al, fb */
+			jm(g, 0, O(jit_fb));
+		}
+		else if (flags == JF_INC)
+		{
+			jb(g, 0xFE);	/* inc al */
+			jb(g, 0xC0);
+		}
+		else if (flags == JF_DEC)
+		{
+			jb(g, 0xFE);	/* dec al */
+			jb(g, 0xC8);
+		}
+		else
+		{
+			jb(g, 0x2A);	/* sub al, fb */
+			jm(g, 0, O(jit_fb));
+		}
+		jb(g, 0x9F);		/* lahf */
+		jb(g, 0x0F);		/* seto dl */
+		jb(g, 0x90);
+		jb(g, 0xC2);
+		jb(g, 0x80);		/* and ah, SZHC or SZH */
+		jb(g, 0xE4);
+		jb(g, (flags == JF_INC || flags == JF_DEC) ? 0xD0 : 0xD1);
+		jb(g, 0xC0);		/* shl dl, 2 */
+		jb(g, 0xE2);
+		jb(g, 0x02);
+		jb(g, 0x08);		/* or ah, dl */
+		jb(g, 0xD4);
+		if (flags != JF_ADD && flags != JF_INC)
+		{
+			jb(g, 0x80);	/* or ah, N */
+			jb(g, 0xCC);
+			jb(g, F_N);
+		}
+		if (flags == JF_CP)
+		{
+			jb(g, 0x8A);	/* mov al, fb */
+			jm(g, 0, O(jit_fb));
+		}
+		jb(g, 0x24);		/* and al, 5 | 3 */
+		jb(g, F_5 | F_3);
+		jb(g, 0x08);		/* or ah, al */
+		jb(g, 0xC4);
+		if (flags == JF_INC || flags == JF_DEC)
+		{
+			j_ld8(g, 1, O(R1.br.F));
+			jb(g, 0x80);	/* and cl, C */
+			jb(g, 0xE1);
+			jb(g, F_C);
+			jb(g, 0x08);	/* or ah, cl */
+			jb(g, 0xCC);
+		}
+		j_st8(g, 4, O(R1.br.F));
+		return;
+	case JF_AND:
+	case JF_OR:
+		j_ld8(g, 0, O(jit_fa));
+		jb(g, 0x84);		/* test al, al */
+		jb(g, 0xC0);
+		jb(g, 0x9F);		/* lahf */
+		jb(g, 0x80);		/* and ah, S | Z | PV */
+		jb(g, 0xE4);
+		jb(g, F_S | F_Z | F_PV);
+		if (flags == JF_AND)
+		{
+			jb(g, 0x80);	/* or ah, H */
+			jb(g, 0xCC);
+			jb(g, F_H);
+		}
+		jb(g, 0x24);		/* and al, 5 | 3 */
+		jb(g, F_5 | F_3);
+		jb(g, 0x08);		/* or ah, al */
+		jb(g, 0xC4);
+		j_st8(g, 4, O(R1.br.F));
+		return;
+	case JF_ADD16:
+		j_ld16(g, 0, O(jit_fw));
+		j_ld16(g, 1, O(jit_fx));
+		jb(g, 0x89);		/* mov edx, eax */
+		jb(g, 0xC2);
+		jb(g, 0x31);		/* xor edx, ecx */
+		jb(g, 0xCA);
+		jb(g, 0x01);		/* add eax, ecx */
+		jb(g, 0xC8);
+		jb(g, 0x31);		/* xor edx, eax: carries into each bit */
+		jb(g, 0xC2);
+		jb(g, 0xC1);		/* shr edx, 8 */
+		jb(g, 0xEA);
+		jb(g, 0x08);
+		jb(g, 0x83);		/* and edx, H */
+		jb(g, 0xE2);
+		jb(g, F_H);
+		jb(g, 0xC1);		/* shr eax, 8 */
+		jb(g, 0xE8);
+		jb(g, 0x08);
+		jb(g, 0x89);		/* mov ecx, eax */
+		jb(g, 0xC1);
+		jb(g, 0x83);		/* and ecx, 5 | 3 */
+		jb(g, 0xE1);
+		jb(g, F_5 | F_3);
+		jb(g, 0x09);		/* or edx, ecx */
+		jb(g, 0xCA);
+		jb(g, 0xC1);		/* shr eax, 8: carry */
+		jb(g, 0xE8);
+		jb(g, 0x08);
+		jb(g, 0x09);		/* or edx, eax */
+		jb(g, 0xC2);
+		j_ld8(g, 1, O(R1.br.F));
+		jb(g, 0x83);		/* and ecx, S | Z | PV */
+		jb(g, 0xE1);
+		jb(g, F_S | F_Z | F_PV);
+		jb(g, 0x09);		/* or edx, ecx */
+		jb(g, 0xCA);
+		j_st8(g, 2, O(R1.br.F));
+		return;
+	}
+}
+
+
+/* Bring F up to date before something looks at it */
+static void j_sync(struct jit_gen *g)
+{
+	j_flags(g, g->flags);
+	g->flags = JF_NONE;
+}
+
+
+static void j_epilogue(struct jit_gen *g)
+{
+	jb(g, 0x48);		/* add rsp, 8 */
+	jb(g, 0x83);
+	jb(g, 0xC4);
+	jb(g, 0x08);
+	jb(g, 0x41);		/* pop r12 */
+	jb(g, 0x5C);
+	jb(g, 0x5B);		/* pop rbx */
+	jb(g, 0xC3);		/* ret */
+}
+
+
+/* Leave the block, accounting for everything done natively. If we are
+   going back to the top of this block, JIT_SLICE is not used up,
+   no interrupt is waiting and the block has not been written to then
+   just loop */
+static void j_leave(struct jit_gen *g, int pc, unsigned tstates, unsigned r,
+	int m1pc, int flags)
+{
+	unsigned p1, p2, p3, p4;
+
+	j_flags(g, flags);
+	if (tstates)
+	{
+		jb(g, 0x81);	/* add dword [tstates], imm32 */
+		jm(g, 0, O(tstates));
+		jl(g, tstates);
+	}
+	r &= 0x7F;
+	if (r)
+	{
+		j_ld8(g, 0, O(R));
+		jb(g, 0x89);	/* mov ecx, eax */
+		jb(g, 0xC1);
+		jb(g, 0x83);	/* add eax, r */
+		jb(g, 0xC0);
+		jb(g, r);
+		jb(g, 0x83);	/* and eax, 0x7F */
+		jb(g, 0xE0);
+		jb(g, 0x7F);
+		jb(g, 0x83);	/* and ecx, 0x80 */
+		jb(g, 0xE1);
+		jb(g, 0x80);
+		jb(g, 0x09);	/* or eax, ecx */
+		jb(g, 0xC8);
+		j_st8(g, 0, O(R));
+	}
+	if (pc == g->start)
+	{
+		jb(g, 0x81);	/* cmp dword [tstates], JIT_SLICE */
+		jm(g, 7, O(tstates));
+		jl(g, JIT_SLICE);
+		jb(g, 0x73);	/* jae out */
+		p1 = g->n;
+		jb(g, 0);
+		jb(g, 0x80);	/* cmp byte [nmi_req], 0 */
+		jm(g, 7, O(nmi_req));
+		jb(g, 0);
+		jb(g, 0x75);	/* jne out */
+		p2 = g->n;
+		jb(g, 0);
+		jb(g, 0x80);	/* cmp byte [int_req], 0 */
+		jm(g, 7, O(int_req));
+		jb(g, 0);
+		jb(g, 0x75);	/* jne out */
+		p3 = g->n;
+		jb(g, 0);
+		jb(g, 0x80);	/* cmp byte [jit_smc], 0 */
+		jm(g, 7, O(jit_smc));
+		jb(g, 0);
+		jb(g, 0x75);	/* jne out */
+		p4 = g->n;
+		jb(g, 0);
+		jb(g, 0xE9);	/* jmp loop */
+		jl(g, g->loop - (g->n + 4));
+		g->p[p1] = g->n - (p1 + 1);
+		g->p[p2] = g->n - (p2 + 1);
+		g->p[p3] = g->n - (p3 + 1);
+		g->p[p4] = g->n - (p4 + 1);
+	}
+	if (pc >= 0)
+		j_st16i(g, O(PC), pc);
+	if (m1pc >= 0)
+		j_st16i(g, O(M1PC), m1pc);
+	j_epilogue(g);
+}
+
+
+/* ---------------------------------------------------------
+ *  Translation
+ * ---------------------------------------------------------
+ */
+
+/* The page being translated, as seen by the probe */
+static const byte *probe_code;
+static ushort probe_base;
+static unsigned probe_avail;
+static byte probe_fill;
+static int probe_io;
+
+static byte probe_read(int param, ushort addr)
+{
+	ushort off = addr - probe_base;
+
+	if (off < probe_avail)
+		return probe_code[off];
+	return probe_fill;
+}
+
+
+static void probe_write(int param, ushort addr, byte val)
+{
+}
+
+
+static byte probe_in(int param, ushort addr)
+{
+	probe_io = 1;
+	return 0xFF;
+}
+
+
+static void probe_out(int param, ushort addr, byte val)
+{
+	probe_io = 1;
+}
+
+
+/* Run one instruction on a scratch context with the flags all clear or
+   all set, and B so that DJNZ goes the same way as the flag tests. The
+   other registers and memory differ between the two runs as well, so
+   anything else that decides where the instruction goes shows up */
+static void jit_probe(Z180Context *s, ushort pc, int set)
+{
+	memset(s, 0, sizeof(*s));
+	s->memRead = probe_read;
+	s->memWrite = probe_write;
+	s->ioRead = probe_in;
+	s->ioWrite = probe_out;
+	s->R1.br.F = set ? 0xFF : 0x00;
+	s->R1.br.B = set ? 1 : 2;
+	s->R1.wr.HL = set ? 0xFFFF : 0;
+	s->R1.wr.IX = s->R1.wr.HL;
+	s->R1.wr.IY = s->R1.wr.HL;
+	/* Keep the stack away from the code */
+	s->R1.wr.SP = (pc ^ 0x8000) & 0xFF00;
+	probe_fill = set ? 0xFF : 0x00;
+	s->PC = pc;
+	do_execute(s);
+}
+
+
+/* Test a condition code on F and branch if it holds. Returns the offset
+   of the rel32 to patch */
+static unsigned j_cond(struct jit_gen *g, unsigned cc, int invert)
+{
+	static const byte mask[4] = { F_Z, F_C, F_PV, F_S };
+
+	jb(g, 0xF6);		/* test byte [F], mask */
+	jm(g, 0, O(R1.br.F));
+	jb(g, mask[cc >> 1]);
+	jb(g, 0x0F);		/* jnz / jz */
+	jb(g, ((cc & 1) ^ invert) ? 0x85 : 0x84);
+	jl(g, 0);
+	return g->n - 4;
+}
+
+
+/* Record an exit taken from the middle of the block */
+static void j_exit(struct jit_gen *g, unsigned patch, int pc,
+	unsigned tstates, unsigned r, int m1pc)
+{
+	struct jit_exit *e = &g->exit[g->nexit++];
+
+	e->patch = patch;
+	e->pc = pc;
+	e->tstates = tstates;
+	e->r = r;
+	e->m1pc = m1pc;
+	e->flags = g->flags;
+}
+
+
+/* Leave if the instruction just done wrote into this block */
+static void j_smc(struct jit_gen *g, int pc)
+{
+	jb(g, 0x80);		/* cmp byte [jit_smc], 0 */
+	jm(g, 7, O(jit_smc));
+	jb(g, 0);
+	jb(g, 0x0F);		/* jne exit */
+	jb(g, 0x85);
+	jl(g, 0);
+	j_exit(g, g->n - 4, pc, g->tstates, g->r, g->m1pc);
+}
+
+
+static void j_patch(struct jit_gen *g, unsigned at)
+{
+	unsigned v = g->n - (at + 4);
+
+	g->p[at] = v;
+	g->p[at + 1] = v >> 8;
+	g->p[at + 2] = v >> 16;
+	g->p[at + 3] = v >> 24;
+}
+
+
+/* Opcodes translated to host code rather than left to the interpreter */
+static int jit_native(byte op)
+{
+	if (op < 0x40)
+		return (op & 7) != 7;
+	if (op < 0x80)
+		return op != 0x76;
+	if (op < 0xC0)
+		return (op & 0xF8) != 0x88 && (op & 0xF8) != 0x98;
+	switch (op)
+	{
+	case 0xCB: case 0xCE: case 0xD3: case 0xDB: case 0xDD:
+	case 0xDE: case 0xE3: case 0xED: case 0xF3: case 0xFB:
+	case 0xFD:
+		return 0;
+	}
+	return 1;
+}
+
+
+/* True if the instruction at c traps as undefined or runs off the end
+   of what we have. Walks the tables as do_execute does, as letting the
+   probe find them would report them */
+static int jit_ufo(const byte *c, unsigned avail)
+{
+	const struct Z180OpcodeTable *t = &opcodes_main;
+	const struct Z180OpcodeEntry *e;
+	unsigned pc = 0;
+	unsigned offset = 0;
+
+	do
+	{
+		if (pc + offset >= avail)
+			return 1;
+		e = &t->entries[c[pc + offset]];
+		pc++;
+		if (e->func != NULL)
+			return 0;
+		t = e->table;
+		if (t != NULL)
+			offset = t->opcode_offset;
+	} while (t != NULL);
+	return 1;
+}
+
+
+static void jit_flush(struct z180jit *j)
+{
+	j->code_used = 0;
+	j->meta_used = 0;
+	memset(j->blocks, 0, sizeof(j->blocks));
+}
+
+
+static struct jit_block *jit_translate(Z180Context *ctx, ushort pc,
+	const byte *host)
+{
+	struct z180jit *j = ctx->jit;
+	static struct jit_gen g;
+	Z180Context s0, s1;
+	struct jit_block *b;
+	unsigned avail = 0x100 - (pc & 0xFF);
+	unsigned off = 0, insns = 0, i;
+	int end = 0;
+
+	if (j->code_used + JIT_MAXCODE > JIT_CODE ||
+		j->meta_used + sizeof(struct jit_block) + 256 + 16 > JIT_META)
+		jit_flush(j);
+
+	g.p = j->code + j->code_used;
+	g.n = 0;
+	g.start = pc;
+	g.flags = JF_NONE;
+	g.tstates = 0;
+	g.r = 0;
+	g.m1pc = -1;
+	g.nexit = 0;
+
+	jb(&g, 0x53);		/* push rbx */
+	jb(&g, 0x41);		/* push r12 */
+	jb(&g, 0x54);
+	jb(&g, 0x48);		/* sub rsp, 8 */
+	jb(&g, 0x83);
+	jb(&g, 0xEC);
+	jb(&g, 0x08);
+	jb(&g, 0x48);		/* mov rbx, rdi */
+	jb(&g, 0x89);
+	jb(&g, 0xFB);
+	g.loop = g.n;
+
+	probe_code = host;
+	probe_base = pc;
+	probe_avail = avail;
+
+	while (!end && insns < JIT_INSNS && off < avail)
+	{
+		const byte *c = host + off;
+		ushort a = pc + off;
+		byte op = c[0];
+		unsigned len, t, tt, r, d, rr, cc;
+		unsigned n = off + 1 < avail ? c[1] : 0;
+		unsigned nn = off + 2 < avail ? n | (c[2] << 8) : 0;
+		int native = jit_native(op);
+		int cond, jump;
+		unsigned at;
+
+		/* Things the interpreter has to see */
+		if (op == 0xDB || op == 0xD3 || op == 0xED || op == 0x76)
+			break;
+		if ((op == 0xDD || op == 0xFD) && (off + 1 >= avail ||
+			n == 0xDD || n == 0xFD || n == 0xED))
+			break;
+		if (jit_ufo(c, avail - off))
+			break;
+
+		probe_io = 0;
+		jit_probe(&s0, a, 0);
+		jit_probe(&s1, a, 1);
+		if (probe_io)
+			break;
+		r = s0.R & 0x7F;
+
+		/* Instruction length for the native set */
+		switch (op)
+		{
+		case 0x01: case 0x11: case 0x21: case 0x31:
+		case 0x22: case 0x2A: case 0x32: case 0x3A:
+		case 0xC2: case 0xCA: case 0xD2: case 0xDA:
+		case 0xE2: case 0xEA: case 0xF2: case 0xFA:
+		case 0xC3: case 0xCD:
+		case 0xC4: case 0xCC: case 0xD4: case 0xDC:
+		case 0xE4: case 0xEC: case 0xF4: case 0xFC:
+			len = 3;
+			break;
+		case 0x06: case 0x0E: case 0x16: case 0x1E:
+		case 0x26: case 0x2E: case 0x36: case 0x3E:
+		case 0x10: case 0x18: case 0x20: case 0x28:
+		case 0x30: case 0x38:
+		case 0xC6: case 0xD6: case 0xE6: case 0xEE:
+		case 0xF6: case 0xFE:
+			len = 2;
+			break;
+		default:
+			len = 1;
+		}
+		if (off + len > avail)
+			break;
+
+		/* The probe must agree about everything we do not work
+		   out for ourselves */
+		cond = op == 0x10 || (op & 0xE7) == 0x20 ||
+			(op & 0xC7) == 0xC0 || (op & 0xC7) == 0xC2 ||
+			(op & 0xC7) == 0xC4;
+		jump = op == 0x18 || op == 0xC3 || op == 0xC9 || op == 0xCD ||
+			op == 0xE9 || (op & 0xC7) == 0xC7;
+		if (native && !cond && (s0.tstates != s1.tstates ||
+			(!jump && (s0.PC != (ushort)(a + len) || s1.PC != s0.PC))))
+			break;
+		if (!native)
+		{
+			/* Left to the interpreter. It must not branch, halt,
+			   or change the interrupt state except for DI and EI */
+			if (s0.PC != s1.PC || s0.halted || s1.halted)
+				break;
+			len = (ushort)(s0.PC - a);
+			if ((op == 0xDD || op == 0xFD) && n == 0xE9)
+				break;
+			if (op != 0xF3 && op != 0xFB && (s0.IFF1 || s0.IFF2 ||
+				s0.defer_int))
+				break;
+			if (len == 0 || len > 4 || off + len > avail)
+				break;
+		}
+
+		t = s0.tstates;
+		tt = s0.tstates;
+		d = (op >> 3) & 7;
+		rr = (op >> 4) & 3;
+
+		switch (op)
+		{
+		case 0x00:		/* NOP */
+			break;
+		case 0x01: case 0x11: case 0x21: case 0x31:
+			j_st16i(&g, jit_r16[rr], nn);
+			break;
+		case 0x02: case 0x12:	/* LD (BC/DE),A */
+			j_ld16(&g, 6, jit_r16[rr]);
+			j_ld8(&g, 2, O(R1.br.A));
+			j_write(&g);
+			break;
+		case 0x0A: case 0x1A:	/* LD A,(BC/DE) */
+			j_ld16(&g, 6, jit_r16[rr]);
+			j_read(&g);
+			j_st8(&g, 0, O(R1.br.A));
+			break;
+		case 0x03: case 0x13: case 0x23: case 0x33:
+		case 0x0B: case 0x1B: case 0x2B: case 0x3B:
+			jb(&g, 0x66);	/* inc/dec word [rr] */
+			jb(&g, 0xFF);
+			jm(&g, (op & 8) ? 1 : 0, jit_r16[rr]);
+			break;
+		case 0x04: case 0x0C: case 0x14: case 0x1C:
+		case 0x24: case 0x2C: case 0x34: case 0x3C:
+		case 0x05: case 0x0D: case 0x15: case 0x1D:
+		case 0x25: case 0x2D: case 0x35: case 0x3D:
+			/* Carry is kept so F has to be real first */
+			j_sync(&g);
+			if (d == 6)
+			{
+				j_ld16(&g, 6, O(R1.wr.HL));
+				jb(&g, 0x41);	/* mov r12d, esi */
+				jb(&g, 0x89);
+				jb(&g, 0xF4);
+				j_read(&g);
+			}
+			else
+				j_ld8(&g, 0, jit_r8[d]);
+			j_st8(&g, 0, O(jit_fa));
+			jb(&g, 0xFE);	/* inc al / dec al */
+			jb(&g, (op & 1) ? 0xC8 : 0xC0);
+			if (d == 6)
+			{
+				jb(&g, 0x89);	/* mov edx, eax */
+				jb(&g, 0xC2);
+				jb(&g, 0x44);	/* mov esi, r12d */
+				jb(&g, 0x89);
+				jb(&g, 0xE6);
+				j_write(&g);
+			}
+			else
+				j_st8(&g, 0, jit_r8[d]);
+			g.flags = (op & 1) ? JF_DEC : JF_INC;
+			break;
+		case 0x06: case 0x0E: case 0x16: case 0x1E:
+		case 0x26: case 0x2E: case 0x36: case 0x3E:
+			if (d == 6)
+			{
+				j_ld16(&g, 6, O(R1.wr.HL));
+				j_movi(&g, 2, n);
+				j_write(&g);
+			}
+			else
+				j_st8i(&g, jit_r8[d], n);
+			break;
+		case 0x08:		/* EX AF,AF' */
+			j_sync(&g);
+			j_ld16(&g, 0, O(R1.wr.AF));
+			j_ld16(&g, 1, O(R2.wr.AF));
+			j_st16(&g, 0, O(R2.wr.AF));
+			j_st16(&g, 1, O(R1.wr.AF));
+			break;
+		case 0x09: case 0x19: case 0x29: case 0x39:
+			/* S, Z and PV are kept */
+			j_sync(&g);
+			j_ld16(&g, 0, O(R1.wr.HL));
+			j_ld16(&g, 1, jit_r16[rr]);
+			j_st16(&g, 0, O(jit_fw));
+			j_st16(&g, 1, O(jit_fx));
+			jb(&g, 0x01);	/* add eax, ecx */
+			jb(&g, 0xC8);
+			j_st16(&g, 0, O(R1.wr.HL));
+			g.flags = JF_ADD16;
+			break;
+		case 0x10:		/* DJNZ */
+			jb(&g, 0xFE);	/* dec byte [B] */
+			jm(&g, 1, O(R1.br.B));
+			jb(&g, 0x0F);	/* jnz */
+			jb(&g, 0x85);
+			jl(&g, 0);
+			j_exit(&g, g.n - 4, (ushort)(a + 2 + (signed char)n),
+				g.tstates + s0.tstates, g.r + r, a);
+			t = s1.tstates;
+			break;
+		case 0x18:		/* JR */
+			end = 1;
+			break;
+		case 0x20: case 0x28: case 0x30: case 0x38:
+			cc = d & 3;
+			j_sync(&g);
+			at = j_cond(&g, cc, 0);
+			tt = (cc & 1) ? s1.tstates : s0.tstates;
+			t = (cc & 1) ? s0.tstates : s1.tstates;
+			j_exit(&g, at, (ushort)(a + 2 + (signed char)n),
+				g.tstates + tt, g.r + r, a);
+			break;
+		case 0x22:		/* LD (nn),HL */
+			j_movi(&g, 6, nn);
+			j_ld8(&g, 2, O(R1.br.L));
+			j_write(&g);
+			j_movi(&g, 6, (nn + 1) & 0xFFFF);
+			j_ld8(&g, 2, O(R1.br.H));
+			j_write(&g);
+			break;
+		case 0x2A:		/* LD HL,(nn) */
+			j_movi(&g, 6, nn);
+			j_read(&g);
+			jb(&g, 0x41);	/* mov r12d, eax */
+			jb(&g, 0x89);
+			jb(&g, 0xC4);
+			j_movi(&g, 6, (nn + 1) & 0xFFFF);
+			j_read(&g);
+			jb(&g, 0xC1);	/* shl eax, 8 */
+			jb(&g, 0xE0);
+			jb(&g, 0x08);
+			jb(&g, 0x44);	/* or eax, r12d */
+			jb(&g, 0x09);
+			jb(&g, 0xE0);
+			j_st16(&g, 0, O(R1.wr.HL));
+			break;
+		case 0x32:		/* LD (nn),A */
+			j_movi(&g, 6, nn);
+			j_ld8(&g, 2, O(R1.br.A));
+			j_write(&g);
+			break;
+		case 0x3A:		/* LD A,(nn) */
+			j_movi(&g, 6, nn);
+			j_read(&g);
+			j_st8(&g, 0, O(R1.br.A));
+			break;
+		case 0x80: case 0x81: case 0x82: case 0x83:
+		case 0x84: case 0x85: case 0x86: case 0x87:
+		case 0x90: case 0x91: case 0x92: case 0x93:
+		case 0x94: case 0x95: case 0x96: case 0x97:
+		case 0xA0: case 0xA1: case 0xA2: case 0xA3:
+		case 0xA4: case 0xA5: case 0xA6: case 0xA7:
+		case 0xA8: case 0xA9: case 0xAA: case 0xAB:
+		case 0xAC: case 0xAD: case 0xAE: case 0xAF:
+		case 0xB0: case 0xB1: case 0xB2: case 0xB3:
+		case 0xB4: case 0xB5: case 0xB6: case 0xB7:
+		case 0xB8: case 0xB9: case 0xBA: case 0xBB:
+		case 0xBC: case 0xBD: case 0xBE: case 0xBF:
+		case 0xC6: case 0xD6: case 0xE6: case 0xEE:
+		case 0xF6: case 0xFE:
+			if (op & 0x40)
+				j_movi(&g, 1, n);
+			else if ((op & 7) == 6)
+			{
+				j_ld16(&g, 6, O(R1.wr.HL));
+				j_read(&g);
+				jb(&g, 0x89);	/* mov ecx, eax */
+				jb(&g, 0xC1);
+			}
+			else
+				j_ld8(&g, 1, jit_r8[op & 7]);
+			/* Every flag is replaced */
+			g.flags = JF_NONE;
+			j_ld8(&g, 0, O(R1.br.A));
+			switch (d)
+			{
+			case 0:		/* ADD */
+			case 2:		/* SUB */
+			case 7:		/* CP */
+				j_st8(&g, 0, O(jit_fa));
+				j_st8(&g, 1, O(jit_fb));
+				if (d != 7)
+				{
+					jb(&g, d ? 0x28 : 0x00);	/* sub/add al, cl */
+					jb(&g, 0xC8);
+					j_st8(&g, 0, O(R1.br.A));
+				}
+				g.flags = d == 0 ? JF_ADD : d == 2 ? JF_SUB : JF_CP;
+				break;
+			default:
+				/* and / xor / or al, cl */
+				jb(&g, d == 4 ? 0x20 : d == 5 ? 0x30 : 0x08);
+				jb(&g, 0xC8);
+				j_st8(&g, 0, O(R1.br.A));
+				j_st8(&g, 0, O(jit_fa));
+				g.flags = d == 4 ? JF_AND : JF_OR;
+				break;
+			}
+			break;
+		case 0xC0: case 0xC8: case 0xD0: case 0xD8:
+		case 0xE0: case 0xE8: case 0xF0: case 0xF8:
+			/* RET cc */
+			j_sync(&g);
+			at = j_cond(&g, d, 1);
+			tt = (d & 1) ? s1.tstates : s0.tstates;
+			t = (d & 1) ? s0.tstates : s1.tstates;
+			j_pop(&g);
+			j_st16(&g, 0, O(PC));
+			j_leave(&g, -1, g.tstates + tt, g.r + r, a, JF_NONE);
+			j_patch(&g, at);
+			break;
+		case 0xC1: case 0xD1: case 0xE1: case 0xF1:
+			if (rr == 3)
+				g.flags = JF_NONE;
+			j_pop(&g);
+			jb(&g, 0x89);	/* mov edx, eax */
+			jb(&g, 0xC2);
+			j_st8(&g, 0, jit_lo[rr]);
+			jb(&g, 0xC1);	/* shr edx, 8 */
+			jb(&g, 0xEA);
+			jb(&g, 0x08);
+			j_st8(&g, 2, jit_hi[rr]);
+			break;
+		case 0xC5: case 0xD5: case 0xE5: case 0xF5:
+			if (rr == 3)
+				j_sync(&g);
+			j_push(&g, jit_lo[rr], jit_hi[rr]);
+			break;
+		case 0xC2: case 0xCA: case 0xD2: case 0xDA:
+		case 0xE2: case 0xEA: case 0xF2: case 0xFA:
+			/* JP cc */
+			j_sync(&g);
+			at = j_cond(&g, d, 0);
+			tt = (d & 1) ? s1.tstates : s0.tstates;
+			t = (d & 1) ? s0.tstates : s1.tstates;
+			j_exit(&g, at, nn, g.tstates + tt, g.r + r, a);
+			break;
+		case 0xC3:		/* JP */
+		case 0xC9:		/* RET */
+		case 0xCD:		/* CALL */
+		case 0xE9:		/* JP (HL) */
+		case 0xC7: case 0xCF: case 0xD7: case 0xDF:
+		case 0xE7: case 0xEF: case 0xF7: case 0xFF:
+			end = 1;
+			break;
+		case 0xC4: case 0xCC: case 0xD4: case 0xDC:
+		case 0xE4: case 0xEC: case 0xF4: case 0xFC:
+			/* CALL cc */
+			j_sync(&g);
+			at = j_cond(&g, d, 1);
+			tt = (d & 1) ? s1.tstates : s0.tstates;
+			t = (d & 1) ? s0.tstates : s1.tstates;
+			j_push(&g, -1, (ushort)(a + 3));
+			j_leave(&g, nn, g.tstates + tt, g.r + r, a, JF_NONE);
+			j_patch(&g, at);
+			break;
+		case 0xD9:		/* EXX */
+			for (i = 0; i < 3; i++)
+			{
+				j_ld16(&g, 0, jit_r16[i]);
+				j_ld16(&g, 1, jit_r16[i] + O(R2));
+				j_st16(&g, 0, jit_r16[i] + O(R2));
+				j_st16(&g, 1, jit_r16[i]);
+			}
+			break;
+		case 0xEB:		/* EX DE,HL */
+			j_ld16(&g, 0, O(R1.wr.DE));
+			j_ld16(&g, 1, O(R1.wr.HL));
+			j_st16(&g, 0, O(R1.wr.HL));
+			j_st16(&g, 1, O(R1.wr.DE));
+			break;
+		case 0xF9:		/* LD SP,HL */
+			j_ld16(&g, 0, O(R1.wr.HL));
+			j_st16(&g, 0, O(R1.wr.SP));
+			break;
+		default:
+			if (op >= 0x40 && op < 0x80)
+			{
+				/* LD r,r' */
+				if ((op & 7) == 6)
+				{
+					j_ld16(&g, 6, O(R1.wr.HL));
+					j_read(&g);
+					j_st8(&g, 0, jit_r8[d]);
+				}
+				else if (d == 6)
+				{
+					j_ld16(&g, 6, O(R1.wr.HL));
+					j_ld8(&g, 2, jit_r8[op & 7]);
+					j_write(&g);
+				}
+				else if (d != (op & 7))
+				{
+					j_ld8(&g, 0, jit_r8[op & 7]);
+					j_st8(&g, 0, jit_r8[d]);
+				}
+				break;
+			}
+			break;
+		}
+
+		if (native)
+		{
+			g.m1pc = a;
+			if (end)
+			{
+				switch (op)
+				{
+				case 0x18:
+					j_leave(&g, (ushort)(a + 2 + (signed char)n),
+						g.tstates + t, g.r + r, a, g.flags);
+					break;
+				case 0xC3:
+					j_leave(&g, nn, g.tstates + t, g.r + r, a,
+						g.flags);
+					break;
+				case 0xC9:
+					j_pop(&g);
+					j_st16(&g, 0, O(PC));
+					j_leave(&g, -1, g.tstates + t, g.r + r, a,
+						g.flags);
+					break;
+				case 0xCD:
+					j_push(&g, -1, (ushort)(a + 3));
+					j_leave(&g, nn, g.tstates + t, g.r + r, a,
+						g.flags);
+					break;
+				case 0xE9:
+					j_ld16(&g, 0, O(R1.wr.HL));
+					j_st16(&g, 0, O(PC));
+					j_leave(&g, -1, g.tstates + t, g.r + r, a,
+						g.flags);
+					break;
+				default:	/* RST */
+					j_push(&g, -1, (ushort)(a + 1));
+					j_leave(&g, op & 0x38, g.tstates + t,
+						g.r + r, a, g.flags);
+					break;
+				}
+			}
+			g.tstates += t;
+			g.r += r;
+			/* Instructions that write memory */
+			if (!end && (op == 0x02 || op == 0x12 || op == 0x22 ||
+				op == 0x32 || op == 0x34 || op == 0x35 ||
+				op == 0x36 || (op >= 0x70 && op <= 0x77) ||
+				(op & 0xCF) == 0xC5 || (op & 0xC7) == 0xC4))
+				j_smc(&g, (ushort)(a + len));
+		}
+		else
+		{
+			/* EI ends the block so the interrupt check is done
+			   after the next instruction, as the interpreter does */
+			if (op == 0xFB)
+				end = 1;
+			j_sync(&g);
+			j_st16i(&g, O(PC), a);
+			j_call(&g, (unsigned long)do_execute);
+			if (end)
+				j_leave(&g, -1, g.tstates, g.r, -1, JF_NONE);
+			else
+			{
+				g.m1pc = -1;
+				j_smc(&g, -1);
+			}
+		}
+		off += len;
+		insns++;
+	}
+
+	if (insns == 0)
+		return NULL;
+
+	if (!end)
+		j_leave(&g, (ushort)(pc + off), g.tstates, g.r, g.m1pc, g.flags);
+
+	/* Exits from the middle */
+	for (i = 0; i < g.nexit; i++)
+	{
+		struct jit_exit *e = &g.exit[i];
+		j_patch(&g, e->patch);
+		j_leave(&g, e->pc, e->tstates, e->r, e->m1pc, e->flags);
+	}
+
+	b = (struct jit_block *)(j->meta + j->meta_used);
+	b->next = j->blocks[pc];
+	b->code = (void (*)(Z180Context *))g.p;
+	b->host = host;
+	b->len = off;
+	memcpy(b->bytes, host, off);
+	j->meta_used += (offsetof(struct jit_block, bytes) + off + 15) & ~15;
+	j->code_used += (g.n + 15) & ~15;
+	j->blocks[pc] = b;
+	return b;
+}
+
+
+/* Run a block if there is one worth running here. Returns 0 to leave
+   this instruction to the interpreter */
+static int jit_run(Z180Context *ctx)
+{
+	struct z180jit *j = ctx->jit;
+	struct jit_block *b, **bp;
+	ushort pc = ctx->PC;
+	const byte *host;
+
+	if (ctx->nmi_req || (ctx->int_req && ctx->IFF1) || ctx->defer_int ||
+		ctx->halted || ctx->trace)
+		return 0;
+	host = j->map(ctx->memParam, pc);
+	if (host == NULL)
+		return 0;
+	bp = &j->blocks[pc];
+	while ((b = *bp) != NULL)
+	{
+		if (b->host == host)
+		{
+			if (memcmp(host, b->bytes, b->len) == 0)
+				break;
+			/* The code has been overwritten */
+			*bp = b->next;
+			continue;
+		}
+		bp = &b->next;
+	}
+	if (b == NULL)
+	{
+		if (j->hot[pc] < JIT_HOT)
+		{
+			j->hot[pc]++;
+			return 0;
+		}
+		j->hot[pc] = 0;
+		b = jit_translate(ctx, pc, host);
+		if (b == NULL)
+			return 0;
+	}
+	ctx->jit_pc = pc;
+	ctx->jit_len = b->len;
+	ctx->jit_smc = 0;
+	b->code(ctx);
+	ctx->jit_len = 0;
+	return 1;
+}
+
+
+int Z180JitEnable(Z180Context *ctx, Z180MemMap map)
+{
+	struct z180jit *j;
+
+	j = calloc(1, sizeof(*j));
+	if (j == NULL)
+		return -1;
+	j->code = mmap(NULL, JIT_CODE, PROT_READ | PROT_WRITE | PROT_EXEC,
+		MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	j->meta = malloc(JIT_META);
+	if (j->code == MAP_FAILED || j->meta == NULL)
+	{
+		if (j->code != MAP_FAILED)
+			munmap(j->code, JIT_CODE);
+		free(j->meta);
+		free(j);
+		return -1;
+	}
+	j->map = map;
+	ctx->jit = j;
+	return 0;
+}
+
+#else
+
+static int jit_run(Z180Context *ctx)
+{
+	return 0;
+}
+
+
+int Z180JitEnable(Z180Context *ctx, Z180MemMap map)
+{
+	return -1;
+}
+
+#endif
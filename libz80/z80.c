@@ -23,6 +23,9 @@
  *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
  */
 
+/* For mmap in the block translator */
+#define _DEFAULT_SOURCE
+
 #include "z80.h"
 #include "string.h"
 
@@ -133,7 +136,12 @@ struct Z80OpcodeTable
 static void write8 (Z80Context* ctx, ushort addr, byte val)
 {
 	ctx->tstates += 3;
+	ctx->spin_dirty = 1;
 	ctx->memWrite(ctx->memParam, addr, val);	
+	/* Interpreting an instruction for a translated block that has
+	   just written into itself */
+	if ((ushort)(addr - ctx->jit_pc) < ctx->jit_len)
+		ctx->jit_smc = 1;
 }
 
 
@@ -159,16 +167,78 @@ static ushort read16 (Z80Context* ctx, ushort addr)
 }
 
 
+/*
+ * Spin loop detection. Each read of an ioPoll port snapshots the CPU.
+ * If we come back to the same instruction with the same registers,
+ * having written nothing and read nothing else with side effects, and
+ * the port gave the same answer, then the loop is a fixed point. The
+ * devices only move on between slices so it will go round identically
+ * until the end of this one. A device that did change shows up as a
+ * different status value or a pending interrupt. Skip as many whole trips round the loop
+ * as fit, adjusting R as if they had run.
+ */
+static void spin_check(Z80Context* ctx, ushort addr, byte val)
+{
+	unsigned d, k;
+	byte iff = ctx->IFF1 | (ctx->IFF2 << 1);
+
+	if (ctx->spin_valid && !ctx->spin_dirty && ctx->spin_pc == ctx->M1PC &&
+		ctx->spin_port == addr && ctx->spin_val == val &&
+		ctx->spin_I == ctx->I && ctx->spin_IFF == iff &&
+		ctx->spin_IM == ctx->IM &&
+		memcmp(&ctx->spin_R1, &ctx->R1, sizeof(Z80Regs)) == 0 &&
+		memcmp(&ctx->spin_R2, &ctx->R2, sizeof(Z80Regs)) == 0 &&
+		!ctx->nmi_req && !(ctx->int_req && ctx->IFF1) &&
+		ctx->tstates < ctx->spin_goal)
+	{
+		d = ctx->tstates - ctx->spin_tstates;
+		k = (ctx->spin_goal - ctx->tstates) / d;
+		ctx->tstates += k * d;
+		ctx->R = (ctx->R & 0x80) |
+			((ctx->R + k * (ctx->R - ctx->spin_R)) & 0x7f);
+		/* Even if the slice was too short to skip anything tell
+		   the caller, it can then hand us a longer one */
+		ctx->spinning = 1;
+	}
+	else
+	{
+		ctx->spin_pc = ctx->M1PC;
+		ctx->spin_port = addr;
+		ctx->spin_val = val;
+		ctx->spin_I = ctx->I;
+		ctx->spin_IFF = iff;
+		ctx->spin_IM = ctx->IM;
+		ctx->spin_R1 = ctx->R1;
+		ctx->spin_R2 = ctx->R2;
+	}
+	ctx->spin_R = ctx->R;
+	ctx->spin_tstates = ctx->tstates;
+	ctx->spin_valid = 1;
+	ctx->spin_dirty = 0;
+}
+
+
 static byte ioRead (Z80Context* ctx, ushort addr)
 {
+	byte r;
+
 	ctx->tstates += 4;
-	return ctx->ioRead(ctx->ioParam, addr);
+	r = ctx->ioRead(ctx->ioParam, addr);
+	if (ctx->ioPoll)
+	{
+		if (ctx->ioPoll(ctx->ioParam, addr))
+			spin_check(ctx, addr, r);
+		else
+			ctx->spin_dirty = 1;
+	}
+	return r;
 }
 
 
 static void ioWrite (Z80Context* ctx, ushort addr, byte val)
 {
 	ctx->tstates += 4;
+	ctx->spin_dirty = 1;
 	ctx->ioWrite(ctx->ioParam, addr, val);
 }
 
@@ -230,32 +300,28 @@ static int parityBit[256] = {
 	1, 0, 0, 1, 0, 1, 1, 0, 0, 1, 1, 0, 1, 0, 0, 1 };
 
 
+/* S, Z, 5 and 3 flags for a result */
+#define FLAGS_SZ53(v)	(((v) & (F_S | F_5 | F_3)) | ((v) ? 0 : F_Z))
+/* As above plus parity */
+#define FLAGS_SZ53P(v)	(FLAGS_SZ53(v) | (parityBit[v] ? F_PV : 0))
+
 static void adjustFlags (Z80Context* ctx, byte val)
 {
-	VALFLAG(F_5, (val & F_5) != 0);
-	VALFLAG(F_3, (val & F_3) != 0);
+	BR.F = (BR.F & ~(F_5 | F_3)) | (val & (F_5 | F_3));
 }
 
 
 static void adjustFlagSZP (Z80Context* ctx, byte val)
 {
-	VALFLAG(F_S, (val & 0x80) != 0);
-	VALFLAG(F_Z, (val == 0));
-	VALFLAG(F_PV, parityBit[val]);
+	BR.F = (BR.F & ~(F_S | F_Z | F_PV)) | (val & F_S) | (val ? 0 : F_Z) |
+		(parityBit[val] ? F_PV : 0);
 }
 
 
 /* Adjust flags after AND, OR, XOR */
 static void adjustLogicFlag (Z80Context* ctx, int flagH)
 {
-    VALFLAG(F_S, (BR.A & 0x80) != 0);
-    VALFLAG(F_Z, (BR.A == 0));
-    VALFLAG(F_H, flagH);
-    VALFLAG(F_N, 0);
-    VALFLAG(F_C, 0);
-    VALFLAG(F_PV, parityBit[BR.A]);
-
-    adjustFlags(ctx, BR.A);
+    BR.F = FLAGS_SZ53P(BR.A) | (flagH ? F_H : 0);
 }
 
 
@@ -327,40 +393,41 @@ static int doComplement(byte v)
 }
 
  
-/** Do an arithmetic operation (ADD, SUB, ADC, SBC y CP) */
+/** Do an arithmetic operation (ADD, SUB, ADC, SBC y CP)
+ *
+ * All the flags are affected so we build the new F in one go rather
+ * than a bit at a time. */
 static byte doArithmetic (Z80Context* ctx, byte value, int withCarry, int isSub)
 {
 	ushort res; /* To detect carry */
+	int carry = withCarry && GETFLAG(F_C);
+	byte f;
 
 	if (isSub)
 	{
-		SETFLAG(F_N);
-		VALFLAG(F_H, (((BR.A & 0x0F) - (value & 0x0F)) & 0x10) != 0);
-		res = BR.A - value;
-		if (withCarry && GETFLAG(F_C))
-			res--;
+		f = F_N;
+		if (((BR.A & 0x0F) - (value & 0x0F)) & 0x10)
+			f |= F_H;
+		res = BR.A - value - carry;
+		/* Overflow if the operands differ in sign and the result
+		   sign differs from the minuend */
+		if ((BR.A ^ value) & (BR.A ^ res) & 0x80)
+			f |= F_PV;
 	}
 	else
 	{
-		RESFLAG(F_N);
-		VALFLAG(F_H, (((BR.A & 0x0F) + (value & 0x0F)) & 0x10) != 0);
-		res = BR.A + value;
-		if (withCarry && GETFLAG(F_C))
-			res++;
+		f = 0;
+		if (((BR.A & 0x0F) + (value & 0x0F)) & 0x10)
+			f |= F_H;
+		res = BR.A + value + carry;
+		/* Overflow if the operands have the same sign and the result
+		   sign differs */
+		if (~(BR.A ^ value) & (BR.A ^ res) & 0x80)
+			f |= F_PV;
 	}
-	VALFLAG(F_S, ((res & 0x80) != 0));
-	VALFLAG(F_C, ((res & 0x100) != 0));
-	VALFLAG(F_Z, ((res & 0xff) == 0));
-	int minuend_sign = BR.A & 0x80;
-	int subtrahend_sign = value & 0x80;
-	int result_sign = res & 0x80;
-	int overflow;
-	if(isSub)
-		overflow = minuend_sign != subtrahend_sign && result_sign != minuend_sign;
-	else
-		overflow = minuend_sign == subtrahend_sign && result_sign != minuend_sign;
-	VALFLAG(F_PV, overflow);
-	adjustFlags(ctx, res);
+	if (res & 0x100)
+		f |= F_C;
+	BR.F = f | FLAGS_SZ53(res & 0xFF);
 
 	return (byte)(res & 0xFF);
 }
@@ -470,24 +537,28 @@ static byte doSetRes (Z80Context* ctx, int bit, int pos, byte val)
 
 static byte doIncDec (Z80Context* ctx, byte val, int isDec)
 {
+    /* Carry is preserved, everything else is set */
+    byte f = BR.F & F_C;
+
     if (isDec)
     {
-        VALFLAG(F_PV, (val & 0x80) && !((val - 1) & 0x80));
+        if (val == 0x80)
+            f |= F_PV;
         val--;
-        VALFLAG(F_H, (val & 0x0F) == 0x0F);
+        if ((val & 0x0F) == 0x0F)
+            f |= F_H;
+        f |= F_N;
     }
     else
     {
-        VALFLAG(F_PV, !(val & 0x80) && ((val + 1) & 0x80));
+        if (val == 0x7F)
+            f |= F_PV;
         val++;
-        VALFLAG(F_H, !(val & 0x0F));
+        if (!(val & 0x0F))
+            f |= F_H;
     }
 
-    VALFLAG(F_S, ((val & 0x80) != 0));
-    VALFLAG(F_Z, (val == 0));
-    VALFLAG(F_N, isDec);
-
-    adjustFlags(ctx, val);
+    BR.F = f | FLAGS_SZ53(val);
 
     return val;
 }
@@ -773,16 +844,58 @@ void Z80Execute (Z80Context* ctx)
 	else
 	{
 		ctx->defer_int = 0;
+		if (ctx->hle && ctx->hle(ctx->memParam, ctx->PC))
+		{
+			ctx->spin_dirty = 1;
+			return;
+		}
 		do_execute(ctx);
 	}
 }
 
 
+int Z80Idle(Z80Context* ctx)
+{
+	return ctx->halted && !ctx->nmi_req && !(ctx->int_req && ctx->IFF1);
+}
+
+
+int Z80Spinning(Z80Context* ctx)
+{
+	return ctx->spinning;
+}
+
+
+#include "z80jit.c"
+
+
 unsigned Z80ExecuteTStates(Z80Context* ctx, unsigned tstates)
 {
+	unsigned n;
+
 	ctx->tstates = 0;
+	ctx->spinning = 0;
+	ctx->spin_goal = tstates;
 	while (ctx->tstates < tstates)
+	{
+		/* Halted and nothing can wake us until the caller changes
+		   something, so account the HALT refetches in one go */
+		if (Z80Idle(ctx))
+		{
+			n = (tstates - ctx->tstates + 3) / 4;
+			ctx->tstates += 4 * n;
+			ctx->R = (ctx->R & 0x80) | ((ctx->R + n) & 0x7f);
+			ctx->defer_int = 0;
+			break;
+		}
+		if (ctx->jit && jit_run(ctx))
+			continue;
 		Z80Execute(ctx);
+	}
+	/* Keep the snapshot across calls so a loop longer than one slice
+	   is still caught. Rebase its time to the start of the next call */
+	ctx->spin_goal = 0;
+	ctx->spin_tstates -= ctx->tstates;
 	return ctx->tstates;
 }
 
@@ -875,6 +988,7 @@ void Z80RESET (Z80Context* ctx)
 	ctx->defer_int = 0;
 	ctx->exec_int_vector = 0;
 	ctx->M1 = 0;
+	ctx->spin_valid = 0;
 }
 
 
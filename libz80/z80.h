@@ -40,6 +40,10 @@ typedef byte (*Z80DataIn) 	(int param, ushort address);
 typedef void (*Z80DataOut)	(int param, ushort address, byte data);
 
 
+/** Function type returning the host memory behind an address. */
+typedef byte *(*Z80MemMap)	(int param, ushort address);
+
+
 /** 
  * A Z80 register set.
  * An union is used since we want independent access to the high and low bytes of the 16-bit registers.
@@ -138,17 +142,71 @@ typedef struct
 
 	void (*trace)(unsigned int memparam);
 
+	/* Optional: return true if reading this port has no side effects
+	 * (eg a UART status register). Loops that only poll such ports and
+	 * see nothing change are skipped over to the end of the slice. */
+	int (*ioPoll)(int param, ushort address);
+	/* Optional: called before each instruction. Return true if the
+	 * code at address was recognised and emulated in one go, in which
+	 * case the hook has already updated the registers and tstates. */
+	int (*hle)(int param, ushort address);
+
+	/* Spin loop detection state */
+	byte spin_valid;
+	byte spin_dirty;
+	byte spinning;
+	byte spin_val;
+	byte spin_R;
+	byte spin_I;
+	byte spin_IFF;
+	byte spin_IM;
+	ushort spin_pc;
+	ushort spin_port;
+	unsigned spin_tstates;
+	unsigned spin_goal;
+	Z80Regs spin_R1;
+	Z80Regs spin_R2;
+
+	/* Block translator state, see z80jit.c */
+	void *jit;
+	ushort jit_pc;
+	ushort jit_len;
+	byte jit_smc;
+	/* Operands of the last flag setting operation */
+	byte jit_fa;
+	byte jit_fb;
+	ushort jit_fw;
+	ushort jit_fx;
+
 } Z80Context;
 
 
 /** Execute the next instruction. */
 void Z80Execute (Z80Context* ctx);
 
+/** True if the CPU is in HALT and nothing pending will wake it, so
+ * running it further only burns time. */
+int Z80Idle(Z80Context* ctx);
+
+/** True if the last Z80ExecuteTStates() found the CPU spinning on an
+ * ioPoll port and skipped ahead. */
+int Z80Spinning(Z80Context* ctx);
+
 /** Execute enough instructions to use at least tstates cycles.
  * Returns the number of tstates actually executed.  Note: Resets
  * ctx->tstates.*/
 unsigned Z80ExecuteTStates(Z80Context* ctx, unsigned tstates);
 
+/** Translate hot code to host code and run that from
+ * Z80ExecuteTStates(). Only x86-64 hosts are supported. map returns a
+ * pointer to the byte at address, which must stay valid to the end of
+ * its 256 byte page, or NULL if the page is not plain memory or its
+ * mapping can be changed by a memory write. Code there is always
+ * interpreted. Blocks are not used while trace or hle is set.
+ * Returns 0 on success.
+ */
+int Z80JitEnable(Z80Context* ctx, Z80MemMap map);
+
 /** Decode the next instruction to be executed.
  * dump and decode can be NULL if such information is not needed
  *
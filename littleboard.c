@@ -27,6 +27,7 @@
 #include "ttycon.h"
 #include "z80dis.h"
 #include "z80sio.h"
+#include "serlink.h"
 #include "sasi.h"
 #include "ncr5380.h"
 #include "wd17xx.h"
@@ -135,11 +136,45 @@ uint8_t z80dis_byte_quiet(uint16_t addr)
 	return mem_read(0, addr);
 }
 
+/*
+ *	INIR/OTIR on the NCR5380 pseudo DMA port. Move all but the last
+ *	byte of the burst in one go and let the CPU run the instruction for
+ *	the final byte so the flags and exit come out as normal.
+ */
+static void scsi_block_io(void)
+{
+	uint8_t buf[256];
+	uint16_t hl = cpu_z80.R1.wr.HL;
+	unsigned len, n, i;
+	uint8_t op;
+
+	if (cpu_z80.R1.br.C != 0x28 || mem_read(0, cpu_z80.M1PC) != 0xED)
+		return;
+	op = mem_read(0, cpu_z80.M1PC + 1);
+	if (op != 0xB2 && op != 0xB3)
+		return;
+	len = cpu_z80.R1.br.B ? cpu_z80.R1.br.B - 1 : 255;
+	if (op == 0xB2) {
+		n = ncr5380_dma_read(ncr, buf, len);
+		for (i = 0; i < n; i++)
+			mem_write(0, hl + i, buf[i]);
+	} else {
+		for (i = 0; i < len; i++)
+			buf[i] = mem_read(0, hl + i);
+		n = ncr5380_dma_write(ncr, buf, len);
+	}
+	cpu_z80.R1.wr.HL = hl + n;
+	cpu_z80.R1.br.B -= n;
+	cpu_z80.tstates += 21 * n;
+}
+
 static void z80_trace(unsigned unused)
 {
 	static uint32_t lastpc = -1;
 	char buf[256];
 
+	if (ncr)
+		scsi_block_io();
 	if ((trace & TRACE_CPU) == 0)
 		return;
 	nbytes = 0;
@@ -577,9 +612,17 @@ static void exit_cleanup(void)
 	tcsetattr(0, TCSADRAIN, &saved_term);
 }
 
+/* Emulated time for pacing a serial link */
+static uint64_t cycles_run;
+
+static uint64_t link_clock(void)
+{
+	return cycles_run;
+}
+
 static void usage(void)
 {
-	fprintf(stderr, "littleboard: [-f] [i idport] [-s path] [-r path] [-d debug] [-A|B|C|D disk]\n");
+	fprintf(stderr, "littleboard: [-f] [i idport] [-s path] [-r path] [-d debug] [-L link] [-A|B|C|D disk]\n");
 	exit(EXIT_FAILURE);
 }
 
@@ -624,8 +667,9 @@ int main(int argc, char *argv[])
 	char *rompath = "ampro.rom";
 	char *diskpath = NULL;
 	static char *fdpath[4] = { NULL, NULL, NULL, NULL };
+	struct serial_device *link = &console_wo;
 
-	while ((opt = getopt(argc, argv, "d:fi:r:s:A:B:C:D:")) != -1) {
+	while ((opt = getopt(argc, argv, "d:fi:L:r:s:A:B:C:D:")) != -1) {
 		switch (opt) {
 		case 'r':
 			rompath = optarg;
@@ -648,6 +692,12 @@ int main(int argc, char *argv[])
 		case 'i':
 			idport = atoi(optarg);
 			break;
+		case 'L':
+			link = serlink_open(optarg);
+			if (link == NULL)
+				exit(1);
+			serlink_set_clock(link_clock, 4000000);
+			break;
 		default:
 			usage();
 		}
@@ -678,7 +728,7 @@ int main(int argc, char *argv[])
 	sio_trace(sio, 0, !!(trace & TRACE_SIO));
 	sio_trace(sio, 1, !!(trace & TRACE_SIO));
 	sio_attach(sio, 0, &console);
-	sio_attach(sio, 1, &console_wo);
+	sio_attach(sio, 1, link);
 	sio_reset(sio);
 	ctc_init();
 
@@ -745,6 +795,7 @@ int main(int argc, char *argv[])
 			/* 200000 T states */
 			for (i = 0; i < 500; i++) {
 				Z80ExecuteTStates(&cpu_z80, 400);
+				cycles_run += 400;
 				sio_timer(sio);
 				ctc_tick(400);
 				for (n = 0; n < 200;n++) {
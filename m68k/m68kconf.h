@@ -31,6 +31,8 @@ extern void cpu_instr_callback(void);
 
 
 /* Configuration switches.
+ * Building with M68K_FAST defined (lib68k-fast.a) turns off trace, prefetch,
+ * address error emulation and the per instruction hook for speed.
  * Use OPT_SPECIFY_HANDLER for configuration options that allow callbacks.
  * OPT_SPECIFY_HANDLER causes the core to link directly to the function
  * or macro you specify, rather than using callback functions whose pointer
@@ -97,7 +99,11 @@ extern void cpu_instr_callback(void);
 
 /* If ON, the CPU will monitor the trace flags and take trace exceptions
  */
+#ifdef M68K_FAST
+#define M68K_EMULATE_TRACE          OPT_OFF
+#else
 #define M68K_EMULATE_TRACE          OPT_ON
+#endif
 
 
 /* If ON, CPU will call the output reset callback when it encounters a reset
@@ -128,19 +134,31 @@ extern void cpu_instr_callback(void);
 /* If ON, CPU will call the instruction hook callback before every
  * instruction.
  */
+#ifdef M68K_FAST
+#define M68K_INSTRUCTION_HOOK       OPT_OFF
+#else
 #define M68K_INSTRUCTION_HOOK       OPT_SPECIFY_HANDLER
+#endif
 #define M68K_INSTRUCTION_CALLBACK() cpu_instr_callback()
 
 
 /* If ON, the CPU will emulate the 4-byte prefetch queue of a real 68000 */
+#ifdef M68K_FAST
+#define M68K_EMULATE_PREFETCH       OPT_OFF
+#else
 #define M68K_EMULATE_PREFETCH       OPT_ON
+#endif
 
 
 /* If ON, the CPU will generate address error exceptions if it tries to
  * access a word or longword at an odd address.
  * NOTE: This is only emulated properly for 68000 mode.
  */
+#ifdef M68K_FAST
+#define M68K_EMULATE_ADDRESS_ERROR  OPT_OFF
+#else
 #define M68K_EMULATE_ADDRESS_ERROR  OPT_ON
+#endif
 
 
 /* Turn ON to enable logging of illegal instruction calls.
@@ -36,8 +36,10 @@
 #include "rtc_bitbang.h"
 #include "sdcard.h"
 #include "z80dis.h"
+#include "guestmem.h"
 
-static uint8_t ramrom[1024 * 1024];	/* Low 512K is ROM */
+#define RAMROM_SIZE	(1024 * 1024)
+static uint8_t *ramrom;		/* Low 512K is ROM */
 
 static uint8_t fast = 0;
 static uint8_t int_recalc = 0;
@@ -337,7 +339,7 @@ static void exit_cleanup(void)
 
 static void usage(void)
 {
-	fprintf(stderr, "markiv: [-f] [-i idepath] [-p proppath] [-r rompath] [-S sdpath] [-d debug]\n");
+	fprintf(stderr, "markiv: [-f] [-i idepath] [-p proppath] [-r rompath] [-S sdpath] [-d debug] [-M fill|merge]\n");
 	exit(EXIT_FAILURE);
 }
 
@@ -350,12 +352,9 @@ int main(int argc, char *argv[])
 	char *sdpath = NULL;
 	char *idepath = NULL;
 	char *proppath = NULL;
+	int len;
 
-	uint8_t *p = ramrom;
-	while (p < ramrom + sizeof(ramrom))
-		*p++= rand();
-
-	while ((opt = getopt(argc, argv, "r:S:i:d:fp:")) != -1) {
+	while ((opt = getopt(argc, argv, "r:S:i:d:fM:p:")) != -1) {
 		switch (opt) {
 		case 'r':
 			rompath = optarg;
@@ -376,6 +375,10 @@ int main(int argc, char *argv[])
 		case 'p':
 			proppath = optarg;
 			break;
+		case 'M':
+			if (guestmem_option(optarg))
+				usage();
+			break;
 		default:
 			usage();
 		}
@@ -383,16 +386,16 @@ int main(int argc, char *argv[])
 	if (optind < argc)
 		usage();
 
-	fd = open(rompath, O_RDONLY);
-	if (fd == -1) {
-		perror(rompath);
+	ramrom = guestmem_alloc(RAMROM_SIZE);
+	guestmem_fill(ramrom, RAMROM_SIZE, -1);
+
+	len = guestmem_load(ramrom, rompath, 0, 524288);
+	if (len == -1)
 		exit(EXIT_FAILURE);
-	}
-	if (read(fd, ramrom, 524288) != 524288) {
+	if (len != 524288) {
 		fprintf(stderr, "markiv: ROM image should be 512K.\n");
 		exit(EXIT_FAILURE);
 	}
-	close(fd);
 
 	if (ide) {
 		ide0 = ide_allocate("cf");
@@ -31,6 +31,7 @@
 #include "z80dis.h"
 #include "sasi.h"
 #include "wd17xx.h"
+#include "wallclock.h"
 
 #include <SDL2/SDL.h>
 #include "keymatrix.h"
@@ -622,8 +623,7 @@ static void sio2_write(uint16_t addr, uint8_t val)
 
 static uint8_t rtc_read(void)
 {
-	time_t t = time(NULL);
-	struct tm *tm = localtime(&t);
+	struct tm *tm = wallclock_localtime();
 	if ((pio_b & 0x20) == 0)
 		return 0xFF;
 	switch (pio_b & 0x0F) {
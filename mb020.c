@@ -38,6 +38,7 @@
 #include "16x50.h"
 #include "ide.h"
 #include "rtc_bitbang.h"
+#include "guestmem.h"
 
 /* CF adapter */
 static struct ide_controller *ide;
@@ -50,9 +51,10 @@ static struct rtc *rtc;
 static unsigned flipped = 0;
 
 /* 16MB RAM */
-static uint8_t ram[0x1000000];
+#define RAM_SIZE	0x1000000
+static uint8_t *ram;
 /* 8K ROM */
-static uint8_t rom[0x2000];
+static uint8_t *rom;
 static int trace = 0;
 
 static unsigned irq_pending;
@@ -149,14 +151,14 @@ unsigned int do_cpu_read_byte(unsigned int address, unsigned int trap)
 		if (address < 0x04000000)
 			return rom[address & 0x1FFF];
 		if (address < 0x0C000000)
-			return ram[address & (sizeof(ram) - 1)];
+			return ram[address & (RAM_SIZE - 1)];
 	} else {
 		if (address < 0x04000000)
-			return ram[address & (sizeof(ram) -1)];
+			return ram[address & (RAM_SIZE - 1)];
 		if (address < 0x08000000)
 			return rom[address & 0x1FFF];
 		if (address < 0x0C000000)
-			return ram[address & (sizeof(ram) - 1)];
+			return ram[address & (RAM_SIZE - 1)];
 	}
 	if (address == 0xFFFF8000)
 		flipped = 1;
@@ -224,12 +226,12 @@ void cpu_write_byte(unsigned int address, unsigned int value)
 			return;
 		}
 		if (address < 0x0C000000) {
-			ram[address & (sizeof(ram) - 1)] = value;
+			ram[address & (RAM_SIZE - 1)] = value;
 			return;
 		}
 	} else {
 		if (address < 0x04000000) {
-			ram[address & (sizeof(ram) - 1)] = value;
+			ram[address & (RAM_SIZE - 1)] = value;
 			return;
 		}
 		if (address < 0x08000000) {
@@ -237,7 +239,7 @@ void cpu_write_byte(unsigned int address, unsigned int value)
 			return;
 		}
 		if (address < 0x0C000000) {
-			ram[address & (sizeof(ram) - 1)] = value;
+			ram[address & (RAM_SIZE - 1)] = value;
 			return;
 		}
 	}
@@ -338,7 +340,7 @@ void cpu_set_fc(int fc)
 
 void usage(void)
 {
-	fprintf(stderr, "mb020: [-1] [-r rompath][-i idepath][-d debug].\n");
+	fprintf(stderr, "mb020: [-1] [-r rompath][-i idepath][-d debug][-M fill|merge].\n");
 	exit(1);
 }
 
@@ -353,8 +355,9 @@ int main(int argc, char *argv[])
 	const char *romname = "mb020mon.rom";
 	const char *diskname = "mb020.ide";
 	unsigned input = IN_ACIA;
+	size_t len;
 
-	while((opt = getopt(argc, argv, "2efd:i:r:1")) != -1) {
+	while((opt = getopt(argc, argv, "2efd:i:M:r:1")) != -1) {
 		switch(opt) {
 		case 'f':
 			fast = 1;
@@ -371,6 +374,10 @@ int main(int argc, char *argv[])
 		case '1':
 			input = IN_16X50;
 			break;
+		case 'M':
+			if (guestmem_option(optarg))
+				usage();
+			break;
 		default:
 			usage();
 		}
@@ -396,18 +403,16 @@ int main(int argc, char *argv[])
 	if (optind < argc)
 		usage();
 
-	memset(ram, 0xA7, sizeof(ram));
+	ram = guestmem_alloc(RAM_SIZE);
+	guestmem_fill(ram, RAM_SIZE, 0xA7);
 
-	fd = open(romname, O_RDONLY);
-	if (fd == -1) {
-		perror(romname);
+	rom = guestmem_rom(romname, 0x2000, &len);
+	if (rom == NULL)
 		exit(1);
-	}
-	if (read(fd, rom, 0x2000) < 0x2000) {
+	if (len < 0x2000) {
 		fprintf(stderr, "%s: too short.\n", romname);
 		exit(1);
 	}
-	close(fd);
 
 	fd = open(diskname, O_RDWR);
 	if (fd == -1) {
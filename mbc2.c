@@ -24,6 +24,7 @@
 #include <sys/select.h>
 #include "libz80/z80.h"
 #include "z80dis.h"
+#include "wallclock.h"
 
 static uint8_t ram[131072];
 
@@ -192,11 +193,7 @@ static uint8_t ios_rx_char(void)
 
 static void ios_rtc_load(void)
 {
-	struct tm *tm;
-	time_t t;
-
-	time(&t);
-	tm = gmtime(&t);
+	struct tm *tm = wallclock_gmtime();
 
 	if (tm == NULL) {
 		fprintf(stderr, "mbc2: unable to get time.\n");
@@ -77,6 +77,10 @@ static uint32_t mem_write_8(uint32_t addr, uint32_t val, uint32_t *trap, uint32_
                                 val = io_in(addr)
 #define MINIRV32_OTHERCSR_WRITE(csr, value) \
                                 csr_out(csr, value)
+/* Cache decoded instructions. The instruction and data bus windows
+   are the same RAM so fold them together for invalidation */
+#define MINIRV32_DECODE_CACHE
+#define MINIRV32_CODE_PAGE(ofs)	(((ofs) & 0x3FFFF) >> 8)
 
 static void disassemble(uint32_t ir, uint32_t addr);
 
@@ -39,6 +39,8 @@
 #include "rtc_bitbang.h"
 #include "w5100.h"
 #include "sdcard.h"
+#include "serialdevice.h"
+#include "serlink.h"
 
 static uint8_t ram[512 * 1024];		/* Covers the banked card */
 static uint8_t rom[32768];		/* System EPROM */
@@ -153,11 +155,25 @@ void m6800_sci_change(struct m6800 *cpu)
 	fprintf(stderr, "[UART  %d baud]\n", baseclock);
 }
 
+/* The SCI goes to the console unless it is cabled to another emulator */
+static struct serial_device *sci_link;
+static uint64_t cycles_run;
+
+static uint64_t link_clock(void)
+{
+	return cycles_run;
+}
+
 void m6800_tx_byte(struct m6800 *cpu, uint8_t byte)
 {
-	write(1, &byte, 1);
+	if (sci_link)
+		sci_link->put(sci_link, byte);
+	else
+		write(1, &byte, 1);
 }
 
+static void remap(void);
+
 static void flatarecalc(struct m6800 *cpu)
 {
 	uint8_t bits = cpu->io.padr;
@@ -176,6 +192,7 @@ static void flatarecalc(struct m6800 *cpu)
 	if (bits & 0x10)
 		flatahigh += 0x10000;
 	romen = !!(bits & 0x08);
+	remap();
 }
 
 /* I/O ports */
@@ -272,6 +289,28 @@ uint8_t *m6800_map(uint16_t addr, int wr)
 	return ram + flatahigh + addr;
 }
 
+/* Let the CPU at the memory behind each page directly. The VIA, ROM and
+   latch writes and memory tracing still come through us. Redone whenever
+   the banking changes */
+static void remap(void)
+{
+	unsigned int page;
+	uint16_t addr;
+	uint8_t *wp;
+
+	for (page = 0; page < 256; page++) {
+		addr = page << 8;
+		if ((trace & TRACE_MEM) || (is_m8 && addr >= 0xF400 && addr < 0xF800)) {
+			m6800_map_page(&cpu, page, NULL, NULL);
+			continue;
+		}
+		wp = m6800_map(addr, 1);
+		if (wp == &mlatch)
+			wp = NULL;
+		m6800_map_page(&cpu, page, m6800_map(addr, 0), wp);
+	}
+}
+
 uint8_t m6800_debug_read(struct m6800 *cpu, uint16_t addr)
 {
 	/* Avoid debugger read side effects */
@@ -309,6 +348,8 @@ void m6800_write(struct m6800 *cpu, uint16_t addr, uint8_t val)
 		fprintf(stderr, "%04X: write to ROM.\n", addr);
 	else
 		*rp = val;
+	if (rp == &mlatch)
+		remap();
 }
 
 static void poll_irq_event(void)
@@ -331,7 +372,7 @@ static void exit_cleanup(void)
 
 static void usage(void)
 {
-	fprintf(stderr, "mini11: [-f] [-8] [-r rom] [-S sdcard] [-m monitor] [-w] [-d debug]\n");
+	fprintf(stderr, "mini11: [-f] [-8] [-r rom] [-S sdcard] [-m monitor] [-w] [-d debug] [-L link]\n");
 	exit(EXIT_FAILURE);
 }
 
@@ -345,7 +386,7 @@ int main(int argc, char *argv[])
 	char *sdpath = NULL;
 	unsigned int cycles = 0;
 
-	while ((opt = getopt(argc, argv, "r:d:fS:m:8")) != -1) {
+	while ((opt = getopt(argc, argv, "r:d:fL:S:m:8")) != -1) {
 		switch (opt) {
 		case 'r':
 			rompath = optarg;
@@ -353,6 +394,12 @@ int main(int argc, char *argv[])
 		case 'd':
 			trace = atoi(optarg);
 			break;
+		case 'L':
+			sci_link = serlink_open(optarg);
+			if (sci_link == NULL)
+				exit(1);
+			serlink_set_clock(link_clock, 8000000 / 4);
+			break;
 		case 'f':
 			fast = 1;
 			break;
@@ -444,6 +491,7 @@ int main(int argc, char *argv[])
 		m68hc11a_reset(&cpu, 8, 0x03, monitor, eerom);
 	else	/* 68HC11A0 */
 		m68hc11a_reset(&cpu, 0, 0, NULL, NULL);
+	remap();
 
 	if (trace & TRACE_CPU)
 		cpu.debug = 1;
@@ -459,14 +507,24 @@ int main(int argc, char *argv[])
 
 		for (j = 0; j < 10; j++) {
 			for (i = 0; i < 10; i++) {
-				while(cycles < clockrate)
-					cycles += m68hc11_execute(&cpu);
+				if (cycles < clockrate) {
+					unsigned int n = m68hc11_run(&cpu, clockrate - cycles);
+					cycles += n;
+					cycles_run += n;
+				}
 				cycles -= clockrate;
 			}
 			/* Drive the internal serial */
-			i = check_chario();
-			if (i & 1)
-				m68hc11_rx_byte(&cpu, next_char());
+			if (sci_link) {
+				/* Leave bytes on the link until there is room */
+				i = sci_link->ready(sci_link);
+				if ((i & 1) && !(cpu.io.scsr & SCSR_RDRF))
+					m68hc11_rx_byte(&cpu, sci_link->get(sci_link));
+			} else {
+				i = check_chario();
+				if (i & 1)
+					m68hc11_rx_byte(&cpu, next_char());
+			}
 			if (i & 2)
 				m68hc11_tx_done(&cpu);
 		}
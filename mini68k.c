@@ -56,6 +56,8 @@
 #include "rtc_bitbang.h"
 #include "sdcard.h"
 #include "lib765/include/765.h"
+#include "tracebuf.h"
+#include "guestmem.h"
 
 
 /* IDE controller */
@@ -78,9 +80,10 @@ static uint8_t m4_bank[64];
 static uint8_t m4_bankp;
 
 /* 2MB RAM */
-static uint8_t ram[0x200000];
+#define RAM_SIZE	0x200000
+static uint8_t *ram;
 /* 128K ROM */
-static uint8_t rom[0x20000];
+static uint8_t *rom;
 /* Force ROM into low space for the first 8 reads */
 static uint8_t u27;
 /* Config register on the MFPIC */
@@ -89,6 +92,8 @@ static uint8_t mfpic_cfg;
 static uint8_t mem4[4][0x100000];
 
 static int trace = 0;
+static struct tracebuf *tracebuf;
+static uint64_t cycles_total;		/* For the trace buffer */
 
 #define TRACE_MEM	1
 #define TRACE_CPU	2
@@ -898,6 +903,57 @@ void cpu_write_pd(unsigned int address, unsigned int value)
 	cpu_write_word(address, value >> 16);
 }
 
+static void cpu_tracebuf(unsigned int pc, uint64_t cycle)
+{
+	struct tracebuf_rec *r = tracebuf_next(tracebuf, pc);
+	unsigned int i;
+
+	r->cycle = cycle;
+	r->bank = m4_bankp;
+	r->reg[0] = m68k_get_reg(NULL, M68K_REG_D0);
+	r->reg[1] = m68k_get_reg(NULL, M68K_REG_D1);
+	r->reg[2] = m68k_get_reg(NULL, M68K_REG_D2);
+	r->reg[3] = m68k_get_reg(NULL, M68K_REG_A0);
+	r->reg[4] = m68k_get_reg(NULL, M68K_REG_A1);
+	r->reg[5] = m68k_get_reg(NULL, M68K_REG_A6);
+	r->reg[6] = m68k_get_reg(NULL, M68K_REG_A7);
+	r->reg[7] = m68k_get_reg(NULL, M68K_REG_SR);
+	for (i = 0; i < 14; i += 2) {
+		unsigned int w = cpu_read_word_dasm(pc + i);
+		r->op[i] = w >> 8;
+		r->op[i + 1] = w;
+	}
+	r->oplen = 14;
+	r->flags = 0;
+}
+
+/* The -fast library has no instruction hook, so the trace buffer is fed
+   by stepping the CPU an instruction at a time instead. A stopped CPU
+   uses a cycle per step and runs nothing, so skip the PC it sits on
+   until something moves it */
+static int trace_execute(int cycles)
+{
+	static unsigned int stop_pc = ~0U;
+	unsigned int pc;
+	int n = 0;
+	int c;
+
+	while (n < cycles) {
+		pc = m68k_get_reg(NULL, M68K_REG_PC);
+		if (pc != stop_pc)
+			cpu_tracebuf(pc, cycles_total + n);
+		c = m68k_execute(1);
+		if (c == 1)
+			stop_pc = pc;
+		else if (m68k_get_reg(NULL, M68K_REG_IR) == 0x4E72)
+			stop_pc = pc + 4;	/* STOP */
+		else
+			stop_pc = ~0U;
+		n += c;
+	}
+	return n;
+}
+
 void cpu_instr_callback(void)
 {
 	if (trace & TRACE_CPU) {
@@ -971,7 +1027,7 @@ void cpu_set_fc(int fc)
 
 void usage(void)
 {
-	fprintf(stderr, "mini68k: [-0][-1][-2][-e][-m memsize][-r rompath][-i idepath][-I idepath] [-d debug].\n");
+	fprintf(stderr, "mini68k: [-0][-1][-2][-e][-m memsize][-M fill|merge][-r rompath][-i idepath][-I idepath] [-d debug] [-t tracefile] [-x traceaddr].\n");
 	exit(1);
 }
 
@@ -987,8 +1043,11 @@ int main(int argc, char *argv[])
 	const char *patha = NULL;
 	const char *pathb = NULL;
 	const char *sdname = NULL;
+	const char *tracepath = NULL;
+	uint32_t tracetrig = TRACEBUF_NOTRIGGER;
+	size_t len;
 
-	while((opt = getopt(argc, argv, "012d:efi:m:r:s:A:B:I:")) != -1) {
+	while((opt = getopt(argc, argv, "012d:efi:m:M:r:s:t:x:A:B:I:")) != -1) {
 		switch(opt) {
 		case '0':
 			cputype = M68K_CPU_TYPE_68000;
@@ -1014,12 +1073,22 @@ int main(int argc, char *argv[])
 		case 'm':
 			memsize = atoi(optarg);
 			break;
+		case 'M':
+			if (guestmem_option(optarg))
+				usage();
+			break;
 		case 'r':
 			romname = optarg;
 			break;
 		case 's':
 			sdname = optarg;
 			break;
+		case 't':
+			tracepath = optarg;
+			break;
+		case 'x':
+			tracetrig = strtoul(optarg, NULL, 16);
+			break;
 		case 'A':
 			patha = optarg;
 			break;
@@ -1054,29 +1123,32 @@ int main(int argc, char *argv[])
 	if (optind < argc)
 		usage();
 
+	if (tracepath) {
+		tracebuf = tracebuf_create(tracepath, TRACEBUF_68000, 262144);
+		tracebuf_trigger(tracebuf, tracetrig);
+	}
+
 	memsize <<= 10;	/* In KiB for friendlyness */
 	if (memsize & 0x7FFFF) {
 		fprintf(stderr, "%s: RAM must be a multiple of 512K blocks.\n",
 			argv[0]);
 		exit(1);
 	}
-	if (memsize > sizeof(ram)) {
+	if (memsize > RAM_SIZE) {
 		fprintf(stderr, "%s: RAM size must be no more than %ldKib\n",
-			argv[0], (long)sizeof(ram) >> 10);
+			argv[0], (long)RAM_SIZE >> 10);
 		exit(1);
 	}
-	memset(ram, 0xA7, sizeof(ram));
+	ram = guestmem_alloc(RAM_SIZE);
+	guestmem_fill(ram, RAM_SIZE, 0xA7);
 
-	fd = open(romname, O_RDONLY);
-	if (fd == -1) {
-		perror(romname);
+	rom = guestmem_rom(romname, 0x20000, &len);
+	if (rom == NULL)
 		exit(1);
-	}
-	if (read(fd, rom, 0x20000) != 0x20000) {
+	if (len != 0x20000) {
 		fprintf(stderr, "%s: too short.\n", romname);
 		exit(1);
 	}
-	close(fd);
 
 	ppide = ppide_create("hd0");
 	ppide_reset(ppide);
@@ -1170,7 +1242,10 @@ int main(int argc, char *argv[])
 
 	while (1) {
 		/* Approximate a 68008 */
-		m68k_execute(400);
+		if (tracebuf)
+			cycles_total += trace_execute(400);
+		else
+			cycles_total += m68k_execute(400);
 		uart16x50_event(uart);
 		recalc_interrupts();
 		/* The CPU runs at 8MHz but the NS202 is run off the serial
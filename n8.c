@@ -64,9 +64,11 @@
 #include "tms9918a.h"
 #include "tms9918a_render.h"
 #include "z80dis.h"
+#include "guestmem.h"
 
-static uint8_t ram[1024 * 1024];
-static uint8_t rom[512 * 1024];
+#define RAM_SIZE	(1024 * 1024)
+static uint8_t *ram;
+static uint8_t *rom;
 
 static uint8_t fast = 0;
 static uint8_t int_recalc = 0;
@@ -543,7 +545,7 @@ static void exit_cleanup(void)
 
 static void usage(void)
 {
-	fprintf(stderr, "n8: [-f] [-i idepath] [-S sdpath] [-F fdpath] [-R] [-r rompath] [-d debug]\n");
+	fprintf(stderr, "n8: [-f] [-i idepath] [-S sdpath] [-F fdpath] [-R] [-r rompath] [-d debug] [-M fill|merge]\n");
 	exit(EXIT_FAILURE);
 }
 
@@ -556,12 +558,9 @@ int main(int argc, char *argv[])
 	char *sdpath = NULL;
 	char *idepath = NULL;
 	char *patha = NULL, *pathb = NULL;
+	size_t len;
 
-	uint8_t *p = ram;
-	while (p < ram + sizeof(ram))
-		*p++= rand();
-
-	while ((opt = getopt(argc, argv, "r:S:i:d:fF:")) != -1) {
+	while ((opt = getopt(argc, argv, "r:S:i:d:fF:M:")) != -1) {
 		switch (opt) {
 		case 'r':
 			rompath = optarg;
@@ -590,6 +589,10 @@ int main(int argc, char *argv[])
 			else
 				patha = optarg;
 			break;
+		case 'M':
+			if (guestmem_option(optarg))
+				usage();
+			break;
 		default:
 			usage();
 		}
@@ -599,16 +602,16 @@ int main(int argc, char *argv[])
 
 	rtc = rtc_create();
 
-	fd = open(rompath, O_RDONLY);
-	if (fd == -1) {
-		perror(rompath);
+	ram = guestmem_alloc(RAM_SIZE);
+	guestmem_fill(ram, RAM_SIZE, -1);
+
+	rom = guestmem_rom(rompath, 524288, &len);
+	if (rom == NULL)
 		exit(EXIT_FAILURE);
-	}
-	if (read(fd, rom, 524288) != 524288) {
+	if (len != 524288) {
 		fprintf(stderr, "n8: ROM image should be 512K.\n");
 		exit(EXIT_FAILURE);
 	}
-	close(fd);
 
 	ppide = ppide_create("ppide");
 	if (idepath) {
@@ -48,6 +48,8 @@
 
 #include "libz80/z80.h"
 #include "z80dis.h"
+#include "inputlog.h"
+#include "wallclock.h"
 
 #define CWIDTH 8
 #define CHEIGHT 15
@@ -90,6 +92,7 @@ static uint8_t map_gm802 = 0x11;
 #define GM849A		5
 
 static Z80Context cpu_z80;
+static uint64_t tstates_total;		/* For the input log */
 static uint8_t fast;
 volatile int emulator_done;
 
@@ -269,19 +272,26 @@ unsigned int check_chario(void)
 		r |= 1;
 	if (FD_ISSET(1, &o))
 		r |= 2;
-	return r;
+	return inputlog_chario(r);
 }
 
 unsigned int next_char(void)
 {
 	char c;
+	if (inputlog_mode == INPUTLOG_REPLAY)
+		return inputlog_char(0);
 	if (read(0, &c, 1) != 1) {
 		printf("(tty read without ready byte)\n");
 		return 0xFF;
 	}
 	if (c == 0x0A)
 		c = '\r';
-	return c;
+	return inputlog_char(c);
+}
+
+static uint64_t input_clock(void)
+{
+	return tstates_total + cpu_z80.tstates;
 }
 
 /*
@@ -846,6 +856,8 @@ static void keytranslate(SDL_Event *ev)
 static void ui_event(void)
 {
 	SDL_Event ev;
+	struct inputlog_key k;
+
 	while (SDL_PollEvent(&ev)) {
 		switch(ev.type) {
 		case SDL_QUIT:
@@ -853,11 +865,28 @@ static void ui_event(void)
 			break;
 		case SDL_KEYDOWN:
 		case SDL_KEYUP:
+			/* Live keys are ignored when replaying a log */
+			if (inputlog_mode == INPUTLOG_REPLAY)
+				break;
+			k.up = ev.type == SDL_KEYUP;
+			k.sym = ev.key.keysym.sym;
+			k.scancode = ev.key.keysym.scancode;
+			k.mod = ev.key.keysym.mod;
+			inputlog_key_record(&k);
 			keytranslate(&ev);
 			keymatrix_SDL2event(matrix, &ev);
 			break;
 		}
 	}
+	while (inputlog_key_replay(&k)) {
+		memset(&ev, 0, sizeof(ev));
+		ev.type = k.up ? SDL_KEYUP : SDL_KEYDOWN;
+		ev.key.keysym.sym = k.sym;
+		ev.key.keysym.scancode = k.scancode;
+		ev.key.keysym.mod = k.mod;
+		keytranslate(&ev);
+		keymatrix_SDL2event(matrix, &ev);
+	}
 }
 
 static struct termios saved_term, term;
@@ -993,7 +1022,7 @@ static int romload(const char *path, uint8_t *mem, unsigned int base, unsigned i
 
 static void usage(void)
 {
-	fprintf(stderr, "nascom: [-f] [-1] [-2] [-3] [-8] [-A|B|C|D disk] [-b basic] [-c] [-e eprom] [-i idepath] [-g] [-r rom] [-m] [-R] [-d debug]\n");
+	fprintf(stderr, "nascom: [-f] [-1] [-2] [-3] [-8] [-A|B|C|D disk] [-b basic] [-c] [-e eprom] [-i idepath] [-g] [-r rom] [-m] [-R] [-d debug] [-j recordlog] [-J replaylog] [-W host|emu|seconds]\n");
 	exit(EXIT_FAILURE);
 }
 
@@ -1013,7 +1042,7 @@ int main(int argc, char *argv[])
 	unsigned int maxmem = 0;
 	static unsigned int need_fdc = 0;
 
-	while ((opt = getopt(argc, argv, "1238b:cd:e:fgi:mr:A:B:C:D:RMS:")) != -1) {
+	while ((opt = getopt(argc, argv, "1238b:cd:e:fgi:j:J:mr:A:B:C:D:RMS:W:")) != -1) {
 		switch (opt) {
 		case '1':
 			nascom_ver = 1;
@@ -1079,6 +1108,16 @@ int main(int argc, char *argv[])
 		case 'S':
 			sasi_path = optarg;
 			break;
+		case 'j':
+			inputlog_init(optarg, INPUTLOG_RECORD, input_clock);
+			break;
+		case 'J':
+			inputlog_init(optarg, INPUTLOG_REPLAY, input_clock);
+			break;
+		case 'W':
+			if (wallclock_option(optarg))
+				usage();
+			break;
 		default:
 			usage();
 		}
@@ -1144,6 +1183,8 @@ int main(int argc, char *argv[])
 	/* TODO: Strictly speaking it's a switch */
 	if (nascom_ver == 2)
 		tstates = 400;
+	/* We run 100 lots of tstates every 10ms */
+	wallclock_set_clock(input_clock, tstates * 10000);
 
 	/* GM802 banked memory wherever there is no existing base memory */
 	if (has_gm802)
@@ -1292,7 +1333,8 @@ int main(int argc, char *argv[])
 		int i;
 		/* Each cycle we do 20000 or 40000 T states */
 		for (i = 0; i < 100; i++) {
-			Z80ExecuteTStates(&cpu_z80, tstates);
+			tstates_total += Z80ExecuteTStates(&cpu_z80, tstates);
+			cpu_z80.tstates = 0;
 		}
 
 		/* We want to run UI events before we rasterize */
@@ -36,6 +36,7 @@
 
 #include "libz80/z80.h"
 #include "z80dis.h"
+#include "wallclock.h"
 
 static SDL_Window *window;
 static SDL_Renderer *render;
@@ -351,13 +352,11 @@ static uint8_t tc8521_read(uint8_t addr)
 
 static void tc8521_write(uint8_t addr, uint8_t val)
 {
-	time_t t;
 	addr &= 0x0F;
 	switch(addr) {
 	case 0x0D:/* Page : bit 3 is timer enable 2 alarm enable - we ignore */
 		rtc_page = val & 3;
-		time(&t);
-		rtc_tm = localtime(&t);
+		rtc_tm = wallclock_localtime();
 		break;
 	case 0x0E:		/* Test */
 	case 0x0F:		/* Reset */
@@ -63,6 +63,7 @@
 #include "libz80/z80.h"
 #include "lib765/include/765.h"
 #include "z80dis.h"
+#include "wallclock.h"
 
 static SDL_Window *window;
 static SDL_Renderer *render;
@@ -302,8 +303,7 @@ static uint8_t rtc_ram[64];
 
 static uint8_t mc146818_read(uint8_t addr)
 {
-	time_t t = time(NULL);
-	struct tm *rtc_tm = localtime(&t);
+	struct tm *rtc_tm = wallclock_localtime();
 
 	/* Should never occur but don't crash if we are in nonsenseville */	
 	if (rtc_tm == NULL)
@@ -284,6 +284,53 @@ uint8_t ncr5380_write(struct ncr5380 *ncr, unsigned reg, uint8_t val)
 	return 0xFF;
 }
 
+/*
+ *	Pseudo DMA block hooks. Board code that can see a whole burst to
+ *	or from the PDMA port (eg a block I/O instruction) can move it in
+ *	one call instead of a register access per byte. Each returns the
+ *	number of bytes moved, which stops short when the DMA ends or the
+ *	bus phase changes just as it would byte by byte.
+ */
+unsigned ncr5380_dma_read(struct ncr5380 *ncr, uint8_t *buf, unsigned len)
+{
+	unsigned n = 0;
+	unsigned r;
+
+	while (ncr->dma_rx && n < len) {
+		r = sasi_read_block_data(ncr->bus, buf + n, len - n);
+		if (r == 0) {
+			ncr_phase_check(ncr);
+			break;
+		}
+		n += r;
+		ncr5380_activity(ncr);
+		ncr_phase_check(ncr);
+	}
+	if (ncr->trace)
+		fprintf(stderr, "ncr5380: dma read %u of %u\n", n, len);
+	return n;
+}
+
+unsigned ncr5380_dma_write(struct ncr5380 *ncr, const uint8_t *buf, unsigned len)
+{
+	unsigned n = 0;
+	unsigned r;
+
+	while (ncr->dma_tx && n < len) {
+		ncr_phase_check(ncr);
+		if (!ncr->dma_tx)
+			break;
+		r = sasi_write_block_data(ncr->bus, buf + n, len - n);
+		if (r == 0)
+			break;
+		n += r;
+		ncr5380_activity(ncr);
+	}
+	if (ncr->trace)
+		fprintf(stderr, "ncr5380: dma write %u of %u\n", n, len);
+	return n;
+}
+
 struct ncr5380 *ncr5380_create(struct sasi_bus *sasi)
 {
 	struct ncr5380 *ncr = malloc(sizeof(*ncr));
@@ -3,6 +3,8 @@ struct ncr5380;
 uint8_t ncr5380_read(struct ncr5380 *ncr, unsigned reg);
 uint8_t ncr5380_write(struct ncr5380 *ncr, unsigned reg, uint8_t val);
 void ncr5380_activity(struct ncr5380 *ncr);
+unsigned ncr5380_dma_read(struct ncr5380 *ncr, uint8_t *buf, unsigned len);
+unsigned ncr5380_dma_write(struct ncr5380 *ncr, const uint8_t *buf, unsigned len);
 struct ncr5380 *ncr5380_create(struct sasi_bus *sasi);
 void ncr5380_free(struct ncr5380 *ncr);
 void ncr5380_trace(struct ncr5380 *ncr, unsigned trace);
@@ -65,8 +65,16 @@
 #include "z80dis.h"
 #include "sasi.h"
 #include "ncr5380.h"
+#include "tracebuf.h"
+#include "inputlog.h"
+#include "serlink.h"
+#include "guestmem.h"
+#include "watch.h"
+#include "wallclock.h"
+#include "vdisk.h"
 
-static uint8_t ramrom[2048 * 1024];	/* Covers the banked card and ZRC */
+#define RAMROM_SIZE	(2048 * 1024)
+static uint8_t *ramrom;			/* Covers the banked card and ZRC */
 
 static unsigned int bankreg[4];
 static uint8_t bankenable;
@@ -134,6 +142,7 @@ static struct tft_renderer *tftrend;
 struct uart16x50 *uart;
 static struct sasi_bus *sasi;
 static struct ncr5380 *ncr;
+static struct vdisk *vdisk;
 
 static uint8_t ef9345_vram[16384];
 static uint8_t ef9345_rom[8192];
@@ -143,6 +152,11 @@ struct ps2 *ps2;
 struct zxkey *zxkey;
 
 static uint16_t tstate_steps = 365;	/* RC2014 speed */
+#define IDLE_SLICES	10		/* Slices run as one when halted */
+static uint64_t tstates_total;		/* For the trace buffer and input log */
+static struct tracebuf *tracebuf;
+static int watching;			/* Memory watchpoints are armed */
+static int jit;				/* Translate hot code to host code */
 
 /* IRQ source that is live in IM2 */
 static uint8_t live_irq;
@@ -157,6 +171,7 @@ static uint8_t live_nonim2;
 #define IRQM_VDP	1
 #define IRQM_ACIA	2
 #define IRQM_16X50	4
+#define IRQM_VDISK	8
 
 static Z80Context cpu_z80;
 static nic_w5100_t *wiz;
@@ -188,6 +203,7 @@ volatile int emulator_done;
 #define TRACE_PS2	0x200000
 #define TRACE_ACIA	0x400000
 #define TRACE_SCSI	0x800000
+#define TRACE_VDISK	0x1000000
 
 static int trace = 0;
 
@@ -840,11 +856,85 @@ uint8_t do_mem_read(uint16_t addr, int quiet)
 	return r;
 }
 
+/* Host memory behind a CPU address for the block translator. Memory
+   tracing wants to see every fetch and watchpoints report the PC of the
+   access, so both leave everything to the interpreter */
+static uint8_t *mem_map(int unused, uint16_t addr)
+{
+	if ((trace & TRACE_MEM) || watching)
+		return NULL;
+	switch (cpuboard) {
+	case CPUBOARD_Z80:
+	case CPUBOARD_EASYZ80:
+	case CPUBOARD_TINYZ80:
+		if (bankenable)
+			return &ramrom[(bankreg[addr >> 14] << 14) + (addr & 0x3FFF)];
+		if (bank512)
+			return &ramrom[addr & 0x3FFF];
+		return &ramrom[addr];
+	case CPUBOARD_SC108:
+		if (addr < 0x8000 && !(port38 & 0x01))
+			return &ramrom[addr];
+		if (port38 & 0x80)
+			return &ramrom[addr + 131072];
+		return &ramrom[addr + 65536];
+	case CPUBOARD_SC114:
+	case CPUBOARD_SC121:
+		if (addr < 0x8000 && !(port38 & 0x01))
+			return &ramrom[addr];
+		if (port30 & 0x01)
+			return &ramrom[addr + 131072];
+		return &ramrom[addr + 65536];
+	case CPUBOARD_Z80SBC64:
+		if (addr >= 0x8000)
+			return &ramrom[addr];
+		return &ramrom[bankreg[0] * 0x8000 + addr];
+	case CPUBOARD_MICRO80:
+		return mmu_micro80_z84c15(addr, 0);
+	case CPUBOARD_ZRCC:
+		/* The boot ROM is smaller than a page */
+		if (addr < 0x40 && bankreg[1] == 0)
+			return NULL;
+		if (addr >= 0x8000)
+			return &ramrom[addr + 65536];
+		return &ramrom[bankreg[0] * 0x8000 + addr];
+	case CPUBOARD_PDOG128:
+		return mmu_pickled128(addr, 0);
+	case CPUBOARD_PDOG512:
+		return mmu_pickled512(addr, 0);
+	case CPUBOARD_MICRO80W:
+		if (bankenable)
+			return &ramrom[(bankreg[addr >> 14] << 14) + (addr & 0x3FFF)];
+		return &ramrom[addr & 0x3FFF];
+	case CPUBOARD_ZRC:
+		if (addr < 0x40 && rom_mapped)
+			return NULL;
+		if (addr >= 0x8000)
+			return &ramrom[addr | 0x1F8000];
+		return &ramrom[bankreg[1] * 0x8000 + addr];
+	case CPUBOARD_SC720:
+		if (addr & 0x8000)
+			return &ramrom[(addr & 0x7FFF) + 0x78000];
+		return &ramrom[addr + bankreg[0] * 0x8000];
+	case CPUBOARD_SC707:
+		if (addr < 0x8000 && !(port38 & 0x01))
+			return &ramrom[addr + bankreg[0] * 0x8000];
+		if (port38 & 0x01)
+			return &ramrom[addr + 0x30000];
+		return &ramrom[addr + 0x20000];
+	case CPUBOARD_TP128:
+		return &ramrom[mmu_tp128(addr, 0)];
+	}
+	return NULL;
+}
+
 uint8_t mem_read(int unused, uint16_t addr)
 {
 	static uint8_t rstate = 0;
 	uint8_t r = do_mem_read(addr, 0);
 
+	if (watching)
+		watch_read(addr, r);
 	if (cpu_z80.M1) {
 		/* DD FD CB see the Z80 interrupt manual */
 		if (r == 0xDD || r == 0xFD || r == 0xCB) {
@@ -866,6 +956,8 @@ uint8_t mem_read(int unused, uint16_t addr)
 
 void mem_write(int unused, uint16_t addr, uint8_t val)
 {
+	if (watching)
+		watch_write(addr, val);
 	switch (cpuboard) {
 	case CPUBOARD_Z80:
 		mem_write0(addr, val);
@@ -919,6 +1011,18 @@ void mem_write(int unused, uint16_t addr, uint8_t val)
 	}
 }
 
+/* The paravirtual disk sees memory as the CPU does with the current
+   banking, as a bus mastering DMA card would */
+static uint8_t vdisk_mem_read(void *priv, uint32_t addr)
+{
+	return do_mem_read(addr, 1);
+}
+
+static void vdisk_mem_write(void *priv, uint32_t addr, uint8_t val)
+{
+	mem_write(0, addr, val);
+}
+
 static unsigned int nbytes;
 
 uint8_t z80dis_byte(uint16_t addr)
@@ -934,11 +1038,43 @@ uint8_t z80dis_byte_quiet(uint16_t addr)
 	return do_mem_read(addr, 1);
 }
 
+static void z80_tracebuf(void)
+{
+	struct tracebuf_rec *r = tracebuf_next(tracebuf, cpu_z80.M1PC);
+	unsigned int i;
+
+	r->cycle = tstates_total + cpu_z80.tstates;
+	r->bank = bankreg[0] | (bankreg[1] << 8) | (bankreg[2] << 16) | (bankreg[3] << 24);
+	r->reg[0] = cpu_z80.R1.wr.AF;
+	r->reg[1] = cpu_z80.R1.wr.BC;
+	r->reg[2] = cpu_z80.R1.wr.DE;
+	r->reg[3] = cpu_z80.R1.wr.HL;
+	r->reg[4] = cpu_z80.R1.wr.IX;
+	r->reg[5] = cpu_z80.R1.wr.IY;
+	r->reg[6] = cpu_z80.R1.wr.SP;
+	r->reg[7] = (cpu_z80.IFF1 << 16) | (cpu_z80.I << 8) | cpu_z80.R;
+	for (i = 0; i < 4; i++)
+		r->op[i] = z80dis_byte_quiet(cpu_z80.M1PC + i);
+	r->oplen = 4;
+	r->flags = 0;
+}
+
+static void watch_hit(unsigned action, uint32_t addr)
+{
+	fprintf(stderr, "watch: PC %04X\n", cpu_z80.M1PC);
+	if (action == WATCH_STOP)
+		emulator_done = 1;
+	else if (action == WATCH_TRACE)
+		trace |= TRACE_CPU;
+}
+
 static void z80_trace(unsigned unused)
 {
 	static uint32_t lastpc = -1;
 	char buf[256];
 
+	if (tracebuf)
+		z80_tracebuf();
 	if ((trace & TRACE_CPU) == 0)
 		return;
 	nbytes = 0;
@@ -984,19 +1120,26 @@ unsigned int check_chario(void)
 		r |= 1;
 	if (FD_ISSET(1, &o))
 		r |= 2;
-	return r;
+	return inputlog_chario(r);
 }
 
 unsigned int next_char(void)
 {
 	char c;
+	if (inputlog_mode == INPUTLOG_REPLAY)
+		return inputlog_char(0);
 	if (read(0, &c, 1) != 1) {
 		printf("(tty read without ready byte)\n");
 		return 0xFF;
 	}
 	if (c == 0x0A)
 		c = '\r';
-	return c;
+	return inputlog_char(c);
+}
+
+static uint64_t input_clock(void)
+{
+	return tstates_total + cpu_z80.tstates;
 }
 
 void recalc_interrupts(void)
@@ -2334,6 +2477,12 @@ static uint8_t io_read_2014(uint16_t addr)
 		return z512_read(addr);
 	if (addr >= 0x58 && addr <= 0x5F && ncr && !extreme)
 		return ncr5380_read(ncr, addr & 7);
+	if (addr >= 0xD0 && addr <= 0xD7 && vdisk) {
+		/* Reading the status clears the interrupt */
+		uint8_t r = vdisk_read(vdisk, addr & 7);
+		poll_irq_nonim2();
+		return r;
+	}
 	if (have_busstop && addr >= 0xDC && addr <= 0xDF) {
 		Z80NMI_Clear(&cpu_z80);
 		if (addr & 1)
@@ -2440,6 +2589,10 @@ static void io_write_2014(uint16_t addr, uint8_t val, uint8_t known)
 		tft_write(tft, addr & 1, val);
 	} else if (addr >= 0x58 && addr <= 0x5F && ncr && !extreme)
 		ncr5380_write(ncr, addr & 7, val);
+	else if (addr >= 0xD0 && addr <= 0xD7 && vdisk) {
+		vdisk_write(vdisk, addr & 7, val);
+		poll_irq_nonim2();
+	}
 	/* The switchable/pageable ROM is not very well decoded */
 	else if (switchrom && (addr & 0x7F) >= 0x38 && (addr & 0x7F) <= 0x3F)
 		toggle_rom();
@@ -2926,6 +3079,52 @@ uint8_t io_read(int unused, uint16_t addr)
 	}
 }
 
+/* Ports that the firmware sits polling for serial status. Reading them
+   has no side effect beyond the first read so a loop that keeps getting
+   the same answer can be skipped until the devices next run. Only the
+   common console setups are listed, anything else is just emulated */
+static int io_poll(int unused, uint16_t addr)
+{
+	if (trace & TRACE_CPU)
+		return 0;
+	switch (cpuboard) {
+	case CPUBOARD_Z80SBC64:
+	case CPUBOARD_ZRCC:
+		if ((addr & 0xFF) == 0xF8)
+			return 1;
+		if ((addr & 0xFF) == 0xF9)
+			return 0;
+		/* Fall through */
+	case CPUBOARD_Z80:
+	case CPUBOARD_SC108:
+	case CPUBOARD_PDOG128:
+	case CPUBOARD_PDOG512:
+	case CPUBOARD_ZRC:
+	case CPUBOARD_SC720:
+	case CPUBOARD_SC707:
+	case CPUBOARD_TP128:
+		if (extreme || copro || zxkey || have_busstop)
+			return 0;
+		break;
+	default:
+		return 0;
+	}
+	addr &= 0xFF;
+	if (addr >= 0x80 && addr <= 0x9F && have_kio)
+		return 0;
+	if ((addr >= 0xA0 && addr <= 0xA7) && acia && acia_narrow == 1)
+		return !(addr & 1);
+	if ((addr >= 0x80 && addr <= 0x87) && acia && acia_narrow == 2)
+		return !(addr & 1);
+	if ((addr >= 0x80 && addr <= 0xBF) && acia && !acia_narrow)
+		return !(addr & 1);
+	if ((addr >= 0x80 && addr <= 0x87) && sio2)
+		return !(addr & 1);
+	if (addr == 0xA5 && have_16x50)
+		return 1;
+	return 0;
+}
+
 /* Work out what our interrupt should look like */
 static void set_interrupt(void)
 {
@@ -2954,6 +3153,8 @@ static void poll_irq_nonim2(void)
 		live_nonim2 |= IRQM_16X50;
 	if (vdp && tms9918a_irq_pending(vdp))
 		live_nonim2 |= IRQM_VDP;
+	if (vdisk && vdisk_irq_pending(vdisk))
+		live_nonim2 |= IRQM_VDISK;
 	set_interrupt();
 }
 
@@ -3029,7 +3230,7 @@ static void exit_cleanup(void)
 
 static void usage(void)
 {
-	fprintf(stderr, "rc2014: [-a] [-A] [-b] [-c] [-f] [-i idepath] [-R] [-m mainboard] [-r rompath] [-e rombank] [-s] [-w] [-d debug]\n");
+	fprintf(stderr, "rc2014: [-a] [-A] [-b] [-c] [-f] [-i idepath] [-R] [-m mainboard] [-r rompath] [-e rombank] [-s] [-V vdiskpath] [-w] [-d debug] [-t tracefile] [-x traceaddr] [-j recordlog] [-J replaylog] [-L link] [-M fill|merge] [-W host|emu|seconds] [-D watch] [-O]\n");
 	exit(EXIT_FAILURE);
 }
 
@@ -3041,13 +3242,21 @@ int main(int argc, char *argv[])
 	int fd;
 	int rom = 1;
 	int rombank = 0;
+	int len;
 	char *rompath = "rc2014.rom";
 	char *sdpath = NULL;
 	char *idepath = NULL;
+	char *vdiskpath = NULL;
 	int save = 0;
 	int have_acia = 0;
 	int indev;
 	char *patha = NULL, *pathb = NULL;
+	char *tracepath = NULL;
+	uint32_t tracetrig = TRACEBUF_NOTRIGGER;
+	char *inputpath = NULL;
+	unsigned inputmode = INPUTLOG_OFF;
+	char *linkspec = NULL;
+	struct serial_device *condev = &console;
 
 #define INDEV_ACIA	1
 #define INDEV_SIO	2
@@ -3055,11 +3264,7 @@ int main(int argc, char *argv[])
 #define INDEV_16C550A	4
 #define INDEV_KIO	5
 
-	uint8_t *p = ramrom;
-	while (p < ramrom + sizeof(ramrom))
-		*p++= rand();
-
-	while ((opt = getopt(argc, argv, "19Aabcd:e:EfF:i:I:km:nN:pPr:sRS:Tuw8CZz:X")) != -1) {
+	while ((opt = getopt(argc, argv, "19AabcD:d:e:EfF:i:I:W:j:J:kL:m:M:nN:OpPr:sRS:t:TuV:w8x:CZz:X")) != -1) {
 		switch (opt) {
 		case 'a':
 			have_acia = 1;
@@ -3091,6 +3296,9 @@ int main(int argc, char *argv[])
 			sdpath = optarg;
 			have_pio = 1;
 			break;
+		case 'V':
+			vdiskpath = optarg;
+			break;
 		case 'e':
 			rombank = atoi(optarg);
 			break;
@@ -3316,12 +3524,68 @@ int main(int argc, char *argv[])
 			extreme = 1;
 			have_kio_ext = 1;
 			break;
+		case 't':
+			tracepath = optarg;
+			break;
+		case 'x':
+			tracetrig = strtoul(optarg, NULL, 16);
+			break;
+		case 'j':
+			inputpath = optarg;
+			inputmode = INPUTLOG_RECORD;
+			break;
+		case 'J':
+			inputpath = optarg;
+			inputmode = INPUTLOG_REPLAY;
+			break;
+		case 'W':
+			if (wallclock_option(optarg))
+				usage();
+			break;
+		case 'L':
+			linkspec = optarg;
+			break;
+		case 'M':
+			if (guestmem_option(optarg))
+				usage();
+			break;
+		case 'D':
+			if (watch_option(optarg))
+				usage();
+			watching = 1;
+			break;
+		case 'O':
+			jit = 1;
+			break;
 		default:
 			usage();
 		}
 	}
 	if (optind < argc)
 		usage();
+	watch_set_hook(watch_hit);
+
+	ramrom = guestmem_alloc(RAMROM_SIZE);
+	guestmem_fill(ramrom, RAMROM_SIZE, -1);
+
+	if (tracepath) {
+		tracebuf = tracebuf_create(tracepath, TRACEBUF_Z80, 262144);
+		tracebuf_trigger(tracebuf, tracetrig);
+	}
+	if (inputpath)
+		inputlog_init(inputpath, inputmode, input_clock);
+	/* 50 frames a second, 4000 slices a frame */
+	wallclock_set_clock(input_clock, 200000ULL * ((tstate_steps + 5) / 10));
+	if (linkspec) {
+		if (indev != INDEV_ACIA && indev != INDEV_16C550A) {
+			fprintf(stderr, "rc2014: a serial link needs the ACIA or 16x50 console.\n");
+			exit(1);
+		}
+		condev = serlink_open(linkspec);
+		if (condev == NULL)
+			exit(1);
+		serlink_set_clock(input_clock, 200000ULL * ((tstate_steps + 5) / 10));
+	}
 
 	if (have_kio) {
 		sio2 = 1;
@@ -3346,24 +3610,17 @@ int main(int argc, char *argv[])
 	}
 
 	if (rom && cpuboard != CPUBOARD_Z80SBC64 && cpuboard != CPUBOARD_ZRCC && cpuboard != CPUBOARD_ZRC) {
-		fd = open(rompath, O_RDONLY);
-		if (fd == -1) {
-			perror(rompath);
-			exit(EXIT_FAILURE);
-		}
 		bankreg[0] = 0;
 		bankreg[1] = 1;
 		bankreg[2] = 32;
 		bankreg[3] = 33;
-		if (lseek(fd, 8192 * rombank, SEEK_SET) < 0) {
-			perror("lseek");
-			exit(1);
-		}
-		if (read(fd, ramrom, romsize) < 8192) {
+		len = guestmem_load(ramrom, rompath, 8192 * rombank, romsize);
+		if (len == -1)
+			exit(EXIT_FAILURE);
+		if (len < 8192) {
 			fprintf(stderr, "rc2014: short rom '%s'.\n", rompath);
 			exit(EXIT_FAILURE);
 		}
-		close(fd);
 	}
 	/* ZRCC has a 64byte wired in CPLD ROM so we don't use the ROM
 	   option in the same way */
@@ -3381,7 +3638,6 @@ int main(int argc, char *argv[])
 	   Mark states read only with chmod and it won't save back */
 
 	if (cpuboard == CPUBOARD_Z80SBC64) {
-		int len;
 		save = 1;
 		fd = open(rompath, O_RDWR);
 		if (fd == -1) {
@@ -3409,17 +3665,14 @@ int main(int argc, char *argv[])
 		z84c15_init();
 
 	if (bank512) {
-		fd = open(rompath, O_RDONLY);
-		if (fd == -1) {
-			perror(rompath);
+		len = guestmem_load(ramrom, rompath, 0, 524288);
+		if (len == -1)
 			exit(EXIT_FAILURE);
-		}
-		if (read(fd, ramrom, 524288) != 524288) {
+		if (len != 524288) {
 			fprintf(stderr, "rc2014: banked rom image should be 512K.\n");
 			exit(EXIT_FAILURE);
 		}
 		bankenable = 1;
-		close(fd);
 	}
 
 	if (have_copro) {
@@ -3464,6 +3717,13 @@ int main(int argc, char *argv[])
 		ncr5380_trace(ncr, !!(trace & TRACE_SCSI));
 	}
 
+	if (vdiskpath) {
+		vdisk = vdisk_create(vdiskpath, vdisk_mem_read, vdisk_mem_write, NULL);
+		if (vdisk == NULL)
+			exit(1);
+		vdisk_trace(vdisk, !!(trace & TRACE_VDISK));
+	}
+
 	/* SD mapping */
 	if (cpuboard == CPUBOARD_MICRO80 || cpuboard == CPUBOARD_MICRO80W) {
 		sd_clock = 0x04;
@@ -3510,7 +3770,7 @@ int main(int argc, char *argv[])
 	if (have_16x50) {
 		uart = uart16x50_create();
 		if (indev == INDEV_16C550A)
-			uart16x50_attach(uart, &console);
+			uart16x50_attach(uart, inputlog_serial(condev));
 		else
 			uart16x50_attach(uart, &console_wo);
 	}
@@ -3576,7 +3836,7 @@ int main(int argc, char *argv[])
 
 	switch(indev) {
 	case INDEV_ACIA:
-		acia_attach(acia, &console);
+		acia_attach(acia, inputlog_serial(condev));
 		break;
 	case INDEV_SIO:
 		sio2_input = 1;
@@ -3613,10 +3873,15 @@ int main(int argc, char *argv[])
 
 	Z80RESET(&cpu_z80);
 	cpu_z80.ioRead = io_read;
+	cpu_z80.ioPoll = io_poll;
 	cpu_z80.ioWrite = io_write;
 	cpu_z80.memRead = mem_read;
 	cpu_z80.memWrite = mem_write;
 	cpu_z80.trace = z80_trace;
+	if (jit && Z80JitEnable(&cpu_z80, mem_map)) {
+		fprintf(stderr, "rc2014: -O is not supported on this host.\n");
+		jit = 0;
+	}
 
 	/* This is the wrong way to do it but it's easier for the moment. We
 	   should track how much real time has occurred and try to keep cycle
@@ -3636,16 +3901,34 @@ int main(int argc, char *argv[])
 		}
 		int i;
 		/* 36400 T states for base RC2014 - varies for others */
-		for (i = 0; i < 40; i++) {
+		for (i = 0; i < 40 && !emulator_done; i++) {
 			int j;
-			for (j = 0; j < 100; j++) {
-				Z80ExecuteTStates(&cpu_z80, (tstate_steps + 5)/ 10);
+			for (j = 0; j < 100 && !emulator_done; j++) {
+				unsigned n = 1;
+				/* Sat in HALT waiting for an interrupt, or spinning
+				   on a status port. Nothing happens until a device
+				   changes so run several slices as one and poll the
+				   devices at the end */
+				if ((Z80Idle(&cpu_z80) || Z80Spinning(&cpu_z80)) && !copro) {
+					n = 100 - j;
+					if (n > IDLE_SLICES)
+						n = IDLE_SLICES;
+					j += n - 1;
+				}
+				/* Translated code only runs with no trace hook, and
+				   the guest can turn CPU tracing on at any point */
+				if (jit)
+					cpu_z80.trace = (tracebuf || (trace & TRACE_CPU)) ? z80_trace : NULL;
+				tstates_total += Z80ExecuteTStates(&cpu_z80, n * ((tstate_steps + 5)/ 10));
+				/* Now counted in the total, so the I/O polls
+				   between slices see an exact clock */
+				cpu_z80.tstates = 0;
 				if (ef9345)
-					ef9345_cycles(ef9345, 200);
+					ef9345_cycles(ef9345, 200 * n);
 				if (copro)
 					z180copro_run(copro);
 				if (ps2)
-					ps2_event(ps2, (tstate_steps + 5) / 10);
+					ps2_event(ps2, n * ((tstate_steps + 5) / 10));
 				if (acia)
 					acia_timer(acia);
 				if (sio2)
@@ -1,6 +1,7 @@
 #include <stdio.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 #include <SDL2/SDL.h>
 
 #define WITH_SDL
@@ -8,6 +9,7 @@
 #include "system.h"
 #include "zxkey.h"
 #include "ps2.h"
+#include "inputlog.h"
 
 int sdl_live;
 
@@ -40,9 +42,19 @@ static void make_ps2_code(SDL_Event *ev)
 	ps2_queue_byte(ps2, code);
 }
 
+static void key_event(SDL_Event *ev)
+{
+	if (zxkey)
+		zxkey_SDL2event(zxkey, ev);
+	if (ps2)
+		make_ps2_code(ev);
+}
+
 void ui_event(void)
 {
 	SDL_Event ev;
+	struct inputlog_key k;
+
 	while (SDL_PollEvent(&ev)) {
 		switch(ev.type) {
 		case SDL_QUIT:
@@ -50,12 +62,25 @@ void ui_event(void)
 			break;
 		case SDL_KEYDOWN:
 		case SDL_KEYUP:
-			if (zxkey)
-				zxkey_SDL2event(zxkey, &ev);
-			if (ps2)
-				make_ps2_code(&ev);
+			/* Live keys are ignored when replaying a log */
+			if (inputlog_mode == INPUTLOG_REPLAY)
+				break;
+			k.up = ev.type == SDL_KEYUP;
+			k.sym = ev.key.keysym.sym;
+			k.scancode = ev.key.keysym.scancode;
+			k.mod = ev.key.keysym.mod;
+			inputlog_key_record(&k);
+			key_event(&ev);
 			break;
 		}
 	}
+	while (inputlog_key_replay(&k)) {
+		memset(&ev, 0, sizeof(ev));
+		ev.type = k.up ? SDL_KEYUP : SDL_KEYDOWN;
+		ev.key.keysym.sym = k.sym;
+		ev.key.keysym.scancode = k.scancode;
+		ev.key.keysym.mod = k.mod;
+		key_event(&ev);
+	}
 }
 
@@ -191,6 +191,45 @@ uint8_t m6800_inport(uint8_t addr)
 	return 0xFF;
 }
 
+/* Point the CPU straight at the memory behind each page so it only calls
+   us for I/O, ROM writes and when tracing memory. Redone whenever the
+   banking changes */
+static void remap(void)
+{
+	unsigned int page;
+	unsigned int addr;
+	uint8_t *p;
+	int ro;
+
+	for (page = 0; page < 256; page++) {
+		addr = page << 8;
+		if (page == 0xFE || (trace & TRACE_MEM)) {
+			m6800_map_page(&cpu, page, NULL, NULL);
+			continue;
+		}
+		if (bankhigh) {
+			uint8_t reg = mmureg;
+			uint32_t higha;
+			if (addr < 0xE000)
+				reg >>= 1;
+			higha = (reg & 0x40) ? 1 : 0;
+			higha |= (reg & 0x10) ? 2 : 0;
+			higha |= (reg & 0x4) ? 4 : 0;
+			higha |= (reg & 0x01) ? 8 : 0;	/* ROM/RAM */
+			p = ramrom + (higha << 16) + addr;
+			ro = !(higha & 8);
+		} else if (bankenable) {
+			unsigned int bank = (addr & 0xC000) >> 14;
+			p = ramrom + (bankreg[bank] << 14) + (addr & 0x3FFF);
+			ro = bankreg[bank] < 32;
+		} else {
+			p = ramrom + addr;
+			ro = addr >= 32768 || bank512;
+		}
+		m6800_map_page(&cpu, page, p, ro ? NULL : p);
+	}
+}
+
 void m6800_outport(uint8_t addr, uint8_t val)
 {
 	if (trace & TRACE_IO)
@@ -199,6 +238,7 @@ void m6800_outport(uint8_t addr, uint8_t val)
 		mmureg = val;
 		if (trace & TRACE_512)
 			fprintf(stderr, "MMUreg set to %02X\n", val);
+		remap();
 	}
 	else if (addr == 0x80)
 		fprintf(stderr, "[%02X] ", val);
@@ -215,15 +255,18 @@ void m6800_outport(uint8_t addr, uint8_t val)
 		bankreg[addr & 3] = val & 0x3F;
 		if (trace & TRACE_512)
 			fprintf(stderr, "Bank %d set to %d\n", addr & 3, val);
+		remap();
 	} else if (bank512 && addr >= 0x7C && addr <= 0x7F) {
 		if (trace & TRACE_512)
 			fprintf(stderr, "Banking %sabled.\n", (val & 1) ? "en" : "dis");
 		bankenable = val & 1;
+		remap();
 	} else if (addr == 0x0C && rtc)
 		rtc_write(rtcdev, val);
 	else if (addr == 0xFD) {
 		printf("trace set to %d\n", val);
 		trace = val;
+		remap();
 	} else if (trace & TRACE_UNK)
 		fprintf(stderr, "Unknown write to port %04X of %02X\n", addr, val);
 }
@@ -496,6 +539,7 @@ int main(int argc, char *argv[])
 	}
 
 	m6800_reset(&cpu, CPU_6303, INTIO_6803, 3);
+	remap();
 
 	if (trace & TRACE_CPU)
 		cpu.debug = 1;
@@ -509,8 +553,8 @@ int main(int argc, char *argv[])
 		unsigned int i;
 		/* 36400 T states for base rcbus - varies for others */
 		for (i = 0; i < 100; i++) {
-			while(cycles < clockrate)
-				cycles += m6800_execute(&cpu);
+			if (cycles < clockrate)
+				cycles += m6800_run(&cpu, clockrate - cycles);
 			cycles -= clockrate;
 		}
 		/* Drive the internal serial */
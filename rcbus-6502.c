@@ -29,7 +29,9 @@
 #include "ide.h"
 #include "6522.h"
 #include "rtc_bitbang.h"
+#include "vdisk.h"
 #include "w5100.h"
+#include "tracebuf.h"
 
 static uint8_t ramrom[1024 * 1024];	/* Covers the banked card */
 
@@ -50,12 +52,14 @@ static uint8_t live_irq;
 #define IRQ_ACIA	1
 #define IRQ_16550A	2
 #define IRQ_VIA		3
+#define IRQ_VDISK	4
 
 static nic_w5100_t *wiz;
 static struct via6522 *via;
 static struct uart16x50 *uart;
 struct rtc *rtc;
 static struct acia *acia;
+static struct vdisk *vdisk;
 static int acia_narrow;
 
 static volatile int done;
@@ -70,8 +74,10 @@ static volatile int done;
 #define TRACE_ACIA	512
 #define TRACE_UART	2048
 #define TRACE_VIA	4096
+#define TRACE_VDISK	8192
 
 static int trace = 0;
+static struct tracebuf *tracebuf;
 
 /* We do this in the 6502 loop instead. Provide a dummy for the device models */
 void recalc_interrupts(void)
@@ -88,6 +94,8 @@ static void int_clear(int src)
 	live_irq &= ~(1 << src);
 }
 
+static void poll_irq_event(void);
+
 
 static int ide = 0;
 struct ide_controller *ide0;
@@ -142,6 +150,12 @@ uint8_t mmio_read_6502(uint8_t addr)
 		return rtc_read(rtc);
 	if (addr >= 0xC0 && addr <= 0xCF && uart)
 		return uart16x50_read(uart, addr & 0x0F);
+	if (addr >= 0xD0 && addr <= 0xD7 && vdisk) {
+		/* Reading the status clears the interrupt */
+		uint8_t r = vdisk_read(vdisk, addr & 7);
+		poll_irq_event();
+		return r;
+	}
 	if (trace & TRACE_UNK)
 		fprintf(stderr, "Unknown read from port %04X\n", addr);
 	return 0xFF;
@@ -174,7 +188,10 @@ void mmio_write_6502(uint8_t addr, uint8_t val)
 		rtc_write(rtc, val);
 	else if (addr >= 0xC0 && addr <= 0xCF && uart)
 		uart16x50_write(uart, addr & 0x0F, val);
-	else if (addr == 0x00) {
+	else if (addr >= 0xD0 && addr <= 0xD7 && vdisk) {
+		vdisk_write(vdisk, addr & 7, val);
+		poll_irq_event();
+	} else if (addr == 0x00) {
 		printf("trace set to %d\n", val);
 		trace = val;
 		if (trace & TRACE_CPU)
@@ -250,6 +267,22 @@ void write6502(uint16_t addr, uint8_t val)
 	}
 }
 
+/* The paravirtual disk sees the CPU view of memory but not the I/O page */
+static uint8_t vdisk_mem_read(void *priv, uint32_t addr)
+{
+	addr &= 0xFFFF;
+	if (addr >> 8 == iopage)
+		return 0xFF;
+	return do_6502_read(addr);
+}
+
+static void vdisk_mem_write(void *priv, uint32_t addr, uint8_t val)
+{
+	addr &= 0xFFFF;
+	if (addr >> 8 != iopage)
+		write6502(addr, val);
+}
+
 static void poll_irq_event(void)
 {
 	if (via_irq_pending(via))
@@ -268,6 +301,12 @@ static void poll_irq_event(void)
 		else
 			int_clear(IRQ_16550A);
 	}
+	if (vdisk) {
+		if (vdisk_irq_pending(vdisk))
+			int_set(IRQ_VDISK);
+		else
+			int_clear(IRQ_VDISK);
+	}
 }
 
 static void irqnotify(void)
@@ -289,9 +328,28 @@ static void exit_cleanup(void)
 	tcsetattr(0, TCSADRAIN, &saved_term);
 }
 
+static void cpu_tracebuf(uint16_t pc, uint8_t a, uint8_t x, uint8_t y,
+			 uint8_t sp, uint8_t status)
+{
+	struct tracebuf_rec *r = tracebuf_next(tracebuf, pc);
+	unsigned int i;
+
+	r->cycle = getclockticks();
+	r->bank = bankreg[0] | (bankreg[1] << 8) | (bankreg[2] << 16) | (bankreg[3] << 24);
+	r->reg[0] = a;
+	r->reg[1] = x;
+	r->reg[2] = y;
+	r->reg[3] = sp;
+	r->reg[4] = status;
+	for (i = 0; i < 3; i++)
+		r->op[i] = read6502_debug(pc + i);
+	r->oplen = 3;
+	r->flags = 0;
+}
+
 static void usage(void)
 {
-	fprintf(stderr, "rcbus-6502: [-1] [-A] [-a] [-f] [-i idepath] [-R] [-r rompath] [-w] [-d debug]\n");
+	fprintf(stderr, "rcbus-6502: [-1] [-A] [-a] [-f] [-i idepath] [-R] [-r rompath] [-V vdiskpath] [-w] [-d debug] [-t tracefile] [-x traceaddr]\n");
 	exit(EXIT_FAILURE);
 }
 
@@ -304,8 +362,11 @@ int main(int argc, char *argv[])
 	int usertc = 0;
 	char *rompath = "rcbus-6502.rom";
 	char *idepath;
+	char *tracepath = NULL;
+	char *vdiskpath = NULL;
+	uint32_t tracetrig = TRACEBUF_NOTRIGGER;
 
-	while ((opt = getopt(argc, argv, "1Aad:fi:r:Rw")) != -1) {
+	while ((opt = getopt(argc, argv, "1Aad:fi:r:Rt:V:wx:")) != -1) {
 		switch (opt) {
 		case '1':
 			input = 2;
@@ -337,6 +398,15 @@ int main(int argc, char *argv[])
 		case 'w':
 			wiznet = 1;
 			break;
+		case 't':
+			tracepath = optarg;
+			break;
+		case 'x':
+			tracetrig = strtoul(optarg, NULL, 16);
+			break;
+		case 'V':
+			vdiskpath = optarg;
+			break;
 		default:
 			usage();
 		}
@@ -397,6 +467,13 @@ int main(int argc, char *argv[])
 		nic_w5100_reset(wiz);
 	}
 
+	if (vdiskpath) {
+		vdisk = vdisk_create(vdiskpath, vdisk_mem_read, vdisk_mem_write, NULL);
+		if (vdisk == NULL)
+			exit(1);
+		vdisk_trace(vdisk, !!(trace & TRACE_VDISK));
+	}
+
 	/* 5ms - it's a balance between nice behaviour and simulation
 	   smoothness */
 	tc.tv_sec = 0;
@@ -426,6 +503,11 @@ int main(int argc, char *argv[])
 	init6502();
 	reset6502();
 	hookexternal(irqnotify);
+	if (tracepath) {
+		tracebuf = tracebuf_create(tracepath, TRACEBUF_6502, 262144);
+		tracebuf_trigger(tracebuf, tracetrig);
+		hooktrace(cpu_tracebuf);
+	}
 
 	/* This is the wrong way to do it but it's easier for the moment. We
 	   should track how much real time has occurred and try to keep cycle
@@ -439,13 +521,25 @@ int main(int argc, char *argv[])
 		int i;
 		/* 36400 T states for base rcbus - varies for others */
 		for (i = 0; i < 100; i++) {
-			/* FIXME: should check return and keep adjusting */
-			exec6502(tstate_steps);
+			unsigned int left = tstate_steps;
+			/* Run up to each VIA timer interrupt so it is taken
+			   on time. exec6502 carries any overrun into the
+			   next call */
+			while (left) {
+				unsigned int n = via_next_event(via);
+				int hit = n && n <= left;
+				if (!hit)
+					n = left;
+				exec6502(n);
+				via_tick(via, n);
+				left -= n;
+				if (hit)
+					poll_irq_event();
+			}
 			if (acia)
 				acia_timer(acia);
 			if (input == 2)
 				uart16x50_event(uart);
-			via_tick(via, tstate_steps);
 		}
 		if (wiznet)
 			w5100_process(wiz);
@@ -25,6 +25,7 @@
 #include "ttycon.h"
 #include "acia.h"
 #include "16x50.h"
+#include "watch.h"
 
 static uint8_t ramrom[1024 * 1024];
 
@@ -149,6 +150,8 @@ static void my_ide_write(uint16_t addr, uint8_t val)
 
 /* I/O space */
 
+static void remap(void);
+
 static uint8_t m6800_do_ior(uint8_t addr)
 {
 	if (acia && (addr == 0xA0 || addr == 0xA1))
@@ -177,13 +180,16 @@ static void m6800_iow(uint8_t addr, uint8_t val)
 	else if (ide && addr >= 0x10 && addr <= 0x17) {
 		/* IDE at 0xFE10 for now */
 		my_ide_write(addr & 7, val);
-	} else if (addr == 0x38)
+	} else if (addr == 0x38) {
 		banksel = val & 3;
-	else if (addr >= 0x78 && addr <= 0x7B)
+		remap();
+	} else if (addr >= 0x78 && addr <= 0x7B) {
 		bankreg[addr - 0x78] = val & 0x3F;
-	else if (addr >= 0x7C && addr <= 0x7F)
+		remap();
+	} else if (addr >= 0x7C && addr <= 0x7F) {
 		bankenable = val & 1;
-	else if (uart && addr >= 0xC0 && addr <= 0xC7)
+		remap();
+	} else if (uart && addr >= 0xC0 && addr <= 0xC7)
 		uart16x50_write(uart, addr & 7, val);
 	else if (trace & TRACE_UNK)
 		fprintf(stderr, "Unknown I/O write to 0x%02X of %02X\n",
@@ -214,7 +220,24 @@ static uint8_t *mmu_map(uint16_t addr, int write)
 		return NULL;
 	return ramrom + (addr & 0x3FFF) + (page << 14);
 }
-		
+
+/* Let the CPU at the memory behind each page directly. Only I/O, ROM
+   writes, watched pages and memory tracing need to come through us.
+   Redone whenever the banking changes */
+static void remap(void)
+{
+	unsigned int page;
+	uint16_t addr;
+
+	for (page = 0; page < 256; page++) {
+		addr = page << 8;
+		if (page == 0xFE || (trace & TRACE_MEM) || watch_page(page))
+			m6800_map_page(&cpu, page, NULL, NULL);
+		else
+			m6800_map_page(&cpu, page, mmu_map(addr, 0), mmu_map(addr, 1));
+	}
+}
+
 uint8_t m6800_read_op(struct m6800 *cpu, uint16_t addr, int debug)
 {
 	uint8_t r;
@@ -241,12 +264,15 @@ uint8_t m6800_debug_read(struct m6800 *cpu, uint16_t addr)
 
 uint8_t m6800_read(struct m6800 *cpu, uint16_t addr)
 {
-	return m6800_read_op(cpu, addr, 0);
+	uint8_t r = m6800_read_op(cpu, addr, 0);
+	watch_read(addr, r);
+	return r;
 }
 
 void m6800_write(struct m6800 *cpu, uint16_t addr, uint8_t val)
 {
 	uint8_t *ptr;
+	watch_write(addr, val);
 	if (addr >= 0xFE00 && addr < 0xFF00)
 		m6800_iow(addr, val);
 	else {
@@ -266,6 +292,15 @@ static void poll_irq_event(void)
 {
 }
 
+static void watch_hit(unsigned action, uint32_t addr)
+{
+	fprintf(stderr, "watch: PC %04X\n", cpu.pc);
+	if (action == WATCH_STOP)
+		done = 1;
+	else if (action == WATCH_TRACE)
+		cpu.debug = 1;
+}
+
 static struct termios saved_term, term;
 
 static void cleanup(int sig)
@@ -282,7 +317,7 @@ static void exit_cleanup(void)
 static void usage(void)
 {
 	fprintf(stderr,
-		"rcbus-6800: [-1] [-b] [-f] [-i path] [-R] [-r rompath] [-d debug]\n");
+		"rcbus-6800: [-1] [-b] [-f] [-i path] [-R] [-r rompath] [-d debug] [-X watch]\n");
 	exit(EXIT_FAILURE);
 }
 
@@ -297,7 +332,7 @@ int main(int argc, char *argv[])
 	unsigned int cycles = 0;
 	unsigned int romsize = 32768;
 
-	while ((opt = getopt(argc, argv, "1bd:fi:r:")) != -1) {
+	while ((opt = getopt(argc, argv, "1bd:fi:r:X:")) != -1) {
 		switch (opt) {
 		case '1':
 			/* 1655x */
@@ -320,12 +355,17 @@ int main(int argc, char *argv[])
 		case 'f':
 			fast = 1;
 			break;
+		case 'X':
+			if (watch_option(optarg))
+				usage();
+			break;
 		default:
 			usage();
 		}
 	}
 	if (optind < argc)
 		usage();
+	watch_set_hook(watch_hit);
 
 	fd = open(rompath, O_RDONLY);
 	if (fd == -1) {
@@ -375,6 +415,7 @@ int main(int argc, char *argv[])
 	}
 
 	m6800_reset(&cpu, CPU_6800, INTIO_NONE, 3);
+	remap();
 
 	if (uarttype == 0) {
 		acia = acia_create();
@@ -398,9 +439,9 @@ int main(int argc, char *argv[])
 
 	while (!done) {
 		unsigned int i;
-		for (i = 0; i < 100; i++) {
-			while (cycles < clockrate)
-				cycles += m6800_execute(&cpu);
+		for (i = 0; i < 100 && !done; i++) {
+			if (cycles < clockrate)
+				cycles += m6800_run(&cpu, clockrate - cycles);
 			cycles -= clockrate;
 		}
 		/* Drive the internal serial */
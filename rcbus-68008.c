@@ -37,6 +37,7 @@
 #include "ppide.h"
 #include "rtc_bitbang.h"
 #include "16x50.h"
+#include "vdisk.h"
 #include "w5100.h"
 #include "sram_mmu8.h"
 
@@ -54,6 +55,7 @@ static uint16_t tstate_steps = 200;
 
 #define IRQ_ACIA	1
 #define IRQ_16550A	2
+#define IRQ_VDISK	3
 
 static nic_w5100_t *wiz;
 static struct acia *acia;
@@ -61,6 +63,7 @@ static struct ppide *ppide;
 static struct rtc *rtc;
 static struct uart16x50 *uart;
 static struct sram_mmu *mmu;
+static struct vdisk *vdisk;
 
 static unsigned acia_narrow;
 
@@ -74,6 +77,7 @@ static unsigned acia_narrow;
 #define TRACE_UART	128
 #define TRACE_PPIDE	256
 #define TRACE_MMU	512
+#define TRACE_VDISK	1024
 
 static int trace = 0;
 static int irq_mask;
@@ -98,6 +102,15 @@ static void remove_irq(int n)
 	}
 }
 
+/* The disk interrupt changes on register accesses so track it as they happen */
+static void vdisk_irq(void)
+{
+	if (vdisk_irq_pending(vdisk))
+		add_irq(IRQ_VDISK);
+	else
+		remove_irq(IRQ_VDISK);
+}
+
 int cpu_irq_ack(int level)
 {
 	return M68K_INT_ACK_AUTOVECTOR;
@@ -143,6 +156,11 @@ static uint8_t do_mmio_read_68000(uint16_t addr)
 		return rtc_read(rtc);
 	if (addr >= 0xC0 && addr <= 0xCF && uart)
 		return uart16x50_read(uart, addr & 0x0F);
+	if (addr >= 0xD0 && addr <= 0xD7 && vdisk) {
+		uint8_t r = vdisk_read(vdisk, addr & 7);
+		vdisk_irq();
+		return r;
+	}
 	if (trace & TRACE_UNK)
 		fprintf(stderr, "Unknown read from port %04X\n", addr);
 	return 0xFF;
@@ -180,7 +198,10 @@ void mmio_write_68000(uint16_t addr, uint8_t val)
 		rtc_write(rtc, val);
 	else if (addr >= 0xC0 && addr <= 0xCF && uart)
 		uart16x50_write(uart, addr & 0x0F, val);
-	else if (addr == 0x00) {
+	else if (addr >= 0xD0 && addr <= 0xD7 && vdisk) {
+		vdisk_write(vdisk, addr & 7, val);
+		vdisk_irq();
+	} else if (addr == 0x00) {
 		printf("trace set to %d\n", val);
 		trace = val;
 #if 0		
@@ -214,6 +235,32 @@ uint8_t *bmmu_translate(unsigned int addr, int wflag, int silent)
 	/* We don't emulate bus error yet */
 }
 
+/* The paravirtual disk sees memory as the CPU does but not the I/O space */
+static uint8_t vdisk_mem_read(void *priv, uint32_t addr)
+{
+	uint8_t *ptr;
+
+	addr &= 0xFFFFF;
+	if ((addr & 0xF0000) == 0x10000)
+		return 0xFF;
+	ptr = bmmu_translate(addr, 0, 1);
+	if (ptr)
+		return *ptr;
+	return 0xFF;
+}
+
+static void vdisk_mem_write(void *priv, uint32_t addr, uint8_t val)
+{
+	uint8_t *ptr;
+
+	addr &= 0xFFFFF;
+	if ((addr & 0xF0000) == 0x10000)
+		return;
+	ptr = bmmu_translate(addr, 1, 1);
+	if (ptr)
+		*ptr = val;
+}
+
 unsigned int cpu_read_byte_dasm(unsigned int addr)
 {
 	uint8_t *ptr = bmmu_translate(addr, 0, 0);
@@ -356,6 +403,8 @@ void system_process(void)
 		else
 			remove_irq(IRQ_16550A);
 	}
+	if (vdisk)
+		vdisk_irq();
 }
 
 static struct termios saved_term, term;
@@ -373,7 +422,7 @@ static void exit_cleanup(void)
 
 static void usage(void)
 {
-	fprintf(stderr, "rcbus-68008: [-1] [-A] [-a] [-b] [-f] [-R] [-r rompath] [-i disk] [-I disk] [-w] [-d debug]\n");
+	fprintf(stderr, "rcbus-68008: [-1] [-A] [-a] [-b] [-f] [-R] [-r rompath] [-i disk] [-I disk] [-V vdiskpath] [-w] [-d debug]\n");
 	exit(EXIT_FAILURE);
 }
 
@@ -384,11 +433,12 @@ int main(int argc, char *argv[])
 	int ppi = 0;
 	char *rompath = "rcbus-68000.rom";
 	char *idepath;
+	char *vdiskpath = NULL;
 	int has_rtc = 0;
 	int has_acia = 0;
 	int has_16550a = 0;
 
-	while ((opt = getopt(argc, argv, "1Aabd:fi:r:I:Rw")) != -1) {
+	while ((opt = getopt(argc, argv, "1Aabd:fi:r:I:RV:w")) != -1) {
 		switch (opt) {
 		case '1':
 			has_16550a = 1;
@@ -432,6 +482,9 @@ int main(int argc, char *argv[])
 		case 'b':
 			bmmu = 1;
 			break;
+		case 'V':
+			vdiskpath = optarg;
+			break;
 		default:
 			usage();
 		}
@@ -495,6 +548,12 @@ int main(int argc, char *argv[])
 		wiz = nic_w5100_alloc();
 		nic_w5100_reset(wiz);
 	}
+	if (vdiskpath) {
+		vdisk = vdisk_create(vdiskpath, vdisk_mem_read, vdisk_mem_write, NULL);
+		if (vdisk == NULL)
+			exit(1);
+		vdisk_trace(vdisk, !!(trace & TRACE_VDISK));
+	}
 	if (has_acia) {
 		acia = acia_create();
 		acia_attach(acia, &console);
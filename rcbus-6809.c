@@ -33,6 +33,7 @@
 #include "serialdevice.h"
 #include "ttycon.h"
 #include "16x50.h"
+#include "watch.h"
 #include "6821.h"
 #include "6840.h"
 #include "ppide.h"
@@ -208,12 +209,12 @@ void uart16x50_signal_change(struct uart16x50 *uart, uint8_t mcr)
 void m6840_output_change(struct m6840 *m, uint8_t outputs)
 {
 	static int old = 0;
-	if ((outputs ^ old) & 2) {
-		/* timer 2 high to low -> clock timer 3 */
-		if (!(outputs & 2))
-			m6840_external_clock(ptm, 3);
-	}
+	int fall = (old & ~outputs) & 2;
+	/* Update first as clocking timer 3 can call us again */
 	old = outputs;
+	/* timer 2 high to low -> clock timer 3 */
+	if (fall)
+		m6840_external_clock(ptm, 3);
 }
 
 static uint8_t m6809_do_inport(uint8_t addr)
@@ -250,6 +251,45 @@ uint8_t m6809_inport(uint8_t addr)
 	return r;
 }
 
+/* Point the CPU straight at the memory behind each page so it only calls
+   us for I/O, ROM writes, watched pages and when tracing memory. Redone
+   whenever the banking changes */
+static void remap(void)
+{
+	unsigned int page;
+	unsigned int addr;
+	uint8_t *p;
+	int ro;
+
+	for (page = 0; page < 256; page++) {
+		addr = page << 8;
+		if (page == 0xFE || (trace & TRACE_MEM) || watch_page(page)) {
+			e6809_map_page(page, NULL, NULL);
+			continue;
+		}
+		if (bankhigh) {
+			uint8_t reg = mmureg;
+			uint32_t higha;
+			if (addr < 0xE000)
+				reg >>= 1;
+			higha = (reg & 0x40) ? 1 : 0;
+			higha |= (reg & 0x10) ? 2 : 0;
+			higha |= (reg & 0x4) ? 4 : 0;
+			higha |= (reg & 0x01) ? 8 : 0;	/* ROM/RAM */
+			p = ramrom + (higha << 16) + addr;
+			ro = !(higha & 8);
+		} else if (bankenable) {
+			unsigned int bank = (addr & 0xC000) >> 14;
+			p = ramrom + (bankreg[bank] << 14) + (addr & 0x3FFF);
+			ro = bankreg[bank] < 32;
+		} else {
+			p = ramrom + addr;
+			ro = addr >= 32768 || bank512;
+		}
+		e6809_map_page(page, p, ro ? NULL : p);
+	}
+}
+
 void m6809_outport(uint8_t addr, uint8_t val)
 {
 	if (trace & TRACE_IO)
@@ -258,6 +298,7 @@ void m6809_outport(uint8_t addr, uint8_t val)
 		mmureg = val;
 		if (trace & TRACE_512)
 			fprintf(stderr, "MMUreg set to %02X\n", val);
+		remap();
 	}
 	else if (addr == 0x80)
 		fprintf(stderr, "[%02X] ", val);
@@ -280,15 +321,18 @@ void m6809_outport(uint8_t addr, uint8_t val)
 		bankreg[addr & 3] = val & 0x3F;
 		if (trace & TRACE_512)
 			fprintf(stderr, "Bank %d set to %d\n", addr & 3, val);
+		remap();
 	} else if (bank512 && addr >= 0x7C && addr <= 0x7F) {
 		if (trace & TRACE_512)
 			fprintf(stderr, "Banking %sabled.\n", (val & 1) ? "en" : "dis");
 		bankenable = val & 1;
+		remap();
 	} else if (addr == 0x0C && rtc)
 		rtc_write(rtcdev, val);
 	else if (addr == 0xFD) {
 		printf("trace set to %d\n", val);
 		trace = val;
+		remap();
 	} else if (trace & TRACE_UNK)
 		fprintf(stderr, "Unknown write to port %04X of %02X\n", addr, val);
 }
@@ -333,7 +377,9 @@ unsigned char do_e6809_read8(unsigned addr, unsigned debug)
 
 unsigned char e6809_read8(unsigned addr)
 {
-	return do_e6809_read8(addr, 0);
+	unsigned char r = do_e6809_read8(addr, 0);
+	watch_read(addr, r);
+	return r;
 }
 
 unsigned char e6809_read8_debug(unsigned addr)
@@ -343,6 +389,7 @@ unsigned char e6809_read8_debug(unsigned addr)
 
 void e6809_write8(unsigned addr, unsigned char val)
 {
+	watch_write(addr, val);
 	if (addr >> 8 == 0xFE) {
 		m6809_outport(addr & 0xFF, val);
 		return;
@@ -422,6 +469,15 @@ void e6809_instruction(unsigned pc)
 	}
 }
 
+static void watch_hit(unsigned action, uint32_t addr)
+{
+	fprintf(stderr, "watch: PC %04X\n", e6809_get_regs()->pc);
+	if (action == WATCH_STOP)
+		done = 1;
+	else if (action == WATCH_TRACE)
+		trace |= TRACE_CPU;
+}
+
 static struct termios saved_term, term;
 
 static void cleanup(int sig)
@@ -437,7 +493,7 @@ static void exit_cleanup(void)
 
 static void usage(void)
 {
-	fprintf(stderr, "rcbus-6809: [-b] [-f] [-R] [-i idepath] [-I ppidepath] [-S sdcardpath] [-r rompath] [-w] [-d debug]\n");
+	fprintf(stderr, "rcbus-6809: [-b] [-f] [-R] [-i idepath] [-I ppidepath] [-S sdcardpath] [-r rompath] [-w] [-d debug] [-X watch]\n");
 	exit(EXIT_FAILURE);
 }
 
@@ -452,7 +508,7 @@ int main(int argc, char *argv[])
 	char *sdpath = NULL;
 	unsigned int cycles = 0;
 
-	while ((opt = getopt(argc, argv, "1abBd:fi:I:r:RS:w")) != -1) {
+	while ((opt = getopt(argc, argv, "1abBd:fi:I:r:RS:wX:")) != -1) {
 		switch (opt) {
 		case 'r':
 			rompath = optarg;
@@ -490,12 +546,17 @@ int main(int argc, char *argv[])
 		case 'w':
 			wiznet = 1;
 			break;
+		case 'X':
+			if (watch_option(optarg))
+				usage();
+			break;
 		default:
 			usage();
 		}
 	}
 	if (optind < argc)
 		usage();
+	watch_set_hook(watch_hit);
 
 	if (rom == 0 && bank512 == 0 && bankhigh == 0) {
 		fprintf(stderr, "rcbus-6809: no ROM\n");
@@ -613,6 +674,7 @@ int main(int argc, char *argv[])
 		tcsetattr(0, TCSADRAIN, &term);
 	}
 
+	remap();
 	e6809_reset(trace & TRACE_CPU);
 
 	/* This is the wrong way to do it but it's easier for the moment. We
@@ -621,16 +683,31 @@ int main(int argc, char *argv[])
 	   is loaded though */
 
 	while (!done) {
-		unsigned int i, j;
+		unsigned int i, n, t, run;
 		/* 36400 T states for base rcbus - varies for others */
-		for (i = 0; i < 100; i++) {
-			while(cycles < clockrate)
-				cycles += e6809_sstep(live_irq, 0);
-			m6840_tick(ptm, cycles);
-			for (j = 0; j < cycles; j++)
-				m6840_external_clock(ptm, 2);
+		for (i = 0; i < 100 && !done; i++) {
+			/* Run up to each timer event so the interrupt is
+			   taken on time. Timer 2 is also clocked by E */
+			while (cycles < clockrate) {
+				n = clockrate - cycles;
+				t = m6840_next_event(ptm);
+				if (t && t < n)
+					n = t;
+				t = m6840_next_clock(ptm, 2);
+				if (t && t < n)
+					n = t;
+				if (trace & TRACE_CPU) {
+					run = 0;
+					while (run < n)
+						run += e6809_sstep(live_irq, 0);
+				} else
+					run = e6809_run(n, &live_irq, NULL);
+				m6840_tick(ptm, run);
+				m6840_external_clocks(ptm, 2, run);
+				cycles += run;
+				recalc_interrupts();
+			}
 			cycles -= clockrate;
-			recalc_interrupts();
 		}
 		/* Drive the  serial */
 		uart16x50_event(uart);
@@ -32,6 +32,8 @@
 #include "rtc_bitbang.h"
 #include "w5100.h"
 #include "sdcard.h"
+#include "serialdevice.h"
+#include "serlink.h"
 
 static uint8_t ramrom[1024 * 1024];	/* Covers the banked card */
 static uint8_t monitor[12288];		/* Monitor ROM - usually Buffalo */
@@ -166,9 +168,66 @@ void m6800_sci_change(struct m6800 *cpu)
 	fprintf(stderr, "[UART  %d baud]\n", baseclock);
 }
 
+/* The SCI goes to the console unless it is cabled to another emulator */
+static struct serial_device *sci_link;
+static uint64_t cycles_run;
+
+static uint64_t link_clock(void)
+{
+	return cycles_run;
+}
+
 void m6800_tx_byte(struct m6800 *cpu, uint8_t byte)
 {
-	write(1, &byte, 1);
+	if (sci_link)
+		sci_link->put(sci_link, byte);
+	else
+		write(1, &byte, 1);
+}
+
+/* Point the CPU straight at the memory behind each page so it only calls
+   us for I/O, ROM writes, protected pages and when tracing memory. Redone
+   whenever the banking or protection changes */
+static void remap(void)
+{
+	unsigned int page;
+	unsigned int addr;
+	uint8_t *p;
+	int ro;
+
+	for (page = 0; page < 256; page++) {
+		addr = page << 8;
+		if (page == 0xFE || (trace & TRACE_MEM)) {
+			m6800_map_page(&cpu, page, NULL, NULL);
+			continue;
+		}
+		if (bankhigh) {
+			uint8_t reg = mmureg;
+			uint32_t higha;
+			if (addr < 0xE000)
+				reg >>= 1;
+			higha = (reg & 0x40) ? 1 : 0;
+			higha |= (reg & 0x10) ? 2 : 0;
+			higha |= (reg & 0x4) ? 4 : 0;
+			higha |= (reg & 0x01) ? 8 : 0;	/* ROM/RAM */
+			p = ramrom + (higha << 16) + addr;
+			ro = !(higha & 8);
+		} else if (bankenable) {
+			unsigned int bank = (addr & 0xC000) >> 14;
+			p = ramrom + (bankreg[bank] << 14) + (addr & 0x3FFF);
+			ro = bankreg[bank] < 32;
+		} else if (bankflat) {
+			p = ramrom + flatahigh + addr;
+			ro = flatahigh < 0x80000;
+		} else {
+			p = ramrom + addr;
+			ro = addr >= 32768 || bank512;
+		}
+		/* Writes to protected pages are reported */
+		if (protlow && page >= protlow && page < prothi)
+			ro = 1;
+		m6800_map_page(&cpu, page, p, ro ? NULL : p);
+	}
 }
 
 static void flatarecalc(struct m6800 *cpu)
@@ -191,6 +250,7 @@ static void flatarecalc(struct m6800 *cpu)
 		flatahigh += 0x40000;
 	if (bits & 0x08)
 		flatahigh += 0x80000;
+	remap();
 }
 
 
@@ -289,6 +349,7 @@ void m6800_outport(uint8_t addr, uint8_t val)
 		mmureg = val;
 		if (trace & TRACE_512)
 			fprintf(stderr, "MMUreg set to %02X\n", val);
+		remap();
 	}
 	else if (addr == 0x80)
 		fprintf(stderr, "[%02X] ", val);
@@ -306,20 +367,25 @@ void m6800_outport(uint8_t addr, uint8_t val)
 		if (trace & TRACE_512)
 			fprintf(stderr, "Bank %d set to %02X [%02X, %02X %02X %02X]\n", addr & 3, val,
 				bankreg[0], bankreg[1], bankreg[2], bankreg[3]);
+		remap();
 	} else if (bank512 && addr >= 0x7C && addr <= 0x7F) {
 		if (trace & TRACE_512)
 			fprintf(stderr, "Banking %sabled.\n", (val & 1) ? "en" : "dis");
 		bankenable = val & 1;
+		remap();
 	} else if (addr == 0x0C && rtc)
 		rtc_write(rtcdev, val);
 	else if (addr == 0xFD) {
 		printf("trace set to %d\n", val);
 		trace = val;
-	} else if (addr == 0xFC)
+		remap();
+	} else if (addr == 0xFC) {
 		protlow = val;
-	else if (addr == 0xFB)
+		remap();
+	} else if (addr == 0xFB) {
 		prothi = val;
-	else if (trace & TRACE_UNK)
+		remap();
+	} else if (trace & TRACE_UNK)
 		fprintf(stderr, "Unknown write to port %04X of %02X\n", addr, val);
 }
 
@@ -459,7 +525,7 @@ static void exit_cleanup(void)
 
 static void usage(void)
 {
-	fprintf(stderr, "rcbus-68hc11: [-b] [-B] [-F] [-f] [-R] [-r rom] [-i idedisk] [-S sdcard] [-m monitor] [-w] [-d debug]\n");
+	fprintf(stderr, "rcbus-68hc11: [-b] [-B] [-F] [-f] [-R] [-r rom] [-i idedisk] [-S sdcard] [-m monitor] [-w] [-d debug] [-L link]\n");
 	exit(EXIT_FAILURE);
 }
 
@@ -475,7 +541,7 @@ int main(int argc, char *argv[])
 	char *sdpath = NULL;
 	unsigned int cycles = 0;
 
-	while ((opt = getopt(argc, argv, "1abBd:Ffi:I:r:RS:m:w")) != -1) {
+	while ((opt = getopt(argc, argv, "1abBd:Ffi:I:L:r:RS:m:w")) != -1) {
 		switch (opt) {
 		case 'r':
 			rompath = optarg;
@@ -509,6 +575,12 @@ int main(int argc, char *argv[])
 		case 'd':
 			trace = atoi(optarg);
 			break;
+		case 'L':
+			sci_link = serlink_open(optarg);
+			if (sci_link == NULL)
+				exit(1);
+			serlink_set_clock(link_clock, 7372800 / 4);
+			break;
 		case 'f':
 			fast = 1;
 			break;
@@ -654,6 +726,7 @@ int main(int argc, char *argv[])
 		m68hc11e_reset(&cpu, 9, 0x03, monitor, eerom);
 	else	/* 68HC11E0 for now */
 		m68hc11e_reset(&cpu, 0, 0, NULL, NULL);
+	remap();
 
 	if (trace & TRACE_CPU)
 		cpu.debug = 1;
@@ -669,14 +742,24 @@ int main(int argc, char *argv[])
 		/* 36400 T states for base rcbus - varies for others */
 		for (j = 0; j < 10; j++) {
 			for (i = 0; i < 10; i++) {
-				while(cycles < clockrate)
-					cycles += m68hc11_execute(&cpu);
+				if (cycles < clockrate) {
+					unsigned int n = m68hc11_run(&cpu, clockrate - cycles);
+					cycles += n;
+					cycles_run += n;
+				}
 				cycles -= clockrate;
 			}
 			/* Drive the internal serial */
-			i = check_chario();
-			if (i & 1)
-				m68hc11_rx_byte(&cpu, next_char());
+			if (sci_link) {
+				/* Leave bytes on the link until there is room */
+				i = sci_link->ready(sci_link);
+				if ((i & 1) && !(cpu.io.scsr & SCSR_RDRF))
+					m68hc11_rx_byte(&cpu, sci_link->get(sci_link));
+			} else {
+				i = check_chario();
+				if (i & 1)
+					m68hc11_rx_byte(&cpu, next_char());
+			}
 			if (i & 2)
 				m68hc11_tx_done(&cpu);
 		}
@@ -383,6 +383,10 @@ int main(int argc, char *argv[])
 	e86_set_mem(cpu, NULL, i808x_read8, i808x_write8, i808x_read16, i808x_write16);
 	e86_set_prt(cpu, NULL, i808x_in8, i808x_out8, i808x_in16, i808x_out16);
 	e86_set_ram(cpu, ramrom, sizeof(ramrom));
+	/* Decode directly from ramrom unless we are debugging the CPU, in
+	   which case keep the accurate prefetch queue */
+	if (!(trace & TRACE_CPU))
+		e86_set_options(cpu, E86_CPU_FAST_FETCH, 1);
 
 	/* Reset the CPU */	
 	e86_reset(cpu);
@@ -25,7 +25,9 @@
 #include "ppide.h"
 #include "rtc_bitbang.h"
 #include "tms9902.h"
+#include "serlink.h"
 #include "w5100.h"
+#include "tracebuf.h"
 
 static uint8_t ramrom[1024 * 1024];	/* Covers the banked card */
 
@@ -73,6 +75,8 @@ static volatile int done;
 #define TRACE_TMS9902	1024
 
 static int trace = 0;
+static struct tracebuf *tracebuf;
+static uint64_t cycles_total;		/* For the trace buffer */
 
 unsigned int check_chario(void)
 {
@@ -342,9 +346,26 @@ static void exit_cleanup(void)
 	tcsetattr(0, TCSADRAIN, &saved_term);
 }
 
+static void cpu_tracebuf(struct tms9995 *tms)
+{
+	struct tracebuf_rec *r = tracebuf_next(tracebuf, tms->PC_debug);
+	unsigned int i;
+
+	r->cycle = cycles_total + clockrate - tms->icount;
+	r->bank = bankreg[0] | (bankreg[1] << 8) | (bankreg[2] << 16) | (bankreg[3] << 24);
+	r->reg[0] = tms->WP;
+	r->reg[1] = tms->ST;
+	for (i = 0; i < 6; i++)
+		r->reg[i + 2] = tms9995_read_workspace_register_debug(tms, i);
+	for (i = 0; i < 6; i++)
+		r->op[i] = tms9995_readb_debug(tms, tms->PC_debug + i);
+	r->oplen = 6;
+	r->flags = 0;
+}
+
 static void usage(void)
 {
-	fprintf(stderr, "rcbus-tms9995-6809: [-b] [-f] [-R] [-i idepath] [-I ppidepath] [-r rompath] [-w] [-d debug]\n");
+	fprintf(stderr, "rcbus-tms9995-6809: [-b] [-f] [-R] [-i idepath] [-I ppidepath] [-r rompath] [-w] [-d debug] [-L link] [-t tracefile] [-x traceaddr]\n");
 	exit(EXIT_FAILURE);
 }
 
@@ -357,8 +378,11 @@ int main(int argc, char *argv[])
 	char *rompath = "rcbus-tms9995.rom";
 	char *idepath;
 	int tmsin = 0;
+	char *tracepath = NULL;
+	uint32_t tracetrig = TRACEBUF_NOTRIGGER;
+	struct serial_device *link = &console_wo;
 
-	while ((opt = getopt(argc, argv, "1abBd:fi:I:r:Rw")) != -1) {
+	while ((opt = getopt(argc, argv, "1abBd:fi:I:L:r:Rt:wx:")) != -1) {
 		switch (opt) {
 		case 'r':
 			rompath = optarg;
@@ -394,7 +418,17 @@ int main(int argc, char *argv[])
 			wiznet = 1;
 			break;
 		case 't':
-			tmsin = 1;
+			tracepath = optarg;
+			break;
+		case 'x':
+			tracetrig = strtoul(optarg, NULL, 16);
+			break;
+		case 'L':
+			/* The clock rate is not yet right so the link is not
+			   paced. serlink warns if a baud rate is given */
+			link = serlink_open(optarg);
+			if (link == NULL)
+				exit(1);
 			break;
 		default:
 			usage();
@@ -466,11 +500,11 @@ int main(int argc, char *argv[])
 
 	uart = uart16x50_create();
 	uart16x50_trace(uart, trace & TRACE_UART);
-	uart16x50_attach(uart, tmsin ? &console_wo: &console);
+	uart16x50_attach(uart, tmsin ? link : &console);
 
 	tmsser = tms9902_create();
 	tms9902_trace(tmsser, trace & TRACE_TMS9902);
-	tms9902_attach(tmsser, tmsin ? &console : &console_wo);
+	tms9902_attach(tmsser, tmsin ? &console : link);
 
 	if (wiznet) {
 		wiz = nic_w5100_alloc();
@@ -507,10 +541,17 @@ int main(int argc, char *argv[])
 	/* B step 9995 */
 	tms = tms9995_create(false, true);
 	tms9995_trace(tms, trace & TRACE_CPU);
+	/* Whole instruction execution when not tracing */
+	tms9995_fast(tms, true);
 	tms9995_ready_line(tms, true);
 	tms9995_reset_line(tms, true);
 	tms9995_reset_line(tms, false);
 	tms9995_hold_line(tms, false);
+	if (tracepath) {
+		tracebuf = tracebuf_create(tracepath, TRACEBUF_TMS9995, 262144);
+		tracebuf_trigger(tracebuf, tracetrig);
+		tms9995_hook(tms, cpu_tracebuf);
+	}
 
 	/* This is the wrong way to do it but it's easier for the moment. We
 	   should track how much real time has occurred and try to keep cycle
@@ -521,6 +562,7 @@ int main(int argc, char *argv[])
 		unsigned int i;
 		for (i = 0; i < 100; i++) {
 			tms9995_execute_run(tms, clockrate);
+			cycles_total += clockrate;
 			recalc_interrupts();
 			tms9995_execute_set_input(tms, INT_9995_INT1, !!live_irq);
 		}
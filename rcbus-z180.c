@@ -38,7 +38,9 @@
 #include "sdcard.h"
 #include "tms9918a.h"
 #include "tms9918a_render.h"
+#include "vdisk.h"
 #include "w5100.h"
+#include "wallclock.h"
 #include "z80dis.h"
 #include "zxkey.h"
 
@@ -70,6 +72,7 @@ static struct z180_io *io;
 static struct acia *acia;
 static struct uart16x50 *uart;
 static struct piratespi *pspi;
+static struct vdisk *vdisk;
 static unsigned int pspi_cs = 0;
 
 static uint16_t tstate_steps = 737;	/* 18.432MHz */
@@ -99,10 +102,13 @@ volatile int emulator_done;
 #define TRACE_ACIA	0x002000
 #define TRACE_512	0x004000
 #define TRACE_UART	0x008000
+#define TRACE_VDISK	0x010000
 
 static int trace = 0;
+static int jit;
 
 static void reti_event(void);
+static void poll_irq_event(void);
 
 /*
  *	Model the bank registers on the paged memory
@@ -150,6 +156,20 @@ void z180_phys_write(int unused, uint32_t addr, uint8_t val)
 		fprintf(stderr, "[%06X: write to ROM from %04X.]\n", addr, cpu_z180.M1PC);
 }
 
+/*
+ *	The paravirtual disk is a bus master so like the DMA engines
+ *	it works with physical addresses
+ */
+static uint8_t vdisk_mem_read(void *priv, uint32_t addr)
+{
+	return z180_phys_read(0, addr);
+}
+
+static void vdisk_mem_write(void *priv, uint32_t addr, uint8_t val)
+{
+	z180_phys_write(0, addr, val);
+}
+
 /*
  *	Model CPU accesses starting with a virtual address
  */
@@ -175,6 +195,26 @@ static void mem_write0(uint16_t addr, uint8_t val)
 	z180_phys_write(0, pa, val);
 }
 
+/*
+ *	Host memory for the block translator. The MMU and bank registers
+ *	are only changed by I/O, which always ends a block.
+ */
+static uint8_t *code_map(int unused, uint16_t addr)
+{
+	uint32_t pa = z180_mmu_translate(io, addr);
+
+	if (trace & TRACE_MEM)
+		return NULL;
+	if (banked)
+		pa = bank_translate(bank_translate(pa));
+	if (mem_map == 1) {
+		pa &= 0x7FFFF;
+		if (pa & 0x40000)
+			pa &= 0x5FFFF;
+	}
+	return ramrom + (pa & 0xFFFFF);
+}
+
 uint8_t mem_read(int unused, uint16_t addr)
 {
 	static uint8_t rstate = 0;
@@ -513,6 +553,12 @@ static uint8_t io_read_2014(uint16_t addr)
 		return rtc_read(rtc);
 	if ((addr == 0x98 || addr == 0x99) && vdp)
 		return tms9918a_read(vdp, addr & 1);
+	if (addr >= 0xD0 && addr <= 0xD7 && vdisk) {
+		/* Reading the status clears the interrupt */
+		uint8_t r = vdisk_read(vdisk, addr & 7);
+		poll_irq_event();
+		return r;
+	}
 	if (trace & TRACE_UNK)
 		fprintf(stderr, "Unknown read from port %04X\n", addr);
 	return 0xFF;
@@ -544,7 +590,10 @@ static void io_write_2014(uint16_t addr, uint8_t val, uint8_t known)
 		ppide_write(ppide, addr & 3, val);
 	else if (addr >= 0x28 && addr <= 0x2C && wiznet)
 		nic_w5100_write(wiz, addr & 3, val);
-	else if (addr == 0x0C) {
+	else if (addr >= 0xD0 && addr <= 0xD7 && vdisk) {
+		vdisk_write(vdisk, addr & 7, val);
+		poll_irq_event();
+	} else if (addr == 0x0C) {
 		if (rtc)
 			rtc_write(rtc, val);
 		sysio_write(val);
@@ -588,11 +637,7 @@ static void bqrtc_write(uint16_t addr, uint8_t val)
 
 static uint8_t bqrtc_read(uint16_t addr)
 {
-	time_t t;
-	struct tm *tm;
-
-	time(&t);
-	tm = gmtime(&t);
+	struct tm *tm = wallclock_gmtime();
 
 	switch(addr & 0x0F) {
 	case 0:
@@ -740,6 +785,8 @@ static void poll_irq_event(void)
 		z180_interrupt(io, 0, 0xFF, 1);
 	else if (vdp && tms9918a_irq_pending(vdp))
 		z180_interrupt(io, 0, 0xFF, 1);
+	else if (vdisk && vdisk_irq_pending(vdisk))
+		z180_interrupt(io, 0, 0xFF, 1);
 	else
 		z180_interrupt(io, 0, 0, 0);
 }
@@ -767,7 +814,7 @@ static void exit_cleanup(void)
 
 static void usage(void)
 {
-	fprintf(stderr, "rcbus-z180: [-a] [-b] [-f] [-i idepath] [-P buspirate] [-R] [-r rompath] [-w] [-d debug]\n");
+	fprintf(stderr, "rcbus-z180: [-a] [-b] [-f] [-i idepath] [-P buspirate] [-O] [-R] [-r rompath] [-V vdiskpath] [-w] [-d debug]\n");
 	exit(EXIT_FAILURE);
 }
 
@@ -781,13 +828,14 @@ int main(int argc, char *argv[])
 	char *idepath = NULL;
 	char *patha = NULL, *pathb = NULL;
 	char *piratepath = NULL;
+	char *vdiskpath = NULL;
 	int input = 0;
 
 	uint8_t *p = ramrom;
 	while (p < ramrom + sizeof(ramrom))
 		*p++= rand();
 
-	while ((opt = getopt(argc, argv, "1acd:fF:i:I:lm:r:sP:RS:Twzb")) != -1) {
+	while ((opt = getopt(argc, argv, "1acd:fF:i:I:lm:Or:sP:RS:TV:wzb")) != -1) {
 		switch (opt) {
 		case 'r':
 			rompath = optarg;
@@ -846,6 +894,9 @@ int main(int argc, char *argv[])
 		case 'f':
 			fast = 1;
 			break;
+		case 'O':
+			jit = 1;
+			break;
 		case 'P':
 			piratepath = optarg;
 			break;
@@ -880,6 +931,9 @@ int main(int argc, char *argv[])
 		case 'T':
 			has_tms = 1;
 			break;
+		case 'V':
+			vdiskpath = optarg;
+			break;
 		default:
 			usage();
 		}
@@ -1007,6 +1061,13 @@ int main(int argc, char *argv[])
 	if (piratepath)
 		pspi = piratespi_create(piratepath);
 
+	if (vdiskpath) {
+		vdisk = vdisk_create(vdiskpath, vdisk_mem_read, vdisk_mem_write, NULL);
+		if (vdisk == NULL)
+			exit(1);
+		vdisk_trace(vdisk, !!(trace & TRACE_VDISK));
+	}
+
 	/* 20ms - it's a balance between nice behaviour and simulation
 	   smoothness */
 	tc.tv_sec = 0;
@@ -1033,6 +1094,10 @@ int main(int argc, char *argv[])
 	cpu_z180.memRead = mem_read;
 	cpu_z180.memWrite = mem_write;
 	cpu_z180.trace = rcbus_trace;
+	if (jit && Z180JitEnable(&cpu_z180, code_map)) {
+		fprintf(stderr, "rcbus-z180: -O is not supported on this host.\n");
+		jit = 0;
+	}
 
 	/* We don't have a GPIO control pin on the SC126, but we do have
 	   devices that need to be wired to \RESET so emulate that with
@@ -1056,6 +1121,9 @@ int main(int argc, char *argv[])
 		/* Do an emulated 20ms of work (368640 clocks) */
 		for (i = 0; i < 50; i++) {
 			for (j = 0; j < 10; j++) {
+				/* Translated code only runs with no trace hook */
+				if (jit)
+					cpu_z180.trace = (trace & TRACE_CPU) ? rcbus_trace : NULL;
 				while (states < tstate_steps) {
 					unsigned int used;
 					used = z180_dma(io);
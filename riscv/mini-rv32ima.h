@@ -110,6 +110,181 @@ MINIRV32_DECORATE int32_t MiniRV32IMAStep( struct MiniRV32IMAState * state, uint
 #define REG( x ) state->regs[x]
 #define REGSET( x, val ) { state->regs[x] = val; }
 
+// Instructions are split up into their fields once and then executed from
+// this form.  With MINIRV32_DECODE_CACHE defined the decoded form is kept in
+// a direct mapped cache keyed by PC so hot code is only decoded once.
+//
+// Each cache entry records the generation of the code page it came from.
+// Any store to RAM bumps the generation of the page it hits which retires
+// every entry decoded from that page.  The page table is hashed so it is
+// a fixed size whatever the RAM size; a collision just causes a spurious
+// re-decode.  If the memory bus aliases RAM at several addresses then
+// define MINIRV32_CODE_PAGE to fold them together.
+
+enum
+{
+	RV_LUI, RV_AUIPC, RV_JAL, RV_JALR,
+	RV_BEQ, RV_BNE, RV_BLT, RV_BGE, RV_BLTU, RV_BGEU,
+	RV_LOAD, RV_STORE,
+	RV_ADDI, RV_SLLI, RV_SLTI, RV_SLTIU, RV_XORI, RV_SRLI, RV_SRAI, RV_ORI, RV_ANDI,
+	RV_ADD, RV_SUB, RV_SLL, RV_SLT, RV_SLTU, RV_XOR, RV_SRL, RV_SRA, RV_OR, RV_AND,
+	RV_MUL, RV_MULH, RV_MULHSU, RV_MULHU, RV_DIV, RV_DIVU, RV_REM, RV_REMU,
+	RV_FENCE, RV_CSR, RV_WFI, RV_MRET, RV_ECALL, RV_EBREAK, RV_AMO,
+	RV_ILLEGAL
+};
+
+struct MiniRV32IMADecoded
+{
+	uint32_t tag;	// ofs_pc | 1 when valid
+	uint32_t gen;	// Code page generation when decoded
+	uint32_t ir;
+	uint32_t imm;	// Sign extended immediate or CSR number
+	uint8_t op;
+	uint8_t rd;	// 0 for instructions that do not write back
+	uint8_t rs1;	// Also the CSR immediate
+	uint8_t rs2;
+	uint8_t funct;	// Width for load/store, CSR microop, AMO function
+};
+
+#ifdef MINIRV32_DECODE_CACHE
+
+#ifndef MINIRV32_CACHE_SIZE
+	#define MINIRV32_CACHE_SIZE	16384
+#endif
+
+#ifndef MINIRV32_CACHE_PAGES
+	#define MINIRV32_CACHE_PAGES	4096
+#endif
+
+#ifndef MINIRV32_CODE_PAGE
+	#define MINIRV32_CODE_PAGE( ofs ) ( ( ofs ) >> 8 )
+#endif
+
+static struct MiniRV32IMADecoded minirv32_cache[MINIRV32_CACHE_SIZE];
+static uint32_t minirv32_page_gen[MINIRV32_CACHE_PAGES];
+
+#define MINIRV32_PAGE_GEN( ofs ) minirv32_page_gen[MINIRV32_CODE_PAGE( ofs ) & ( MINIRV32_CACHE_PAGES - 1 )]
+#define MINIRV32_CODE_WRITTEN( ofs ) MINIRV32_PAGE_GEN( ofs )++
+
+#else
+	#define MINIRV32_CODE_WRITTEN( ofs )
+#endif
+
+static void MiniRV32IMADecode( struct MiniRV32IMADecoded * d, uint32_t ir )
+{
+	uint32_t funct3 = ( ir >> 12 ) & 0x7;
+	uint32_t imm = ir >> 20;
+
+	d->ir = ir;
+	d->rd = (ir >> 7) & 0x1f;
+	d->rs1 = (ir >> 15) & 0x1f;
+	d->rs2 = (ir >> 20) & 0x1f;
+	d->op = RV_ILLEGAL;
+
+	switch( ir & 0x7f )
+	{
+		case 0b0110111: // LUI
+			d->op = RV_LUI;
+			d->imm = ir & 0xfffff000;
+			break;
+		case 0b0010111: // AUIPC
+			d->op = RV_AUIPC;
+			d->imm = ir & 0xfffff000;
+			break;
+		case 0b1101111: // JAL
+		{
+			int32_t reladdy = ((ir & 0x80000000)>>11) | ((ir & 0x7fe00000)>>20) | ((ir & 0x00100000)>>9) | ((ir&0x000ff000));
+			if( reladdy & 0x00100000 ) reladdy |= 0xffe00000; // Sign extension.
+			d->op = RV_JAL;
+			d->imm = reladdy;
+			break;
+		}
+		case 0b1100111: // JALR
+			d->op = RV_JALR;
+			d->imm = imm | (( imm & 0x800 )?0xfffff000:0);
+			break;
+		case 0b1100011: // Branch
+		{
+			uint32_t immm4 = ((ir & 0xf00)>>7) | ((ir & 0x7e000000)>>20) | ((ir & 0x80) << 4) | ((ir >> 31)<<12);
+			if( immm4 & 0x1000 ) immm4 |= 0xffffe000;
+			static const uint8_t bops[8] = { RV_BEQ, RV_BNE, RV_ILLEGAL, RV_ILLEGAL, RV_BLT, RV_BGE, RV_BLTU, RV_BGEU };
+			d->op = bops[funct3];
+			d->imm = immm4;
+			d->rd = 0;
+			break;
+		}
+		case 0b0000011: // Load
+			d->op = RV_LOAD;
+			d->imm = imm | (( imm & 0x800 )?0xfffff000:0);
+			d->funct = funct3;
+			break;
+		case 0b0100011: // Store
+		{
+			uint32_t addy = ( ( ir >> 7 ) & 0x1f ) | ( ( ir & 0xfe000000 ) >> 20 );
+			if( addy & 0x800 ) addy |= 0xfffff000;
+			d->op = RV_STORE;
+			d->imm = addy;
+			d->funct = funct3;
+			d->rd = 0;
+			break;
+		}
+		case 0b0010011: // Op-immediate
+		{
+			static const uint8_t iops[8] = { RV_ADDI, RV_SLLI, RV_SLTI, RV_SLTIU, RV_XORI, RV_SRLI, RV_ORI, RV_ANDI };
+			d->op = iops[funct3];
+			if( funct3 == 0b101 && ( ir & 0x40000000 ) )
+				d->op = RV_SRAI;
+			d->imm = imm | (( imm & 0x800 )?0xfffff000:0);
+			break;
+		}
+		case 0b0110011: // Op
+		{
+			static const uint8_t rops[8] = { RV_ADD, RV_SLL, RV_SLT, RV_SLTU, RV_XOR, RV_SRL, RV_OR, RV_AND };
+			if( ir & 0x02000000 ) // RV32M
+				d->op = RV_MUL + funct3;
+			else
+			{
+				d->op = rops[funct3];
+				if( ir & 0x40000000 )
+				{
+					if( funct3 == 0b000 ) d->op = RV_SUB;
+					if( funct3 == 0b101 ) d->op = RV_SRA;
+				}
+			}
+			break;
+		}
+		case 0b0001111:
+			d->op = RV_FENCE;
+			d->rd = 0;   // fencetype = (ir >> 12) & 0b111; We ignore fences in this impl.
+			break;
+		case 0b1110011: // Zifencei+Zicsr
+			d->imm = imm;
+			if( funct3 & 3 ) // It's a Zicsr function.
+			{
+				d->op = RV_CSR;
+				d->funct = funct3;
+			}
+			else if( funct3 == 0b000 ) // "SYSTEM"
+			{
+				d->rd = 0;
+				if( imm == 0x105 ) //WFI (Wait for interrupts)
+					d->op = RV_WFI;
+				else if( ( ( imm & 0xff ) == 0x02 ) )  // MRET
+					d->op = RV_MRET;
+				else if( imm == 0 )
+					d->op = RV_ECALL;
+				else if( imm == 1 )
+					d->op = RV_EBREAK;
+			}
+			// Note micrrop 0b100 == undefined.
+			break;
+		case 0b0101111: // RV32A
+			d->op = RV_AMO;
+			d->funct = ( ir>>27 ) & 0x1f;
+			break;
+	}
+}
+
 MINIRV32_DECORATE int32_t MiniRV32IMAStep( struct MiniRV32IMAState * state, uint8_t * image, uint32_t vProcAddress, uint32_t elapsedUs, int count )
 {
 	uint32_t new_timer = CSR( timerl ) + elapsedUs;
@@ -150,62 +325,50 @@ MINIRV32_DECORATE int32_t MiniRV32IMAStep( struct MiniRV32IMAState * state, uint
 			trap = 1 + 0;  //Handle PC-misaligned access
 		else
 		{
-			ir = MINIRV32_LOAD4( ofs_pc );
-			uint32_t rdid = (ir >> 7) & 0x1f;
+#ifdef MINIRV32_DECODE_CACHE
+			struct MiniRV32IMADecoded * d = &minirv32_cache[( ofs_pc >> 2 ) & ( MINIRV32_CACHE_SIZE - 1 )];
+			uint32_t gen = MINIRV32_PAGE_GEN( ofs_pc );
+			if( d->tag != ( ofs_pc | 1 ) || d->gen != gen )
+			{
+				MiniRV32IMADecode( d, MINIRV32_LOAD4( ofs_pc ) );
+				// Don't remember a fetch the bus faulted
+				d->tag = trap ? 0 : ( ofs_pc | 1 );
+				d->gen = gen;
+			}
+#else
+			struct MiniRV32IMADecoded dec, * d = &dec;
+			MiniRV32IMADecode( d, MINIRV32_LOAD4( ofs_pc ) );
+#endif
+			ir = d->ir;
+			uint32_t rdid = d->rd;
+			uint32_t rs1 = REG( d->rs1 );
+			uint32_t rs2 = REG( d->rs2 );
+			uint32_t imm = d->imm;
 
 			disassemble(ir, ofs_pc);
 
-			switch( ir & 0x7f )
+			switch( d->op )
 			{
-				case 0b0110111: // LUI
-					rval = ( ir & 0xfffff000 );
-					break;
-				case 0b0010111: // AUIPC
-					rval = pc + ( ir & 0xfffff000 );
-					break;
-				case 0b1101111: // JAL
-				{
-					int32_t reladdy = ((ir & 0x80000000)>>11) | ((ir & 0x7fe00000)>>20) | ((ir & 0x00100000)>>9) | ((ir&0x000ff000));
-					if( reladdy & 0x00100000 ) reladdy |= 0xffe00000; // Sign extension.
+				case RV_LUI: rval = imm; break;
+				case RV_AUIPC: rval = pc + imm; break;
+				case RV_JAL:
 					rval = pc + 4;
-					pc = pc + reladdy - 4;
+					pc = pc + imm - 4;
 					break;
-				}
-				case 0b1100111: // JALR
-				{
-					uint32_t imm = ir >> 20;
-					int32_t imm_se = imm | (( imm & 0x800 )?0xfffff000:0);
+				case RV_JALR:
 					rval = pc + 4;
-					pc = ( (REG( (ir >> 15) & 0x1f ) + imm_se) & ~1) - 4;
-					break;
-				}
-				case 0b1100011: // Branch
-				{
-					uint32_t immm4 = ((ir & 0xf00)>>7) | ((ir & 0x7e000000)>>20) | ((ir & 0x80) << 4) | ((ir >> 31)<<12);
-					if( immm4 & 0x1000 ) immm4 |= 0xffffe000;
-					int32_t rs1 = REG((ir >> 15) & 0x1f);
-					int32_t rs2 = REG((ir >> 20) & 0x1f);
-					immm4 = pc + immm4 - 4;
-					rdid = 0;
-					switch( ( ir >> 12 ) & 0x7 )
-					{
-						// BEQ, BNE, BLT, BGE, BLTU, BGEU
-						case 0b000: if( rs1 == rs2 ) pc = immm4; break;
-						case 0b001: if( rs1 != rs2 ) pc = immm4; break;
-						case 0b100: if( rs1 < rs2 ) pc = immm4; break;
-						case 0b101: if( rs1 >= rs2 ) pc = immm4; break; //BGE
-						case 0b110: if( (uint32_t)rs1 < (uint32_t)rs2 ) pc = immm4; break;   //BLTU
-						case 0b111: if( (uint32_t)rs1 >= (uint32_t)rs2 ) pc = immm4; break;  //BGEU
-						default: trap = (2+1);
-					}
+					pc = ( (rs1 + imm) & ~1) - 4;
 					break;
-				}
-				case 0b0000011: // Load
+				// BEQ, BNE, BLT, BGE, BLTU, BGEU
+				case RV_BEQ: if( rs1 == rs2 ) pc = pc + imm - 4; break;
+				case RV_BNE: if( rs1 != rs2 ) pc = pc + imm - 4; break;
+				case RV_BLT: if( (int32_t)rs1 < (int32_t)rs2 ) pc = pc + imm - 4; break;
+				case RV_BGE: if( (int32_t)rs1 >= (int32_t)rs2 ) pc = pc + imm - 4; break;
+				case RV_BLTU: if( rs1 < rs2 ) pc = pc + imm - 4; break;
+				case RV_BGEU: if( rs1 >= rs2 ) pc = pc + imm - 4; break;
+				case RV_LOAD:
 				{
-					uint32_t rs1 = REG((ir >> 15) & 0x1f);
-					uint32_t imm = ir >> 20;
-					int32_t imm_se = imm | (( imm & 0x800 )?0xfffff000:0);
-					uint32_t rsval = rs1 + imm_se;
+					uint32_t rsval = rs1 + imm;
 
 					rsval -= MINIRV32_RAM_IMAGE_OFFSET;
 					if(rsval >= MINI_RV32_RAM_SIZE-3 )
@@ -228,7 +391,7 @@ MINIRV32_DECORATE int32_t MiniRV32IMAStep( struct MiniRV32IMAState * state, uint
 					}
 					else
 					{
-						switch( ( ir >> 12 ) & 0x7 )
+						switch( d->funct )
 						{
 							//LB, LH, LW, LBU, LHU
 							case 0b000: rval = (int8_t)MINIRV32_LOAD1( rsval ); break;
@@ -241,21 +404,16 @@ MINIRV32_DECORATE int32_t MiniRV32IMAStep( struct MiniRV32IMAState * state, uint
 					}
 					break;
 				}
-				case 0b0100011: // Store
+				case RV_STORE:
 				{
-					uint32_t rs1 = REG((ir >> 15) & 0x1f);
-					uint32_t rs2 = REG((ir >> 20) & 0x1f);
-					uint32_t addy = ( ( ir >> 7 ) & 0x1f ) | ( ( ir & 0xfe000000 ) >> 20 );
-					if( addy & 0x800 ) addy |= 0xfffff000;
-					addy += rs1 - MINIRV32_RAM_IMAGE_OFFSET;
-					rdid = 0;
+					uint32_t addy = imm + rs1 - MINIRV32_RAM_IMAGE_OFFSET;
 
 					if( addy >= MINI_RV32_RAM_SIZE-3 )
 					{
 						addy += MINIRV32_RAM_IMAGE_OFFSET;
 						if( addy >= MINIRV32_IO_OFFSET && addy < MINIRV32_IO_OFFSET + MINIRV32_IO_SIZE)
 						{
-							// Should be stuff like SYSCON, 8250, CLNT                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                  
+							// Should be stuff like SYSCON, 8250, CLNT
 							if( addy == 0x11004004 ) //CLNT
 								CSR( timermatchh ) = rs2;
 							else if( addy == 0x11004000 ) //CLNT
@@ -276,7 +434,7 @@ MINIRV32_DECORATE int32_t MiniRV32IMAStep( struct MiniRV32IMAState * state, uint
 					}
 					else
 					{
-						switch( ( ir >> 12 ) & 0x7 )
+						switch( d->funct )
 						{
 							//SB, SH, SW
 							case 0b000: MINIRV32_STORE1( addy, rs2 ); break;
@@ -284,158 +442,126 @@ MINIRV32_DECORATE int32_t MiniRV32IMAStep( struct MiniRV32IMAState * state, uint
 							case 0b010: MINIRV32_STORE4( addy, rs2 ); break;
 							default: trap = (2+1);
 						}
+						MINIRV32_CODE_WRITTEN( addy );
 					}
 					break;
 				}
-				case 0b0010011: // Op-immediate
-				case 0b0110011: // Op
+				case RV_ADDI: rval = rs1 + imm; break;
+				case RV_SLLI: rval = rs1 << (imm & 0x1F); break;
+				case RV_SLTI: rval = (int32_t)rs1 < (int32_t)imm; break;
+				case RV_SLTIU: rval = rs1 < imm; break;
+				case RV_XORI: rval = rs1 ^ imm; break;
+				case RV_SRLI: rval = rs1 >> (imm & 0x1F); break;
+				case RV_SRAI: rval = ((int32_t)rs1) >> (imm & 0x1F); break;
+				case RV_ORI: rval = rs1 | imm; break;
+				case RV_ANDI: rval = rs1 & imm; break;
+				case RV_ADD: rval = rs1 + rs2; break;
+				case RV_SUB: rval = rs1 - rs2; break;
+				case RV_SLL: rval = rs1 << (rs2 & 0x1F); break;
+				case RV_SLT: rval = (int32_t)rs1 < (int32_t)rs2; break;
+				case RV_SLTU: rval = rs1 < rs2; break;
+				case RV_XOR: rval = rs1 ^ rs2; break;
+				case RV_SRL: rval = rs1 >> (rs2 & 0x1F); break;
+				case RV_SRA: rval = ((int32_t)rs1) >> (rs2 & 0x1F); break;
+				case RV_OR: rval = rs1 | rs2; break;
+				case RV_AND: rval = rs1 & rs2; break;
+				case RV_MUL: rval = rs1 * rs2; break; // MUL
+				case RV_MULH: rval = ((int64_t)((int32_t)rs1) * (int64_t)((int32_t)rs2)) >> 32; break; // MULH
+				case RV_MULHSU: rval = ((int64_t)((int32_t)rs1) * (uint64_t)rs2) >> 32; break; // MULHSU
+				case RV_MULHU: rval = ((uint64_t)rs1 * (uint64_t)rs2) >> 32; break; // MULHU
+				case RV_DIV: if( rs2 == 0 ) rval = -1; else rval = ((int32_t)rs1 == INT32_MIN && (int32_t)rs2 == -1) ? rs1 : ((int32_t)rs1 / (int32_t)rs2); break; // DIV
+				case RV_DIVU: if( rs2 == 0 ) rval = 0xffffffff; else rval = rs1 / rs2; break; // DIVU
+				case RV_REM: if( rs2 == 0 ) rval = rs1; else rval = ((int32_t)rs1 == INT32_MIN && (int32_t)rs2 == -1) ? 0 : ((uint32_t)((int32_t)rs1 % (int32_t)rs2)); break; // REM
+				case RV_REMU: if( rs2 == 0 ) rval = rs1; else rval = rs1 % rs2; break; // REMU
+				case RV_FENCE:
+					break;
+				case RV_CSR:
 				{
-					uint32_t imm = ir >> 20;
-					imm = imm | (( imm & 0x800 )?0xfffff000:0);
-					uint32_t rs1 = REG((ir >> 15) & 0x1f);
-					uint32_t is_reg = !!( ir & 0b100000 );
-					uint32_t rs2 = is_reg ? REG(imm & 0x1f) : imm;
+					uint32_t csrno = imm;
+					int microop = d->funct;
+					int rs1imm = d->rs1;
+					uint32_t writeval = rs1;
+
+					// https://raw.githubusercontent.com/riscv/virtual-memory/main/specs/663-Svpbmt.pdf
+					// Generally, support for Zicsr
+					switch( csrno )
+					{
+					case 0x340: rval = CSR( mscratch ); break;
+					case 0x305: rval = CSR( mtvec ); break;
+					case 0x304: rval = CSR( mie ); break;
+					case 0xC00: rval = CSR( cyclel ); break;
+					case 0x344: rval = CSR( mip ); break;
+					case 0x341: rval = CSR( mepc ); break;
+					case 0x300: rval = CSR( mstatus ); break; //mstatus
+					case 0x342: rval = CSR( mcause ); break;
+					case 0x343: rval = CSR( mtval ); break;
+					case 0xf11: rval = 0xff0ff0ff; break; //mvendorid
+					case 0x301: rval = 0x40401101; break; //misa (XLEN=32, IMA+X)
+					//case 0x3B0: rval = 0; break; //pmpaddr0
+					//case 0x3a0: rval = 0; break; //pmpcfg0
+					//case 0xf12: rval = 0x00000000; break; //marchid
+					//case 0xf13: rval = 0x00000000; break; //mimpid
+					//case 0xf14: rval = 0x00000000; break; //mhartid
+					default:
+						MINIRV32_OTHERCSR_READ( csrno, rval );
+						break;
+					}
 
-					if( is_reg && ( ir & 0x02000000 ) )
+					switch( microop )
 					{
-						switch( (ir>>12)&7 ) //0x02000000 = RV32M
-						{
-							case 0b000: rval = rs1 * rs2; break; // MUL
-							case 0b001: rval = ((int64_t)((int32_t)rs1) * (int64_t)((int32_t)rs2)) >> 32; break; // MULH
-							case 0b010: rval = ((int64_t)((int32_t)rs1) * (uint64_t)rs2) >> 32; break; // MULHSU
-							case 0b011: rval = ((uint64_t)rs1 * (uint64_t)rs2) >> 32; break; // MULHU
-							case 0b100: if( rs2 == 0 ) rval = -1; else rval = ((int32_t)rs1 == INT32_MIN && (int32_t)rs2 == -1) ? rs1 : ((int32_t)rs1 / (int32_t)rs2); break; // DIV
-              case 0b101: if( rs2 == 0 ) rval = 0xffffffff; else rval = rs1 / rs2; break; // DIVU
-              case 0b110: if( rs2 == 0 ) rval = rs1; else rval = ((int32_t)rs1 == INT32_MIN && (int32_t)rs2 == -1) ? 0 : ((uint32_t)((int32_t)rs1 % (int32_t)rs2)); break; // REM
-							case 0b111: if( rs2 == 0 ) rval = rs1; else rval = rs1 % rs2; break; // REMU
-						}
+						case 0b001: writeval = rs1; break;  			//CSRRW
+						case 0b010: writeval = rval | rs1; break;		//CSRRS
+						case 0b011: writeval = rval & ~rs1; break;		//CSRRC
+						case 0b101: writeval = rs1imm; break;			//CSRRWI
+						case 0b110: writeval = rval | rs1imm; break;	//CSRRSI
+						case 0b111: writeval = rval & ~rs1imm; break;	//CSRRCI
 					}
-					else
+
+					switch( csrno )
 					{
-						switch( (ir>>12)&7 ) // These could be either op-immediate or op commands.  Be careful.
-						{
-							case 0b000: rval = (is_reg && (ir & 0x40000000) ) ? ( rs1 - rs2 ) : ( rs1 + rs2 ); break;
-							case 0b001: rval = rs1 << (rs2 & 0x1F); break;
-							case 0b010: rval = (int32_t)rs1 < (int32_t)rs2; break;
-							case 0b011: rval = rs1 < rs2; break;
-							case 0b100: rval = rs1 ^ rs2; break;
-							case 0b101: rval = (ir & 0x40000000 ) ? ( ((int32_t)rs1) >> (rs2 & 0x1F) ) : ( rs1 >> (rs2 & 0x1F) ); break;
-							case 0b110: rval = rs1 | rs2; break;
-							case 0b111: rval = rs1 & rs2; break;
-						}
+					case 0x340: SETCSR( mscratch, writeval ); break;
+					case 0x305: SETCSR( mtvec, writeval ); break;
+					case 0x304: SETCSR( mie, writeval ); break;
+					case 0x344: SETCSR( mip, writeval ); break;
+					case 0x341: SETCSR( mepc, writeval ); break;
+					case 0x300: SETCSR( mstatus, writeval ); break; //mstatus
+					case 0x342: SETCSR( mcause, writeval ); break;
+					case 0x343: SETCSR( mtval, writeval ); break;
+					//case 0x3a0: break; //pmpcfg0
+					//case 0x3B0: break; //pmpaddr0
+					//case 0xf11: break; //mvendorid
+					//case 0xf12: break; //marchid
+					//case 0xf13: break; //mimpid
+					//case 0xf14: break; //mhartid
+					//case 0x301: break; //misa
+					default:
+						MINIRV32_OTHERCSR_WRITE( csrno, writeval );
+						break;
 					}
 					break;
 				}
-				case 0b0001111:
-					rdid = 0;   // fencetype = (ir >> 12) & 0b111; We ignore fences in this impl.
-					break;
-				case 0b1110011: // Zifencei+Zicsr
+				case RV_WFI: //WFI (Wait for interrupts)
+					CSR( mstatus ) |= 8;    //Enable interrupts
+					CSR( extraflags ) |= 4; //Infor environment we want to go to sleep.
+					SETCSR( pc, pc + 4 );
+					return 1;
+				case RV_MRET:
 				{
-					uint32_t csrno = ir >> 20;
-					int microop = ( ir >> 12 ) & 0b111;
-					if( (microop & 3) ) // It's a Zicsr function.
-					{
-						int rs1imm = (ir >> 15) & 0x1f;
-						uint32_t rs1 = REG(rs1imm);
-						uint32_t writeval = rs1;
-
-						// https://raw.githubusercontent.com/riscv/virtual-memory/main/specs/663-Svpbmt.pdf
-						// Generally, support for Zicsr
-						switch( csrno )
-						{
-						case 0x340: rval = CSR( mscratch ); break;
-						case 0x305: rval = CSR( mtvec ); break;
-						case 0x304: rval = CSR( mie ); break;
-						case 0xC00: rval = CSR( cyclel ); break;
-						case 0x344: rval = CSR( mip ); break;
-						case 0x341: rval = CSR( mepc ); break;
-						case 0x300: rval = CSR( mstatus ); break; //mstatus
-						case 0x342: rval = CSR( mcause ); break;
-						case 0x343: rval = CSR( mtval ); break;
-						case 0xf11: rval = 0xff0ff0ff; break; //mvendorid
-						case 0x301: rval = 0x40401101; break; //misa (XLEN=32, IMA+X)
-						//case 0x3B0: rval = 0; break; //pmpaddr0
-						//case 0x3a0: rval = 0; break; //pmpcfg0
-						//case 0xf12: rval = 0x00000000; break; //marchid
-						//case 0xf13: rval = 0x00000000; break; //mimpid
-						//case 0xf14: rval = 0x00000000; break; //mhartid
-						default:
-							MINIRV32_OTHERCSR_READ( csrno, rval );
-							break;
-						}
-
-						switch( microop )
-						{
-							case 0b001: writeval = rs1; break;  			//CSRRW
-							case 0b010: writeval = rval | rs1; break;		//CSRRS
-							case 0b011: writeval = rval & ~rs1; break;		//CSRRC
-							case 0b101: writeval = rs1imm; break;			//CSRRWI
-							case 0b110: writeval = rval | rs1imm; break;	//CSRRSI
-							case 0b111: writeval = rval & ~rs1imm; break;	//CSRRCI
-						}
-
-						switch( csrno )
-						{
-						case 0x340: SETCSR( mscratch, writeval ); break;
-						case 0x305: SETCSR( mtvec, writeval ); break;
-						case 0x304: SETCSR( mie, writeval ); break;
-						case 0x344: SETCSR( mip, writeval ); break;
-						case 0x341: SETCSR( mepc, writeval ); break;
-						case 0x300: SETCSR( mstatus, writeval ); break; //mstatus
-						case 0x342: SETCSR( mcause, writeval ); break;
-						case 0x343: SETCSR( mtval, writeval ); break;
-						//case 0x3a0: break; //pmpcfg0
-						//case 0x3B0: break; //pmpaddr0
-						//case 0xf11: break; //mvendorid
-						//case 0xf12: break; //marchid
-						//case 0xf13: break; //mimpid
-						//case 0xf14: break; //mhartid
-						//case 0x301: break; //misa
-						default:
-							MINIRV32_OTHERCSR_WRITE( csrno, writeval );
-							break;
-						}
-					}
-					else if( microop == 0b000 ) // "SYSTEM"
-					{
-						rdid = 0;
-						if( csrno == 0x105 ) //WFI (Wait for interrupts)
-						{
-							CSR( mstatus ) |= 8;    //Enable interrupts
-							CSR( extraflags ) |= 4; //Infor environment we want to go to sleep.
-							SETCSR( pc, pc + 4 );
-							return 1;
-						}
-						else if( ( ( csrno & 0xff ) == 0x02 ) )  // MRET
-						{
-							//https://raw.githubusercontent.com/riscv/virtual-memory/main/specs/663-Svpbmt.pdf
-							//Table 7.6. MRET then in mstatus/mstatush sets MPV=0, MPP=0, MIE=MPIE, and MPIE=1. La
-							// Should also update mstatus to reflect correct mode.
-							uint32_t startmstatus = CSR( mstatus );
-							uint32_t startextraflags = CSR( extraflags );
-							SETCSR( mstatus , (( startmstatus & 0x80) >> 4) | ((startextraflags&3) << 11) | 0x80 );
-							SETCSR( extraflags, (startextraflags & ~3) | ((startmstatus >> 11) & 3) );
-							pc = CSR( mepc ) -4;
-						}
-						else
-						{
-							switch( csrno )
-							{
-							case 0: trap = ( CSR( extraflags ) & 3) ? (11+1) : (8+1); break; // ECALL; 8 = "Environment call from U-mode"; 11 = "Environment call from M-mode"
-							case 1:	trap = (3+1); break; // EBREAK 3 = "Breakpoint"
-							default: trap = (2+1); break; // Illegal opcode.
-							}
-						}
-					}
-					else
-						trap = (2+1); 				// Note micrrop 0b100 == undefined.
+					//https://raw.githubusercontent.com/riscv/virtual-memory/main/specs/663-Svpbmt.pdf
+					//Table 7.6. MRET then in mstatus/mstatush sets MPV=0, MPP=0, MIE=MPIE, and MPIE=1. La
+					// Should also update mstatus to reflect correct mode.
+					uint32_t startmstatus = CSR( mstatus );
+					uint32_t startextraflags = CSR( extraflags );
+					SETCSR( mstatus , (( startmstatus & 0x80) >> 4) | ((startextraflags&3) << 11) | 0x80 );
+					SETCSR( extraflags, (startextraflags & ~3) | ((startmstatus >> 11) & 3) );
+					pc = CSR( mepc ) -4;
 					break;
 				}
-				case 0b0101111: // RV32A
+				case RV_ECALL: trap = ( CSR( extraflags ) & 3) ? (11+1) : (8+1); break; // ECALL; 8 = "Environment call from U-mode"; 11 = "Environment call from M-mode"
+				case RV_EBREAK: trap = (3+1); break; // EBREAK 3 = "Breakpoint"
+				case RV_AMO:
 				{
-					uint32_t rs1 = REG((ir >> 15) & 0x1f);
-					uint32_t rs2 = REG((ir >> 20) & 0x1f);
-					uint32_t irmid = ( ir>>27 ) & 0x1f;
+					uint32_t irmid = d->funct;
 
 					rs1 -= MINIRV32_RAM_IMAGE_OFFSET;
 
@@ -467,7 +593,11 @@ MINIRV32_DECORATE int32_t MiniRV32IMAStep( struct MiniRV32IMAState * state, uint
 							case 0b11100: rs2 = (rs2>rval)?rs2:rval; break; //AMOMAXU.W
 							default: trap = (2+1); dowrite = 0; break; //Not supported.
 						}
-						if( dowrite ) MINIRV32_STORE4( rs1, rs2 );
+						if( dowrite )
+						{
+							MINIRV32_STORE4( rs1, rs2 );
+							MINIRV32_CODE_WRITTEN( rs1 );
+						}
 					}
 					break;
 				}
@@ -523,5 +653,3 @@ MINIRV32_DECORATE int32_t MiniRV32IMAStep( struct MiniRV32IMAState * state, uint
 #endif
 
 #endif
-
-
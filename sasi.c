@@ -72,8 +72,15 @@ struct sasi_disk
     
     unsigned int status;
 
+    uint8_t *cache;		/* Read ahead and write gather buffer */
+    uint32_t cache_lba;		/* First block held in the cache */
+    unsigned int cache_valid;	/* Blocks valid from cache_lba */
+    unsigned int readahead;	/* Extra blocks to fetch beyond a read */
+    uint32_t wlba;		/* Start of the write being gathered */
 };
 
+#define READAHEAD	32
+
 struct sasi_bus {
     unsigned control;		/* Control and status lines */
     unsigned init_ctl;		/* Initiator control lines */
@@ -93,10 +100,11 @@ struct sasi_bus {
  
 static int do_read(struct sasi_disk *sd)
 {
-    if (lseek(sd->fd, sd->lba * sd->sectorsize, SEEK_SET) < 0)
-        return -1;
-    if (read(sd->fd, sd->dbuf, sd->sectorsize) != sd->sectorsize)
+    uint32_t n = sd->lba - sd->cache_lba;
+
+    if (sd->lba < sd->cache_lba || n >= sd->cache_valid)
         return -1;
+    memcpy(sd->dbuf, sd->cache + n * sd->sectorsize, sd->sectorsize);
     return 0;
 }
 
@@ -109,6 +117,46 @@ static int do_write(struct sasi_disk *sd)
     return 0;
 }
 
+/*
+ *	Pull the whole of a read request plus the read ahead window into
+ *	the cache in one go unless we already hold it. A short read just
+ *	leaves fewer blocks valid and the read fails at that block.
+ */
+static void sasi_cache_fill(struct sasi_disk *sd)
+{
+    uint32_t n = sd->count + sd->readahead;
+    ssize_t r;
+
+    if (sd->lba >= sd->cache_lba &&
+        sd->lba + sd->count <= sd->cache_lba + sd->cache_valid)
+        return;
+    r = pread(sd->fd, sd->cache, n * sd->sectorsize,
+        (off_t)sd->lba * sd->sectorsize);
+    if (r < 0)
+        r = 0;
+    sd->cache_lba = sd->lba;
+    sd->cache_valid = r / sd->sectorsize;
+}
+
+/*
+ *	Write out the blocks gathered so far for this command. The data
+ *	written stays in the cache as it is the newest copy.
+ */
+static int sasi_write_flush(struct sasi_disk *sd)
+{
+    size_t len = (sd->lba - sd->wlba) * sd->sectorsize;
+
+    if (len == 0)
+        return 0;
+    if (pwrite(sd->fd, sd->cache, len, (off_t)sd->wlba * sd->sectorsize) != len) {
+        sd->cache_valid = 0;
+        return -1;
+    }
+    sd->cache_lba = sd->wlba;
+    sd->cache_valid = sd->lba - sd->wlba;
+    return 0;
+}
+
 
 /*
  *	Complete a command and initiate sending of the status
@@ -194,6 +242,7 @@ static void sasi_read_command(struct sasi_disk *sd, uint32_t lba,
     sd->lba = lba;
     sd->count = count;
     sd->ecc = ecc;
+    sasi_cache_fill(sd);
     sasi_read_block(sd);
 }
 
@@ -201,20 +250,24 @@ static void sasi_read_command(struct sasi_disk *sd, uint32_t lba,
 static void sasi_write_block(struct sasi_disk *sd)
 {
     if (sd->lba == sd->blocks) {
+        sasi_write_flush(sd);
         sasi_sense_with_lba(sd, 0x21);
         sasi_status_in(sd, CHECK_CONDITION);
         return;
     }
-    /* Write the data received */
-    if (do_write(sd)) {
-        sasi_sense_with_lba(sd, 0x14);	/* Target sector not found */
-        sasi_status_in(sd, CHECK_CONDITION);
-        return;
-    }
+    /* Gather the data received */
+    memcpy(sd->cache + (sd->lba - sd->wlba) * sd->sectorsize, sd->dbuf,
+        sd->sectorsize);
     sd->lba++;
     sd->count--;
     /* And done */
     if (sd->count == 0) {
+        if (sasi_write_flush(sd)) {
+            sd->lba = sd->wlba;
+            sasi_sense_with_lba(sd, 0x14);	/* Target sector not found */
+            sasi_status_in(sd, CHECK_CONDITION);
+            return;
+        }
         sasi_sense_clear(sd);
         sasi_status_in(sd, 0);
         return;
@@ -224,14 +277,17 @@ static void sasi_write_block(struct sasi_disk *sd)
 
 /*
  *	Start the write state machine up by requesting the first block
- *	of data from the host.
+ *	of data from the host. The blocks are gathered and written in one
+ *	go when the last one arrives.
  */
 static void sasi_write_command(struct sasi_disk *sd, uint32_t lba,
     uint16_t count, unsigned int ecc)
 {
     sd->lba = lba;
+    sd->wlba = lba;
     sd->count = count;
     sd->ecc = ecc;
+    sd->cache_valid = 0;
     sasi_data_out(sd, sd->sectorsize + 4 * sd->ecc);
 }
 
@@ -245,6 +301,7 @@ static void sasi_format_disk(struct sasi_disk *sd)
         sasi_status_in(sd, CHECK_CONDITION);
         return;
     }
+    sd->cache_valid = 0;
     while(sd->lba < sd->blocks) {
         if (do_write(sd)) {
             sasi_sense_with_lba(sd, 0x1A);
@@ -626,6 +683,52 @@ uint8_t sasi_read_data(struct sasi_bus *bus)
     return r;
 }   
 
+/*
+ *	Block versions for controllers that move a burst at a time. These
+ *	transfer up to len bytes of the current data phase and stop at the
+ *	end of it so the caller can check the bus phase. Returns the number
+ *	of bytes moved, 0 if the bus is not in the right data phase.
+ */
+unsigned sasi_read_block_data(struct sasi_bus *bus, uint8_t *buf, unsigned len)
+{
+    struct sasi_disk *sd = bus->selected;
+    unsigned n;
+
+    if (bus->state != BUS_TRANSFER ||
+        (bus->control & (SASI_MSG | SASI_CD | SASI_IO)) != SASI_IO)
+        return 0;
+    n = sd->dlen - sd->dptr;
+    if (n > len)
+        n = len;
+    if (n == 0)
+        return 0;
+    memcpy(buf, sd->dbuf + sd->dptr, n);
+    /* The final ack runs the command state machine */
+    sd->dptr += n - 1;
+    sasi_disk_ack_read(sd);
+    return n;
+}
+
+unsigned sasi_write_block_data(struct sasi_bus *bus, const uint8_t *buf, unsigned len)
+{
+    struct sasi_disk *sd = bus->selected;
+    unsigned n;
+
+    if (bus->state != BUS_TRANSFER ||
+        (bus->control & (SASI_MSG | SASI_CD | SASI_IO)) != 0)
+        return 0;
+    n = sd->dlen - sd->dptr;
+    if (n > len)
+        n = len;
+    if (n == 0)
+        return 0;
+    memcpy(sd->dbuf + sd->dptr, buf, n);
+    sd->dptr += n;
+    if (sd->dptr == sd->dlen)
+        sasi_command_execute_out(sd);
+    return n;
+}
+
 static void sasi_bus_exit_reset(struct sasi_bus *bus)
 {
     int i;
@@ -714,11 +817,29 @@ void sasi_disk_attach(struct sasi_bus *bus, unsigned int lun, const char *path,
     }
     sd->blocks = lseek(sd->fd, (off_t)0, 1) / sd->sectorsize;
     bus->device[lun] = sd;
+    sasi_disk_readahead(bus, lun, READAHEAD);
+}
+
+/*
+ *	Set the number of blocks read beyond each read request. The cache
+ *	always holds a full 256 block request as well.
+ */
+void sasi_disk_readahead(struct sasi_bus *bus, unsigned int lun, unsigned int blocks)
+{
+    struct sasi_disk *sd = bus->device[lun];
+
+    if (sd == NULL)
+        return;
+    free(sd->cache);
+    sd->cache = alloc((256 + blocks) * sd->sectorsize);
+    sd->cache_valid = 0;
+    sd->readahead = blocks;
 }
     
 static void sasi_disk_free(struct sasi_disk *sd)
 {
     close(sd->fd);
+    free(sd->cache);
     free(sd);
 }
 
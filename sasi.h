@@ -6,11 +6,14 @@ void sasi_bus_free(struct sasi_bus *bus);
 void sasi_bus_reset(struct sasi_bus *bus);
 
 void sasi_disk_attach(struct sasi_bus *bus, unsigned int lun, const char *path, unsigned int sectorsize);
+void sasi_disk_readahead(struct sasi_bus *bus, unsigned int lun, unsigned int blocks);
 
 
 void sasi_write_data(struct sasi_bus *bus, uint8_t data);
 void sasi_set_data(struct sasi_bus *bus, uint8_t data);
 uint8_t sasi_read_data(struct sasi_bus *bus);
+unsigned sasi_read_block_data(struct sasi_bus *bus, uint8_t *buf, unsigned len);
+unsigned sasi_write_block_data(struct sasi_bus *bus, const uint8_t *buf, unsigned len);
 void sasi_bus_control(struct sasi_bus *bus, unsigned val);
 uint8_t sasi_read_bus(struct sasi_bus *bus);
 void sasi_ack_bus(struct sasi_bus *bus);
@@ -357,6 +357,30 @@ static void take_a_nap(void)
 		perror("nanosleep");
 }
 
+/* The timers see the clocks of the real 68008, which does the work of
+   600 of our 68000 cycles in 1000 */
+static unsigned int clkfrac;
+
+static void tick_devices(unsigned int cycles)
+{
+	unsigned int clocks = cycles * 5 + clkfrac;
+	clkfrac = clocks % 3;
+	clocks /= 3;
+	duart_tick(duart, clocks);
+	m68230_tick(pit, clocks);
+}
+
+/* CPU cycles until a timer next interrupts, 0 if none will */
+static unsigned int next_event(void)
+{
+	unsigned int n = duart_next_event(duart);
+	unsigned int p = m68230_next_event(pit);
+	if (n == 0 || (p && p < n))
+		n = p;
+	/* Round up so that we don't stop just short of it */
+	return ((uint64_t)n * 3 + 4) / 5;
+}
+
 void cpu_pulse_reset(void)
 {
 	device_init();
@@ -378,6 +402,8 @@ int main(int argc, char *argv[])
 	int cputype = M68K_CPU_TYPE_68000;
 	int fast = 0;
 	int opt;
+	int budget = 0;
+	unsigned int n;
 	const char *romname = "Tutor131.bin";
 	const char *diskname = NULL;
 
@@ -463,6 +489,8 @@ int main(int argc, char *argv[])
 	duart = duart_create();
 	if (trace & TRACE_DUART)
 		duart_trace(duart, 1);
+	/* Ticks are in clocks of the real 10MHz 68008, see tick_devices */
+	duart_set_clock(duart, 10000000);
 
 	pit = m68230_create();
 	if (trace & TRACE_PIT)
@@ -480,9 +508,18 @@ int main(int argc, char *argv[])
 		   second. We do a blind 0.01 second sleep so we are actually
 		   emulating a bit under 10Mhz - which will do fine for
 		   testing this stuff */
-		m68k_execute(600);	/* We don't have an 008 emulation so approx the timing */
-		duart_tick(duart);
-		m68230_tick(pit, 1000);
+		budget += 600;	/* We don't have an 008 emulation so approx the timing */
+		/* Run straight up to each timer interrupt so it is taken
+		   on time */
+		while (budget > 0) {
+			n = next_event();
+			if (n == 0 || n > (unsigned int)budget)
+				n = budget;
+			n = m68k_execute(n);
+			tick_devices(n);
+			budget -= n;
+		}
+		duart_poll(duart);
 		if (!fast)
 			take_a_nap();
 	}
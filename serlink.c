@@ -0,0 +1,274 @@
+/*
+ *	Shared memory serial link
+ *
+ *	Both emulators map the same POSIX shared memory segment. It holds a
+ *	ring for each direction, and each ring has exactly one writer and
+ *	one reader, so moving a byte is a couple of memory accesses with no
+ *	locks and no system calls. Side a sends on ring 0 and side b on
+ *	ring 1.
+ *
+ *	The segment is left behind when the emulators exit so either end
+ *	can be restarted. An end coming up with no live peer throws away
+ *	anything still sitting in its receive ring from an earlier run.
+ *
+ *	When pacing, a byte is only presented once a character time has
+ *	passed since the last one, and the transmitter reports busy for a
+ *	character time after each byte. Each end paces against its own
+ *	emulated clock as the two machines do not share a time base.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "serialdevice.h"
+#include "serlink.h"
+
+#define SERLINK_MAGIC	0x534C4E4BUL
+#define SERLINK_RING	4096		/* Power of two */
+
+/* head and tail are on their own cache lines so the two ends do not
+   fight over one line */
+struct serlink_ring {
+	uint32_t head;			/* Written only by the sender */
+	uint32_t pad0[15];
+	uint32_t tail;			/* Written only by the receiver */
+	uint32_t pad1[15];
+	uint8_t buf[SERLINK_RING];
+};
+
+struct serlink_shm {
+	uint32_t magic;
+	uint32_t pid[2];		/* Which processes have each end */
+	uint32_t pad[13];
+	struct serlink_ring ring[2];
+};
+
+struct serlink {
+	struct serial_device dev;
+	struct serlink_shm *shm;
+	struct serlink_ring *tx;
+	struct serlink_ring *rx;
+	unsigned side;
+	uint32_t baud;
+	uint64_t rx_next;		/* Clock the next byte may be seen */
+	uint64_t tx_next;		/* Clock the transmitter is free */
+	uint8_t last;
+	struct serlink *next;
+};
+
+static struct serlink *links;
+static uint64_t (*serlink_cycles)(void);
+static uint64_t serlink_hz;
+
+void serlink_set_clock(uint64_t (*cycles)(void), uint64_t hz)
+{
+	serlink_cycles = cycles;
+	serlink_hz = hz;
+}
+
+/* Clocks a character takes at this baud rate (start, 8 data, stop) or
+   0 if we are not pacing */
+static uint64_t serlink_char_clocks(struct serlink *l)
+{
+	static int warned;
+
+	if (l->baud == 0)
+		return 0;
+	/* Not every board has a clock to pace against yet */
+	if (serlink_cycles == NULL) {
+		if (!warned)
+			fprintf(stderr, "serial link: no emulated clock on this machine, baud rate ignored.\n");
+		warned = 1;
+		return 0;
+	}
+	return serlink_hz * 10 / l->baud;
+}
+
+static unsigned serlink_ready(struct serial_device *dev)
+{
+	struct serlink *l = dev->private;
+	uint32_t head = __atomic_load_n(&l->rx->head, __ATOMIC_ACQUIRE);
+	uint32_t tail = __atomic_load_n(&l->tx->tail, __ATOMIC_ACQUIRE);
+	uint64_t now = 0;
+	unsigned r = 0;
+
+	if (serlink_char_clocks(l))
+		now = serlink_cycles();
+	if (head != l->rx->tail && now >= l->rx_next)
+		r |= 1;
+	if (l->tx->head - tail < SERLINK_RING && now >= l->tx_next)
+		r |= 2;
+	return r;
+}
+
+static uint8_t serlink_get(struct serial_device *dev)
+{
+	struct serlink *l = dev->private;
+	struct serlink_ring *r = l->rx;
+	uint32_t head = __atomic_load_n(&r->head, __ATOMIC_ACQUIRE);
+	uint64_t cc;
+
+	if (head == r->tail)
+		return l->last;
+	l->last = r->buf[r->tail & (SERLINK_RING - 1)];
+	__atomic_store_n(&r->tail, r->tail + 1, __ATOMIC_RELEASE);
+	cc = serlink_char_clocks(l);
+	if (cc)
+		l->rx_next = serlink_cycles() + cc;
+	return l->last;
+}
+
+static void serlink_put(struct serial_device *dev, uint8_t c)
+{
+	struct serlink *l = dev->private;
+	struct serlink_ring *r = l->tx;
+	uint32_t tail = __atomic_load_n(&r->tail, __ATOMIC_ACQUIRE);
+	uint64_t cc;
+
+	/* Like a real line, if the far end is not taking data it is lost */
+	if (r->head - tail >= SERLINK_RING)
+		return;
+	r->buf[r->head & (SERLINK_RING - 1)] = c;
+	__atomic_store_n(&r->head, r->head + 1, __ATOMIC_RELEASE);
+	cc = serlink_char_clocks(l);
+	if (cc)
+		l->tx_next = serlink_cycles() + cc;
+}
+
+/* Let a restarted peer know this end has gone */
+static void serlink_exit(void)
+{
+	struct serlink *l;
+
+	for (l = links; l; l = l->next)
+		__atomic_store_n(&l->shm->pid[l->side], 0, __ATOMIC_RELEASE);
+}
+
+static int serlink_peer_alive(struct serlink *l)
+{
+	pid_t pid = __atomic_load_n(&l->shm->pid[!l->side], __ATOMIC_ACQUIRE);
+
+	if (pid == 0)
+		return 0;
+	if (kill(pid, 0) == -1 && errno == ESRCH)
+		return 0;
+	return 1;
+}
+
+static struct serlink_shm *serlink_map(const char *name)
+{
+	char path[80];
+	struct serlink_shm *shm;
+	int fd;
+
+	snprintf(path, sizeof(path), "/emulatorkit-%s", name);
+	fd = shm_open(path, O_RDWR | O_CREAT, 0600);
+	if (fd == -1) {
+		perror(path);
+		return NULL;
+	}
+	/* Both ends may get here at once. The size is the same and new
+	   memory is zero, which is an empty ring, so that is fine */
+	if (ftruncate(fd, sizeof(struct serlink_shm)) == -1) {
+		perror(path);
+		close(fd);
+		return NULL;
+	}
+	shm = mmap(NULL, sizeof(struct serlink_shm), PROT_READ | PROT_WRITE,
+		MAP_SHARED, fd, 0);
+	close(fd);
+	if (shm == MAP_FAILED) {
+		perror(path);
+		return NULL;
+	}
+	if (shm->magic == 0)
+		shm->magic = SERLINK_MAGIC;
+	if (shm->magic != SERLINK_MAGIC) {
+		fprintf(stderr, "%s: not a serial link.\n", path);
+		munmap(shm, sizeof(struct serlink_shm));
+		return NULL;
+	}
+	return shm;
+}
+
+static struct serial_device *serlink_shm(const char *spec)
+{
+	char name[64];
+	const char *p = strchr(spec, ':');
+	struct serlink *l;
+	unsigned side;
+	unsigned long baud = 0;
+	char *e;
+
+	if (p == NULL || p == spec || p - spec >= sizeof(name)) {
+		fprintf(stderr, "serial link: expected shm:name:a|b[:baud].\n");
+		return NULL;
+	}
+	memcpy(name, spec, p - spec);
+	name[p - spec] = 0;
+	if (strchr(name, '/')) {
+		fprintf(stderr, "serial link: name may not contain '/'.\n");
+		return NULL;
+	}
+	p++;
+	if ((*p != 'a' && *p != 'b') || (p[1] && p[1] != ':')) {
+		fprintf(stderr, "serial link: side must be a or b.\n");
+		return NULL;
+	}
+	side = *p++ - 'a';
+	if (*p == ':') {
+		baud = strtoul(p + 1, &e, 10);
+		if (baud == 0 || *e) {
+			fprintf(stderr, "serial link: invalid baud rate '%s'.\n", p + 1);
+			return NULL;
+		}
+	}
+
+	l = malloc(sizeof(struct serlink));
+	if (l == NULL) {
+		fprintf(stderr, "Out of memory.\n");
+		exit(1);
+	}
+	memset(l, 0, sizeof(struct serlink));
+	l->shm = serlink_map(name);
+	if (l->shm == NULL) {
+		free(l);
+		return NULL;
+	}
+	l->side = side;
+	l->baud = baud;
+	l->tx = &l->shm->ring[side];
+	l->rx = &l->shm->ring[!side];
+
+	if (serlink_peer_alive(l) == 0)
+		__atomic_store_n(&l->rx->tail, __atomic_load_n(&l->rx->head, __ATOMIC_ACQUIRE), __ATOMIC_RELEASE);
+	__atomic_store_n(&l->shm->pid[side], getpid(), __ATOMIC_RELEASE);
+
+	l->dev.name = "Serial link";
+	l->dev.private = l;
+	l->dev.get = serlink_get;
+	l->dev.put = serlink_put;
+	l->dev.ready = serlink_ready;
+
+	if (links == NULL)
+		atexit(serlink_exit);
+	l->next = links;
+	links = l;
+	return &l->dev;
+}
+
+/* Returns NULL having reported why if the spec is no good */
+struct serial_device *serlink_open(const char *spec)
+{
+	if (strncmp(spec, "shm:", 4) == 0)
+		return serlink_shm(spec + 4);
+	fprintf(stderr, "serial link: unknown link type '%s'.\n", spec);
+	return NULL;
+}
@@ -0,0 +1,17 @@
+/*
+ *	Serial links between emulators
+ *
+ *	shm:name:a[:baud]	one end of a shared memory link
+ *	shm:name:b[:baud]	the other end
+ *
+ *	Each end is a serial_device that can be attached to any UART model
+ *	in place of the console. With a baud rate given, and a cycle counter
+ *	registered, bytes move no faster than the line would in emulated time.
+ */
+
+#include <stdint.h>
+
+struct serial_device;
+
+extern struct serial_device *serlink_open(const char *spec);
+extern void serlink_set_clock(uint64_t (*cycles)(void), uint64_t hz);
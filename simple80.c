@@ -62,6 +62,7 @@ static uint8_t boardmod = 0;	/* Unmodified */
 static uint8_t sioa15 = 0;	/* SIO on A15 not A7 */
 
 static unsigned int r16bug = 0;
+static int jit;
 
 static Z80Context cpu_z80;
 static uint8_t int_recalc = 0;
@@ -142,6 +143,19 @@ static uint8_t mem_read(int unused, uint16_t addr)
 	return r;
 }
 
+/* Host memory for the block translator. ROM and RAM both enabled is
+   left to the interpreter so the hazard checks still see it */
+static uint8_t *mem_map(int unused, uint16_t addr)
+{
+	if (trace & TRACE_MEM)
+		return NULL;
+	if (romen)
+		return (ramen && ramen2) ? NULL : &rom[addr];
+	if (ramen && ramen2)
+		return &ram[addr + 65536 * banknum];
+	return NULL;
+}
+
 static void mem_write(int unused, uint16_t addr, uint8_t val)
 {
 	if (trace & TRACE_MEM)
@@ -918,7 +932,7 @@ static void exit_cleanup(void)
 
 static void usage(void)
 {
-	fprintf(stderr, "simple80: [-b] [-f] [-1] [-5] [-S] [-f] [-i path] [-r path] [-d debug]\n");
+	fprintf(stderr, "simple80: [-b] [-f] [-1] [-5] [-O] [-S] [-f] [-i path] [-r path] [-d debug]\n");
 	exit(EXIT_FAILURE);
 }
 
@@ -931,7 +945,7 @@ int main(int argc, char *argv[])
 	char *rompath = "simple80.rom";
 	char *idepath = "simple80.cf";
 
-	while ((opt = getopt(argc, argv, "d:i:r:fb15S")) != -1) {
+	while ((opt = getopt(argc, argv, "d:i:r:fb15OS")) != -1) {
 		switch (opt) {
 		case 'r':
 			rompath = optarg;
@@ -964,6 +978,9 @@ int main(int argc, char *argv[])
 		case 'S':
 			sioa15 = 1;
 			break;
+		case 'O':
+			jit = 1;
+			break;
 		default:
 			usage();
 		}
@@ -1026,6 +1043,10 @@ int main(int argc, char *argv[])
 	cpu_z80.memRead = mem_read;
 	cpu_z80.memWrite = mem_write;
 	cpu_z80.trace = simple80_trace;
+	if (jit && Z80JitEnable(&cpu_z80, mem_map)) {
+		fprintf(stderr, "simple80: -O is not supported on this host.\n");
+		jit = 0;
+	}
 
 	/* This is the wrong way to do it but it's easier for the moment. We
 	   should track how much real time has occurred and try to keep cycle
@@ -1038,6 +1059,9 @@ int main(int argc, char *argv[])
 			int i;
 			/* 36400 T states */
 			for (i = 0; i < 100; i++) {
+				/* Translated code only runs with no trace hook */
+				if (jit)
+					cpu_z80.trace = (trace & TRACE_CPU) ? simple80_trace : NULL;
 				Z80ExecuteTStates(&cpu_z80, 364);
 				sio2_timer();
 				ctc_tick(364);
@@ -28,6 +28,7 @@
 #include <sys/mman.h>
 #include "libz80/z80.h"
 #include "ide.h"
+#include "wallclock.h"
 
 static uint8_t eeprom[32768];
 static uint8_t fixedram[32768];
@@ -468,10 +469,8 @@ void rtc_write(uint8_t addr, uint8_t val)
             if ((val & 0x04) == 0)
                 rtc_status &= ~4;
             if (val & 0x01) {
-                time_t t;
                 rtc_status &= ~2;
-                time(&t);
-                tmhold = gmtime(&t);
+                tmhold = wallclock_gmtime();
             } else
                 rtc_status |= 2;
             /* FIXME: sort out hold behaviour */
@@ -410,6 +410,23 @@ static unsigned is_slot(unsigned addr)
 	return 0;
 }
 
+/* Point the CPU straight at the memory behind each page so it only calls
+   us for the I/O slots, the DAT and when tracing memory. Redone whenever
+   the DAT changes */
+static void remap(void)
+{
+	unsigned int page;
+	unsigned int addr;
+
+	for (page = 0; page < 256; page++) {
+		addr = page << 8;
+		if ((trace & TRACE_MEM) || is_slot(addr) || is_slot(addr + 0xFF))
+			e6809_map_page(page, NULL, NULL);
+		else
+			e6809_map_page(page, dat_xlate(addr, 0), dat_xlate(addr, 1));
+	}
+}
+
 void recalc_interrupts(void)
 {
 /*	static unsigned prev; */
@@ -469,6 +486,7 @@ void e6809_write8(unsigned addr, unsigned char val)
 		if (trace & TRACE_DAT)
 			fprintf(stderr, "DAT %1X: %2X\n", addr & 0x0F, val);
 		dat[addr & 0x0F] = val;
+		remap();
 	} else {
 		uint8_t *ap = dat_xlate(addr, 1);
 		if (ap)
@@ -685,6 +703,7 @@ int main(int argc, char *argv[])
 		tcsetattr(0, TCSADRAIN, &term);
 	}
 
+	remap();
 	e6809_reset(trace & TRACE_CPU);
 
 	/* This is the wrong way to do it but it's easier for the moment. We
@@ -695,8 +714,11 @@ int main(int argc, char *argv[])
 	while (!done) {
 		unsigned int i;
 		for (i = 0; i < 100; i++) {
-			while (cycles < clockrate)
-				cycles += e6809_sstep(live_irq, 0);
+			if (trace & TRACE_CPU) {
+				while (cycles < clockrate)
+					cycles += e6809_sstep(live_irq, 0);
+			} else if (cycles < clockrate)
+				cycles += e6809_run(clockrate - cycles, &live_irq, NULL);
 			cycles -= clockrate;
 			recalc_interrupts();
 		}
@@ -14,6 +14,7 @@
 #include <arpa/inet.h>
 #include "ide.h"
 #include "duart.h"
+#include "serlink.h"
 
 /* 16MB RAM except for the top 32K which is I/O */
 
@@ -23,6 +24,8 @@ static struct ide_controller *ide;
 /* 68681 */
 static struct duart *duart;
 static int rcbus;
+/* CPU cycles run, for pacing a serial link */
+static uint64_t cycles_run;
 
 static int trace = 0;
 
@@ -358,9 +361,14 @@ void cpu_set_fc(int fc)
 {
 }
 
+static uint64_t link_clock(void)
+{
+	return cycles_run;
+}
+
 void usage(void)
 {
-	fprintf(stderr, "tiny68k [-0][-1][-2][-e][-R][-r rompath][-i idepath][-d debug].\n");
+	fprintf(stderr, "tiny68k [-0][-1][-2][-e][-R][-r rompath][-i idepath][-L link][-d debug].\n");
 	exit(1);
 }
 
@@ -370,10 +378,13 @@ int main(int argc, char *argv[])
 	int cputype = M68K_CPU_TYPE_68000;
 	int fast = 0;
 	int opt;
+	int budget = 0;
+	unsigned int n;
 	const char *romname = "tiny68k.rom";
 	const char *diskname = "tiny68k.ide";
+	const char *linkspec = NULL;
 
-	while((opt = getopt(argc, argv, "012eRfd:i:r:")) != -1) {
+	while((opt = getopt(argc, argv, "012eRfd:i:L:r:")) != -1) {
 		switch(opt) {
 		case '0':
 			cputype = M68K_CPU_TYPE_68000;
@@ -399,6 +410,9 @@ int main(int argc, char *argv[])
 		case 'i':
 			diskname = optarg;
 			break;
+		case 'L':
+			linkspec = optarg;
+			break;
 		case 'r':
 			romname = optarg;
 			break;
@@ -454,6 +468,16 @@ int main(int argc, char *argv[])
 	duart = duart_create();
 	if (trace & TRACE_DUART)
 		duart_trace(duart, 1);
+	/* The run loop paces us as a 10MHz 68000 */
+	duart_set_clock(duart, 10000000);
+	if (linkspec) {
+		struct serial_device *link = serlink_open(linkspec);
+		if (link == NULL)
+			exit(1);
+		/* Port A is the console port */
+		duart_attach(duart, 0, link);
+		serlink_set_clock(link_clock, 10000000);
+	}
 
 	m68k_init();
 	m68k_set_cpu_type(cputype);
@@ -467,8 +491,19 @@ int main(int argc, char *argv[])
 		   second. We do a blind 0.01 second sleep so we are actually
 		   emulating a bit under 10Mhz - which will do fine for
 		   testing this stuff */
-		m68k_execute(1000);
-		duart_tick(duart);
+		budget += 1000;
+		/* Run straight up to each DUART timer interrupt so it
+		   is taken on time */
+		while (budget > 0) {
+			n = duart_next_event(duart);
+			if (n == 0 || n > (unsigned int)budget)
+				n = budget;
+			n = m68k_execute(n);
+			duart_tick(duart, n);
+			cycles_run += n;
+			budget -= n;
+		}
+		duart_poll(duart);
 		if (!fast)
 			take_a_nap();
 	}
@@ -99,6 +99,7 @@
 #include <string.h>
 
 #include "tms9995.h"
+#include "tms9995dis.h"
 
 #define NOPRG -1
 
@@ -138,6 +139,7 @@ static void tms9995_command_completed(struct tms9995 *tms);
 static void tms9995_trigger_decrementer(struct tms9995 *tms);
 static void tms9995_build_command_lookup_table(struct tms9995 *tms);
 static void tms9995_disassemble(struct tms9995 *tms);
+static bool tms9995_execute_fast(struct tms9995 *tms);
 
 /****************************************************************************
     Some small helpers
@@ -187,6 +189,16 @@ void tms9995_itrace(struct tms9995 *tms, bool onoff)
 	tms->itrace = onoff;
 }
 
+void tms9995_fast(struct tms9995 *tms, bool onoff)
+{
+	tms->fast = onoff;
+}
+
+void tms9995_hook(struct tms9995 *tms, void (*hook)(struct tms9995 *tms))
+{
+	tms->hook = hook;
+}
+
 enum {
 	TMS9995_PC=0, TMS9995_WP, TMS9995_STATUS, TMS9995_IR,
 	TMS9995_R0, TMS9995_R1, TMS9995_R2, TMS9995_R3,
@@ -978,6 +990,12 @@ void tms9995_execute_run(struct tms9995 *tms, unsigned int cycles)
 	if (tms->itrace) fprintf(stderr, "calling execute_run for %d cycles\n", tms->icount);
 	do
 	{
+		// Whole instructions at a time when nothing needs the microcode
+		if (tms->boundary && tms->fast && tms9995_execute_fast(tms))
+			continue;
+
+		tms->boundary = false;
+
 		// Normal operation
 		if (tms->check_ready && tms->ready == false)
 		{
@@ -1372,7 +1390,10 @@ static void tms9995_next_command(struct tms9995 *tms)
 		tms->PC_debug = tms->PC - 2;
 		if (tms->trace)
 			tms9995_disassemble(tms);
+		if (tms->hook)
+			tms->hook(tms);
 		tms->first_cycle = tms->icount;
+		tms->boundary = true;
 	}
 }
 
@@ -1533,6 +1554,7 @@ static void tms9995_service_interrupt(struct tms9995 *tms)
 	tms->MPC = 0;
 	tms->first_cycle = tms->icount;
 	tms->check_ready = false;      // set to default
+	tms->boundary = false;
 }
 
 /*
@@ -3309,241 +3331,488 @@ static const ophandler s_microoperation[45] =
 	tms9995_alu_int
 };
 
-/* Disassembler */
+/**************************************************************************
+    Fast execution engine
+
+    When nothing needs cycle by cycle attention (no HOLD request, READY
+    held high with no automatic wait states, no tracing, not IDLE) whole
+    instructions are run at the instruction boundary by the handlers below
+    instead of stepping the microprogram. Each handler performs the same
+    memory accesses, ALU calls and clock pulses in the same order as the
+    microprogram it replaces, so the cycle counts, decrementer and
+    interrupt checks come out identical. Instructions without a handler
+    (CRU, BLWP, XOP, X, DIV, external) and interrupt service still run on
+    the microcode engine.
+**************************************************************************/
 
-/* Op decode table */
-
-static const char *opnames0[] = {
-    "SZC %s,%d",
-    "SZCB %s,%d",
-    "S %s,%d",
-    "SB %s,%d",
-    "C %s,%d",
-    "CB %s,%d",
-    "A %s,%d",
-    "AB %s,%d",
-    "MOV %s,%d",
-    "MOVB %s,%d",
-    "SOC %s,%d",
-    "SOCB %s,%d"
-};
+/*
+    Clock pulse without READY or auto wait state handling
+*/
+static void tms9995_fast_clock(struct tms9995 *tms, int count)
+{
+	tms->icount -= count;
+	if (tms->flag[0] == false && tms->flag[1] == true)
+	{
+		while (count--)
+		{
+			tms->decrementer_clkdiv = (tms->decrementer_clkdiv+1)%4;
+			if (tms->decrementer_clkdiv==0) tms9995_trigger_decrementer(tms);
+		}
+	}
+}
 
-static const char *opnames1[] = {
-    "COC %s,%W",
-    "CZC %s,%W",
-    "XOR %s,%W",
-    "XOP %x,%s ",
-    "LDCR %x,%s",
-    "STCR %x,%s",
-    "MPY %s,%W",
-    "DIV %s,%W"
-};
+/*
+    Equivalent of tms9995_mem_read. A byte is returned in the high byte.
+*/
+static uint16_t tms9995_fast_read(struct tms9995 *tms, uint16_t addr, bool byte)
+{
+	uint16_t value;
 
-static const char *opnames2[] = {
-    "JMP %8",
-    "JLT %8",
-    "JLE %8",
-    "JEQ %8",
-    "JHE %8",
-    "JGT %8",
-    "JNE %8",
-    "JNC %8",
-    "JOC %8",
-    "JNO %8",
-    "JL %8",
-    "JH %8",
-    "JOP %8",
-    "SBO %8",
-    "SBZ %8",
-    "TB %8"
-};
+	if ((addr & 0xfffe)==0xfffa && !tms->mp9537)
+	{
+		value = tms->decrementer_value;
+		if (byte)
+		{
+			if ((addr & 1)==1) value <<= 8;
+			value &= 0xff00;
+		}
+		tms9995_fast_clock(tms, 1);
+		return value;
+	}
 
-static const char *opnames8[] = {
-    "SRA %w,%S",
-    "SRL %w,%S",
-    "SLA %w,%S",
-    "SRC %w,%S"
-};
+	if (is_onchip(tms, addr))
+	{
+		uint16_t intaddr = addr & 0x00fe;
+		value = (tms->onchip_memory[intaddr] << 8) | tms->onchip_memory[intaddr + 1];
+		if (byte)
+		{
+			if ((addr & 1)==1) value <<= 8;
+			value &= 0xff00;
+		}
+		tms9995_fast_clock(tms, 1);
+		return value;
+	}
 
-static const char *opnames9[] = {
-    "BLWP %s",
-    "B %s",
-    "X %s",
-    "CLR %s",
-    "NEG %s",
-    "INV %s",
-    "INC %s",
-    "INCT %s",
-    "DEC %s",
-    "DECT %s",
-    "BL %s",
-    "SWPB %s",
-    "SETO %s",
-    "ABS %s",
-    NULL,
-    NULL
-};
+	if (byte)
+	{
+		tms9995_fast_clock(tms, 1);
+		return tms9995_readb(tms, addr) << 8;
+	}
 
-static const char *opnames10[] = {
-    "LI %w,%i",
-    "AI %w,%i",
-    "ANDI %w,%i",
-    "ORI %w,%i",
-    "CI %w,%i",
-    "STWP %w",
-    "STST %w",
-    "LWPI %i",
-    "LIMI %i",
-    NULL,
-    "IDLE",	/* No arguments */
-    "RSET",	/* No arguments */
-    "RTWP",	/* No arguments */
-    "CKON",	/* No arguments */
-    "CKOF",	/* No arguments */
-    "LREX"	/* No arguments */
-};
+	addr &= 0xfffe;
+	tms9995_fast_clock(tms, 1);
+	value = tms9995_readb(tms, addr) << 8;
+	tms9995_fast_clock(tms, 1);
+	value |= tms9995_readb(tms, addr | 1);
+	return value;
+}
 
-static const char *opnames11[] = {
-    NULL,
-    NULL, //"BIND",
-    "DIVS %s",
-    "MPYS %s"
-};
+/*
+    Equivalent of tms9995_mem_write. A byte is taken from the high byte.
+*/
+static void tms9995_fast_write(struct tms9995 *tms, uint16_t addr, uint16_t value, bool byte)
+{
+	if ((addr & 0xfffe)==0xfffa && !tms->mp9537)
+	{
+		if (byte && addr == 0xfffb) value >>= 8;
+		tms->starting_count_storage_register = tms->decrementer_value = value;
+		tms9995_fast_clock(tms, 1);
+		return;
+	}
 
-static const char *opnames12[] = {
-    "LST %w",
-    "LWP %w",
-    NULL,
-    NULL,
-    NULL,
-    NULL,
-    NULL,
-    NULL,
-};
+	if (is_onchip(tms, addr))
+	{
+		if (!byte) addr &= 0xfffe;
+		tms->onchip_memory[addr & 0x00ff] = (value >> 8) & 0xff;
+		if (!byte)
+			tms->onchip_memory[(addr & 0x00ff)+1] = value & 0xff;
+		tms9995_fast_clock(tms, 1);
+		return;
+	}
 
-struct opset {
-    uint16_t min;
-    uint16_t shift;
-    const char **name;
-};
+	if (!byte) addr &= 0xfffe;
+	tms9995_writeb(tms, addr, (value >> 8) & 0xff);
+	tms9995_fast_clock(tms, 1);
+	if (!byte)
+	{
+		tms9995_writeb(tms, addr | 1, value & 0xff);
+		tms9995_fast_clock(tms, 1);
+	}
+}
 
-struct opset ops[] = {
-    {	0x4000, 12,	opnames0	},
-    {	0x2000,	10,	opnames1	},
-    {	0x1000, 8,	opnames2	},
-    {	0x0E40, 6,	NULL		},
-    {	0x0E00, 4,	NULL		},
-    {	0x0C40, 6,	NULL		},
-    {	0x0C10, 4,	NULL		},
-    {	0x0C00, 0,	NULL		},
-    {	0x0800, 8,	opnames8	},
-    {	0x0400,	6,	opnames9	},
-    {	0x0200,	5,	opnames10	},
-    {	0x0100, 6,	opnames11	},
-    {	0x0080,	4,	opnames12	},
-    {	0,		}
-};
+#define MEMORY_READ_FAST(tms)	\
+	((tms)->current_value = tms9995_fast_read((tms), (tms)->address, (tms)->byteop))
+#define MEMORY_WRITE_FAST(tms)	\
+	tms9995_fast_write((tms), (tms)->address, (tms)->current_value, (tms)->byteop)
 
+/*
+    Operand address derivation for the 6 bit Ts/S field. Leaves the operand
+    address in tms->address and the previous tms->current_value in
+    tms->source_value as the microprogram does.
+*/
+static void tms9995_fast_operand(struct tms9995 *tms, uint16_t field)
+{
+	uint16_t regaddr = tms->WP + ((field & 0x000f) << 1);
+	uint16_t value;
 
-static uint16_t idata[3];
-static uint16_t iptr;
+	tms->source_value = tms->current_value;
 
-static struct opset *tms9995_get_op(uint16_t ip)
+	switch ((field >> 4) & 3)
+	{
+	case 0:     // Register direct
+		tms->address = regaddr;
+		break;
+	case 1:     // Register indirect
+		tms->address = tms9995_fast_read(tms, regaddr, false);
+		break;
+	case 2:
+		if ((field & 0x000f) == 0)
+		{
+			// Symbolic
+			value = tms->PC;
+			tms->PC = (tms->PC + 2) & 0xfffe;
+			tms->address = tms9995_fast_read(tms, value, false);
+		}
+		else
+		{
+			// Indexed
+			tms->address_add = tms9995_fast_read(tms, regaddr, false);
+			value = tms->PC;
+			tms->PC = (tms->PC + 2) & 0xfffe;
+			tms9995_fast_clock(tms, 1);
+			tms->address = tms9995_fast_read(tms, value, false) + tms->address_add;
+		}
+		break;
+	case 3:     // Register indirect auto-increment
+		value = tms9995_fast_read(tms, regaddr, false);
+		tms9995_fast_clock(tms, 1);
+		tms9995_fast_write(tms, regaddr, value + (tms->byteop ? 1 : 2), false);
+		tms->address = value;
+		break;
+	}
+	tms->current_value = tms->address;
+}
+
+/*
+    Equivalent of tms9995_int_prefetch_and_decode when not IDLE
+*/
+static void tms9995_fast_prefetch(struct tms9995 *tms)
 {
-    struct opset *p = ops;
-    while(p->min) {
-        if (ip >= p->min)
-            return p;
-        p++;
-    }
-    return NULL;
+	int intmask = tms->ST & 0x000f;
+
+	if (tms->nmi_active)
+	{
+		tms->int_pending |= PENDING_NMI;
+		tms->idle_state = false;
+		tms->PC = (tms->PC + 2) & 0xfffe;
+		return;
+	}
+
+	tms->int_pending = 0;
+	if ((tms->int1_active || tms->flag[2]) && intmask >= 1) tms->int_pending |= PENDING_LEVEL1;
+	if (tms->int_overflow && intmask >= 2) tms->int_pending |= PENDING_OVERFLOW;
+	if (tms->flag[3] && intmask >= 3) tms->int_pending |= PENDING_DECR;
+	if ((tms->int4_active || tms->flag[4]) && intmask >= 4) tms->int_pending |= PENDING_LEVEL4;
+
+	if (tms->int_pending != 0)
+	{
+		tms->PC = tms->PC + 2;
+		return;
+	}
+
+	tms9995_decode(tms, tms9995_fast_read(tms, tms->PC, false));
+	tms->PC = (tms->PC + 2) & 0xfffe;
 }
 
-static uint16_t next_word(void)
+static void tms9995_fast_add_s_sxc(struct tms9995 *tms)
 {
-    return idata[iptr++];
+	tms9995_fast_operand(tms, tms->IR);
+	MEMORY_READ_FAST(tms);
+	tms9995_fast_operand(tms, tms->IR >> 6);
+	MEMORY_READ_FAST(tms);
+	tms9995_alu_add_s_sxc(tms);
+	tms9995_fast_prefetch(tms);
+	MEMORY_WRITE_FAST(tms);
 }
 
-static char *decode_addr(char *p, uint8_t bits)
+static void tms9995_fast_b(struct tms9995 *tms)
 {
-    uint8_t v = bits & 0x0F;
-    switch(bits & 0x30) {
-    case 0x00:	/* R */
-        p += sprintf(p, "R%d", v);
-        break;
-    case 0x10:
-        p += sprintf(p, "*R%d", v);
-        break;
-    case 0x20:
-        p += sprintf(p, "@%04X", next_word());
-        if (v)
-            p += sprintf(p, "(R%d)", v);
-        break;
-    case 0x30:
-        p += sprintf(p, "*R%d+", v);
-        break;
-    }
-    return p;
+	tms9995_fast_operand(tms, tms->IR);
+	tms9995_fast_clock(tms, 1);
+	tms9995_alu_b(tms);
+	tms9995_fast_prefetch(tms);
+	tms9995_fast_clock(tms, 1);
 }
 
-static char *decode_op(struct opset *op, uint16_t ip)
+static void tms9995_fast_bl(struct tms9995 *tms)
 {
-    static char buf[128];
-    char *out = buf;
-    uint16_t inst;
-    const char *name = NULL;
+	tms9995_fast_b(tms);
+	MEMORY_WRITE_FAST(tms);
+	tms9995_fast_clock(tms, 1);
+}
 
-    if (op) {
-        inst = (ip - op->min) >> op->shift;
-        if (op->name)
-            name = op->name[inst];
-    }
+static void tms9995_fast_c(struct tms9995 *tms)
+{
+	tms9995_fast_operand(tms, tms->IR);
+	MEMORY_READ_FAST(tms);
+	tms9995_fast_operand(tms, tms->IR >> 6);
+	MEMORY_READ_FAST(tms);
+	tms9995_alu_c(tms);
+	tms9995_fast_prefetch(tms);
+	tms9995_fast_clock(tms, 1);
+}
 
-    if (name == NULL) {
-        sprintf(buf, "ILLEGAL %04X", ip);
-        return buf;
-    }
-    /* TODO; a first *name byte to say 'non inst must be zero' */
-    while(*name) {
-        if (*name != '%') {
-            *out++ = *name++;
-            continue;
-        }
-        switch(*++name) {
-            case 'w':
-                out += sprintf(out, "R%d", ip & 0x0F);
-                break;
-            case 'W':
-                out += sprintf(out, "R%d", (ip >> 6) & 0x0F);
-                break;
-            case 's':
-                out = decode_addr(out, ip);
-                break;
-            case 'd':
-                out = decode_addr(out, ip >> 6);
-                break;
-            case 'a':
-                out = decode_addr(out, ip >> 4);
-                break;
-            case 'x':
-                out += sprintf(out, "%d", (ip >> 6) & 0x0F);
-                break;
-            case '8':
-                out += sprintf(out, "%d", (int)(int8_t)ip);
-                break;
-            case 'S':
-                out += sprintf(out, "%d", (ip >> 4) & 0x0F);
-                break;
-            case 'i':
-                out += sprintf(out, "%04X", next_word());
-                break;
-        }
-        name++;
-    }
-    *out = 0;
-    return buf;
+/*
+    Immediate operand fetch (SET_IMM followed by MEMORY_READ)
+*/
+static void tms9995_fast_immediate(struct tms9995 *tms)
+{
+	tms->address_saved = tms->WP + ((tms->IR & 0x000f)<<1);
+	tms->source_value = tms->current_value;
+	tms->address = tms->PC;
+	tms->PC = (tms->PC + 2) & 0xfffe;
+	MEMORY_READ_FAST(tms);
+}
+
+static void tms9995_fast_ci(struct tms9995 *tms)
+{
+	MEMORY_READ_FAST(tms);
+	tms9995_fast_immediate(tms);
+	tms9995_alu_ci(tms);
+	tms9995_fast_prefetch(tms);
+	tms9995_fast_clock(tms, 1);
+}
+
+static void tms9995_fast_clr_seto(struct tms9995 *tms)
+{
+	tms9995_fast_operand(tms, tms->IR);
+	tms9995_fast_clock(tms, 1);
+	tms9995_alu_clr_seto(tms);
+	tms9995_fast_prefetch(tms);
+	MEMORY_WRITE_FAST(tms);
+}
+
+static void tms9995_fast_f3(struct tms9995 *tms)
+{
+	tms9995_fast_operand(tms, tms->IR);
+	MEMORY_READ_FAST(tms);
+	tms9995_alu_f3(tms);
+	MEMORY_READ_FAST(tms);
+	tms9995_alu_f3(tms);
+	tms9995_fast_prefetch(tms);
+	if (tms->command == XOR)
+		MEMORY_WRITE_FAST(tms);
+	else
+		tms9995_fast_clock(tms, 1);
 }
 
+static void tms9995_fast_imm_arithm(struct tms9995 *tms)
+{
+	MEMORY_READ_FAST(tms);
+	tms9995_fast_immediate(tms);
+	tms9995_alu_imm_arithm(tms);
+	tms9995_fast_prefetch(tms);
+	MEMORY_WRITE_FAST(tms);
+}
+
+static void tms9995_fast_jump(struct tms9995 *tms)
+{
+	tms9995_fast_clock(tms, 1);
+	tms9995_alu_jump(tms);
+	tms9995_fast_prefetch(tms);
+	tms9995_fast_clock(tms, 1);
+}
+
+static void tms9995_fast_li(struct tms9995 *tms)
+{
+	tms9995_fast_immediate(tms);
+	tms9995_alu_li(tms);
+	tms9995_fast_prefetch(tms);
+	MEMORY_WRITE_FAST(tms);
+}
+
+static void tms9995_fast_limi_lwpi(struct tms9995 *tms)
+{
+	tms9995_fast_immediate(tms);
+	tms9995_fast_clock(tms, 1);
+	tms9995_alu_limi_lwpi(tms);
+	tms9995_fast_prefetch(tms);
+	tms9995_fast_clock(tms, 1);
+}
+
+static void tms9995_fast_lst_lwp(struct tms9995 *tms)
+{
+	MEMORY_READ_FAST(tms);
+	tms9995_fast_clock(tms, 1);
+	tms9995_alu_lst_lwp(tms);
+	tms9995_fast_prefetch(tms);
+	tms9995_fast_clock(tms, 1);
+}
+
+static void tms9995_fast_mov(struct tms9995 *tms)
+{
+	tms9995_fast_operand(tms, tms->IR);
+	MEMORY_READ_FAST(tms);
+	tms9995_fast_operand(tms, tms->IR >> 6);
+	tms9995_alu_mov(tms);
+	tms9995_fast_prefetch(tms);
+	MEMORY_WRITE_FAST(tms);
+}
+
+static void tms9995_fast_multiply(struct tms9995 *tms)
+{
+	tms9995_fast_operand(tms, tms->IR);
+	MEMORY_READ_FAST(tms);
+	tms9995_alu_multiply(tms);
+	MEMORY_READ_FAST(tms);
+	tms9995_alu_multiply(tms);
+	MEMORY_WRITE_FAST(tms);
+	tms9995_alu_multiply(tms);
+	tms9995_fast_prefetch(tms);
+	MEMORY_WRITE_FAST(tms);
+}
+
+static void tms9995_fast_rtwp(struct tms9995 *tms)
+{
+	tms9995_alu_rtwp(tms);
+	MEMORY_READ_FAST(tms);
+	tms9995_alu_rtwp(tms);
+	MEMORY_READ_FAST(tms);
+	tms9995_alu_rtwp(tms);
+	MEMORY_READ_FAST(tms);
+	tms9995_alu_rtwp(tms);
+	tms9995_fast_prefetch(tms);
+	tms9995_fast_clock(tms, 1);
+}
+
+static void tms9995_fast_shift(struct tms9995 *tms)
+{
+	MEMORY_READ_FAST(tms);
+	tms9995_alu_shift(tms);
+	// A zero count in the instruction means the count comes from R0
+	if (tms->current_value == 0)
+		MEMORY_READ_FAST(tms);
+	tms9995_alu_shift(tms);
+	tms9995_fast_prefetch(tms);
+	MEMORY_WRITE_FAST(tms);
+}
+
+static void tms9995_fast_single_arithm(struct tms9995 *tms)
+{
+	tms9995_fast_operand(tms, tms->IR);
+	MEMORY_READ_FAST(tms);
+	tms9995_alu_single_arithm(tms);
+	tms9995_fast_prefetch(tms);
+	MEMORY_WRITE_FAST(tms);
+}
+
+static void tms9995_fast_stst_stwp(struct tms9995 *tms)
+{
+	tms9995_alu_stst_stwp(tms);
+	tms9995_fast_clock(tms, 1);
+	tms9995_fast_prefetch(tms);
+	MEMORY_WRITE_FAST(tms);
+}
+
+/*
+    Instruction handlers indexed by command id. NULL means the instruction
+    always goes through the microcode engine.
+*/
+static const ophandler s_fast_command[OPAD + 1] =
+{
+	[A] = tms9995_fast_add_s_sxc,
+	[AB] = tms9995_fast_add_s_sxc,
+	[ABS] = tms9995_fast_single_arithm,
+	[AI] = tms9995_fast_imm_arithm,
+	[ANDI] = tms9995_fast_imm_arithm,
+	[B] = tms9995_fast_b,
+	[BL] = tms9995_fast_bl,
+	[C] = tms9995_fast_c,
+	[CB] = tms9995_fast_c,
+	[CI] = tms9995_fast_ci,
+	[CLR] = tms9995_fast_clr_seto,
+	[COC] = tms9995_fast_f3,
+	[CZC] = tms9995_fast_f3,
+	[DEC] = tms9995_fast_single_arithm,
+	[DECT] = tms9995_fast_single_arithm,
+	[INC] = tms9995_fast_single_arithm,
+	[INCT] = tms9995_fast_single_arithm,
+	[INV] = tms9995_fast_single_arithm,
+	[JEQ] = tms9995_fast_jump,
+	[JGT] = tms9995_fast_jump,
+	[JH] = tms9995_fast_jump,
+	[JHE] = tms9995_fast_jump,
+	[JL] = tms9995_fast_jump,
+	[JLE] = tms9995_fast_jump,
+	[JLT] = tms9995_fast_jump,
+	[JMP] = tms9995_fast_jump,
+	[JNC] = tms9995_fast_jump,
+	[JNE] = tms9995_fast_jump,
+	[JNO] = tms9995_fast_jump,
+	[JOC] = tms9995_fast_jump,
+	[JOP] = tms9995_fast_jump,
+	[LI] = tms9995_fast_li,
+	[LIMI] = tms9995_fast_limi_lwpi,
+	[LST] = tms9995_fast_lst_lwp,
+	[LWP] = tms9995_fast_lst_lwp,
+	[LWPI] = tms9995_fast_limi_lwpi,
+	[MOV] = tms9995_fast_mov,
+	[MOVB] = tms9995_fast_mov,
+	[MPY] = tms9995_fast_multiply,
+	[MPYS] = tms9995_fast_multiply,
+	[NEG] = tms9995_fast_single_arithm,
+	[ORI] = tms9995_fast_imm_arithm,
+	[RTWP] = tms9995_fast_rtwp,
+	[S] = tms9995_fast_add_s_sxc,
+	[SB] = tms9995_fast_add_s_sxc,
+	[SETO] = tms9995_fast_clr_seto,
+	[SLA] = tms9995_fast_shift,
+	[SOC] = tms9995_fast_add_s_sxc,
+	[SOCB] = tms9995_fast_add_s_sxc,
+	[SRA] = tms9995_fast_shift,
+	[SRC] = tms9995_fast_shift,
+	[SRL] = tms9995_fast_shift,
+	[STST] = tms9995_fast_stst_stwp,
+	[STWP] = tms9995_fast_stst_stwp,
+	[SWPB] = tms9995_fast_single_arithm,
+	[SZC] = tms9995_fast_add_s_sxc,
+	[SZCB] = tms9995_fast_add_s_sxc,
+	[XOR] = tms9995_fast_f3,
+};
+
+/*
+    Run the current instruction to completion if we can. Returns false
+    if the microcode engine has to take it.
+*/
+static bool tms9995_execute_fast(struct tms9995 *tms)
+{
+	ophandler op = s_fast_command[tms->command];
+
+	if (op == NULL || tms->trace || tms->itrace || tms->hold_requested
+		|| tms->auto_wait || !tms->ready_bufd || tms->idle_state)
+		return false;
+
+	tms->boundary = false;
+	op(tms);
+
+	tms->ready = tms->ready_bufd;
+	tms->check_ready = false;
+	tms->check_hold = true;
+
+	// Run the END step as the main loop would
+	tms->pass = 1;
+	tms9995_command_completed(tms);
+	tms->pass--;
+	if (tms->pass<=0)
+	{
+		tms->pass = 1;
+		tms->MPC++;
+	}
+	return true;
+}
+
+/* Disassembler */
+
 static uint16_t tms9995_debug_read(struct tms9995 *tms, uint16_t addr)
 {
     if (is_onchip(tms, addr))
@@ -3556,19 +3825,14 @@ static uint16_t tms9995_debug_read(struct tms9995 *tms, uint16_t addr)
 
 static void tms9995_disassemble(struct tms9995 *tms)
 {
-    struct opset *op;
-    uint16_t ir;
+    uint16_t idata[3];
     uint16_t addr = tms->PC_debug;
     unsigned int i;
 
-    iptr = 0;
     idata[0] = tms9995_debug_read(tms, addr);
     idata[1] = tms9995_debug_read(tms, addr + 2);
     idata[2] = tms9995_debug_read(tms, addr + 4);
 
-    ir = next_word();
-    op = tms9995_get_op(ir);
-
     for (i = 0; i < 16; i++) {
         fprintf(stderr, "R%d %04x ", i, tms9995_read_workspace_register_debug(tms, i));
         if ((i & 3) == 3) {
@@ -3578,5 +3842,5 @@ static void tms9995_disassemble(struct tms9995 *tms)
         } else
             fprintf(stderr, " | ");
     }
-    fprintf(stderr, "%04X: %s\n\t\t", tms->PC_debug, decode_op(op, ir));
+    fprintf(stderr, "%04X: %s\n\t\t", tms->PC_debug, tms9995_disasm(idata));
 }
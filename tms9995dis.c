@@ -0,0 +1,255 @@
+/*
+ *	TMS9995 disassembler, split out of the CPU core so that it can also be
+ *	used by offline tools.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include "tms9995dis.h"
+
+/* Op decode table */
+
+static const char *opnames0[] = {
+    "SZC %s,%d",
+    "SZCB %s,%d",
+    "S %s,%d",
+    "SB %s,%d",
+    "C %s,%d",
+    "CB %s,%d",
+    "A %s,%d",
+    "AB %s,%d",
+    "MOV %s,%d",
+    "MOVB %s,%d",
+    "SOC %s,%d",
+    "SOCB %s,%d"
+};
+
+static const char *opnames1[] = {
+    "COC %s,%W",
+    "CZC %s,%W",
+    "XOR %s,%W",
+    "XOP %x,%s ",
+    "LDCR %x,%s",
+    "STCR %x,%s",
+    "MPY %s,%W",
+    "DIV %s,%W"
+};
+
+static const char *opnames2[] = {
+    "JMP %8",
+    "JLT %8",
+    "JLE %8",
+    "JEQ %8",
+    "JHE %8",
+    "JGT %8",
+    "JNE %8",
+    "JNC %8",
+    "JOC %8",
+    "JNO %8",
+    "JL %8",
+    "JH %8",
+    "JOP %8",
+    "SBO %8",
+    "SBZ %8",
+    "TB %8"
+};
+
+static const char *opnames8[] = {
+    "SRA %w,%S",
+    "SRL %w,%S",
+    "SLA %w,%S",
+    "SRC %w,%S"
+};
+
+static const char *opnames9[] = {
+    "BLWP %s",
+    "B %s",
+    "X %s",
+    "CLR %s",
+    "NEG %s",
+    "INV %s",
+    "INC %s",
+    "INCT %s",
+    "DEC %s",
+    "DECT %s",
+    "BL %s",
+    "SWPB %s",
+    "SETO %s",
+    "ABS %s",
+    NULL,
+    NULL
+};
+
+static const char *opnames10[] = {
+    "LI %w,%i",
+    "AI %w,%i",
+    "ANDI %w,%i",
+    "ORI %w,%i",
+    "CI %w,%i",
+    "STWP %w",
+    "STST %w",
+    "LWPI %i",
+    "LIMI %i",
+    NULL,
+    "IDLE",	/* No arguments */
+    "RSET",	/* No arguments */
+    "RTWP",	/* No arguments */
+    "CKON",	/* No arguments */
+    "CKOF",	/* No arguments */
+    "LREX"	/* No arguments */
+};
+
+static const char *opnames11[] = {
+    NULL,
+    NULL, //"BIND",
+    "DIVS %s",
+    "MPYS %s"
+};
+
+static const char *opnames12[] = {
+    "LST %w",
+    "LWP %w",
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+};
+
+struct opset {
+    uint16_t min;
+    uint16_t shift;
+    const char **name;
+};
+
+static struct opset ops[] = {
+    {	0x4000, 12,	opnames0	},
+    {	0x2000,	10,	opnames1	},
+    {	0x1000, 8,	opnames2	},
+    {	0x0E40, 6,	NULL		},
+    {	0x0E00, 4,	NULL		},
+    {	0x0C40, 6,	NULL		},
+    {	0x0C10, 4,	NULL		},
+    {	0x0C00, 0,	NULL		},
+    {	0x0800, 8,	opnames8	},
+    {	0x0400,	6,	opnames9	},
+    {	0x0200,	5,	opnames10	},
+    {	0x0100, 6,	opnames11	},
+    {	0x0080,	4,	opnames12	},
+    {	0,		}
+};
+
+
+static uint16_t idata[3];
+static uint16_t iptr;
+
+static struct opset *tms9995_get_op(uint16_t ip)
+{
+    struct opset *p = ops;
+    while(p->min) {
+        if (ip >= p->min)
+            return p;
+        p++;
+    }
+    return NULL;
+}
+
+static uint16_t next_word(void)
+{
+    return idata[iptr++];
+}
+
+static char *decode_addr(char *p, uint8_t bits)
+{
+    uint8_t v = bits & 0x0F;
+    switch(bits & 0x30) {
+    case 0x00:	/* R */
+        p += sprintf(p, "R%d", v);
+        break;
+    case 0x10:
+        p += sprintf(p, "*R%d", v);
+        break;
+    case 0x20:
+        p += sprintf(p, "@%04X", next_word());
+        if (v)
+            p += sprintf(p, "(R%d)", v);
+        break;
+    case 0x30:
+        p += sprintf(p, "*R%d+", v);
+        break;
+    }
+    return p;
+}
+
+static char *decode_op(struct opset *op, uint16_t ip)
+{
+    static char buf[128];
+    char *out = buf;
+    uint16_t inst;
+    const char *name = NULL;
+
+    if (op) {
+        inst = (ip - op->min) >> op->shift;
+        if (op->name)
+            name = op->name[inst];
+    }
+
+    if (name == NULL) {
+        sprintf(buf, "ILLEGAL %04X", ip);
+        return buf;
+    }
+    /* TODO; a first *name byte to say 'non inst must be zero' */
+    while(*name) {
+        if (*name != '%') {
+            *out++ = *name++;
+            continue;
+        }
+        switch(*++name) {
+            case 'w':
+                out += sprintf(out, "R%d", ip & 0x0F);
+                break;
+            case 'W':
+                out += sprintf(out, "R%d", (ip >> 6) & 0x0F);
+                break;
+            case 's':
+                out = decode_addr(out, ip);
+                break;
+            case 'd':
+                out = decode_addr(out, ip >> 6);
+                break;
+            case 'a':
+                out = decode_addr(out, ip >> 4);
+                break;
+            case 'x':
+                out += sprintf(out, "%d", (ip >> 6) & 0x0F);
+                break;
+            case '8':
+                out += sprintf(out, "%d", (int)(int8_t)ip);
+                break;
+            case 'S':
+                out += sprintf(out, "%d", (ip >> 4) & 0x0F);
+                break;
+            case 'i':
+                out += sprintf(out, "%04X", next_word());
+                break;
+        }
+        name++;
+    }
+    *out = 0;
+    return buf;
+}
+
+/* Decode the instruction in words[0], with any operands following */
+char *tms9995_disasm(const uint16_t *words)
+{
+    uint16_t ir;
+
+    iptr = 0;
+    idata[0] = words[0];
+    idata[1] = words[1];
+    idata[2] = words[2];
+
+    ir = next_word();
+    return decode_op(tms9995_get_op(ir), ir);
+}
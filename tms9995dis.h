@@ -0,0 +1,3 @@
+
+/* Entry point: words[0] is the opcode, up to two operand words follow */
+extern char *tms9995_disasm(const uint16_t *words);
@@ -0,0 +1,145 @@
+/*
+ *	Binary instruction trace ring buffer
+ *
+ *	The caller asks for the next record slot and fills in what it has.
+ *	We keep the last N records and write them out oldest first. There
+ *	is no formatting on the hot path at all.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <signal.h>
+#include "tracebuf.h"
+
+struct tracebuf {
+	struct tracebuf_rec *ring;
+	unsigned int size;
+	unsigned int head;
+	unsigned int wrapped;
+	uint32_t trigger;
+	unsigned int triggered;
+	uint8_t cpu;
+	char *path;
+};
+
+/* Only one trace per emulator so the exit and signal paths can find it */
+static struct tracebuf *tracebuf_active;
+static volatile sig_atomic_t tracebuf_signalled;
+
+static int tracebuf_put(int fd, struct tracebuf_rec *r, unsigned int n)
+{
+	size_t len = n * sizeof(struct tracebuf_rec);
+	return write(fd, r, len) == len ? 0 : -1;
+}
+
+static void tracebuf_write(struct tracebuf *tb)
+{
+	struct tracebuf_header h;
+	int fd;
+	int err;
+
+	memcpy(h.magic, TRACEBUF_MAGIC, 4);
+	h.version = TRACEBUF_VERSION;
+	h.cpu = tb->cpu;
+	h.recsize = sizeof(struct tracebuf_rec);
+	h.count = tb->wrapped ? tb->size : tb->head;
+
+	fd = open(tb->path, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+	if (fd == -1) {
+		perror(tb->path);
+		return;
+	}
+	err = write(fd, &h, sizeof(h)) != sizeof(h);
+	/* Oldest first: if we wrapped that is the slot we write next */
+	if (!err && tb->wrapped)
+		err = tracebuf_put(fd, tb->ring + tb->head, tb->size - tb->head);
+	if (!err)
+		err = tracebuf_put(fd, tb->ring, tb->head);
+	if (err)
+		perror(tb->path);
+	close(fd);
+	fprintf(stderr, "[Trace of %u instructions written to %s]\n", h.count, tb->path);
+}
+
+void tracebuf_dump(struct tracebuf *tb)
+{
+	tracebuf_write(tb);
+}
+
+static void tracebuf_exit(void)
+{
+	/* A trigger snapshot is what was asked for, don't overwrite it */
+	if (tracebuf_active && tracebuf_active->triggered != 2)
+		tracebuf_write(tracebuf_active);
+}
+
+static void tracebuf_signal(int sig)
+{
+	tracebuf_signalled = 1;
+}
+
+struct tracebuf *tracebuf_create(const char *path, unsigned cpu, unsigned entries)
+{
+	struct tracebuf *tb = malloc(sizeof(struct tracebuf));
+	if (tb == NULL) {
+		fprintf(stderr, "Out of memory.\n");
+		exit(1);
+	}
+	tb->ring = calloc(entries, sizeof(struct tracebuf_rec));
+	tb->path = strdup(path);
+	if (tb->ring == NULL || tb->path == NULL) {
+		fprintf(stderr, "Out of memory.\n");
+		exit(1);
+	}
+	tb->size = entries;
+	tb->head = 0;
+	tb->wrapped = 0;
+	tb->trigger = TRACEBUF_NOTRIGGER;
+	tb->triggered = 0;
+	tb->cpu = cpu;
+
+	tracebuf_active = tb;
+	atexit(tracebuf_exit);
+	signal(SIGUSR1, tracebuf_signal);
+	return tb;
+}
+
+/* Dump the buffer the first time we execute addr */
+void tracebuf_trigger(struct tracebuf *tb, uint32_t addr)
+{
+	tb->trigger = addr;
+}
+
+/*
+ *	Hand back the record to fill for the instruction at pc. The pc is
+ *	filled in for the caller and everything else is left as it was.
+ */
+struct tracebuf_rec *tracebuf_next(struct tracebuf *tb, uint32_t pc)
+{
+	struct tracebuf_rec *r;
+
+	if (tracebuf_signalled) {
+		tracebuf_signalled = 0;
+		tracebuf_write(tb);
+	}
+	/* The triggering instruction is the last one recorded so dump on
+	   the following call once it has been filled in */
+	if (tb->triggered == 1) {
+		tb->triggered = 2;
+		tracebuf_write(tb);
+	}
+	if (pc == tb->trigger && !tb->triggered)
+		tb->triggered = 1;
+
+	r = tb->ring + tb->head;
+	if (++tb->head == tb->size) {
+		tb->head = 0;
+		tb->wrapped = 1;
+	}
+	r->pc = pc;
+	return r;
+}
@@ -0,0 +1,44 @@
+/*
+ *	Binary instruction trace ring buffer
+ *
+ *	Records are fixed size and written raw so that tracing can be left
+ *	on while chasing a rare failure. The ring is written out on exit,
+ *	on SIGUSR1 or when a trigger address is executed and can be decoded
+ *	afterwards with tracedump.
+ */
+
+#define TRACEBUF_MAGIC		"ETRB"
+#define TRACEBUF_VERSION	1
+
+#define TRACEBUF_Z80		1
+#define TRACEBUF_6502		3
+#define TRACEBUF_68000		4
+#define TRACEBUF_TMS9995	5
+
+#define TRACEBUF_NOTRIGGER	0xFFFFFFFFU
+
+/* Everything is in host byte order */
+struct tracebuf_header {
+	char magic[4];
+	uint8_t version;
+	uint8_t cpu;
+	uint16_t recsize;
+	uint32_t count;
+};
+
+struct tracebuf_rec {
+	uint64_t cycle;
+	uint32_t pc;
+	uint32_t bank;		/* Board defined: bank latch, MMU state etc */
+	uint32_t reg[8];	/* CPU specific, see tracedump */
+	uint8_t op[14];		/* Instruction bytes from pc */
+	uint8_t oplen;
+	uint8_t flags;		/* Reserved, written as 0 */
+};
+
+struct tracebuf;
+
+extern struct tracebuf *tracebuf_create(const char *path, unsigned cpu, unsigned entries);
+extern void tracebuf_trigger(struct tracebuf *tb, uint32_t addr);
+extern struct tracebuf_rec *tracebuf_next(struct tracebuf *tb, uint32_t pc);
+extern void tracebuf_dump(struct tracebuf *tb);
@@ -0,0 +1,145 @@
+/*
+ *	Decode a binary trace written by the emulators with -t tracefile
+ *
+ *	tracedump tracefile
+ *
+ *	Each record is printed as cycle, bank state, pc, the disassembled
+ *	instruction and the register snapshot for that CPU type.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <m68k.h>
+#include "tracebuf.h"
+#include "z80dis.h"
+#include "tms9995dis.h"
+
+extern void disassembler_init(void);
+extern char *dis6502(uint16_t addr, uint8_t *p);
+
+/* The record being decoded. The disassemblers ask for bytes by address
+   so we serve them out of the bytes captured at the time */
+static struct tracebuf_rec *cur;
+
+static uint8_t rec_byte(uint32_t addr)
+{
+	uint32_t off = addr - cur->pc;
+	if (off >= cur->oplen)
+		return 0xFF;
+	return cur->op[off];
+}
+
+uint8_t z80dis_byte(uint16_t addr)
+{
+	return rec_byte(addr);
+}
+
+unsigned int cpu_read_word_dasm(unsigned int addr)
+{
+	return (rec_byte(addr) << 8) | rec_byte(addr + 1);
+}
+
+unsigned int cpu_read_long_dasm(unsigned int addr)
+{
+	return (cpu_read_word_dasm(addr) << 16) | cpu_read_word_dasm(addr + 2);
+}
+
+static void decode_z80(struct tracebuf_rec *r)
+{
+	char buf[256];
+
+	z80_disasm(buf, r->pc);
+	printf("%04X: %-20s [ %02X:%02X %04X %04X %04X %04X %04X %04X I%02X R%02X %s ]\n",
+		r->pc, buf, r->reg[0] >> 8, r->reg[0] & 0xFF,
+		r->reg[1], r->reg[2], r->reg[3], r->reg[4], r->reg[5], r->reg[6],
+		(r->reg[7] >> 8) & 0xFF, r->reg[7] & 0xFF,
+		(r->reg[7] & 0x10000) ? "EI" : "DI");
+}
+
+static void decode_6502(struct tracebuf_rec *r)
+{
+	printf("%04X: %-20s [ A %02X X %02X Y %02X S %02X P %02X ]\n",
+		r->pc, dis6502(r->pc, r->op),
+		r->reg[0], r->reg[1], r->reg[2], r->reg[3], r->reg[4]);
+}
+
+static void decode_68000(struct tracebuf_rec *r)
+{
+	char buf[128];
+
+	m68k_disassemble(buf, r->pc, M68K_CPU_TYPE_68000);
+	printf("%06X: %-30s [ D0 %08X D1 %08X D2 %08X A0 %08X A1 %08X A6 %08X A7 %08X SR %04X ]\n",
+		r->pc, buf, r->reg[0], r->reg[1], r->reg[2], r->reg[3],
+		r->reg[4], r->reg[5], r->reg[6], r->reg[7]);
+}
+
+static void decode_tms9995(struct tracebuf_rec *r)
+{
+	uint16_t w[3];
+	unsigned int i;
+
+	for (i = 0; i < 3; i++)
+		w[i] = cpu_read_word_dasm(r->pc + 2 * i);
+	printf("%04X: %-20s [ WP %04X ST %04X R0 %04X R1 %04X R2 %04X R3 %04X R4 %04X R5 %04X ]\n",
+		r->pc, tms9995_disasm(w), r->reg[0], r->reg[1],
+		r->reg[2], r->reg[3], r->reg[4], r->reg[5], r->reg[6], r->reg[7]);
+}
+
+int main(int argc, char *argv[])
+{
+	struct tracebuf_header h;
+	struct tracebuf_rec r;
+	void (*decode)(struct tracebuf_rec *);
+	FILE *fp;
+	uint32_t n = 0;
+
+	if (argc != 2) {
+		fprintf(stderr, "%s: tracefile\n", argv[0]);
+		exit(1);
+	}
+	fp = fopen(argv[1], "r");
+	if (fp == NULL) {
+		perror(argv[1]);
+		exit(1);
+	}
+	if (fread(&h, sizeof(h), 1, fp) != 1 || memcmp(h.magic, TRACEBUF_MAGIC, 4)) {
+		fprintf(stderr, "%s: not a trace file.\n", argv[1]);
+		exit(1);
+	}
+	if (h.version != TRACEBUF_VERSION || h.recsize != sizeof(r)) {
+		fprintf(stderr, "%s: unsupported trace version %d.\n", argv[1], h.version);
+		exit(1);
+	}
+	switch(h.cpu) {
+	case TRACEBUF_Z80:
+		decode = decode_z80;
+		break;
+	case TRACEBUF_6502:
+		disassembler_init();
+		decode = decode_6502;
+		break;
+	case TRACEBUF_68000:
+		decode = decode_68000;
+		break;
+	case TRACEBUF_TMS9995:
+		decode = decode_tms9995;
+		break;
+	default:
+		fprintf(stderr, "%s: unknown CPU type %d.\n", argv[1], h.cpu);
+		exit(1);
+	}
+
+	cur = &r;
+	while (n < h.count && fread(&r, sizeof(r), 1, fp) == 1) {
+		printf("%12llu %08X ", (unsigned long long)r.cycle, r.bank);
+		decode(&r);
+		n++;
+	}
+	if (n != h.count)
+		fprintf(stderr, "%s: truncated after %u of %u records.\n",
+			argv[1], n, h.count);
+	fclose(fp);
+	return 0;
+}
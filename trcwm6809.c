@@ -158,6 +158,27 @@ void uart16x50_signal_change(struct uart16x50 *uart, uint8_t mcr)
 	/* Modem lines changed - don't care */
 }
 
+/* Point the CPU straight at the memory behind each page so it only calls
+   us for I/O, ROM writes and when tracing memory. Redone whenever the
+   page register changes */
+static void remap(void)
+{
+	unsigned int pg;
+	unsigned int addr;
+
+	for (pg = 0; pg < 256; pg++) {
+		addr = pg << 8;
+		if ((trace & TRACE_MEM) || (addr & 0xF000) == 0xE000)
+			e6809_map_page(pg, NULL, NULL);
+		else if ((addr & 0xF000) == 0xF000)
+			e6809_map_page(pg, rom + (addr & 0xFFF), NULL);
+		else if (addr & 0x8000)
+			e6809_map_page(pg, ram + addr, ram + addr);
+		else
+			e6809_map_page(pg, ram + (addr | (page << 15)), ram + (addr | (page << 15)));
+	}
+}
+
 unsigned char do_e6809_read8(unsigned addr, unsigned debug)
 {
         unsigned char r = 0xFF;
@@ -211,6 +232,7 @@ void e6809_write8(unsigned addr, unsigned char val)
         }
         else if ((addr & 0xF800) == 0xE800) {
             page = val & 0x1F;
+            remap();
             return;
         }
         else if (addr & 0x8000)
@@ -349,6 +371,7 @@ int main(int argc, char *argv[])
 		tcsetattr(0, TCSADRAIN, &term);
 	}
 
+	remap();
 	e6809_reset(trace & TRACE_CPU);
 
 	/* This is the wrong way to do it but it's easier for the moment. We
@@ -359,8 +382,11 @@ int main(int argc, char *argv[])
 	while (!done) {
 		unsigned int i;
 		for (i = 0; i < 100; i++) {
-			while(cycles < clockrate)
-				cycles += e6809_sstep(live_irq, 0);
+			if (trace & TRACE_CPU) {
+				while(cycles < clockrate)
+					cycles += e6809_sstep(live_irq, 0);
+			} else if (cycles < clockrate)
+				cycles += e6809_run(clockrate - cycles, &live_irq, NULL);
 			cycles -= clockrate;
 			recalc_interrupts();
 		}
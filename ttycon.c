@@ -9,15 +9,29 @@
 
 /*
  *	This replaces the old hard coded serial to tty link
+ *
+ *	Input is read in blocks so that a UART with a FIFO can take a
+ *	pasted or transferred file as fast as the host supplies it
+ *	without a system call per byte.
  */
+static uint8_t con_buf[256];
+static unsigned con_pos;
+static unsigned con_len;
+
 static unsigned con_ready(struct serial_device *dev)
 {
 	fd_set i, o;
 	struct timeval tv;
 	unsigned int r = 0;
 
+	/* Input already buffered is ready, but we must still ask whether
+	   stdout can take more */
+	if (con_pos < con_len)
+		r = 1;
+
 	FD_ZERO(&i);
-	FD_SET(0, &i);
+	if (r == 0)
+		FD_SET(0, &i);
 	FD_ZERO(&o);
 	FD_SET(1, &o);
 	tv.tv_sec = 0;
@@ -25,7 +39,7 @@ static unsigned con_ready(struct serial_device *dev)
 
 	if (select(2, &i, &o, NULL, &tv) == -1) {
 		if (errno == EINTR)
-			return 0;
+			return r;
 		perror("select");
 		exit(1);
 	}
@@ -49,8 +63,16 @@ static unsigned con_noready(struct serial_device *dev)
 static uint8_t con_get(struct serial_device *dev)
 {
 	static uint8_t c;
-	if (read(0, (char *)&c, 1) != 1)
-		return c;
+	int l;
+
+	if (con_pos == con_len) {
+		l = read(0, con_buf, sizeof(con_buf));
+		if (l <= 0)
+			return c;
+		con_len = l;
+		con_pos = 0;
+	}
+	c = con_buf[con_pos++];
 	if (c == 0x0A)
 		c = '\r';
 	return c;
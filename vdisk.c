@@ -0,0 +1,188 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+
+#include "vdisk.h"
+
+/*
+ *	Paravirtual block device. Each command runs to completion as soon
+ *	as it is written so the card is never busy. The data is moved
+ *	through the machine's own memory map callbacks so banking and ROM
+ *	protection apply as they would to the CPU or a DMA engine.
+ *
+ *	The LBA, count and address registers are left pointing past the
+ *	last block moved so a driver can carry on from there.
+ */
+
+struct vdisk {
+	int fd;
+	int ro;
+	uint32_t blocks;
+	uint8_t reg[8];
+	uint8_t status;
+	uint8_t buf[512];
+	vdisk_read_t rd;
+	vdisk_write_t wr;
+	void *priv;
+	int trace;
+};
+
+static uint32_t get24(struct vdisk *vd, unsigned r)
+{
+	return vd->reg[r] | (vd->reg[r + 1] << 8) | (vd->reg[r + 2] << 16);
+}
+
+static void put24(struct vdisk *vd, unsigned r, uint32_t v)
+{
+	vd->reg[r] = v;
+	vd->reg[r + 1] = v >> 8;
+	vd->reg[r + 2] = v >> 16;
+}
+
+static int vdisk_xfer(struct vdisk *vd, int is_write)
+{
+	uint32_t lba = get24(vd, 1);
+	uint32_t addr = get24(vd, 5);
+	unsigned count = vd->reg[4] ? vd->reg[4] : 256;
+	unsigned i;
+
+	if (vd->trace)
+		fprintf(stderr, "vdisk: %s %u blocks at %u, buffer %06X\n",
+			is_write ? "write" : "read", count, lba, addr);
+	if (is_write && vd->ro)
+		return -1;
+	if (lba + count > vd->blocks) {
+		if (vd->trace)
+			fprintf(stderr, "vdisk: beyond end of disk.\n");
+		return -1;
+	}
+	while (count--) {
+		off_t off = (off_t)lba << 9;
+		if (is_write) {
+			for (i = 0; i < 512; i++)
+				vd->buf[i] = vd->rd(vd->priv, addr + i);
+			if (pwrite(vd->fd, vd->buf, 512, off) != 512) {
+				perror("vdisk");
+				return -1;
+			}
+		} else {
+			if (pread(vd->fd, vd->buf, 512, off) != 512) {
+				perror("vdisk");
+				return -1;
+			}
+			for (i = 0; i < 512; i++)
+				vd->wr(vd->priv, addr + i, vd->buf[i]);
+		}
+		lba++;
+		addr += 512;
+		put24(vd, 1, lba);
+		put24(vd, 5, addr);
+		vd->reg[4]--;
+	}
+	return 0;
+}
+
+static void vdisk_command(struct vdisk *vd, uint8_t cmd)
+{
+	int err = 0;
+
+	switch(cmd & ~VDISK_CMD_IRQ) {
+	case VDISK_CMD_READ:
+		err = vdisk_xfer(vd, 0);
+		break;
+	case VDISK_CMD_WRITE:
+		err = vdisk_xfer(vd, 1);
+		break;
+	case VDISK_CMD_SIZE:
+		put24(vd, 1, vd->blocks > 0xFFFFFF ? 0xFFFFFF : vd->blocks);
+		break;
+	default:
+		if (vd->trace)
+			fprintf(stderr, "vdisk: unknown command %02X.\n", cmd);
+		err = -1;
+	}
+	vd->status = VDISK_ST_READY;
+	if (err)
+		vd->status |= VDISK_ST_ERROR;
+	if (cmd & VDISK_CMD_IRQ)
+		vd->status |= VDISK_ST_IRQ;
+}
+
+uint8_t vdisk_read(struct vdisk *vd, uint8_t addr)
+{
+	uint8_t r;
+
+	addr &= 7;
+	if (addr)
+		return vd->reg[addr];
+	/* Reading the status acknowledges the interrupt */
+	r = vd->status;
+	vd->status &= ~VDISK_ST_IRQ;
+	return r;
+}
+
+void vdisk_write(struct vdisk *vd, uint8_t addr, uint8_t val)
+{
+	addr &= 7;
+	if (addr)
+		vd->reg[addr] = val;
+	else
+		vdisk_command(vd, val);
+}
+
+int vdisk_irq_pending(struct vdisk *vd)
+{
+	return vd->status & VDISK_ST_IRQ;
+}
+
+void vdisk_reset(struct vdisk *vd)
+{
+	memset(vd->reg, 0, sizeof(vd->reg));
+	vd->status = VDISK_ST_READY;
+}
+
+void vdisk_trace(struct vdisk *vd, int onoff)
+{
+	vd->trace = onoff;
+}
+
+struct vdisk *vdisk_create(const char *path, vdisk_read_t rd, vdisk_write_t wr, void *priv)
+{
+	struct vdisk *vd = malloc(sizeof(struct vdisk));
+	off_t size;
+
+	if (vd == NULL) {
+		fprintf(stderr, "Out of memory.\n");
+		exit(1);
+	}
+	memset(vd, 0, sizeof(struct vdisk));
+	vd->rd = rd;
+	vd->wr = wr;
+	vd->priv = priv;
+
+	vd->fd = open(path, O_RDWR);
+	if (vd->fd == -1 && (errno == EACCES || errno == EROFS)) {
+		vd->fd = open(path, O_RDONLY);
+		vd->ro = 1;
+	}
+	if (vd->fd == -1 || (size = lseek(vd->fd, 0L, SEEK_END)) == -1) {
+		perror(path);
+		if (vd->fd != -1)
+			close(vd->fd);
+		free(vd);
+		return NULL;
+	}
+	vd->blocks = size >> 9;
+	vdisk_reset(vd);
+	return vd;
+}
+
+void vdisk_free(struct vdisk *vd)
+{
+	close(vd->fd);
+	free(vd);
+}
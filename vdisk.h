@@ -0,0 +1,35 @@
+/*
+ *	A paravirtual block device for the RCbus machines
+ *
+ *	There is no real card like this. It exists so that guests that
+ *	have a driver for it can move whole blocks straight to and from
+ *	memory instead of a byte at a time through an emulated port.
+ *
+ *	0	W command R status
+ *	1-3	LBA (low byte first)
+ *	4	block count (0 = 256)
+ *	5-7	buffer address (low byte first)
+ */
+
+#define VDISK_CMD_READ		0x01
+#define VDISK_CMD_WRITE		0x02
+#define VDISK_CMD_SIZE		0x03	/* LBA registers := size in blocks */
+#define VDISK_CMD_IRQ		0x80	/* Or in to interrupt on completion */
+
+#define VDISK_ST_ERROR		0x01
+#define VDISK_ST_IRQ		0x20
+#define VDISK_ST_READY		0x40
+#define VDISK_ST_BUSY		0x80
+
+struct vdisk;
+
+typedef uint8_t (*vdisk_read_t)(void *priv, uint32_t addr);
+typedef void (*vdisk_write_t)(void *priv, uint32_t addr, uint8_t val);
+
+extern struct vdisk *vdisk_create(const char *path, vdisk_read_t rd, vdisk_write_t wr, void *priv);
+extern void vdisk_free(struct vdisk *vd);
+extern void vdisk_reset(struct vdisk *vd);
+extern uint8_t vdisk_read(struct vdisk *vd, uint8_t addr);
+extern void vdisk_write(struct vdisk *vd, uint8_t addr, uint8_t val);
+extern int vdisk_irq_pending(struct vdisk *vd);
+extern void vdisk_trace(struct vdisk *vd, int onoff);
@@ -0,0 +1,95 @@
+/*
+ *	Wall clock time as seen by the emulated RTCs
+ *
+ *	When a board runs unthrottled, fast forwards idle time or replays
+ *	an input log the host clock no longer has anything to do with the
+ *	emulated machine. Guest timers and the guest RTC then disagree, and
+ *	a replay sees a different date each run. Instead every RTC asks us,
+ *	and we can derive the time from the emulated cycle count.
+ *
+ *	The broken down time is cached and only recomputed when the second
+ *	changes so the RTCs can ask on every register access.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "wallclock.h"
+
+static unsigned wallclock_mode;
+static time_t wallclock_epoch;
+static uint64_t (*wallclock_cycles)(void);
+static uint64_t wallclock_hz;
+
+static time_t gm_time = -1;
+static struct tm gm_tm;
+static time_t local_time = -1;
+static struct tm local_tm;
+
+/* Parse a command line clock option: host, emu, or a fixed start
+   time in seconds since 1970 */
+int wallclock_option(const char *arg)
+{
+	char *p;
+	long long t;
+
+	if (strcmp(arg, "host") == 0) {
+		wallclock_mode = WALLCLOCK_HOST;
+		return 0;
+	}
+	if (strcmp(arg, "emu") == 0) {
+		wallclock_mode = WALLCLOCK_EMULATED;
+		wallclock_epoch = time(NULL);
+		return 0;
+	}
+	t = strtoll(arg, &p, 0);
+	if (*arg == 0 || *p || t < 0) {
+		fprintf(stderr, "wallclock: clock must be host, emu or a time in seconds.\n");
+		return -1;
+	}
+	wallclock_mode = WALLCLOCK_FIXED;
+	wallclock_epoch = t;
+	return 0;
+}
+
+void wallclock_set_clock(uint64_t (*cycles)(void), uint64_t hz)
+{
+	wallclock_cycles = cycles;
+	wallclock_hz = hz;
+}
+
+time_t wallclock_time(void)
+{
+	if (wallclock_mode == WALLCLOCK_HOST)
+		return time(NULL);
+	if (wallclock_cycles == NULL) {
+		if (wallclock_mode == WALLCLOCK_FIXED)
+			return wallclock_epoch;
+		return time(NULL);
+	}
+	return wallclock_epoch + wallclock_cycles() / wallclock_hz;
+}
+
+struct tm *wallclock_gmtime(void)
+{
+	time_t t = wallclock_time();
+	if (t != gm_time) {
+		if (gmtime_r(&t, &gm_tm) == NULL)
+			return NULL;
+		gm_time = t;
+	}
+	return &gm_tm;
+}
+
+struct tm *wallclock_localtime(void)
+{
+	time_t t = wallclock_time();
+	if (t != local_time) {
+		if (localtime_r(&t, &local_tm) == NULL)
+			return NULL;
+		local_time = t;
+	}
+	return &local_tm;
+}
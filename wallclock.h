@@ -0,0 +1,21 @@
+/*
+ *	Wall clock time as seen by the emulated RTCs
+ *
+ *	WALLCLOCK_HOST		the host time, as before
+ *	WALLCLOCK_EMULATED	host time at start up plus emulated run time
+ *	WALLCLOCK_FIXED		a given start time plus emulated run time
+ *
+ *	Emulated run time comes from a cycle counter the board registers.
+ *	A board that registers none just gets host time, or for a fixed
+ *	clock the start time frozen.
+ */
+
+#define WALLCLOCK_HOST		0
+#define WALLCLOCK_EMULATED	1
+#define WALLCLOCK_FIXED		2
+
+extern int wallclock_option(const char *arg);
+extern void wallclock_set_clock(uint64_t (*cycles)(void), uint64_t hz);
+extern time_t wallclock_time(void);
+extern struct tm *wallclock_gmtime(void);
+extern struct tm *wallclock_localtime(void);
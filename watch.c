@@ -0,0 +1,137 @@
+/*
+ *	Memory watchpoints
+ *
+ *	Rather than tracing every memory access to catch a corruption we
+ *	keep a bitmap of the 256 byte pages any watchpoint covers. The board
+ *	leaves those pages out of its CPU page map so only accesses to them
+ *	come through the slow path and get checked here. Everything else runs
+ *	as fast as it ever did, so a watchpoint can be left armed across a
+ *	long run.
+ *
+ *	A hit is always reported. The board hook decides what stopping or
+ *	tracing means for that machine.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "watch.h"
+
+#define MAX_WATCH	16
+#define WATCH_PAGES	65536		/* Covers a 24bit address space */
+
+struct watch {
+	uint32_t start;
+	uint32_t end;
+	unsigned type;
+	int value;			/* -1 for any */
+	unsigned action;
+};
+
+static struct watch watches[MAX_WATCH];
+static unsigned nwatch;
+static uint8_t watch_map[WATCH_PAGES / 8];
+static void (*watch_hook)(unsigned action, uint32_t addr);
+
+int watch_option(const char *arg)
+{
+	struct watch *w = &watches[nwatch];
+	const char *p = arg;
+	char *e;
+	uint32_t page;
+
+	if (nwatch == MAX_WATCH) {
+		fprintf(stderr, "watch: too many watchpoints.\n");
+		return -1;
+	}
+	memset(w, 0, sizeof(struct watch));
+	w->value = -1;
+	while (*p && *p != ':') {
+		if (*p == 'r')
+			w->type |= WATCH_READ;
+		else if (*p == 'w')
+			w->type |= WATCH_WRITE;
+		else
+			break;
+		p++;
+	}
+	if (w->type == 0 || *p++ != ':')
+		goto bad;
+	w->start = strtoul(p, &e, 16);
+	if (e == p)
+		goto bad;
+	w->end = w->start;
+	p = e;
+	if (*p == '-') {
+		w->end = strtoul(p + 1, &e, 16);
+		if (e == p + 1 || w->end < w->start)
+			goto bad;
+		p = e;
+	}
+	if (*p == '=') {
+		w->value = strtoul(p + 1, &e, 16);
+		if (e == p + 1 || w->value > 0xFF)
+			goto bad;
+		p = e;
+	}
+	if (strcmp(p, ",stop") == 0)
+		w->action = WATCH_STOP;
+	else if (strcmp(p, ",trace") == 0)
+		w->action = WATCH_TRACE;
+	else if (*p)
+		goto bad;
+	if ((w->end >> 8) >= WATCH_PAGES) {
+		fprintf(stderr, "watch: address out of range.\n");
+		return -1;
+	}
+	for (page = w->start >> 8; page <= w->end >> 8; page++)
+		watch_map[page >> 3] |= 1 << (page & 7);
+	nwatch++;
+	return 0;
+bad:
+	fprintf(stderr, "watch: expected r|w|rw:start[-end][=value][,stop|,trace].\n");
+	return -1;
+}
+
+/* True if the board must route this page through its slow accessors */
+int watch_page(uint32_t page)
+{
+	if (page >= WATCH_PAGES)
+		return 0;
+	return watch_map[page >> 3] & (1 << (page & 7));
+}
+
+void watch_set_hook(void (*hook)(unsigned action, uint32_t addr))
+{
+	watch_hook = hook;
+}
+
+static void watch_check(unsigned type, uint32_t addr, uint8_t val)
+{
+	struct watch *w = watches;
+	unsigned i;
+
+	if (!watch_page(addr >> 8))
+		return;
+	for (i = 0; i < nwatch; i++, w++) {
+		if (!(w->type & type) || addr < w->start || addr > w->end)
+			continue;
+		if (w->value != -1 && w->value != val)
+			continue;
+		fprintf(stderr, "watch: %c %04X = %02X\n",
+			type == WATCH_READ ? 'R' : 'W', addr, val);
+		if (watch_hook)
+			watch_hook(w->action, addr);
+	}
+}
+
+void watch_read(uint32_t addr, uint8_t val)
+{
+	watch_check(WATCH_READ, addr, val);
+}
+
+void watch_write(uint32_t addr, uint8_t val)
+{
+	watch_check(WATCH_WRITE, addr, val);
+}
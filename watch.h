@@ -0,0 +1,27 @@
+/*
+ *	Memory watchpoints
+ *
+ *	r|w|rw:start[-end][=value][,stop|,trace]
+ *
+ *	Addresses and values are hex and are CPU addresses. A board with a
+ *	page map sends every page watch_page() reports through its slow
+ *	accessors and calls watch_read()/watch_write() from them, so pages
+ *	with nothing watched run at full speed. A board without one calls
+ *	them on every access, which costs a bitmap test.
+ */
+
+#include <stdint.h>
+
+#define WATCH_READ	1
+#define WATCH_WRITE	2
+
+/* Actions handed to the board hook on a hit */
+#define WATCH_LOG	0
+#define WATCH_STOP	1
+#define WATCH_TRACE	2
+
+extern int watch_option(const char *arg);
+extern int watch_page(uint32_t page);
+extern void watch_set_hook(void (*hook)(unsigned action, uint32_t addr));
+extern void watch_read(uint32_t addr, uint8_t val);
+extern void watch_write(uint32_t addr, uint8_t val);
@@ -4,6 +4,7 @@
 #include <string.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <sys/mman.h>
 #include "system.h"
 #include "wd17xx.h"
 
@@ -13,6 +14,10 @@
 
 struct wd17xx {
 	int fd[4];
+	uint8_t *map[4];	/* Image mapped into memory, or NULL */
+	off_t maplen[4];
+	off_t sidesize[4];	/* Bytes per side of a cylinder */
+	off_t cylsize[4];	/* Bytes per cylinder */
 	unsigned int tracks[4];
 	unsigned int spt[4];
 	unsigned int secsize[4];
@@ -24,6 +29,9 @@ struct wd17xx {
 	unsigned int diskden[4];
 	unsigned int drive;
 	uint8_t buf[2048];
+	uint8_t *rdbuf;		/* buf, or trackbuf for a read track */
+	uint8_t *trackbuf;
+	unsigned int trackbuflen;
 	unsigned int pos;
 	unsigned int wr;
 	unsigned int rd;
@@ -60,29 +68,159 @@ struct wd17xx {
 
 #define NO_DRIVE	0xFF
 
-static void wd17xx_diskseek(struct wd17xx *fdc)
+static off_t wd17xx_diskseek(struct wd17xx *fdc, unsigned sector)
 {
 	off_t pos;
+	unsigned drive = fdc->drive;
 	unsigned track = fdc->track;
 
 	/* Devices with different numbering for side 1 */
 	if (fdc->side)
-		track -= fdc->side1[fdc->drive];
+		track -= fdc->side1[drive];
 
-	pos = track * fdc->spt[fdc->drive] * fdc->sides[fdc->drive];
-	pos += fdc->sector - fdc->sector0[fdc->drive];
-	if (fdc->sides[fdc->drive] == 2 && fdc->side)
-		pos += fdc->spt[fdc->drive];
-	pos *= fdc->secsize[fdc->drive];
-	if (lseek(fdc->fd[fdc->drive], pos, SEEK_SET) < 0) {
-		perror("lseek");
-		exit(1);
-	}
+	pos = track * fdc->cylsize[drive];
+	pos += (sector - fdc->sector0[drive]) * fdc->secsize[drive];
+	if (fdc->sides[drive] == 2 && fdc->side)
+		pos += fdc->sidesize[drive];
 	if (fdc->trace) {
 		fprintf(stderr, "fdc%d: seek to %d,%d,%d = %lx\n",
-			fdc->drive, fdc->side, track, fdc->sector,
-			(long)pos);
+			drive, fdc->side, track, sector, (long)pos);
 	}
+	return pos;
+}
+
+/* Move a sector between the image and buf. Mapped images are just a
+   copy; anything else, or beyond the end of the mapping, goes to the
+   file */
+static int wd17xx_diskio(struct wd17xx *fdc, unsigned sector, uint8_t *buf,
+	unsigned wr)
+{
+	unsigned drive = fdc->drive;
+	unsigned size = fdc->secsize[drive];
+	off_t pos = wd17xx_diskseek(fdc, sector);
+
+	if (fdc->map[drive] && pos + size <= fdc->maplen[drive]) {
+		if (wr)
+			memcpy(fdc->map[drive] + pos, buf, size);
+		else
+			memcpy(buf, fdc->map[drive] + pos, size);
+		return 0;
+	}
+	if (lseek(fdc->fd[drive], pos, SEEK_SET) < 0) {
+		perror("lseek");
+		return -1;
+	}
+	if (wr) {
+		if (write(fdc->fd[drive], buf, size) != size) {
+			perror("wd17xx: write: ");
+			return -1;
+		}
+	} else if (read(fdc->fd[drive], buf, size) != size) {
+		perror("wd17xx: read: ");
+		return -1;
+	}
+	return 0;
+}
+
+static unsigned wd17xx_sizecode(unsigned size)
+{
+	unsigned n = 0;
+	while ((128U << n) < size && n < 3)
+		n++;
+	return n;
+}
+
+static uint16_t wd17xx_crc(const uint8_t *p, unsigned len)
+{
+	uint16_t crc = 0xFFFF;
+	unsigned i;
+
+	while (len--) {
+		crc ^= *p++ << 8;
+		for (i = 0; i < 8; i++)
+			crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+	}
+	return crc;
+}
+
+static uint8_t *wd17xx_fill(uint8_t *p, uint8_t v, unsigned n)
+{
+	memset(p, v, n);
+	return p + n;
+}
+
+/* Sync and address mark for an ID or data field. The CRC covers the
+   A1 sync bytes in MFM */
+static uint8_t *wd17xx_mark(uint8_t *p, unsigned fm, uint8_t mark)
+{
+	p = wd17xx_fill(p, 0x00, fm ? 6 : 12);
+	if (!fm)
+		p = wd17xx_fill(p, 0xA1, 3);
+	*p++ = mark;
+	return p;
+}
+
+static uint8_t *wd17xx_field_crc(uint8_t *p, uint8_t *start)
+{
+	uint16_t crc = wd17xx_crc(start, p - start);
+	*p++ = crc >> 8;
+	*p++ = crc;
+	return p;
+}
+
+/*
+ *	Lay out a whole track as READ TRACK would return it, with the
+ *	standard IBM gaps. The clock bits are lost so the MFM sync marks
+ *	just read as A1 and C2.
+ */
+static unsigned wd17xx_build_track(struct wd17xx *fdc, unsigned track)
+{
+	unsigned drive = fdc->drive;
+	unsigned fm = fdc->density == DEN_SD || fdc->diskden[drive] == DEN_SD;
+	unsigned size = fdc->secsize[drive];
+	unsigned need = 256 + fdc->spt[drive] * (size + 128);
+	uint8_t gap = fm ? 0xFF : 0x4E;
+	uint8_t *p, *f;
+	unsigned i;
+
+	if (need > fdc->trackbuflen) {
+		p = realloc(fdc->trackbuf, need);
+		if (p == NULL)
+			return 0;
+		fdc->trackbuf = p;
+		fdc->trackbuflen = need;
+	}
+	p = fdc->trackbuf;
+	p = wd17xx_fill(p, gap, fm ? 40 : 80);
+	p = wd17xx_fill(p, 0x00, fm ? 6 : 12);
+	if (!fm)
+		p = wd17xx_fill(p, 0xC2, 3);
+	*p++ = 0xFC;
+	p = wd17xx_fill(p, gap, fm ? 26 : 50);
+
+	for (i = 0; i < fdc->spt[drive]; i++) {
+		f = p + (fm ? 6 : 12);
+		p = wd17xx_mark(p, fm, 0xFE);
+		*p++ = track;
+		*p++ = fdc->side;
+		*p++ = fdc->sector0[drive] + i;
+		*p++ = wd17xx_sizecode(size);
+		p = wd17xx_field_crc(p, f);
+		p = wd17xx_fill(p, gap, fm ? 11 : 22);
+
+		f = p + (fm ? 6 : 12);
+		p = wd17xx_mark(p, fm, 0xFB);
+		/* Sector data goes straight into place */
+		if (wd17xx_diskio(fdc, fdc->sector0[drive] + i, p, 0)) {
+			fprintf(stderr, "wd17xx: I/O error.\n");
+			memset(p, 0, size);
+		}
+		p += size;
+		p = wd17xx_field_crc(p, f);
+		p = wd17xx_fill(p, gap, fm ? 27 : 54);
+	}
+	p = wd17xx_fill(p, gap, fm ? 40 : 80);
+	return p - fdc->trackbuf;
 }
 
 uint8_t wd17xx_read_data(struct wd17xx *fdc)
@@ -101,14 +239,14 @@ uint8_t wd17xx_read_data(struct wd17xx *fdc)
 		fdc->status &= ~(DRQ|BUSY);
 		fdc->intrq = 1;
 		fdc->rd = 0;
-		return fdc->buf[fdc->pos];
+		return fdc->rdbuf[fdc->pos];
 	}
 	/* Hand out data */
 	if (fdc->pos < end)
-		return fdc->buf[fdc->pos++];
+		return fdc->rdbuf[fdc->pos++];
 	if (fdc->trace)
 		fprintf(stderr, "fdc%d: read beyond data end.\n", fdc->drive);
-	return fdc->buf[end];
+	return fdc->rdbuf[end];
 }
 
 void wd17xx_write_data(struct wd17xx *fdc, uint8_t v)
@@ -129,11 +267,8 @@ void wd17xx_write_data(struct wd17xx *fdc, uint8_t v)
 	if (fdc->pos == size) {
 		if (fdc->trace)
 			fprintf(stderr, "fdc%d: write final byte, dropping BUSY and DRQ.\n", fdc->drive);
-		wd17xx_diskseek(fdc);
-		if (write(fdc->fd[fdc->drive], fdc->buf, size) != size) {
-			perror("wd17xx: write: ");
+		if (wd17xx_diskio(fdc, fdc->sector, fdc->buf, 1))
 			fprintf(stderr, "wd17xx: I/O error.\n");
-		}
 		fdc->status &= ~(BUSY | DRQ);
 		fdc->wr = 0;
 		fdc->intrq = 1;
@@ -407,10 +542,9 @@ void wd17xx_command(struct wd17xx *fdc, uint8_t v)
 			return;
 		}
 		wd17xx_side_control(fdc, v);
-		wd17xx_diskseek(fdc);
 		fdc->rd = 1;
-		if (read(fdc->fd[fdc->drive], fdc->buf, size) != size) {
-			perror("wd17xx: read: ");
+		fdc->rdbuf = fdc->buf;
+		if (wd17xx_diskio(fdc, fdc->sector, fdc->buf, 0)) {
 			fprintf(stderr, "wd17xx: I/O error.\n");
 			fdc->status |= RECNFERR;
 			fdc->intrq = 1;
@@ -457,6 +591,7 @@ void wd17xx_command(struct wd17xx *fdc, uint8_t v)
 		fdc->busy = 0;
 
 		fdc->rd = 1;
+		fdc->rdbuf = fdc->buf;
 		fdc->rdsize = 7;
 
 		/* If we tried to seek off the end of the disk then
@@ -501,9 +636,30 @@ void wd17xx_command(struct wd17xx *fdc, uint8_t v)
 		break;
 	case 0xD0:	/* Force interrupt : handled above */
 		break;
+	case 0xE0:	/* read track */
+		wd17xx_side_control(fdc, v);
+		if (track >= fdc->tracks[fdc->drive] ||
+			fdc->side >= fdc->sides[fdc->drive]) {
+			fdc->status |= RECNFERR;
+			fdc->intrq = 1;
+			return;
+		}
+		/* Build the whole track now and stream it out */
+		fdc->rdsize = wd17xx_build_track(fdc, track);
+		if (fdc->rdsize == 0) {
+			fdc->status |= RECNFERR;
+			fdc->intrq = 1;
+			return;
+		}
+		fdc->rd = 1;
+		fdc->rdbuf = fdc->trackbuf;
+		fdc->status |= DRQ;
+		fdc->busy = 0;
+		wd17xx_check_density(fdc);
+		wd17xx_motor(fdc, motor);
+		break;
 	case 0x90:	/* read multi */
 	case 0xB0:	/* write multi */
-	case 0xE0:	/* read track */
 	case 0xF0:	/* write track */
 	default:
 		fprintf(stderr, "wd17xx: unemulated command %02X.\n", v);
@@ -550,6 +706,7 @@ struct wd17xx *wd17xx_create(unsigned type)
 	fdc->sector0[1] = 1;
 	fdc->sector0[2] = 1;
 	fdc->sector0[3] = 1;
+	fdc->rdbuf = fdc->buf;
 	fdc->type = type;
 	fdc->motor_timeout = 10000;	/* 10 seconds */
 	return fdc;
@@ -557,17 +714,27 @@ struct wd17xx *wd17xx_create(unsigned type)
 
 void wd17xx_detach(struct wd17xx *fdc, int dev)
 {
+	if (fdc->map[dev])
+		munmap(fdc->map[dev], fdc->maplen[dev]);
+	fdc->map[dev] = NULL;
 	if (fdc->fd[dev] != -1)
 		close(fdc->fd[dev]);
 	fdc->fd[dev] = -1;
 }
 
+/*
+ *	The image is mapped shared so sector transfers are a memcpy and
+ *	writes land in the file without any further work. If it cannot be
+ *	mapped we fall back to seek and read/write on the descriptor.
+ */
 int wd17xx_attach(struct wd17xx *fdc, int dev, const char *path,
 	unsigned int sides, unsigned int tracks,
 	unsigned int sectors, unsigned int secsize)
 {
-	if (fdc->fd[dev])
-		close(fdc->fd[dev]);
+	off_t len;
+	void *map;
+
+	wd17xx_detach(fdc, dev);
 	fdc->fd[dev] = open(path, O_RDWR);
 	if (fdc->fd[dev] == -1)
 		perror(path);
@@ -575,6 +742,19 @@ int wd17xx_attach(struct wd17xx *fdc, int dev, const char *path,
 	fdc->tracks[dev] = tracks;
 	fdc->sides[dev] = sides;
 	fdc->secsize[dev] = secsize;
+	fdc->sidesize[dev] = sectors * secsize;
+	fdc->cylsize[dev] = fdc->sidesize[dev] * sides;
+	if (fdc->fd[dev] == -1)
+		return -1;
+	len = lseek(fdc->fd[dev], 0, SEEK_END);
+	if (len > 0) {
+		map = mmap(0, len, PROT_READ|PROT_WRITE, MAP_SHARED,
+			fdc->fd[dev], 0);
+		if (map != MAP_FAILED) {
+			fdc->map[dev] = map;
+			fdc->maplen[dev] = len;
+		}
+	}
 	return fdc->fd[dev];
 }
 
@@ -583,6 +763,7 @@ void wd17xx_free(struct wd17xx *fdc)
 	unsigned int i;
 	for (i = 0; i < 4; i++)
 		wd17xx_detach(fdc, i);
+	free(fdc->trackbuf);
 	free(fdc);
 }
 
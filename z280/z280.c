@@ -95,6 +95,8 @@ struct z280_state
 	UINT32  ea;                             /* effective address */
 	int     eapdr;                          /* PDR used to calculate ea */
 	UINT16  timer_cnt;
+	int     timer_pending;                  /* cycles not yet given to the timers */
+	int     timer_deadline;                 /* when the timers next need to run */
 	struct z80_daisy_chain *daisy;	/* daisy chain */
 	device_irq_acknowledge_callback irq_callback;
 	struct z280_device *device;
@@ -103,8 +105,10 @@ struct z280_state
 	int icount;
 	int extra_cycles;           /* extra cpu cycles */
 	UINT8 *cc[8];	/* cycle count tables */
-	jmp_buf abort_handler;
+	jmp_buf abort_handler;                  /* armed once per cpu_execute_z280 */
+	int abort_cycles;                       /* cycles used before the aborted instruction */
 	UINT8 abort_type;                       /* which abort will be taken upon ACCV */
+	UINT32 tlb[2][64];                      /* MMU translations for read, write */
 };
 
 INLINE struct z280_state *get_safe_token(device_t *device)
@@ -335,6 +339,7 @@ void z280_writeio_byte(struct z280_state *cpustate, offs_t port, UINT8 data);
 UINT16 z280_readio_word(struct z280_state *cpustate, offs_t port);
 void z280_writeio_word(struct z280_state *cpustate, offs_t port, UINT16 data);
 int z280_dma(struct z280_state *cpustate, int channel);
+void z280_sync_timers(struct z280_state *cpustate);
 void cpu_burn_z280(device_t *device, int cycles);
 //static void cpu_set_info_z280(device_t *device, UINT32 state, cpuinfo *info);
 void z280_reload_timer(struct z280_state *cpustate, int unit);
@@ -499,6 +504,8 @@ UINT8 z280_readio_byte(struct z280_state *cpustate, offs_t port)
 {
 	UINT8 data = 0;
 
+	z280_sync_timers(cpustate);
+
 	if(cpustate->cr[Z280_IOP] == Z280_UARTIOP && (port & Z280_UARTMASK) == Z280_UARTBASE) {
 	    offs_t uartport = port & (Z280_UARTRSIZE-1);
 		switch (uartport) {
@@ -591,6 +598,11 @@ UINT8 z280_readio_byte(struct z280_state *cpustate, offs_t port)
 
 void z280_writeio_byte(struct z280_state *cpustate, offs_t port, UINT8 data)
 {
+	/* Bring the timers up to date and look again at when they next
+	   need to run once this write has changed things */
+	z280_sync_timers(cpustate);
+	cpustate->timer_deadline = 0;
+
     if(cpustate->cr[Z280_IOP] == Z280_UARTIOP && (port & Z280_UARTMASK) == Z280_UARTBASE) {
 	    offs_t uartport = port & (Z280_UARTRSIZE-1);
 		switch (uartport) {
@@ -667,6 +679,7 @@ void z280_writeio_byte(struct z280_state *cpustate, offs_t port, UINT8 data)
 	else if(cpustate->cr[Z280_IOP] == Z280_MMUIOP && (port & Z280_MMUMASK) == Z280_MMUBASE) {
 		offs_t mmuport = port & (Z280_MMURSIZE-1);
 		int i;
+		z280_mmu(cpustate);
 		switch (mmuport) {
 			case Z280_MMUMCR:
 				MMUMCR(cpustate) = ((UINT16)data<<8) | (MMUMCR(cpustate)&0xff);
@@ -735,6 +748,8 @@ UINT16 z280_readio_word(struct z280_state *cpustate, offs_t port)
 {
 	UINT16 data = 0;
 
+	z280_sync_timers(cpustate);
+
 	if(cpustate->cr[Z280_IOP] == Z280_UARTIOP && (port & Z280_UARTMASK) == Z280_UARTBASE) {
 	    offs_t uartport = port & (Z280_UARTRSIZE-1);
 		switch (uartport) {
@@ -869,6 +884,11 @@ UINT16 z280_readio_word(struct z280_state *cpustate, offs_t port)
 
 void z280_writeio_word(struct z280_state *cpustate, offs_t port, UINT16 data)
 {
+	/* Bring the timers up to date and look again at when they next
+	   need to run once this write has changed things */
+	z280_sync_timers(cpustate);
+	cpustate->timer_deadline = 0;
+
     if(cpustate->cr[Z280_IOP] == Z280_UARTIOP && (port & Z280_UARTMASK) == Z280_UARTBASE) {
 	    offs_t uartport = port & (Z280_UARTRSIZE-1);
 		switch (uartport) {
@@ -987,6 +1007,7 @@ void z280_writeio_word(struct z280_state *cpustate, offs_t port, UINT16 data)
 	}
 	else if(cpustate->cr[Z280_IOP] == Z280_MMUIOP && (port & Z280_MMUMASK) == Z280_MMUBASE) {
 		offs_t mmuport = port & (Z280_MMURSIZE-1);
+		z280_mmu(cpustate);
 		switch (mmuport) {
 			case Z280_MMUMCR:
 				MMUMCR(cpustate) = data;
@@ -1516,6 +1537,8 @@ void cpu_reset_z280(device_t *device)
 	   cpustate->ctcsr[i] = 0;
 	}
 	cpustate->timer_cnt = 0;
+	cpustate->timer_pending = 0;
+	cpustate->timer_deadline = 0;
 
     cpustate->dar[0] = 0;
     cpustate->dmatdr[0] = 0x100;
@@ -1541,6 +1564,10 @@ void cpu_reset_z280(device_t *device)
 
 #define timer_linking (cpustate->ctcr[0] & Z280_CTCR_CTC)
 
+/* Nothing for the DMA engine to do unless a channel is enabled */
+#define dma_idle(cs) ((cs)->dma_active == -1 && \
+	!(((cs)->dmatdr[0] | (cs)->dmatdr[1] | (cs)->dmatdr[2] | (cs)->dmatdr[3]) & Z280_DMATDR_EN))
+
 /* Reload CT timer */
 void z280_reload_timer(struct z280_state *cpustate, int unit)
 {
@@ -1654,6 +1681,58 @@ void clock_timers(struct z280_state *cpustate, int cycles)
 	}
 }
 
+/* Most instructions change nothing the timers care about, so rather than
+   clock them every instruction we bank the cycles and only run them once
+   enough have built up for something to happen: a counter reaching zero
+   or the UART clock ticking. Anything that looks at or changes the
+   timers syncs them first so they always appear up to date */
+static int timer_deadline(struct z280_state *cpustate)
+{
+	int d = 16384;	/* Keeps timer_cnt and the UART count in range */
+	int i;
+
+	if (!(cpustate->device->z280uart->m_uartcr & 0x8 /*UARTCR_CS*/))
+	{
+		int u = cpustate->device->ctin1_brg_const - cpustate->device->ctin1_uart_timer;
+		if (u < d)
+			d = u;
+	}
+	for (i=0; i<3; i++)
+	{
+		if(!(cpustate->ctcr[i] & Z280_CTCR_CT)
+		   && (cpustate->ctcsr[i] & (Z280_CTCSR_EN | Z280_CTCSR_GT)) == (Z280_CTCSR_EN | Z280_CTCSR_GT))
+		{
+			int c;
+			/* A zero count acts on the next decrement. A linked CT1 is
+			   stepped by CT0 so only matters once it is at zero */
+			if (i == 1 && timer_linking)
+				c = cpustate->ctctr[i] ? d : 4 - cpustate->timer_cnt;
+			else
+				c = (cpustate->ctctr[i] ? cpustate->ctctr[i] : 1) * 4 - cpustate->timer_cnt;
+			if (c < d)
+				d = c;
+		}
+	}
+	return d < 1 ? 1 : d;
+}
+
+void z280_sync_timers(struct z280_state *cpustate)
+{
+	if (cpustate->timer_pending)
+	{
+		clock_timers(cpustate, cpustate->timer_pending);
+		cpustate->timer_pending = 0;
+	}
+	cpustate->timer_deadline = timer_deadline(cpustate);
+}
+
+INLINE void run_timers(struct z280_state *cpustate, int cycles)
+{
+	cpustate->timer_pending += cycles;
+	if (cpustate->timer_pending >= cpustate->timer_deadline)
+		z280_sync_timers(cpustate);
+}
+
 // helper function to calculate UART baud rate
 UINT32 get_brg_const_z280(struct z280_device *d)
 {
@@ -1706,14 +1785,32 @@ void cpu_execute_z280(device_t *device, int icount)
 	int curcycles;
 	cpustate->icount = icount;
 
+	/* An MMU access violation longjmps back here from the middle of an
+	   instruction. Arming this per instruction is expensive so it is
+	   done once and the loop picks up where it left off */
+	if (setjmp(cpustate->abort_handler) != 0)
+	{
+		curcycles = cpustate->abort_cycles;
+		if (cpustate->abort_type == Z280_ABORT_ACCV)
+			curcycles += take_trap(cpustate, Z280_TRAP_ACCV);
+		else
+			curcycles += take_fatal(cpustate);
+		cpustate->icount -= curcycles;
+		run_timers(cpustate, curcycles);
+	}
+
 	while (cpustate->icount > 0)
 	{
 		// DMA
-		curcycles = z280_check_dma(cpustate);
+		curcycles = 0;
+		cpustate->abort_cycles = 0;
+		if (!dma_idle(cpustate))
+			curcycles = z280_check_dma(cpustate);
 		//cpustate->icount -= curcycles;
 		//clock_timers(cpustate, curcycles);
 
 		// interrupts
+		cpustate->abort_cycles = curcycles;
 		curcycles += check_interrupts(cpustate);
 		//cpustate->icount -= curcycles;
 		//clock_timers(cpustate, curcycles);
@@ -1724,6 +1821,7 @@ void cpu_execute_z280(device_t *device, int icount)
 		z280_debug(device, cpustate->_PCD);
 
 		// instructon fetch
+		cpustate->abort_cycles = curcycles;
 		if (!cpustate->HALT)
 		{
 			//cpustate->R++;
@@ -1735,28 +1833,17 @@ void cpu_execute_z280(device_t *device, int icount)
 			else
 			{
 				MSR(cpustate) = (MSR(cpustate)&Z280_MSR_SS)? (MSR(cpustate)|Z280_MSR_SSP) : (MSR(cpustate)&~Z280_MSR_SSP);
-				if (setjmp(cpustate->abort_handler) == 0)
-				{
-					// try to execute the instruction
-					cpustate->extra_cycles = 0;
-					curcycles += exec_op(cpustate,ROP(cpustate));
-					curcycles += cpustate->extra_cycles;
-				}
-				else if (cpustate->abort_type == Z280_ABORT_ACCV)
-				{
-					curcycles += take_trap(cpustate, Z280_TRAP_ACCV);
-				}
-				else
-				{
-					curcycles += take_fatal(cpustate);
-				}
+				// try to execute the instruction
+				cpustate->extra_cycles = 0;
+				curcycles += exec_op(cpustate,ROP(cpustate));
+				curcycles += cpustate->extra_cycles;
 			}
 		}
 		else
 			curcycles += 3;
 
 		cpustate->icount -= curcycles;
-		clock_timers(cpustate, curcycles);
+		run_timers(cpustate, curcycles);
 	}
 
 	//cpustate->old_icount -= cpustate->icount;
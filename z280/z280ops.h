@@ -91,12 +91,21 @@ if ((cs)->cr[Z280_TCR]&Z280_TCR_S &&                          \
 
 /***************************************************************
  * MMU calculate the memory management lookup table
+ *
+ * Successful translations are cached per 4K page, keyed by
+ * user/system mode, program/data and page. A write entry is only
+ * made once the page M bit has been set, so a hit never needs to
+ * touch the PDR. Anything that changes the MMU setup must flush.
  ***************************************************************/
 INLINE void z280_mmu(struct z280_state *cpustate)
 {
-
+	memset(cpustate->tlb, 0, sizeof(cpustate->tlb));
 }
 
+#define TLB_SLOT(cs,addr,program) \
+	((is_user(cs) << 5) | ((program) << 4) | (((addr) >> 12) & 0x0f))
+#define TLB_VALID	1
+
 // translate separate program/data
 INLINE offs_t mmu_translate_separate(struct z280_state *cpustate, offs_t addr, int mode, int program) {
 	offs_t offset, pfa;
@@ -129,7 +138,7 @@ INLINE offs_t mmu_translate_nonseparate(struct z280_state *cpustate, offs_t addr
 }
 
 // translate ea for memory read/write
-INLINE offs_t MMU_REMAP_ADDR(struct z280_state *cpustate, offs_t addr, int program, int write)
+static offs_t mmu_remap_slow(struct z280_state *cpustate, offs_t addr, int program, int write)
 {
 	offs_t res;
 	if (is_user(cpustate)) // User mode
@@ -202,9 +211,19 @@ INLINE offs_t MMU_REMAP_ADDR(struct z280_state *cpustate, offs_t addr, int progr
 			res = addr & 0xffff;
 		}
 	}
+	/* We didn't abort so cache it */
+	cpustate->tlb[write][TLB_SLOT(cpustate, addr, program)] = (res & ~0xfff) | TLB_VALID;
 	return res;
 }
 
+INLINE offs_t MMU_REMAP_ADDR(struct z280_state *cpustate, offs_t addr, int program, int write)
+{
+	UINT32 e = cpustate->tlb[write][TLB_SLOT(cpustate, addr, program)];
+	if (e)
+		return (e & ~0xfff) | (addr & 0xfff);
+	return mmu_remap_slow(cpustate, addr, program, write);
+}
+
 // translate ea for LDUD/LDUP instruction
 INLINE offs_t MMU_REMAP_ADDR_LDU(struct z280_state *cpustate, offs_t addr, int program, int write)
 {
@@ -85,6 +85,7 @@ volatile int emulator_done;
 #define TRACE_RTC	0x001000
 
 static int trace = 0;
+static int jit;
 
 static void reti_event(void);
 
@@ -111,6 +112,14 @@ static uint8_t do_mem_read(uint16_t addr, int quiet)
 	return r;
 }
 
+/* Host memory for the block translator */
+static uint8_t *mem_map(int unused, uint16_t addr)
+{
+	if (trace & TRACE_MEM)
+		return NULL;
+	return map_addr(addr, 0);
+}
+
 void mem_write(int unused, uint16_t addr, uint8_t val)
 {
 	uint8_t *p = map_addr(addr, 1);
@@ -918,7 +927,7 @@ static void exit_cleanup(void)
 static void usage(void)
 {
 	fprintf(stderr,
-		"z80retro: [-b cpath] [-c config] [-r rompath] [-S sdpath] [-N nvpath] [-f] [-d debug]\n"
+		"z80retro: [-b cpath] [-c config] [-r rompath] [-S sdpath] [-N nvpath] [-f] [-O] [-d debug]\n"
 			"   config:  State of DIP switches (0-7)\n"
 			"   rompath: 512K binary file\n"
 			"   sdpath:  Path to file containing SDCard data\n"
@@ -942,7 +951,7 @@ int main(int argc, char *argv[])
 	char *nvpath = "z80retrom.nvram";
 	char *sdpath = NULL;
 
-	while ((opt = getopt(argc, argv, "d:fr:S:")) != -1) {
+	while ((opt = getopt(argc, argv, "d:fOr:S:")) != -1) {
 		switch (opt) {
 		case 'r':
 			rompath = optarg;
@@ -964,6 +973,9 @@ int main(int argc, char *argv[])
 		case 'f':
 			fast = 1;
 			break;
+		case 'O':
+			jit = 1;
+			break;
 		default:
 			usage();
 		}
@@ -1031,6 +1043,10 @@ int main(int argc, char *argv[])
 	cpu_z80.memRead = mem_read;
 	cpu_z80.memWrite = mem_write;
 	cpu_z80.trace = z80_trace;
+	if (jit && Z80JitEnable(&cpu_z80, mem_map)) {
+		fprintf(stderr, "z80retro: -O is not supported on this host.\n");
+		jit = 0;
+	}
 
 	/* This is the wrong way to do it but it's easier for the moment. We
 	   should track how much real time has occurred and try to keep cycle
@@ -1053,6 +1069,9 @@ int main(int argc, char *argv[])
 		for (i = 0; i < 40; i++) {
 			int j;
 			for (j = 0; j < 100; j++) {
+				/* Translated code only runs with no trace hook */
+				if (jit)
+					cpu_z80.trace = (trace & TRACE_CPU) ? z80_trace : NULL;
 				Z80ExecuteTStates(&cpu_z80, (tstate_steps + 5)/ 10);
 				sio2_timer();
 			}